@@ -0,0 +1,298 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-clipboard-provider.h"
+
+/*
+ * What was selected when copying. The same provider backs both the clipboard
+ * and the primary selection, so each format gets serialized at most once, and
+ * is then written to whoever asks a chunk at a time without blocking on them.
+ *
+ * vte doesn't give the selection bounds away, only the selected text, and
+ * output, a reset or a redraw may drop the selection at any time, before
+ * even contents-changed tells about it. The text is thus serialized right
+ * away, copying pays for that. Only the HTML waits for someone to ask for it:
+ * the terminal resolves us right before anything it knows of changes the
+ * selection, and if it goes away before that, so does text/html.
+ */
+#define WRITE_CHUNK_SIZE (64 * 1024)
+
+struct _GerminalClipboardProvider
+{
+    GdkContentProvider parent_instance;
+};
+
+typedef struct
+{
+    VteTerminal *terminal;
+    gulong       selection_changed_id;
+    gboolean     html;
+    GBytes      *text;
+    GBytes      *markup;
+} GerminalClipboardProviderPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GerminalClipboardProvider, germinal_clipboard_provider, GDK_TYPE_CONTENT_PROVIDER)
+
+static const gchar *text_mime_types[] = {
+    "text/plain;charset=utf-8",
+    "text/plain",
+    "UTF8_STRING",
+    "TEXT",
+    "STRING",
+    NULL,
+};
+
+/* The selection is gone, so is anything we didn't serialize yet */
+static void
+germinal_clipboard_provider_forget_terminal (GerminalClipboardProviderPrivate *priv)
+{
+    if (!priv->terminal)
+        return;
+
+    g_clear_signal_handler (&priv->selection_changed_id, priv->terminal);
+    g_clear_weak_pointer (&priv->terminal);
+}
+
+/* Whether text/html can still be provided */
+static gboolean
+germinal_clipboard_provider_has_html (GerminalClipboardProviderPrivate *priv)
+{
+    return priv->html && (priv->markup || priv->terminal);
+}
+
+static void
+on_selection_changed (VteTerminal *terminal G_GNUC_UNUSED,
+                      gpointer     user_data)
+{
+    GdkContentProvider *provider = GDK_CONTENT_PROVIDER (user_data);
+    GerminalClipboardProviderPrivate *priv = germinal_clipboard_provider_get_instance_private (GERMINAL_CLIPBOARD_PROVIDER (provider));
+    gboolean had_html = germinal_clipboard_provider_has_html (priv);
+
+    germinal_clipboard_provider_forget_terminal (priv);
+
+    /* Don't advertise what we can't produce anymore */
+    if (had_html && !germinal_clipboard_provider_has_html (priv))
+        gdk_content_provider_content_changed (provider);
+}
+
+static GBytes *
+germinal_clipboard_provider_get_bytes (GerminalClipboardProvider *self,
+                                       gboolean                   html)
+{
+    GerminalClipboardProviderPrivate *priv = germinal_clipboard_provider_get_instance_private (self);
+    GBytes **bytes = html ? &priv->markup : &priv->text;
+
+    if (!*bytes)
+    {
+        gsize length = 0;
+        gchar *data = priv->terminal ? vte_terminal_get_text_selected_full (priv->terminal, html ? VTE_FORMAT_HTML : VTE_FORMAT_TEXT, &length) : NULL;
+
+        *bytes = data ? g_bytes_new_take (data, length) : g_bytes_new_static ("", 0);
+    }
+
+    return g_bytes_ref (*bytes);
+}
+
+/* Serializes every format we offer while the selection is still there */
+void
+germinal_clipboard_provider_resolve (GerminalClipboardProvider *self)
+{
+    g_return_if_fail (GERMINAL_IS_CLIPBOARD_PROVIDER (self));
+
+    GerminalClipboardProviderPrivate *priv = germinal_clipboard_provider_get_instance_private (self);
+
+    if (!priv->terminal)
+        return;
+
+    g_bytes_unref (germinal_clipboard_provider_get_bytes (self, FALSE));
+    if (priv->html)
+        g_bytes_unref (germinal_clipboard_provider_get_bytes (self, TRUE));
+
+    germinal_clipboard_provider_forget_terminal (priv);
+}
+
+static GdkContentFormats *
+germinal_clipboard_provider_ref_formats (GdkContentProvider *provider)
+{
+    GerminalClipboardProviderPrivate *priv = germinal_clipboard_provider_get_instance_private (GERMINAL_CLIPBOARD_PROVIDER (provider));
+    g_autoptr (GdkContentFormatsBuilder) builder = gdk_content_formats_builder_new ();
+
+    gdk_content_formats_builder_add_gtype (builder, G_TYPE_STRING);
+    if (germinal_clipboard_provider_has_html (priv))
+        gdk_content_formats_builder_add_mime_type (builder, "text/html");
+    for (guint i = 0; text_mime_types[i]; ++i)
+        gdk_content_formats_builder_add_mime_type (builder, text_mime_types[i]);
+
+    return gdk_content_formats_builder_to_formats (builder);
+}
+
+/* Pasting in the same process doesn't go through any stream */
+static gboolean
+germinal_clipboard_provider_get_value (GdkContentProvider  *provider,
+                                       GValue              *value,
+                                       GError             **error)
+{
+    if (G_VALUE_HOLDS (value, G_TYPE_STRING))
+    {
+        g_autoptr (GBytes) text = germinal_clipboard_provider_get_bytes (GERMINAL_CLIPBOARD_PROVIDER (provider), FALSE);
+        gsize length = 0;
+        const gchar *data = g_bytes_get_data (text, &length);
+
+        g_value_take_string (value, g_strndup (data, length));
+        return TRUE;
+    }
+
+    return GDK_CONTENT_PROVIDER_CLASS (germinal_clipboard_provider_parent_class)->get_value (provider, value, error);
+}
+
+typedef struct
+{
+    GOutputStream *stream;
+    GBytes        *bytes;
+    gsize          offset;
+    gint           io_priority;
+} WriteData;
+
+static void
+write_data_free (gpointer data)
+{
+    WriteData *write = data;
+
+    g_object_unref (write->stream);
+    g_bytes_unref (write->bytes);
+    g_free (write);
+}
+
+static void germinal_clipboard_provider_write_next (GTask *task);
+
+static void
+on_chunk_written (GObject      *source,
+                  GAsyncResult *result,
+                  gpointer      user_data)
+{
+    g_autoptr (GTask) task = user_data;
+    WriteData *write = g_task_get_task_data (task);
+    GError *error = NULL;
+    gsize written = 0;
+
+    if (!g_output_stream_write_all_finish (G_OUTPUT_STREAM (source), result, &written, &error))
+    {
+        g_task_return_error (task, error);
+        return;
+    }
+
+    write->offset += written;
+    germinal_clipboard_provider_write_next (task);
+}
+
+static void
+germinal_clipboard_provider_write_next (GTask *task)
+{
+    WriteData *write = g_task_get_task_data (task);
+    gsize length = 0;
+    const guint8 *data = g_bytes_get_data (write->bytes, &length);
+
+    if (write->offset >= length)
+    {
+        g_task_return_boolean (task, TRUE);
+        return;
+    }
+
+    g_output_stream_write_all_async (write->stream, data + write->offset, MIN (length - write->offset, WRITE_CHUNK_SIZE),
+                                     write->io_priority, g_task_get_cancellable (task), on_chunk_written, g_object_ref (task));
+}
+
+static void
+germinal_clipboard_provider_write_mime_type_async (GdkContentProvider  *provider,
+                                                   const gchar         *mime_type,
+                                                   GOutputStream       *stream,
+                                                   gint                 io_priority,
+                                                   GCancellable        *cancellable,
+                                                   GAsyncReadyCallback  callback,
+                                                   gpointer             user_data)
+{
+    GerminalClipboardProvider *self = GERMINAL_CLIPBOARD_PROVIDER (provider);
+    GerminalClipboardProviderPrivate *priv = germinal_clipboard_provider_get_instance_private (self);
+    g_autoptr (GTask) task = g_task_new (provider, cancellable, callback, user_data);
+    gboolean html = !g_strcmp0 (mime_type, "text/html");
+
+    g_task_set_name (task, "[germinal] write-clipboard");
+    g_task_set_priority (task, io_priority);
+
+    if (!(html && germinal_clipboard_provider_has_html (priv)) && !g_strv_contains (text_mime_types, mime_type))
+    {
+        g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Cannot provide contents as “%s”", mime_type);
+        return;
+    }
+
+    WriteData *write = g_new0 (WriteData, 1);
+
+    write->stream = g_object_ref (stream);
+    write->bytes = germinal_clipboard_provider_get_bytes (self, html);
+    write->io_priority = io_priority;
+    g_task_set_task_data (task, write, write_data_free);
+
+    germinal_clipboard_provider_write_next (task);
+}
+
+static gboolean
+germinal_clipboard_provider_write_mime_type_finish (GdkContentProvider  *provider,
+                                                    GAsyncResult        *result,
+                                                    GError             **error)
+{
+    g_return_val_if_fail (g_task_is_valid (result, provider), FALSE);
+
+    return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+static void
+germinal_clipboard_provider_finalize (GObject *object)
+{
+    GerminalClipboardProviderPrivate *priv = germinal_clipboard_provider_get_instance_private (GERMINAL_CLIPBOARD_PROVIDER (object));
+
+    germinal_clipboard_provider_forget_terminal (priv);
+    g_clear_pointer (&priv->text, g_bytes_unref);
+    g_clear_pointer (&priv->markup, g_bytes_unref);
+
+    G_OBJECT_CLASS (germinal_clipboard_provider_parent_class)->finalize (object);
+}
+
+static void
+germinal_clipboard_provider_init (GerminalClipboardProvider *self G_GNUC_UNUSED)
+{
+}
+
+static void
+germinal_clipboard_provider_class_init (GerminalClipboardProviderClass *klass)
+{
+    GdkContentProviderClass *provider_class = GDK_CONTENT_PROVIDER_CLASS (klass);
+
+    G_OBJECT_CLASS (klass)->finalize = germinal_clipboard_provider_finalize;
+
+    provider_class->ref_formats = germinal_clipboard_provider_ref_formats;
+    provider_class->get_value = germinal_clipboard_provider_get_value;
+    provider_class->write_mime_type_async = germinal_clipboard_provider_write_mime_type_async;
+    provider_class->write_mime_type_finish = germinal_clipboard_provider_write_mime_type_finish;
+}
+
+/* Only the text is serialized yet, html also offers the selection as text/html */
+GdkContentProvider *
+germinal_clipboard_provider_new (VteTerminal *terminal,
+                                 gboolean     html)
+{
+    g_return_val_if_fail (VTE_IS_TERMINAL (terminal), NULL);
+
+    GerminalClipboardProvider *self = g_object_new (GERMINAL_TYPE_CLIPBOARD_PROVIDER, NULL);
+    GerminalClipboardProviderPrivate *priv = germinal_clipboard_provider_get_instance_private (self);
+
+    priv->html = html;
+    g_set_weak_pointer (&priv->terminal, terminal);
+    g_bytes_unref (germinal_clipboard_provider_get_bytes (self, FALSE));
+
+    if (html)
+        priv->selection_changed_id = g_signal_connect (terminal, "selection-changed", G_CALLBACK (on_selection_changed), self);
+    else
+        germinal_clipboard_provider_forget_terminal (priv);
+
+    return GDK_CONTENT_PROVIDER (self);
+}
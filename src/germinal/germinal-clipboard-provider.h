@@ -0,0 +1,16 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <vte/vte.h>
+
+G_BEGIN_DECLS
+
+#define GERMINAL_TYPE_CLIPBOARD_PROVIDER germinal_clipboard_provider_get_type ()
+G_DECLARE_FINAL_TYPE (GerminalClipboardProvider, germinal_clipboard_provider, GERMINAL, CLIPBOARD_PROVIDER, GdkContentProvider)
+
+GdkContentProvider *germinal_clipboard_provider_new     (VteTerminal *terminal, gboolean html);
+void                germinal_clipboard_provider_resolve (GerminalClipboardProvider *self);
+
+G_END_DECLS
@@ -0,0 +1,472 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-export.h"
+
+#include <string.h>
+
+/*
+ * The scrollback is written a chunk of rows at a time: vte only gets asked
+ * for the next chunk once the previous one is written, so that neither the
+ * whole text nor the window waiting on the disk are ever a thing.
+ */
+#define EXPORT_CHUNK_ROWS 2000
+
+typedef struct
+{
+    VteTerminal            *terminal;
+    GerminalExportFormat    format;
+    GOutputStream          *stream;
+    gint64                  first;
+    gint64                  next;
+    gint64                  end;
+    gchar                  *header;
+    gchar                  *buffer;
+    gboolean                finishing;
+    GerminalExportProgress  progress;
+    gpointer                progress_data;
+} ExportData;
+
+static void
+export_data_free (gpointer data)
+{
+    ExportData *export = data;
+
+    g_object_unref (export->terminal);
+    g_clear_object (&export->stream);
+    g_free (export->header);
+    g_free (export->buffer);
+    g_free (export);
+}
+
+GerminalExportFormat
+germinal_export_format_for_file (GFile *file)
+{
+    g_autofree gchar *basename = g_file_get_basename (file);
+    const gchar *extension = basename ? strrchr (basename, '.') : NULL;
+
+    if (!extension)
+        return GERMINAL_EXPORT_TEXT;
+
+    if (!g_ascii_strcasecmp (extension, ".html") || !g_ascii_strcasecmp (extension, ".htm"))
+        return GERMINAL_EXPORT_HTML;
+
+    if (!g_ascii_strcasecmp (extension, ".ansi"))
+        return GERMINAL_EXPORT_ANSI;
+
+    return GERMINAL_EXPORT_TEXT;
+}
+
+/* --- HTML to ANSI ----------------------------------------------------- */
+
+/*
+ * vte only gives attributes away as HTML: a <pre> with <b>, <i>, <u>,
+ * <strike> and <blink> tags, <font color> and background-color spans.
+ * Each of them becomes the matching SGR, colors as 24 bits ones.
+ */
+typedef struct
+{
+    const gchar *tag;
+    const gchar *sgr;
+} TagSgr;
+
+static const TagSgr tag_sgrs[] = {
+    { "b",      "1" },
+    { "i",      "3" },
+    { "u",      "4" },
+    { "blink",  "5" },
+    { "strike", "9" },
+};
+
+static const gchar *
+sgr_for_tag (const gchar *tag,
+             gsize        length)
+{
+    g_autofree gchar *name = g_strndup (tag, MIN (strcspn (tag, " \t/>"), length));
+
+    for (guint i = 0; i < G_N_ELEMENTS (tag_sgrs); ++i)
+    {
+        if (!g_ascii_strcasecmp (name, tag_sgrs[i].tag))
+            return tag_sgrs[i].sgr;
+    }
+
+    return NULL;
+}
+
+/* "38;2;r;g;b" for the #rrggbb after key in the tag */
+static gchar *
+color_sgr (const gchar *tag,
+           gsize        length,
+           const gchar *key,
+           const gchar *prefix)
+{
+    g_autofree gchar *attributes = g_strndup (tag, length);
+    const gchar *color = strstr (attributes, key);
+    guint rgb = 0;
+
+    if (!color)
+        return g_strdup ("");
+
+    for (color += strlen (key); *color == ' '; ++color);
+
+    if (*color != '#')
+        return g_strdup ("");
+
+    for (guint i = 1; i <= 6; ++i)
+    {
+        if (!g_ascii_isxdigit (color[i]))
+            return g_strdup ("");
+        rgb = (rgb << 4) | g_ascii_xdigit_value (color[i]);
+    }
+
+    return g_strdup_printf ("%s;2;%u;%u;%u", prefix, rgb >> 16, (rgb >> 8) & 0xff, rgb & 0xff);
+}
+
+/* Tags only change what the next text looks like */
+static void
+germinal_export_flush_sgr (GString   *ansi,
+                           GPtrArray *stack,
+                           gboolean  *dirty)
+{
+    if (!*dirty)
+        return;
+
+    *dirty = FALSE;
+    g_string_append (ansi, "\033[0");
+
+    for (guint i = 0; i < stack->len; ++i)
+    {
+        const gchar *sgr = stack->pdata[i];
+
+        if (*sgr)
+        {
+            g_string_append_c (ansi, ';');
+            g_string_append (ansi, sgr);
+        }
+    }
+
+    g_string_append_c (ansi, 'm');
+}
+
+static const gchar *
+append_entity (GString     *ansi,
+               const gchar *entity)
+{
+    const gchar *end = strchr (entity, ';');
+
+    if (end && end - entity <= 10)
+    {
+        gunichar c = 0;
+
+        if (entity[1] == '#')
+            c = (entity[2] == 'x' || entity[2] == 'X') ? g_ascii_strtoull (entity + 3, NULL, 16) : g_ascii_strtoull (entity + 2, NULL, 10);
+        else if (!strncmp (entity, "&lt;", 4))
+            c = '<';
+        else if (!strncmp (entity, "&gt;", 4))
+            c = '>';
+        else if (!strncmp (entity, "&amp;", 5))
+            c = '&';
+        else if (!strncmp (entity, "&quot;", 6))
+            c = '"';
+        else if (!strncmp (entity, "&apos;", 6))
+            c = '\'';
+
+        if (c && g_unichar_validate (c))
+        {
+            g_string_append_unichar (ansi, c);
+            return end + 1;
+        }
+    }
+
+    g_string_append_c (ansi, '&');
+
+    return entity + 1;
+}
+
+void
+germinal_export_html_to_ansi (const gchar *html,
+                              GString     *ansi)
+{
+    g_return_if_fail (html != NULL);
+    g_return_if_fail (ansi != NULL);
+
+    /* The SGR of every open tag, "" for those without one */
+    g_autoptr (GPtrArray) stack = g_ptr_array_new_with_free_func (g_free);
+    gboolean dirty = FALSE;
+    gboolean styled = FALSE;
+
+    for (const gchar *p = html; *p;)
+    {
+        if (*p == '&')
+        {
+            germinal_export_flush_sgr (ansi, stack, &dirty);
+            p = append_entity (ansi, p);
+            continue;
+        }
+
+        if (*p != '<')
+        {
+            const gchar *text = p;
+
+            while (*p && *p != '<' && *p != '&')
+                ++p;
+
+            germinal_export_flush_sgr (ansi, stack, &dirty);
+            g_string_append_len (ansi, text, p - text);
+            continue;
+        }
+
+        const gchar *end = strchr (p, '>');
+
+        if (!end)
+            break;
+
+        const gchar *tag = p + 1;
+        gsize length = end - tag;
+
+        p = end + 1;
+
+        if (!g_ascii_strncasecmp (tag, "br", 2) && (length == 2 || tag[2] == '/' || tag[2] == ' '))
+        {
+            g_string_append_c (ansi, '\n');
+            continue;
+        }
+
+        /* <pre> only wraps the whole thing */
+        if (!g_ascii_strncasecmp (tag, "pre", 3) || !g_ascii_strncasecmp (tag, "/pre", 4) || (length && tag[length - 1] == '/'))
+            continue;
+
+        if (*tag == '/')
+        {
+            if (stack->len)
+                g_ptr_array_remove_index (stack, stack->len - 1);
+        }
+        else if (!g_ascii_strncasecmp (tag, "font", 4))
+        {
+            g_ptr_array_add (stack, color_sgr (tag, length, "color=\"", "38"));
+        }
+        else if (!g_ascii_strncasecmp (tag, "span", 4))
+        {
+            g_ptr_array_add (stack, color_sgr (tag, length, "background-color:", "48"));
+        }
+        else
+        {
+            const gchar *sgr = sgr_for_tag (tag, length);
+
+            g_ptr_array_add (stack, g_strdup (sgr ? sgr : ""));
+        }
+
+        dirty = TRUE;
+        styled = TRUE;
+    }
+
+    /* Leave the terminal showing the file as it found it */
+    if (styled)
+        g_string_append (ansi, "\033[0m");
+}
+
+/* --- Writing ---------------------------------------------------------- */
+
+static void germinal_export_write_next (GTask *task);
+
+static void
+on_closed (GObject      *source,
+           GAsyncResult *result,
+           gpointer      user_data)
+{
+    g_autoptr (GTask) task = user_data;
+    GError *error = NULL;
+
+    if (!g_output_stream_close_finish (G_OUTPUT_STREAM (source), result, &error))
+        g_task_return_error (task, error);
+    else
+        g_task_return_boolean (task, TRUE);
+}
+
+/* Closing with a cancelled cancellable leaves whatever was there before alone */
+static void
+germinal_export_abandon (GTask  *task,
+                         GError *error)
+{
+    ExportData *export = g_task_get_task_data (task);
+    g_autoptr (GCancellable) cancelled = g_cancellable_new ();
+
+    g_cancellable_cancel (cancelled);
+    if (export->stream)
+        g_output_stream_close (export->stream, cancelled, NULL);
+
+    g_task_return_error (task, error);
+}
+
+static void
+on_chunk_written (GObject      *source,
+                  GAsyncResult *result,
+                  gpointer      user_data)
+{
+    g_autoptr (GTask) task = user_data;
+    ExportData *export = g_task_get_task_data (task);
+    GError *error = NULL;
+
+    g_clear_pointer (&export->buffer, g_free);
+
+    if (!g_output_stream_write_all_finish (G_OUTPUT_STREAM (source), result, NULL, &error))
+    {
+        germinal_export_abandon (task, error);
+        return;
+    }
+
+    if (export->progress)
+        export->progress (MIN (export->next, export->end) - export->first, export->end - export->first, export->progress_data);
+
+    if (export->finishing)
+    {
+        g_output_stream_close_async (export->stream, G_PRIORITY_LOW, g_task_get_cancellable (task), on_closed, g_object_ref (task));
+        return;
+    }
+
+    germinal_export_write_next (task);
+}
+
+static gchar *
+html_header (const GdkRGBA *foreground,
+             const GdkRGBA *background,
+             const gchar   *font_family)
+{
+    g_autofree gchar *forecolor = gdk_rgba_to_string (foreground);
+    g_autofree gchar *backcolor = gdk_rgba_to_string (background);
+
+    return g_strdup_printf ("<!DOCTYPE html>\n"
+                            "<html>\n"
+                            "<head>\n"
+                            "<meta charset=\"utf-8\">\n"
+                            "<style>body { color: %s; background-color: %s; } pre { margin: 0; font-family: \"%s\", monospace; }</style>\n"
+                            "</head>\n"
+                            "<body>\n",
+                            forecolor, backcolor, font_family ? font_family : "monospace");
+}
+
+static void
+germinal_export_write_next (GTask *task)
+{
+    ExportData *export = g_task_get_task_data (task);
+    GtkAdjustment *vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (export->terminal));
+    GError *error = NULL;
+    gsize length = 0;
+
+    if (g_cancellable_set_error_if_cancelled (g_task_get_cancellable (task), &error))
+    {
+        germinal_export_abandon (task, error);
+        return;
+    }
+
+    /* Whatever the scrollback dropped since is gone for us too */
+    export->next = MAX (export->next, (gint64) gtk_adjustment_get_lower (vadjustment));
+
+    if (export->next >= export->end)
+    {
+        export->finishing = TRUE;
+        export->buffer = g_strdup (export->format == GERMINAL_EXPORT_HTML ? "</body>\n</html>\n" : "");
+    }
+    else
+    {
+        gint64 last = MIN (export->end, export->next + EXPORT_CHUNK_ROWS);
+        VteFormat format = export->format == GERMINAL_EXPORT_TEXT ? VTE_FORMAT_TEXT : VTE_FORMAT_HTML;
+        g_autofree gchar *text = vte_terminal_get_text_range_format (export->terminal, format, export->next, 0, last, 0, NULL);
+
+        export->next = last;
+
+        if (export->format == GERMINAL_EXPORT_ANSI && text)
+        {
+            GString *ansi = g_string_sized_new (strlen (text));
+
+            germinal_export_html_to_ansi (text, ansi);
+            export->buffer = g_string_free (ansi, FALSE);
+        }
+        else
+        {
+            export->buffer = text ? g_steal_pointer (&text) : g_strdup ("");
+        }
+    }
+
+    length = strlen (export->buffer);
+    g_output_stream_write_all_async (export->stream, export->buffer, length, G_PRIORITY_LOW,
+                                     g_task_get_cancellable (task), on_chunk_written, g_object_ref (task));
+}
+
+static void
+on_file_replaced (GObject      *source,
+                  GAsyncResult *result,
+                  gpointer      user_data)
+{
+    g_autoptr (GTask) task = user_data;
+    ExportData *export = g_task_get_task_data (task);
+    GError *error = NULL;
+
+    export->stream = G_OUTPUT_STREAM (g_file_replace_finish (G_FILE (source), result, &error));
+
+    if (!export->stream)
+    {
+        g_task_return_error (task, error);
+        return;
+    }
+
+    if (export->format != GERMINAL_EXPORT_HTML)
+    {
+        germinal_export_write_next (task);
+        return;
+    }
+
+    export->buffer = g_steal_pointer (&export->header);
+    g_output_stream_write_all_async (export->stream, export->buffer, strlen (export->buffer), G_PRIORITY_LOW,
+                                     g_task_get_cancellable (task), on_chunk_written, g_object_ref (task));
+}
+
+/*
+ * Writes what the scrollback holds now, output coming meanwhile isn't. The
+ * colors and font family are what the page is styled with in HTML.
+ */
+void
+germinal_export_async (VteTerminal            *terminal,
+                       GFile                  *file,
+                       GerminalExportFormat    format,
+                       const GdkRGBA          *foreground,
+                       const GdkRGBA          *background,
+                       const gchar            *font_family,
+                       GCancellable           *cancellable,
+                       GerminalExportProgress  progress,
+                       gpointer                progress_data,
+                       GAsyncReadyCallback     callback,
+                       gpointer                user_data)
+{
+    g_return_if_fail (VTE_IS_TERMINAL (terminal));
+    g_return_if_fail (G_IS_FILE (file));
+    g_return_if_fail (foreground != NULL);
+    g_return_if_fail (background != NULL);
+
+    GtkAdjustment *vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (terminal));
+    ExportData *export = g_new0 (ExportData, 1);
+    GTask *task = g_task_new (terminal, cancellable, callback, user_data);
+
+    export->terminal = g_object_ref (terminal);
+    export->format = format;
+    export->header = format == GERMINAL_EXPORT_HTML ? html_header (foreground, background, font_family) : NULL;
+    export->first = export->next = gtk_adjustment_get_lower (vadjustment);
+    export->end = gtk_adjustment_get_upper (vadjustment);
+    export->progress = progress;
+    export->progress_data = progress_data;
+
+    g_task_set_name (task, "[germinal] export-scrollback");
+    g_task_set_task_data (task, export, export_data_free);
+
+    g_file_replace_async (file, NULL, FALSE, G_FILE_CREATE_REPLACE_DESTINATION, G_PRIORITY_LOW, cancellable, on_file_replaced, task);
+}
+
+gboolean
+germinal_export_finish (VteTerminal   *terminal,
+                        GAsyncResult  *result,
+                        GError       **error)
+{
+    g_return_val_if_fail (g_task_is_valid (result, terminal), FALSE);
+
+    return g_task_propagate_boolean (G_TASK (result), error);
+}
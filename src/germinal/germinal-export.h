@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <vte/vte.h>
+
+G_BEGIN_DECLS
+
+typedef enum
+{
+    GERMINAL_EXPORT_TEXT,
+    GERMINAL_EXPORT_HTML,
+    GERMINAL_EXPORT_ANSI,
+} GerminalExportFormat;
+
+/* How many of the rows there were when the export started are written */
+typedef void (*GerminalExportProgress) (gint64 rows_done, gint64 n_rows, gpointer user_data);
+
+GerminalExportFormat germinal_export_format_for_file (GFile *file);
+
+void     germinal_export_async  (VteTerminal            *terminal,
+                                 GFile                  *file,
+                                 GerminalExportFormat    format,
+                                 const GdkRGBA          *foreground,
+                                 const GdkRGBA          *background,
+                                 const gchar            *font_family,
+                                 GCancellable           *cancellable,
+                                 GerminalExportProgress  progress,
+                                 gpointer                progress_data,
+                                 GAsyncReadyCallback     callback,
+                                 gpointer                user_data);
+gboolean germinal_export_finish (VteTerminal *terminal, GAsyncResult *result, GError **error);
+
+void     germinal_export_html_to_ansi (const gchar *html, GString *ansi);
+
+G_END_DECLS
@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-font-list.h"
+
+#include <pango/pangocairo.h>
+
+/*
+ * Listing every installed family and checking which are monospace can take
+ * a while with thousands of fonts, so it is done once in a thread, with a
+ * font map of its own, and kept until fontconfig reports a change.
+ */
+static GHashTable *monospace_families;
+static GPtrArray  *waiting;
+static guint       generation;
+static gboolean    loading;
+
+typedef struct
+{
+    GObject                  *owner;
+    GerminalFontListCallback  callback;
+} GerminalFontListWaiter;
+
+static void
+germinal_font_list_waiter_free (gpointer data)
+{
+    GerminalFontListWaiter *waiter = data;
+
+    g_object_unref (waiter->owner);
+    g_free (waiter);
+}
+
+static void
+list_monospace_families (GTask        *task,
+                         gpointer      source_object G_GNUC_UNUSED,
+                         gpointer      task_data     G_GNUC_UNUSED,
+                         GCancellable *cancellable   G_GNUC_UNUSED)
+{
+    g_autoptr (PangoFontMap) font_map = pango_cairo_font_map_new ();
+    GHashTable *families = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    PangoFontFamily **list = NULL;
+    gint n_families = 0;
+
+    pango_font_map_list_families (font_map, &list, &n_families);
+
+    for (gint i = 0; i < n_families; ++i)
+    {
+        if (pango_font_family_is_monospace (list[i]))
+            g_hash_table_add (families, g_strdup (pango_font_family_get_name (list[i])));
+    }
+
+    g_free (list);
+
+    g_task_return_pointer (task, families, (GDestroyNotify) g_hash_table_unref);
+}
+
+static void germinal_font_list_load (void);
+
+static void
+on_families_listed (GObject      *source    G_GNUC_UNUSED,
+                    GAsyncResult *result,
+                    gpointer      user_data)
+{
+    g_autoptr (GHashTable) families = g_task_propagate_pointer (G_TASK (result), NULL);
+
+    loading = FALSE;
+
+    /* Fonts changed while we were listing them */
+    if (GPOINTER_TO_UINT (user_data) != generation)
+    {
+        germinal_font_list_load ();
+        return;
+    }
+
+    g_debug ("Found %u monospace font families", g_hash_table_size (families));
+    monospace_families = g_steal_pointer (&families);
+
+    g_autoptr (GPtrArray) ready = g_steal_pointer (&waiting);
+
+    for (guint i = 0; ready && i < ready->len; ++i)
+    {
+        GerminalFontListWaiter *waiter = ready->pdata[i];
+
+        waiter->callback (monospace_families, waiter->owner);
+    }
+}
+
+static void
+germinal_font_list_load (void)
+{
+    if (loading || !waiting)
+        return;
+
+    g_autoptr (GTask) task = g_task_new (NULL, NULL, on_families_listed, GUINT_TO_POINTER (generation));
+
+    loading = TRUE;
+    g_task_set_name (task, "[germinal] list-monospace-families");
+    g_task_run_in_thread (task, list_monospace_families);
+}
+
+static void
+on_fontconfig_timestamp_changed (GtkSettings *settings  G_GNUC_UNUSED,
+                                 GParamSpec  *pspec     G_GNUC_UNUSED,
+                                 gpointer     user_data G_GNUC_UNUSED)
+{
+    germinal_font_list_invalidate ();
+}
+
+void
+germinal_font_list_invalidate (void)
+{
+    ++generation;
+    g_clear_pointer (&monospace_families, g_hash_table_unref);
+}
+
+void
+germinal_font_list_get_monospace (GObject                  *owner,
+                                  GerminalFontListCallback  callback)
+{
+    g_return_if_fail (G_IS_OBJECT (owner));
+    g_return_if_fail (callback != NULL);
+
+    static gboolean watching;
+    GtkSettings *settings = gtk_settings_get_default ();
+
+    if (!watching && settings)
+    {
+        g_signal_connect (settings, "notify::gtk-fontconfig-timestamp", G_CALLBACK (on_fontconfig_timestamp_changed), NULL);
+        watching = TRUE;
+    }
+
+    if (monospace_families)
+    {
+        callback (monospace_families, owner);
+        return;
+    }
+
+    GerminalFontListWaiter *waiter = g_new (GerminalFontListWaiter, 1);
+
+    waiter->owner = g_object_ref (owner);
+    waiter->callback = callback;
+
+    if (!waiting)
+        waiting = g_ptr_array_new_with_free_func (germinal_font_list_waiter_free);
+    g_ptr_array_add (waiting, waiter);
+
+    germinal_font_list_load ();
+}
+
+static gboolean
+is_listed_family (gpointer item,
+                  gpointer user_data)
+{
+    GHashTable *families = user_data;
+    PangoFontFamily *family = PANGO_IS_FONT_FACE (item) ? pango_font_face_get_family (item) : item;
+
+    return g_hash_table_contains (families, pango_font_family_get_name (family));
+}
+
+GtkFilter *
+germinal_font_list_filter_new (GHashTable *families)
+{
+    g_return_val_if_fail (families != NULL, NULL);
+
+    return GTK_FILTER (gtk_custom_filter_new (is_listed_family, g_hash_table_ref (families), (GDestroyNotify) g_hash_table_unref));
+}
@@ -0,0 +1,18 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+/* families is a set of family names, owned by the cache */
+typedef void (*GerminalFontListCallback) (GHashTable *families,
+                                          gpointer    user_data);
+
+void       germinal_font_list_get_monospace  (GObject *owner, GerminalFontListCallback callback);
+void       germinal_font_list_invalidate     (void);
+GtkFilter *germinal_font_list_filter_new     (GHashTable *families);
+
+G_END_DECLS
@@ -0,0 +1,222 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-font-warmup.h"
+
+/*
+ * Resolves the terminal font and its fallbacks, and renders the glyphs the
+ * first frames are the most likely to need, ahead of time.
+ *
+ * This goes through the same font map as the terminals (GTK's default one),
+ * whose fonts are shared by the whole process, and the glyphs are drawn by
+ * the renderer of the widget's window, which is where their atlas lives:
+ * each font at each size only gets warmed up once, whatever the number of
+ * windows. Until the widget has a renderer, the font can only be resolved
+ * and shaped, it is warmed up again once the widget gets realized.
+ *
+ * Work is split in small steps run at low priority, so that it never delays
+ * a frame.
+ */
+
+typedef enum
+{
+    WARMUP_FONTSET,
+    WARMUP_FALLBACKS,
+    WARMUP_ASCII,
+    WARMUP_BOX_DRAWING,
+
+    WARMUP_DONE
+} WarmupStep;
+
+typedef struct
+{
+    GtkWidget            *widget;
+    PangoContext         *context;
+    PangoFontDescription *font;
+    WarmupStep            step;
+    gint64                start;
+    gboolean              shaped_only;
+} Warmup;
+
+static GQueue      pending = G_QUEUE_INIT;
+static GHashTable *warmed;
+static guint       warmup_source_id;
+
+static void
+warmup_free (Warmup *warmup)
+{
+    g_clear_weak_pointer (&warmup->widget);
+    g_object_unref (warmup->context);
+    pango_font_description_free (warmup->font);
+    g_free (warmup);
+}
+
+/* FALSE if the glyphs couldn't be drawn, only shaped */
+static gboolean
+warmup_render (Warmup      *warmup,
+               const gchar *text)
+{
+    g_autoptr (PangoLayout) layout = pango_layout_new (warmup->context);
+    GtkNative *native = warmup->widget ? gtk_widget_get_native (warmup->widget) : NULL;
+    GskRenderer *renderer = native ? gtk_native_get_renderer (native) : NULL;
+
+    pango_layout_set_font_description (layout, warmup->font);
+    pango_layout_set_text (layout, text, -1);
+
+    /* Not shown yet, or gone: shaping is all we can do */
+    if (!renderer || !gsk_renderer_is_realized (renderer))
+    {
+        pango_layout_get_extents (layout, NULL, NULL);
+        return FALSE;
+    }
+
+    /* At the scale the terminal draws at, glyphs are cached per scale */
+    GtkSnapshot *snapshot = gtk_snapshot_new ();
+    gint scale = gtk_widget_get_scale_factor (warmup->widget);
+    GdkRGBA color = { 0, 0, 0, 1 };
+
+    gtk_snapshot_scale (snapshot, scale, scale);
+    gtk_snapshot_append_layout (snapshot, layout, &color);
+
+    g_autoptr (GskRenderNode) node = gtk_snapshot_free_to_node (snapshot);
+
+    if (!node)
+        return TRUE;
+
+    /* Glyphs outside of the viewport would be culled before reaching the atlas */
+    graphene_rect_t viewport;
+    gsk_render_node_get_bounds (node, &viewport);
+
+    g_autoptr (GdkTexture) texture = gsk_renderer_render_texture (renderer, node, &viewport);
+
+    return TRUE;
+}
+
+static gchar *
+warmup_range (gunichar first,
+              gunichar last)
+{
+    GString *text = g_string_sized_new ((last - first + 1) * 3);
+
+    for (gunichar c = first; c <= last; ++c)
+        g_string_append_unichar (text, c);
+
+    return g_string_free (text, FALSE);
+}
+
+static void
+on_realize (GtkWidget *widget,
+            gpointer   user_data)
+{
+    germinal_font_warmup (widget, user_data);
+    g_signal_handlers_disconnect_by_func (widget, on_realize, user_data);
+}
+
+static gboolean
+warmup_step (gpointer user_data G_GNUC_UNUSED)
+{
+    Warmup *warmup = g_queue_peek_head (&pending);
+
+    switch (warmup->step)
+    {
+    case WARMUP_FONTSET:
+    {
+        PangoFontset *fontset = pango_context_load_fontset (warmup->context, warmup->font, pango_language_get_default ());
+
+        g_clear_object (&fontset);
+        break;
+    }
+    case WARMUP_FALLBACKS:
+    {
+        /* Only resolved, these are too many glyphs to render upfront */
+        g_autoptr (PangoLayout) layout = pango_layout_new (warmup->context);
+
+        pango_layout_set_font_description (layout, warmup->font);
+        pango_layout_set_text (layout, "é€…✓一あ한😀", -1);
+        pango_layout_get_extents (layout, NULL, NULL);
+        break;
+    }
+    case WARMUP_ASCII:
+    {
+        g_autofree gchar *text = warmup_range (0x20, 0x7e);
+        warmup->shaped_only |= !warmup_render (warmup, text);
+        break;
+    }
+    case WARMUP_BOX_DRAWING:
+    {
+        /* What tmux draws its borders with */
+        g_autofree gchar *text = warmup_range (0x2500, 0x257f);
+        warmup->shaped_only |= !warmup_render (warmup, text);
+        break;
+    }
+    case WARMUP_DONE:
+        break;
+    }
+
+    if (++warmup->step < WARMUP_DONE)
+        return G_SOURCE_CONTINUE;
+
+    g_autofree gchar *name = pango_font_description_to_string (warmup->font);
+
+    g_queue_pop_head (&pending);
+
+    if (warmup->shaped_only)
+    {
+        /* Nothing reached the glyph atlas, that is for when there is one */
+        g_debug ("Shaped %s in %.2f ms", name, (g_get_monotonic_time () - warmup->start) / 1000.0);
+        g_hash_table_remove (warmed, name);
+        if (warmup->widget && gtk_widget_get_realized (warmup->widget))
+            germinal_font_warmup (warmup->widget, warmup->font);
+        else if (warmup->widget)
+            g_signal_connect_data (warmup->widget, "realize", G_CALLBACK (on_realize),
+                                   pango_font_description_copy (warmup->font), (GClosureNotify) pango_font_description_free, 0);
+    }
+    else
+        g_debug ("Warmed up %s in %.2f ms", name, (g_get_monotonic_time () - warmup->start) / 1000.0);
+
+    warmup_free (warmup);
+
+    if (!g_queue_is_empty (&pending))
+        return G_SOURCE_CONTINUE;
+
+    warmup_source_id = 0;
+    return G_SOURCE_REMOVE;
+}
+
+/* Fonts still waiting to be warmed up */
+guint
+germinal_font_warmup_get_n_pending (void)
+{
+    return g_queue_get_length (&pending);
+}
+
+void
+germinal_font_warmup (GtkWidget                  *widget,
+                      const PangoFontDescription *font)
+{
+    g_return_if_fail (GTK_IS_WIDGET (widget));
+    g_return_if_fail (font != NULL);
+
+    gchar *name = pango_font_description_to_string (font);
+
+    if (!warmed)
+        warmed = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+    if (!g_hash_table_add (warmed, name))
+        return;
+
+    Warmup *warmup = g_new0 (Warmup, 1);
+
+    /* Same font map, resolution and font options as the widget */
+    g_set_weak_pointer (&warmup->widget, widget);
+    warmup->context = gtk_widget_create_pango_context (widget);
+    warmup->font = pango_font_description_copy (font);
+    warmup->start = g_get_monotonic_time ();
+    g_queue_push_tail (&pending, warmup);
+
+    if (!warmup_source_id)
+    {
+        warmup_source_id = g_idle_add_full (G_PRIORITY_LOW, warmup_step, NULL, NULL);
+        g_source_set_name_by_id (warmup_source_id, "[germinal] font-warmup");
+    }
+}
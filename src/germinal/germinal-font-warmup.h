@@ -0,0 +1,13 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+void  germinal_font_warmup               (GtkWidget *widget, const PangoFontDescription *font);
+guint germinal_font_warmup_get_n_pending (void);
+
+G_END_DECLS
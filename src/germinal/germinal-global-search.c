@@ -0,0 +1,204 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-global-search.h"
+#include "germinal-scrollback-index.h"
+#include "germinal-window.h"
+
+#include <glib/gi18n-lib.h>
+
+/* More than that won't be read anyway */
+#define MAX_HITS 200
+
+#define ENTRY_KEY    "germinal-global-search-entry"
+#define LIST_KEY     "germinal-global-search-list"
+#define STATUS_KEY   "germinal-global-search-status"
+#define HIT_KEY      "germinal-global-search-hit"
+
+/* The one being shown, if any */
+static AdwDialog *shown_dialog;
+
+typedef struct
+{
+    guint  document;
+    gint64 row;
+} HitLocation;
+
+static void
+update_status (AdwDialog *dialog,
+               guint      n_hits,
+               gdouble    elapsed_ms)
+{
+    GerminalScrollbackIndex *index = germinal_scrollback_index_get_default ();
+    GtkLabel *status = g_object_get_data (G_OBJECT (dialog), STATUS_KEY);
+    g_autofree gchar *size = g_format_size (germinal_scrollback_index_get_size (index));
+    guint n_rows = germinal_scrollback_index_get_n_rows (index);
+    g_autofree gchar *indexed = g_strdup_printf (g_dngettext (GETTEXT_PACKAGE, "%u row indexed, %s", "%u rows indexed, %s", n_rows), n_rows, size);
+    g_autofree gchar *label = NULL;
+
+    if (elapsed_ms < 0)
+        label = g_steal_pointer (&indexed);
+    else
+        /* Translators: the last %s is how many rows were indexed */
+        label = g_strdup_printf (g_dngettext (GETTEXT_PACKAGE, "%u match in %.1f ms — %s", "%u matches in %.1f ms — %s", n_hits), n_hits, elapsed_ms, indexed);
+
+    gtk_label_set_label (status, label);
+}
+
+static void
+on_search_changed (GtkSearchEntry *entry,
+                   gpointer        user_data)
+{
+    AdwDialog *dialog = ADW_DIALOG (user_data);
+    GerminalScrollbackIndex *index = germinal_scrollback_index_get_default ();
+    GtkListBox *list = g_object_get_data (G_OBJECT (dialog), LIST_KEY);
+    const gchar *text = gtk_editable_get_text (GTK_EDITABLE (entry));
+    GtkWidget *child;
+
+    while ((child = gtk_widget_get_first_child (GTK_WIDGET (list))))
+        gtk_list_box_remove (list, child);
+
+    if (!*text)
+    {
+        update_status (dialog, 0, -1);
+        return;
+    }
+
+    gint64 start = g_get_monotonic_time ();
+    g_autoptr (GArray) hits = germinal_scrollback_index_search (index, text, MAX_HITS);
+    gdouble elapsed_ms = (g_get_monotonic_time () - start) / 1000.0;
+
+    guint n_hits = 0;
+
+    g_debug ("Found %u rows with \"%s\" in %.2f ms", hits->len, text, elapsed_ms);
+
+    for (guint i = 0; i < hits->len; ++i)
+    {
+        GerminalIndexHit *hit = &g_array_index (hits, GerminalIndexHit, i);
+        GtkWidget *terminal = germinal_scrollback_index_get_owner (index, hit->document);
+        GtkRoot *window = terminal ? gtk_widget_get_root (terminal) : NULL;
+
+        /* Spare windows aren't part of the application until they are presented */
+        if (!GERMINAL_IS_WINDOW (window) || !gtk_window_get_application (GTK_WINDOW (window)))
+            continue;
+
+        ++n_hits;
+
+        GtkWidget *row = adw_action_row_new ();
+        HitLocation *location = g_new (HitLocation, 1);
+
+        location->document = hit->document;
+        location->row = hit->row;
+        g_object_set_data_full (G_OBJECT (row), HIT_KEY, location, g_free);
+
+        adw_preferences_row_set_use_markup (ADW_PREFERENCES_ROW (row), FALSE);
+        adw_preferences_row_set_title (ADW_PREFERENCES_ROW (row), g_strstrip (hit->text));
+        adw_action_row_set_subtitle (ADW_ACTION_ROW (row), gtk_window_get_title (GTK_WINDOW (window)));
+        adw_action_row_set_title_lines (ADW_ACTION_ROW (row), 1);
+        gtk_list_box_row_set_activatable (GTK_LIST_BOX_ROW (row), TRUE);
+        gtk_list_box_append (list, row);
+    }
+
+    update_status (dialog, n_hits, elapsed_ms);
+}
+
+static void
+on_row_activated (GtkListBox    *list G_GNUC_UNUSED,
+                  GtkListBoxRow *row,
+                  gpointer       user_data)
+{
+    HitLocation *location = g_object_get_data (G_OBJECT (row), HIT_KEY);
+    GtkWidget *terminal = germinal_scrollback_index_get_owner (germinal_scrollback_index_get_default (), location->document);
+
+    /* Closed since */
+    if (!terminal || !GERMINAL_IS_WINDOW (gtk_widget_get_root (terminal)))
+        return;
+
+    germinal_window_reveal_terminal (GERMINAL_WINDOW (gtk_widget_get_root (terminal)), GERMINAL_TERMINAL (terminal));
+    germinal_terminal_scroll_to_row (GERMINAL_TERMINAL (terminal), location->row);
+    adw_dialog_close (ADW_DIALOG (user_data));
+}
+
+AdwDialog *
+germinal_global_search_new (void)
+{
+    AdwDialog *dialog = adw_dialog_new ();
+    adw_dialog_set_title (dialog, _("Search All Terminals"));
+    adw_dialog_set_content_width (dialog, 720);
+    adw_dialog_set_content_height (dialog, 480);
+
+    GtkWidget *entry = gtk_search_entry_new ();
+    gtk_widget_set_hexpand (entry, TRUE);
+    gtk_search_entry_set_placeholder_text (GTK_SEARCH_ENTRY (entry), _("Search the scrollback of every terminal"));
+    g_signal_connect_object (entry, "search-changed", G_CALLBACK (on_search_changed), dialog, 0);
+
+    GtkWidget *header_bar = adw_header_bar_new ();
+    adw_header_bar_set_title_widget (ADW_HEADER_BAR (header_bar), entry);
+
+    GtkWidget *list = gtk_list_box_new ();
+    gtk_list_box_set_selection_mode (GTK_LIST_BOX (list), GTK_SELECTION_NONE);
+    gtk_widget_add_css_class (list, "navigation-sidebar");
+    g_signal_connect_object (list, "row-activated", G_CALLBACK (on_row_activated), dialog, 0);
+
+    GtkWidget *scrolled = gtk_scrolled_window_new ();
+    gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scrolled), GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+    gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (scrolled), list);
+    gtk_widget_set_vexpand (scrolled, TRUE);
+
+    GtkWidget *status = gtk_label_new (NULL);
+    gtk_label_set_xalign (GTK_LABEL (status), 0);
+    gtk_widget_add_css_class (status, "dim-label");
+    gtk_widget_add_css_class (status, "numeric");
+    gtk_widget_set_margin_start (status, 12);
+    gtk_widget_set_margin_end (status, 12);
+    gtk_widget_set_margin_top (status, 6);
+    gtk_widget_set_margin_bottom (status, 6);
+
+    GtkWidget *toolbar_view = adw_toolbar_view_new ();
+    adw_toolbar_view_add_top_bar (ADW_TOOLBAR_VIEW (toolbar_view), header_bar);
+    adw_toolbar_view_set_content (ADW_TOOLBAR_VIEW (toolbar_view), scrolled);
+    adw_toolbar_view_add_bottom_bar (ADW_TOOLBAR_VIEW (toolbar_view), status);
+    adw_dialog_set_child (dialog, toolbar_view);
+    adw_dialog_set_focus (dialog, entry);
+
+    g_object_set_data (G_OBJECT (dialog), ENTRY_KEY, entry);
+    g_object_set_data (G_OBJECT (dialog), LIST_KEY, list);
+    g_object_set_data (G_OBJECT (dialog), STATUS_KEY, status);
+    update_status (dialog, 0, -1);
+
+    return dialog;
+}
+
+static void
+on_dialog_closed (AdwDialog *dialog,
+                  gpointer   user_data G_GNUC_UNUSED)
+{
+    if (shown_dialog == dialog)
+        shown_dialog = NULL;
+}
+
+void
+germinal_global_search_present (GtkWidget *parent)
+{
+    /* Terminals only index their scrollback once it got searched for the first time */
+    germinal_scrollback_index_start (germinal_scrollback_index_get_default ());
+
+    if (shown_dialog)
+    {
+        GtkWidget *entry = g_object_get_data (G_OBJECT (shown_dialog), ENTRY_KEY);
+
+        /* What it found is stale by now */
+        if (gtk_widget_get_root (GTK_WIDGET (shown_dialog)) == gtk_widget_get_root (parent))
+        {
+            on_search_changed (GTK_SEARCH_ENTRY (entry), shown_dialog);
+            gtk_widget_grab_focus (entry);
+            return;
+        }
+
+        adw_dialog_force_close (shown_dialog);
+    }
+
+    shown_dialog = germinal_global_search_new ();
+    g_signal_connect (shown_dialog, "closed", G_CALLBACK (on_dialog_closed), NULL);
+    adw_dialog_present (shown_dialog, parent);
+}
@@ -0,0 +1,13 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <adwaita.h>
+
+G_BEGIN_DECLS
+
+AdwDialog *germinal_global_search_new     (void);
+void       germinal_global_search_present (GtkWidget *parent);
+
+G_END_DECLS
@@ -0,0 +1,333 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-match-counter.h"
+
+#define PCRE2_CODE_UNIT_WIDTH 8
+#include <pcre2.h>
+
+#include <string.h>
+
+/*
+ * Counts and locates every match of the search in rows of text copied from
+ * the scrollback, in a thread. Rows are given from some point on, whatever
+ * was known from there is replaced, so new output only costs a scan of the
+ * rows that changed.
+ */
+
+struct _GerminalMatchCounter
+{
+    GObject parent_instance;
+};
+
+enum
+{
+    SIGNAL_CHANGED,
+
+    N_SIGNALS
+};
+
+static guint signals[N_SIGNALS];
+
+/* Shared with the scans still running when the pattern changes */
+typedef struct
+{
+    pcre2_code *code;
+} GerminalPattern;
+
+typedef struct
+{
+    GerminalPattern *pattern;
+    guint            generation;
+    gboolean         scanning;
+    GArray          *rows;
+    guint            n_matches;
+} GerminalMatchCounterPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GerminalMatchCounter, germinal_match_counter, G_TYPE_OBJECT)
+
+static void
+germinal_pattern_clear (gpointer data)
+{
+    GerminalPattern *pattern = data;
+
+    pcre2_code_free (pattern->code);
+}
+
+static void
+germinal_pattern_release (GerminalPattern *pattern)
+{
+    g_atomic_rc_box_release_full (pattern, germinal_pattern_clear);
+}
+
+typedef struct
+{
+    GerminalPattern *pattern;
+    guint            generation;
+    gint64           first_row;
+    GPtrArray       *rows;
+} ScanData;
+
+static void
+scan_data_free (gpointer data)
+{
+    ScanData *scan = data;
+
+    germinal_pattern_release (scan->pattern);
+    g_ptr_array_unref (scan->rows);
+    g_free (scan);
+}
+
+static void
+scan_rows (GTask        *task,
+           gpointer      source_object G_GNUC_UNUSED,
+           gpointer      task_data,
+           GCancellable *cancellable   G_GNUC_UNUSED)
+{
+    ScanData *scan = task_data;
+    pcre2_match_data *match_data = pcre2_match_data_create_from_pattern (scan->pattern->code, NULL);
+    GArray *matches = g_array_new (FALSE, FALSE, sizeof (GerminalMatchRow));
+
+    for (guint i = 0; i < scan->rows->len; ++i)
+    {
+        const gchar *text = scan->rows->pdata[i];
+        PCRE2_SIZE length = strlen (text);
+        PCRE2_SIZE offset = 0;
+        guint count = 0;
+
+        while (offset < length && pcre2_match (scan->pattern->code, (PCRE2_SPTR) text, length, offset, PCRE2_NOTEMPTY, match_data, NULL) >= 0)
+        {
+            offset = pcre2_get_ovector_pointer (match_data)[1];
+            ++count;
+        }
+
+        if (count)
+        {
+            GerminalMatchRow row = { scan->first_row + i, count };
+
+            g_array_append_val (matches, row);
+        }
+    }
+
+    pcre2_match_data_free (match_data);
+
+    g_task_return_pointer (task, matches, (GDestroyNotify) g_array_unref);
+}
+
+static void
+on_rows_scanned (GObject      *source,
+                 GAsyncResult *result,
+                 gpointer      user_data G_GNUC_UNUSED)
+{
+    GerminalMatchCounter *self = GERMINAL_MATCH_COUNTER (source);
+    GerminalMatchCounterPrivate *priv = germinal_match_counter_get_instance_private (self);
+    ScanData *scan = g_task_get_task_data (G_TASK (result));
+    g_autoptr (GArray) matches = g_task_propagate_pointer (G_TASK (result), NULL);
+
+    /* The pattern changed since */
+    if (scan->generation != priv->generation)
+        return;
+
+    priv->scanning = FALSE;
+
+    guint kept = priv->rows->len;
+
+    while (kept && g_array_index (priv->rows, GerminalMatchRow, kept - 1).row >= scan->first_row)
+        priv->n_matches -= g_array_index (priv->rows, GerminalMatchRow, --kept).matches;
+    g_array_set_size (priv->rows, kept);
+
+    for (guint i = 0; i < matches->len; ++i)
+        priv->n_matches += g_array_index (matches, GerminalMatchRow, i).matches;
+    g_array_append_vals (priv->rows, matches->data, matches->len);
+
+    g_signal_emit (self, signals[SIGNAL_CHANGED], 0);
+}
+
+/* rows are the text of each row from first_row on, the counter takes them */
+void
+germinal_match_counter_scan (GerminalMatchCounter *self,
+                             gint64                first_row,
+                             GPtrArray            *rows)
+{
+    g_return_if_fail (GERMINAL_IS_MATCH_COUNTER (self));
+    g_return_if_fail (rows != NULL);
+
+    GerminalMatchCounterPrivate *priv = germinal_match_counter_get_instance_private (self);
+
+    if (!priv->pattern)
+    {
+        g_ptr_array_unref (rows);
+        return;
+    }
+
+    /* Results are applied as they come, they have to come in order */
+    if (priv->scanning)
+    {
+        g_ptr_array_unref (rows);
+        g_return_if_reached ();
+    }
+
+    ScanData *scan = g_new (ScanData, 1);
+
+    scan->pattern = g_atomic_rc_box_acquire (priv->pattern);
+    scan->generation = priv->generation;
+    scan->first_row = first_row;
+    scan->rows = rows;
+
+    g_autoptr (GTask) task = g_task_new (self, NULL, on_rows_scanned, NULL);
+
+    priv->scanning = TRUE;
+    g_task_set_name (task, "[germinal] count-matches");
+    g_task_set_task_data (task, scan, scan_data_free);
+    g_task_run_in_thread (task, scan_rows);
+}
+
+/* The scrollback forgot about rows before first_row */
+void
+germinal_match_counter_trim (GerminalMatchCounter *self,
+                             gint64                first_row)
+{
+    g_return_if_fail (GERMINAL_IS_MATCH_COUNTER (self));
+
+    GerminalMatchCounterPrivate *priv = germinal_match_counter_get_instance_private (self);
+    guint dropped = 0;
+
+    while (dropped < priv->rows->len && g_array_index (priv->rows, GerminalMatchRow, dropped).row < first_row)
+        priv->n_matches -= g_array_index (priv->rows, GerminalMatchRow, dropped++).matches;
+
+    if (!dropped)
+        return;
+
+    g_array_remove_range (priv->rows, 0, dropped);
+    g_signal_emit (self, signals[SIGNAL_CHANGED], 0);
+}
+
+/* Forgets about every match, a NULL pattern stops counting */
+gboolean
+germinal_match_counter_set_pattern (GerminalMatchCounter  *self,
+                                    const gchar           *pattern,
+                                    gboolean               regex,
+                                    GError               **error)
+{
+    g_return_val_if_fail (GERMINAL_IS_MATCH_COUNTER (self), FALSE);
+
+    GerminalMatchCounterPrivate *priv = germinal_match_counter_get_instance_private (self);
+
+    ++priv->generation;
+    priv->scanning = FALSE;
+    priv->n_matches = 0;
+    g_array_set_size (priv->rows, 0);
+    g_clear_pointer (&priv->pattern, germinal_pattern_release);
+
+    if (pattern)
+    {
+        gint errcode;
+        PCRE2_SIZE erroffset;
+        /* Unlike vte, nothing forces PCRE2_MULTILINE on us here */
+        pcre2_code *code = pcre2_compile ((PCRE2_SPTR) pattern, PCRE2_ZERO_TERMINATED,
+                                          PCRE2_UTF | PCRE2_CASELESS | (regex ? PCRE2_MULTILINE : PCRE2_LITERAL),
+                                          &errcode, &erroffset, NULL);
+
+        if (!code)
+        {
+            PCRE2_UCHAR message[256];
+
+            pcre2_get_error_message (errcode, message, sizeof (message));
+            g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "%s at offset %" G_GSIZE_FORMAT, message, (gsize) erroffset);
+            g_signal_emit (self, signals[SIGNAL_CHANGED], 0);
+            return FALSE;
+        }
+
+        pcre2_jit_compile (code, PCRE2_JIT_COMPLETE);
+        priv->pattern = g_atomic_rc_box_new0 (GerminalPattern);
+        priv->pattern->code = code;
+    }
+
+    g_signal_emit (self, signals[SIGNAL_CHANGED], 0);
+
+    return TRUE;
+}
+
+gboolean
+germinal_match_counter_is_scanning (GerminalMatchCounter *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_MATCH_COUNTER (self), FALSE);
+
+    GerminalMatchCounterPrivate *priv = germinal_match_counter_get_instance_private (self);
+
+    return priv->scanning;
+}
+
+guint
+germinal_match_counter_get_n_matches (GerminalMatchCounter *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_MATCH_COUNTER (self), 0);
+
+    GerminalMatchCounterPrivate *priv = germinal_match_counter_get_instance_private (self);
+
+    return priv->n_matches;
+}
+
+/* GerminalMatchRow, ordered by row */
+const GArray *
+germinal_match_counter_get_rows (GerminalMatchCounter *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_MATCH_COUNTER (self), NULL);
+
+    GerminalMatchCounterPrivate *priv = germinal_match_counter_get_instance_private (self);
+
+    return priv->rows;
+}
+
+guint
+germinal_match_counter_count_before (GerminalMatchCounter *self,
+                                     gint64                row)
+{
+    g_return_val_if_fail (GERMINAL_IS_MATCH_COUNTER (self), 0);
+
+    GerminalMatchCounterPrivate *priv = germinal_match_counter_get_instance_private (self);
+    guint count = 0;
+
+    for (guint i = 0; i < priv->rows->len && g_array_index (priv->rows, GerminalMatchRow, i).row < row; ++i)
+        count += g_array_index (priv->rows, GerminalMatchRow, i).matches;
+
+    return count;
+}
+
+static void
+germinal_match_counter_finalize (GObject *object)
+{
+    GerminalMatchCounterPrivate *priv = germinal_match_counter_get_instance_private (GERMINAL_MATCH_COUNTER (object));
+
+    g_clear_pointer (&priv->pattern, germinal_pattern_release);
+    g_clear_pointer (&priv->rows, g_array_unref);
+
+    G_OBJECT_CLASS (germinal_match_counter_parent_class)->finalize (object);
+}
+
+static void
+germinal_match_counter_init (GerminalMatchCounter *self)
+{
+    GerminalMatchCounterPrivate *priv = germinal_match_counter_get_instance_private (self);
+
+    priv->rows = g_array_new (FALSE, FALSE, sizeof (GerminalMatchRow));
+}
+
+static void
+germinal_match_counter_class_init (GerminalMatchCounterClass *klass)
+{
+    G_OBJECT_CLASS (klass)->finalize = germinal_match_counter_finalize;
+
+    /* The matches or their count changed */
+    signals[SIGNAL_CHANGED] = g_signal_new ("changed",
+                                            G_TYPE_FROM_CLASS (klass),
+                                            G_SIGNAL_RUN_LAST,
+                                            0, NULL, NULL, NULL,
+                                            G_TYPE_NONE, 0);
+}
+
+GerminalMatchCounter *
+germinal_match_counter_new (void)
+{
+    return g_object_new (GERMINAL_TYPE_MATCH_COUNTER, NULL);
+}
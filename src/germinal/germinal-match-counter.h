@@ -0,0 +1,29 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define GERMINAL_TYPE_MATCH_COUNTER germinal_match_counter_get_type ()
+G_DECLARE_FINAL_TYPE (GerminalMatchCounter, germinal_match_counter, GERMINAL, MATCH_COUNTER, GObject)
+
+/* A row of the scrollback and how many times the pattern matched in it */
+typedef struct
+{
+    gint64 row;
+    guint  matches;
+} GerminalMatchRow;
+
+GerminalMatchCounter *germinal_match_counter_new           (void);
+gboolean              germinal_match_counter_set_pattern   (GerminalMatchCounter *self, const gchar *pattern, gboolean regex, GError **error);
+void                  germinal_match_counter_scan          (GerminalMatchCounter *self, gint64 first_row, GPtrArray *rows);
+void                  germinal_match_counter_trim          (GerminalMatchCounter *self, gint64 first_row);
+gboolean              germinal_match_counter_is_scanning   (GerminalMatchCounter *self);
+guint                 germinal_match_counter_get_n_matches (GerminalMatchCounter *self);
+const GArray         *germinal_match_counter_get_rows      (GerminalMatchCounter *self);
+guint                 germinal_match_counter_count_before  (GerminalMatchCounter *self, gint64 row);
+
+G_END_DECLS
@@ -0,0 +1,241 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-paste.h"
+
+#include <glib-unix.h>
+
+/*
+ * A big paste is handed over a chunk at a time, the next one only once the
+ * pty can take more: whoever reads on the other side sets the pace, instead
+ * of megabytes piling up in front of it while the window waits.
+ */
+
+typedef struct
+{
+    gint                   fd;
+    GBytes                *text;
+    gsize                  offset;
+    GerminalPasteWrite     write;
+    gpointer               write_data;
+    GerminalPasteProgress  progress;
+    gpointer               progress_data;
+    gint64                 start;
+    gint64                 elapsed;
+    GSource               *writable;
+    GSource               *cancelled;
+} PasteData;
+
+static void
+paste_data_clear_sources (PasteData *paste)
+{
+    if (paste->writable)
+        g_source_destroy (paste->writable);
+    if (paste->cancelled)
+        g_source_destroy (paste->cancelled);
+    g_clear_pointer (&paste->writable, g_source_unref);
+    g_clear_pointer (&paste->cancelled, g_source_unref);
+}
+
+static void
+paste_data_free (gpointer data)
+{
+    PasteData *paste = data;
+
+    paste_data_clear_sources (paste);
+    g_bytes_unref (paste->text);
+    g_free (paste);
+}
+
+/*
+ * Where the chunk from offset ends: after its last newline if it has one,
+ * so that each line gets there whole, or else on a character boundary.
+ */
+gsize
+germinal_paste_chunk_end (const gchar *text,
+                          gsize        length,
+                          gsize        offset,
+                          gsize        max_size)
+{
+    g_return_val_if_fail (offset <= length, length);
+    g_return_val_if_fail (max_size > 0, length);
+
+    if (length - offset <= max_size)
+        return length;
+
+    gsize end = offset + max_size;
+
+    for (gsize i = end; i > offset; --i)
+    {
+        if (text[i - 1] == '\n')
+            return i;
+    }
+
+    while (end > offset && (text[end] & 0xc0) == 0x80)
+        --end;
+
+    /* Don't split a \r\n either */
+    if (end > offset + 1 && text[end - 1] == '\r' && text[end] == '\n')
+        --end;
+
+    return end > offset ? end : offset + max_size;
+}
+
+/*
+ * What vte sends the application for pasted text: line ends as carriage
+ * returns, and no control character that could end a bracketed paste early
+ * or act on the application instead of being pasted.
+ */
+gchar *
+germinal_paste_sanitize (const gchar *text,
+                         gsize        length,
+                         gsize       *sanitized_length)
+{
+    g_return_val_if_fail (text != NULL || length == 0, NULL);
+    g_return_val_if_fail (sanitized_length != NULL, NULL);
+
+    GString *sanitized = g_string_sized_new (length);
+
+    for (gsize i = 0; i < length; ++i)
+    {
+        guchar c = text[i];
+
+        if (c == '\n')
+        {
+            if (i == 0 || text[i - 1] != '\r')
+                g_string_append_c (sanitized, '\r');
+        }
+        /* C1 controls, U+0080 to U+009F */
+        else if (c == 0xc2 && i + 1 < length && (guchar) text[i + 1] >= 0x80 && (guchar) text[i + 1] <= 0x9f)
+            ++i;
+        else if (c == '\r' || c == '\t' || (c >= 0x20 && c != 0x7f))
+            g_string_append_c (sanitized, c);
+    }
+
+    *sanitized_length = sanitized->len;
+
+    return g_string_free (sanitized, FALSE);
+}
+
+static void germinal_paste_feed (GTask *task);
+
+static gboolean
+on_writable (gint         fd G_GNUC_UNUSED,
+             GIOCondition condition,
+             gpointer     user_data)
+{
+    GTask *task = G_TASK (user_data);
+    PasteData *paste = g_task_get_task_data (task);
+
+    if (condition & (G_IO_HUP | G_IO_ERR))
+    {
+        paste_data_clear_sources (paste);
+        g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_BROKEN_PIPE, "Nothing reads from the terminal anymore");
+        return G_SOURCE_REMOVE;
+    }
+
+    germinal_paste_feed (task);
+
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+on_cancelled (GCancellable *cancellable G_GNUC_UNUSED,
+              gpointer      user_data)
+{
+    germinal_paste_feed (G_TASK (user_data));
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+germinal_paste_feed (GTask *task)
+{
+    PasteData *paste = g_task_get_task_data (task);
+    gsize length = 0;
+    const gchar *text = g_bytes_get_data (paste->text, &length);
+
+    paste_data_clear_sources (paste);
+
+    if (g_task_return_error_if_cancelled (task))
+        return;
+
+    /* The last chunk got through too */
+    if (paste->offset >= length)
+    {
+        paste->elapsed = g_get_monotonic_time () - paste->start;
+        g_task_return_boolean (task, TRUE);
+        return;
+    }
+
+    gsize end = germinal_paste_chunk_end (text, length, paste->offset, GERMINAL_PASTE_CHUNK_SIZE);
+
+    paste->write (text + paste->offset, end - paste->offset, paste->write_data);
+    paste->offset = end;
+
+    if (paste->progress)
+        paste->progress (paste->offset, length, paste->progress_data);
+
+    paste->writable = g_unix_fd_source_new (paste->fd, G_IO_OUT);
+    g_task_attach_source (task, paste->writable, G_SOURCE_FUNC (on_writable));
+
+    if (g_task_get_cancellable (task))
+    {
+        paste->cancelled = g_cancellable_source_new (g_task_get_cancellable (task));
+        g_task_attach_source (task, paste->cancelled, G_SOURCE_FUNC (on_cancelled));
+    }
+}
+
+/* fd is the pty whose writability paces the writes */
+void
+germinal_paste_async (gint                   fd,
+                      GBytes                *text,
+                      GerminalPasteWrite     write,
+                      gpointer               write_data,
+                      GCancellable          *cancellable,
+                      GerminalPasteProgress  progress,
+                      gpointer               progress_data,
+                      GAsyncReadyCallback    callback,
+                      gpointer               user_data)
+{
+    g_return_if_fail (fd >= 0);
+    g_return_if_fail (text != NULL);
+    g_return_if_fail (write != NULL);
+
+    g_autoptr (GTask) task = g_task_new (NULL, cancellable, callback, user_data);
+    PasteData *paste = g_new0 (PasteData, 1);
+
+    paste->fd = fd;
+    paste->text = g_bytes_ref (text);
+    paste->write = write;
+    paste->write_data = write_data;
+    paste->progress = progress;
+    paste->progress_data = progress_data;
+    paste->start = g_get_monotonic_time ();
+
+    g_task_set_name (task, "[germinal] paste");
+    /* Below the pty's own watches, so they drain what they hold first */
+    g_task_set_priority (task, G_PRIORITY_LOW);
+    g_task_set_task_data (task, paste, paste_data_free);
+
+    germinal_paste_feed (task);
+}
+
+/* throughput is in bytes per second */
+gboolean
+germinal_paste_finish (GAsyncResult  *result,
+                       gdouble       *throughput,
+                       GError       **error)
+{
+    g_return_val_if_fail (g_task_is_valid (result, NULL), FALSE);
+
+    PasteData *paste = g_task_get_task_data (G_TASK (result));
+
+    if (!g_task_propagate_boolean (G_TASK (result), error))
+        return FALSE;
+
+    if (throughput)
+        *throughput = paste->offset * (gdouble) G_USEC_PER_SEC / MAX (paste->elapsed, 1);
+
+    return TRUE;
+}
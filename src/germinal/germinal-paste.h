@@ -0,0 +1,33 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+/* Pastes up to that size go in one go */
+#define GERMINAL_PASTE_CHUNK_SIZE (16 * 1024)
+
+/* Hands a chunk over to whatever writes it to the pty */
+typedef void (*GerminalPasteWrite) (const gchar *chunk, gsize length, gpointer user_data);
+
+/* How many bytes of the text were handed over */
+typedef void (*GerminalPasteProgress) (gsize bytes_done, gsize n_bytes, gpointer user_data);
+
+gsize    germinal_paste_chunk_end (const gchar *text, gsize length, gsize offset, gsize max_size);
+gchar   *germinal_paste_sanitize  (const gchar *text, gsize length, gsize *sanitized_length);
+
+void     germinal_paste_async  (gint                   fd,
+                                GBytes                *text,
+                                GerminalPasteWrite     write,
+                                gpointer               write_data,
+                                GCancellable          *cancellable,
+                                GerminalPasteProgress  progress,
+                                gpointer               progress_data,
+                                GAsyncReadyCallback    callback,
+                                gpointer               user_data);
+gboolean germinal_paste_finish (GAsyncResult *result, gdouble *throughput, GError **error);
+
+G_END_DECLS
@@ -1,9 +1,11 @@
 // SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include "germinal-font-list.h"
 #include "germinal-palette-editor.h"
 #include "germinal-preferences.h"
 #include "germinal-settings.h"
+#include "germinal-theme-gallery.h"
 
 #include <glib/gi18n-lib.h>
 #include <pango/pango.h>
@@ -72,6 +74,83 @@ double_to_int (const GValue       *value,
     return g_variant_new_int32 ((gint) g_value_get_double (value));
 }
 
+/* Index in the combo row model <-> choice in the schema */
+static const gchar *multiplexer_values[] = { "tmux", "tmux-control", "native", NULL };
+static const gchar *tmux_sessions_values[] = { "shared", "grouped", "per-window", NULL };
+
+static gboolean
+choice_get_mapping (GValue   *value,
+                    GVariant *variant,
+                    gpointer  user_data)
+{
+    const gchar **values = user_data;
+    const gchar *choice = g_variant_get_string (variant, NULL);
+
+    for (guint i = 0; values[i]; ++i)
+    {
+        if (!g_strcmp0 (values[i], choice))
+        {
+            g_value_set_uint (value, i);
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static GVariant *
+choice_set_mapping (const GValue       *value,
+                    const GVariantType *expected_type G_GNUC_UNUSED,
+                    gpointer            user_data)
+{
+    const gchar **values = user_data;
+    guint index = g_value_get_uint (value);
+
+    if (index >= g_strv_length ((GStrv) values))
+        return NULL;
+
+    return g_variant_new_string (values[index]);
+}
+
+/* --- Font button ------------------------------------------------------- */
+
+static void
+on_monospace_families (GHashTable *families,
+                       gpointer    user_data)
+{
+    GtkFontDialogButton *button = GTK_FONT_DIALOG_BUTTON (user_data);
+    g_autoptr (GtkFilter) filter = germinal_font_list_filter_new (families);
+
+    /*
+     * The chooser still walks every family of the font map on the main
+     * thread to filter them, GtkFontDialog has no way to take a model.
+     * This only spares it from querying each family for monospace-ness
+     * and from listing and rendering previews of the others.
+     */
+    gtk_font_dialog_set_filter (gtk_font_dialog_button_get_dialog (button), filter);
+    gtk_widget_set_sensitive (GTK_WIDGET (button), TRUE);
+}
+
+/* Cached after the first time, but fonts may have been installed since */
+static void
+on_font_button_map (GtkWidget *button,
+                    gpointer   user_data G_GNUC_UNUSED)
+{
+    germinal_font_list_get_monospace (G_OBJECT (button), on_monospace_families);
+}
+
+static GtkWidget *
+make_font_button (void)
+{
+    GtkWidget *button = gtk_font_dialog_button_new (gtk_font_dialog_new ());
+
+    /* Until we know which families to offer, the chooser would list them all, unfiltered */
+    gtk_widget_set_sensitive (button, FALSE);
+    g_signal_connect (button, "map", G_CALLBACK (on_font_button_map), NULL);
+
+    return button;
+}
+
 /* --- Reset button ------------------------------------------------------ */
 
 static void
@@ -152,7 +231,7 @@ germinal_preferences_new (void)
     AdwPreferencesGroup *font_group = ADW_PREFERENCES_GROUP (adw_preferences_group_new ());
     adw_preferences_group_set_title (font_group, _("Font"));
 
-    GtkWidget *font_button = gtk_font_dialog_button_new (gtk_font_dialog_new ());
+    GtkWidget *font_button = make_font_button ();
     AdwActionRow *font_row = make_button_row (_("Font"), font_button, settings, FONT_KEY);
     g_settings_bind_with_mapping (settings, FONT_KEY, font_button, "font-desc",
                                   G_SETTINGS_BIND_DEFAULT,
@@ -180,6 +259,13 @@ germinal_preferences_new (void)
 
     adw_preferences_page_add (appearance, colors_group);
 
+    /* Themes group */
+    AdwPreferencesGroup *themes_group = ADW_PREFERENCES_GROUP (adw_preferences_group_new ());
+    adw_preferences_group_set_title (themes_group, _("Themes"));
+    adw_preferences_group_set_description (themes_group, _("iTerm2, base16 and Xresources color schemes"));
+    adw_preferences_group_add (themes_group, germinal_theme_gallery_new (settings));
+    adw_preferences_page_add (appearance, themes_group);
+
     /* Palette group */
     AdwPreferencesGroup *palette_group = ADW_PREFERENCES_GROUP (adw_preferences_group_new ());
     adw_preferences_group_set_title (palette_group, _("Palette"));
@@ -230,6 +316,22 @@ germinal_preferences_new (void)
     g_settings_bind (settings, DECORATED_KEY, decorated_row, "active", G_SETTINGS_BIND_DEFAULT);
     adw_preferences_group_add (window_group, decorated_row);
 
+    GtkWidget *spare_row = adw_spin_row_new_with_range (0.0, 4.0, 1.0);
+    adw_preferences_row_set_title (ADW_PREFERENCES_ROW (spare_row), _("Spare windows"));
+    adw_action_row_set_subtitle (ADW_ACTION_ROW (spare_row), _("Kept ready in the background for new windows"));
+    adw_action_row_add_suffix (ADW_ACTION_ROW (spare_row), make_reset_button (settings, SPARE_WINDOWS_KEY));
+    g_settings_bind_with_mapping (settings, SPARE_WINDOWS_KEY, spare_row, "value",
+                                  G_SETTINGS_BIND_DEFAULT,
+                                  int_to_double, double_to_int, NULL, NULL);
+    adw_preferences_group_add (window_group, spare_row);
+
+    GtkWidget *drop_down_row = adw_switch_row_new ();
+    adw_preferences_row_set_title (ADW_PREFERENCES_ROW (drop_down_row), _("Drop-down window"));
+    adw_action_row_set_subtitle (ADW_ACTION_ROW (drop_down_row), _("When started as a service"));
+    adw_action_row_add_suffix (ADW_ACTION_ROW (drop_down_row), make_reset_button (settings, DROP_DOWN_KEY));
+    g_settings_bind (settings, DROP_DOWN_KEY, drop_down_row, "active", G_SETTINGS_BIND_DEFAULT);
+    adw_preferences_group_add (window_group, drop_down_row);
+
     adw_preferences_page_add (terminal, window_group);
     adw_preferences_dialog_add (dialog, terminal);
 
@@ -254,8 +356,49 @@ germinal_preferences_new (void)
     g_settings_bind (settings, TERM_KEY, term_row, "text", G_SETTINGS_BIND_DEFAULT);
     adw_preferences_group_add (command_group, term_row);
 
+    const gchar *multiplexer_labels[] = { _("Terminal"), _("Native panes"), _("Built-in tabs and splits"), NULL };
+    GtkWidget *multiplexer_row = adw_combo_row_new ();
+    adw_preferences_row_set_title (ADW_PREFERENCES_ROW (multiplexer_row), _("Tabs and panes"));
+    adw_action_row_set_subtitle (ADW_ACTION_ROW (multiplexer_row), _("Applies to new windows"));
+    adw_combo_row_set_model (ADW_COMBO_ROW (multiplexer_row), G_LIST_MODEL (gtk_string_list_new (multiplexer_labels)));
+    adw_action_row_add_suffix (ADW_ACTION_ROW (multiplexer_row), make_reset_button (settings, MULTIPLEXER_KEY));
+    g_settings_bind_with_mapping (settings, MULTIPLEXER_KEY, multiplexer_row, "selected",
+                                  G_SETTINGS_BIND_DEFAULT,
+                                  choice_get_mapping, choice_set_mapping, multiplexer_values, NULL);
+    adw_preferences_group_add (command_group, multiplexer_row);
+
+    const gchar *tmux_sessions_labels[] = { _("Shared"), _("Grouped"), _("One per window"), NULL };
+    GtkWidget *tmux_sessions_row = adw_combo_row_new ();
+    adw_preferences_row_set_title (ADW_PREFERENCES_ROW (tmux_sessions_row), _("tmux sessions"));
+    adw_action_row_set_subtitle (ADW_ACTION_ROW (tmux_sessions_row), _("For windows after the first one"));
+    adw_combo_row_set_model (ADW_COMBO_ROW (tmux_sessions_row), G_LIST_MODEL (gtk_string_list_new (tmux_sessions_labels)));
+    adw_action_row_add_suffix (ADW_ACTION_ROW (tmux_sessions_row), make_reset_button (settings, TMUX_SESSIONS_KEY));
+    g_settings_bind_with_mapping (settings, TMUX_SESSIONS_KEY, tmux_sessions_row, "selected",
+                                  G_SETTINGS_BIND_DEFAULT,
+                                  choice_get_mapping, choice_set_mapping, tmux_sessions_values, NULL);
+    adw_preferences_group_add (command_group, tmux_sessions_row);
+
     adw_preferences_page_add (shell, command_group);
     adw_preferences_dialog_add (dialog, shell);
 
     return ADW_DIALOG (dialog);
 }
+
+void
+germinal_preferences_present (GtkWidget *parent)
+{
+    /* Built the first time it is opened, then shared by every window */
+    static AdwDialog *dialog;
+
+    if (!dialog)
+        dialog = g_object_ref_sink (germinal_preferences_new ());
+
+    /* Already open on another window */
+    if (gtk_widget_get_parent (GTK_WIDGET (dialog)))
+    {
+        gtk_window_present (GTK_WINDOW (gtk_widget_get_root (GTK_WIDGET (dialog))));
+        return;
+    }
+
+    adw_dialog_present (dialog, parent);
+}
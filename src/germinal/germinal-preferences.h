@@ -7,6 +7,7 @@
 
 G_BEGIN_DECLS
 
-AdwDialog *germinal_preferences_new (void);
+AdwDialog *germinal_preferences_new     (void);
+void       germinal_preferences_present (GtkWidget *parent);
 
 G_END_DECLS
@@ -0,0 +1,177 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-pty-child.h"
+#include "germinal-timings.h"
+
+#include <signal.h>
+
+/*
+ * A PTY and the process running in it, without any VteTerminal attached.
+ *
+ * Tabs that are not shown yet only own one of these, the terminal widget
+ * (and its fonts and scrollback) is created and attached when first needed.
+ */
+
+struct _GerminalPtyChild
+{
+    GObject parent_instance;
+};
+
+enum
+{
+    SIGNAL_EXITED,
+
+    N_SIGNALS
+};
+
+static guint signals[N_SIGNALS];
+
+typedef struct
+{
+    VtePty *pty;
+    GPid    pid;
+} GerminalPtyChildPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GerminalPtyChild, germinal_pty_child, G_TYPE_OBJECT)
+
+static void
+on_child_exited (GPid     pid,
+                 gint     status,
+                 gpointer user_data)
+{
+    g_autoptr (GerminalPtyChild) self = g_weak_ref_get (user_data);
+
+    g_spawn_close_pid (pid);
+
+    if (!self)
+        return;
+
+    GerminalPtyChildPrivate *priv = germinal_pty_child_get_instance_private (self);
+
+    priv->pid = 0;
+
+    g_signal_emit (self, signals[SIGNAL_EXITED], 0, status);
+}
+
+static void
+weak_ref_free (gpointer data)
+{
+    g_weak_ref_clear (data);
+    g_free (data);
+}
+
+static void
+on_spawned (GObject      *source,
+            GAsyncResult *result,
+            gpointer      user_data)
+{
+    g_autoptr (GerminalPtyChild) self = user_data;
+    GerminalPtyChildPrivate *priv = germinal_pty_child_get_instance_private (self);
+    g_autoptr (GError) error = NULL;
+    GPid pid;
+
+    if (!vte_pty_spawn_finish (VTE_PTY (source), result, &pid, &error))
+    {
+        g_warning ("%s", error->message);
+        g_signal_emit (self, signals[SIGNAL_EXITED], 0, -1);
+        return;
+    }
+
+    priv->pid = pid;
+
+    /* The watch must outlive us, or nobody would reap the child */
+    GWeakRef *ref = g_new0 (GWeakRef, 1);
+    g_weak_ref_init (ref, self);
+    g_child_watch_add_full (G_PRIORITY_DEFAULT, pid, on_child_exited, ref, weak_ref_free);
+}
+
+VtePty *
+germinal_pty_child_get_pty (GerminalPtyChild *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_PTY_CHILD (self), NULL);
+
+    GerminalPtyChildPrivate *priv = germinal_pty_child_get_instance_private (self);
+
+    return priv->pty;
+}
+
+void
+germinal_pty_child_terminate (GerminalPtyChild *self)
+{
+    g_return_if_fail (GERMINAL_IS_PTY_CHILD (self));
+
+    GerminalPtyChildPrivate *priv = germinal_pty_child_get_instance_private (self);
+
+    if (priv->pid > 0)
+        kill (priv->pid, SIGHUP);
+}
+
+static void
+germinal_pty_child_dispose (GObject *object)
+{
+    GerminalPtyChild *self = GERMINAL_PTY_CHILD (object);
+    GerminalPtyChildPrivate *priv = germinal_pty_child_get_instance_private (self);
+
+    germinal_pty_child_terminate (self);
+    g_clear_object (&priv->pty);
+
+    G_OBJECT_CLASS (germinal_pty_child_parent_class)->dispose (object);
+}
+
+static void
+germinal_pty_child_init (GerminalPtyChild *self G_GNUC_UNUSED)
+{
+}
+
+static void
+germinal_pty_child_class_init (GerminalPtyChildClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    object_class->dispose = germinal_pty_child_dispose;
+
+    /* Same status as VteTerminal::child-exited, -1 if the spawn failed */
+    signals[SIGNAL_EXITED] = g_signal_new ("exited",
+                                           G_TYPE_FROM_CLASS (klass),
+                                           G_SIGNAL_RUN_LAST,
+                                           0, NULL, NULL, NULL,
+                                           G_TYPE_NONE, 1, G_TYPE_INT);
+}
+
+GerminalPtyChild *
+germinal_pty_child_new (const gchar * const *argv,
+                        const gchar * const *envp,
+                        glong                columns,
+                        glong                rows,
+                        GError             **error)
+{
+    g_return_val_if_fail (argv != NULL && argv[0] != NULL, NULL);
+
+    g_autoptr (VtePty) pty = vte_pty_new_sync (VTE_PTY_DEFAULT, NULL, error);
+
+    if (!pty)
+        return NULL;
+
+    /* The child gets its final size right away when we know it, VteTerminal takes over once attached */
+    if (columns > 0 && rows > 0 && !vte_pty_set_size (pty, (gint) rows, (gint) columns, error))
+        return NULL;
+
+    germinal_timings_mark (GERMINAL_TIMING_PTY_OPENED);
+
+    GerminalPtyChild *self = g_object_new (GERMINAL_TYPE_PTY_CHILD, NULL);
+    GerminalPtyChildPrivate *priv = germinal_pty_child_get_instance_private (self);
+
+    priv->pty = g_steal_pointer (&pty);
+
+    vte_pty_spawn_async (priv->pty, g_get_home_dir (), (gchar **) argv, (gchar **) envp, G_SPAWN_SEARCH_PATH,
+                         NULL,  /* child_setup */
+                         NULL,  /* child_setup_data */
+                         NULL,  /* child_setup_data_destroy */
+                         -1,    /* timeout */
+                         NULL,  /* cancellable */
+                         on_spawned,
+                         g_object_ref (self));
+
+    return self;
+}
@@ -0,0 +1,17 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <vte/vte.h>
+
+G_BEGIN_DECLS
+
+#define GERMINAL_TYPE_PTY_CHILD germinal_pty_child_get_type ()
+G_DECLARE_FINAL_TYPE (GerminalPtyChild, germinal_pty_child, GERMINAL, PTY_CHILD, GObject)
+
+GerminalPtyChild *germinal_pty_child_new       (const gchar * const *argv, const gchar * const *envp, glong columns, glong rows, GError **error);
+VtePty           *germinal_pty_child_get_pty   (GerminalPtyChild *self);
+void              germinal_pty_child_terminate (GerminalPtyChild *self);
+
+G_END_DECLS
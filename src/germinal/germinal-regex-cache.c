@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-regex-cache.h"
+
+#define PCRE2_CODE_UNIT_WIDTH 0
+#include <pcre2.h>
+
+/*
+ * Match regexes (the url matcher) are few and used by every terminal, they
+ * are kept forever. Search regexes come from whatever gets typed in the
+ * search entry, only the most recent ones are kept.
+ */
+#define MAX_SEARCH_REGEXES 32
+
+static GHashTable *regexes;
+static GQueue      recent_searches = G_QUEUE_INIT;
+
+typedef VteRegex *(*RegexNewFunc) (const gchar *pattern, gssize pattern_length, guint32 flags, GError **error);
+
+static VteRegex *
+germinal_regex_cache_get (const gchar  *pattern,
+                          guint32       flags,
+                          gboolean      search,
+                          GError      **error)
+{
+    if (!regexes)
+        regexes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) vte_regex_unref);
+
+    g_autofree gchar *key = g_strdup_printf ("%c%08x%s", search ? 's' : 'm', flags, pattern);
+    VteRegex *regex = g_hash_table_lookup (regexes, key);
+
+    if (regex)
+    {
+        if (search)
+        {
+            /* Most recently used first */
+            GList *link = g_queue_find_custom (&recent_searches, key, (GCompareFunc) g_strcmp0);
+
+            g_queue_unlink (&recent_searches, link);
+            g_queue_push_head_link (&recent_searches, link);
+        }
+
+        return vte_regex_ref (regex);
+    }
+
+    RegexNewFunc regex_new = search ? vte_regex_new_for_search : vte_regex_new_for_match;
+
+    regex = regex_new (pattern, -1, flags, error);
+
+    if (!regex)
+        return NULL;
+
+    g_autoptr (GError) jit_error = NULL;
+
+    /* Not fatal, JIT may not be available (no executable memory) */
+    if (!vte_regex_jit (regex, PCRE2_JIT_COMPLETE, &jit_error))
+        g_debug ("Couldn't JIT compile '%s': %s", pattern, jit_error->message);
+
+    if (search)
+    {
+        g_queue_push_head (&recent_searches, g_strdup (key));
+
+        if (g_queue_get_length (&recent_searches) > MAX_SEARCH_REGEXES)
+        {
+            g_autofree gchar *oldest = g_queue_pop_tail (&recent_searches);
+
+            g_hash_table_remove (regexes, oldest);
+        }
+    }
+
+    g_hash_table_insert (regexes, g_steal_pointer (&key), vte_regex_ref (regex));
+
+    return regex;
+}
+
+VteRegex *
+germinal_regex_cache_get_match (const gchar  *pattern,
+                                guint32       flags,
+                                GError      **error)
+{
+    g_return_val_if_fail (pattern != NULL, NULL);
+
+    return germinal_regex_cache_get (pattern, flags, FALSE, error);
+}
+
+VteRegex *
+germinal_regex_cache_get_search (const gchar  *pattern,
+                                 guint32       flags,
+                                 GError      **error)
+{
+    g_return_val_if_fail (pattern != NULL, NULL);
+
+    return germinal_regex_cache_get (pattern, flags, TRUE, error);
+}
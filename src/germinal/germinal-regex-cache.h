@@ -0,0 +1,14 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <vte/vte.h>
+
+G_BEGIN_DECLS
+
+/* Compiled and JIT'd once per process, the caller gets a new reference */
+VteRegex *germinal_regex_cache_get_match  (const gchar *pattern, guint32 flags, GError **error);
+VteRegex *germinal_regex_cache_get_search (const gchar *pattern, guint32 flags, GError **error);
+
+G_END_DECLS
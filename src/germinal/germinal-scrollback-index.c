@@ -0,0 +1,648 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-scrollback-index.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Every row of every scrollback gets an id, in the order they are indexed,
+ * and each trigram of its text (ASCII case folded) lists the ids of the rows
+ * it appears in. Looking for some text only has to go through the shortest
+ * of the lists for its trigrams, checking the others and then the text.
+ *
+ * Rows that go away only leave their ids behind in the lists, which get
+ * cleaned up all at once when those make up half of them.
+ */
+
+struct _GerminalScrollbackIndex
+{
+    GObject parent_instance;
+};
+
+enum
+{
+    SIGNAL_STARTED,
+
+    N_SIGNALS
+};
+
+static guint signals[N_SIGNALS];
+
+typedef struct
+{
+    guint  document;
+    gint64 row;
+    guint  n_trigrams;
+    gsize  size;
+    gchar  text[];
+} IndexedRow;
+
+/* The ids of a document's rows, by row, from head on */
+typedef struct
+{
+    gpointer  owner;
+    GArray   *ids;
+    guint     head;
+} Document;
+
+typedef struct
+{
+    gsize       max_size;
+
+    /* Nothing gets indexed until someone searches */
+    gboolean    started;
+
+    GHashTable *documents;
+    guint       next_document;
+
+    /* IndexedRow by id, from first_id on, NULL once gone, the first head of them are */
+    GPtrArray  *records;
+    guint       first_id;
+    guint       head;
+    gsize       records_size;
+    guint       n_rows;
+
+    /* Sorted ids of the rows by trigram */
+    GHashTable *postings;
+    gsize       n_postings;
+    gsize       n_dead_postings;
+
+    GArray     *trigrams;
+} GerminalScrollbackIndexPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GerminalScrollbackIndex, germinal_scrollback_index, G_TYPE_OBJECT)
+
+/* What a hash table entry and an array cost, besides the ids */
+#define POSTING_LIST_OVERHEAD (sizeof (GArray) + 4 * sizeof (gpointer))
+#define MIN_DEAD_POSTINGS     4096
+
+static void
+document_free (gpointer data)
+{
+    Document *document = data;
+
+    g_array_unref (document->ids);
+    g_free (document);
+}
+
+static void
+document_pop_front (Document *document)
+{
+    if (++document->head > document->ids->len / 2)
+    {
+        g_array_remove_range (document->ids, 0, document->head);
+        document->head = 0;
+    }
+}
+
+static IndexedRow *
+record_at (GerminalScrollbackIndexPrivate *priv,
+           guint                           id)
+{
+    if (id < priv->first_id + priv->head || id - priv->first_id >= priv->records->len)
+        return NULL;
+
+    return priv->records->pdata[id - priv->first_id];
+}
+
+static gint
+compare_ids (gconstpointer a,
+             gconstpointer b)
+{
+    guint first = *(const guint *) a;
+    guint second = *(const guint *) b;
+
+    return (first > second) - (first < second);
+}
+
+/* Each distinct trigram of text once, sorted, into priv->trigrams */
+static void
+collect_trigrams (GerminalScrollbackIndexPrivate *priv,
+                  const gchar                    *text)
+{
+    gsize length = strlen (text);
+
+    g_array_set_size (priv->trigrams, 0);
+
+    for (gsize i = 0; i + 2 < length; ++i)
+    {
+        guint trigram = ((guint) (guchar) g_ascii_tolower (text[i])     << 16) |
+                        ((guint) (guchar) g_ascii_tolower (text[i + 1]) <<  8) |
+                         (guint) (guchar) g_ascii_tolower (text[i + 2]);
+
+        g_array_append_val (priv->trigrams, trigram);
+    }
+
+    if (priv->trigrams->len < 2)
+        return;
+
+    g_array_sort (priv->trigrams, compare_ids);
+
+    guint *trigrams = (guint *) priv->trigrams->data;
+    guint unique = 1;
+
+    for (guint i = 1; i < priv->trigrams->len; ++i)
+    {
+        if (trigrams[i] != trigrams[unique - 1])
+            trigrams[unique++] = trigrams[i];
+    }
+
+    g_array_set_size (priv->trigrams, unique);
+}
+
+static void
+add_record (GerminalScrollbackIndexPrivate *priv,
+            guint                           document_id,
+            Document                       *document,
+            gint64                          row,
+            const gchar                    *text)
+{
+    gsize length = strlen (text);
+    IndexedRow *record = g_malloc (sizeof (IndexedRow) + length + 1);
+    guint id = priv->first_id + priv->records->len;
+
+    record->document = document_id;
+    record->row = row;
+    record->size = sizeof (IndexedRow) + length + 1;
+    memcpy (record->text, text, length + 1);
+
+    collect_trigrams (priv, text);
+    record->n_trigrams = priv->trigrams->len;
+
+    for (guint i = 0; i < priv->trigrams->len; ++i)
+    {
+        gpointer key = GUINT_TO_POINTER (g_array_index (priv->trigrams, guint, i));
+        GArray *ids = g_hash_table_lookup (priv->postings, key);
+
+        if (!ids)
+        {
+            ids = g_array_new (FALSE, FALSE, sizeof (guint));
+            g_hash_table_insert (priv->postings, key, ids);
+        }
+
+        g_array_append_val (ids, id);
+    }
+
+    g_ptr_array_add (priv->records, record);
+    g_array_append_val (document->ids, id);
+    priv->records_size += record->size;
+    priv->n_postings += record->n_trigrams;
+    ++priv->n_rows;
+}
+
+static void
+drop_record (GerminalScrollbackIndexPrivate *priv,
+             guint                           id)
+{
+    IndexedRow *record = record_at (priv, id);
+
+    priv->records_size -= record->size;
+    priv->n_dead_postings += record->n_trigrams;
+    --priv->n_rows;
+
+    g_free (record);
+    priv->records->pdata[id - priv->first_id] = NULL;
+}
+
+/* Forget about the ids of rows that are gone, once they are too many or when forced to */
+static void
+germinal_scrollback_index_compact (GerminalScrollbackIndexPrivate *priv,
+                                   gboolean                        force)
+{
+    while (priv->head < priv->records->len && !priv->records->pdata[priv->head])
+        ++priv->head;
+
+    if (priv->head > priv->records->len / 2)
+    {
+        g_ptr_array_remove_range (priv->records, 0, priv->head);
+        priv->first_id += priv->head;
+        priv->head = 0;
+    }
+
+    if (!priv->n_dead_postings || (!force && (priv->n_dead_postings < MIN_DEAD_POSTINGS || priv->n_dead_postings * 2 < priv->n_postings)))
+        return;
+
+    GHashTableIter iter;
+    GArray *ids;
+
+    g_hash_table_iter_init (&iter, priv->postings);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &ids))
+    {
+        guint kept = 0;
+
+        for (guint i = 0; i < ids->len; ++i)
+        {
+            guint id = g_array_index (ids, guint, i);
+
+            if (record_at (priv, id))
+                g_array_index (ids, guint, kept++) = id;
+        }
+
+        if (kept)
+            g_array_set_size (ids, kept);
+        else
+            g_hash_table_iter_remove (&iter);
+    }
+
+    g_debug ("Dropped %" G_GSIZE_FORMAT " stale ids from the scrollback index", priv->n_dead_postings);
+    priv->n_postings -= priv->n_dead_postings;
+    priv->n_dead_postings = 0;
+}
+
+/* Past the budget, make some room at once rather than a row at a time */
+static void
+germinal_scrollback_index_enforce_budget (GerminalScrollbackIndex *self)
+{
+    GerminalScrollbackIndexPrivate *priv = germinal_scrollback_index_get_instance_private (self);
+
+    if (germinal_scrollback_index_get_size (self) <= priv->max_size)
+        return;
+
+    gsize target = priv->max_size - priv->max_size / 8;
+
+    /* The ids of the rows dropped on the way are only gone after the last compaction */
+    while (priv->n_rows && germinal_scrollback_index_get_size (self) - priv->n_dead_postings * sizeof (guint) > target)
+    {
+        /* The oldest row is the first one of its document */
+        IndexedRow *record = priv->records->pdata[priv->head];
+        Document *document = g_hash_table_lookup (priv->documents, GUINT_TO_POINTER (record->document));
+
+        drop_record (priv, priv->first_id + priv->head);
+        document_pop_front (document);
+        germinal_scrollback_index_compact (priv, FALSE);
+    }
+
+    germinal_scrollback_index_compact (priv, TRUE);
+
+    g_debug ("Scrollback index down to %u rows, %" G_GSIZE_FORMAT " bytes", priv->n_rows, germinal_scrollback_index_get_size (self));
+}
+
+/* owner is whatever callers want back for the document's hits */
+guint
+germinal_scrollback_index_add_document (GerminalScrollbackIndex *self,
+                                        gpointer                 owner)
+{
+    g_return_val_if_fail (GERMINAL_IS_SCROLLBACK_INDEX (self), 0);
+
+    GerminalScrollbackIndexPrivate *priv = germinal_scrollback_index_get_instance_private (self);
+    Document *document = g_new0 (Document, 1);
+
+    document->owner = owner;
+    document->ids = g_array_new (FALSE, FALSE, sizeof (guint));
+    g_hash_table_insert (priv->documents, GUINT_TO_POINTER (++priv->next_document), document);
+
+    return priv->next_document;
+}
+
+void
+germinal_scrollback_index_remove_document (GerminalScrollbackIndex *self,
+                                           guint                    document_id)
+{
+    g_return_if_fail (GERMINAL_IS_SCROLLBACK_INDEX (self));
+
+    GerminalScrollbackIndexPrivate *priv = germinal_scrollback_index_get_instance_private (self);
+    Document *document = g_hash_table_lookup (priv->documents, GUINT_TO_POINTER (document_id));
+
+    if (!document)
+        return;
+
+    for (guint i = document->head; i < document->ids->len; ++i)
+        drop_record (priv, g_array_index (document->ids, guint, i));
+
+    g_hash_table_remove (priv->documents, GUINT_TO_POINTER (document_id));
+    germinal_scrollback_index_compact (priv, FALSE);
+}
+
+gpointer
+germinal_scrollback_index_get_owner (GerminalScrollbackIndex *self,
+                                     guint                    document_id)
+{
+    g_return_val_if_fail (GERMINAL_IS_SCROLLBACK_INDEX (self), NULL);
+
+    GerminalScrollbackIndexPrivate *priv = germinal_scrollback_index_get_instance_private (self);
+    Document *document = g_hash_table_lookup (priv->documents, GUINT_TO_POINTER (document_id));
+
+    return document ? document->owner : NULL;
+}
+
+/*
+ * rows are the text of each row from first_row on. Rows indexed with the
+ * same text are kept, from the first one that changed, whatever was known
+ * from there is replaced.
+ */
+void
+germinal_scrollback_index_update (GerminalScrollbackIndex *self,
+                                  guint                    document_id,
+                                  gint64                   first_row,
+                                  GPtrArray               *rows)
+{
+    g_return_if_fail (GERMINAL_IS_SCROLLBACK_INDEX (self));
+    g_return_if_fail (rows != NULL);
+
+    GerminalScrollbackIndexPrivate *priv = germinal_scrollback_index_get_instance_private (self);
+    Document *document = g_hash_table_lookup (priv->documents, GUINT_TO_POINTER (document_id));
+
+    g_return_if_fail (document != NULL);
+
+    guint *ids = (guint *) document->ids->data;
+    guint low = document->head, high = document->ids->len;
+
+    while (low < high)
+    {
+        guint middle = low + (high - low) / 2;
+
+        if (record_at (priv, ids[middle])->row < first_row)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    guint same = 0;
+
+    while (same < rows->len && low + same < document->ids->len)
+    {
+        IndexedRow *record = record_at (priv, ids[low + same]);
+
+        if (record->row != first_row + same || strcmp (record->text, rows->pdata[same]))
+            break;
+
+        ++same;
+    }
+
+    for (guint i = low + same; i < document->ids->len; ++i)
+        drop_record (priv, ids[i]);
+    g_array_set_size (document->ids, low + same);
+
+    for (guint i = same; i < rows->len; ++i)
+        add_record (priv, document_id, document, first_row + i, rows->pdata[i]);
+
+    germinal_scrollback_index_compact (priv, FALSE);
+    germinal_scrollback_index_enforce_budget (self);
+}
+
+/* The scrollback forgot about rows before first_row */
+void
+germinal_scrollback_index_trim (GerminalScrollbackIndex *self,
+                                guint                    document_id,
+                                gint64                   first_row)
+{
+    g_return_if_fail (GERMINAL_IS_SCROLLBACK_INDEX (self));
+
+    GerminalScrollbackIndexPrivate *priv = germinal_scrollback_index_get_instance_private (self);
+    Document *document = g_hash_table_lookup (priv->documents, GUINT_TO_POINTER (document_id));
+    gboolean trimmed = FALSE;
+
+    g_return_if_fail (document != NULL);
+
+    while (document->head < document->ids->len)
+    {
+        guint id = g_array_index (document->ids, guint, document->head);
+
+        if (record_at (priv, id)->row >= first_row)
+            break;
+
+        drop_record (priv, id);
+        document_pop_front (document);
+        trimmed = TRUE;
+    }
+
+    if (trimmed)
+        germinal_scrollback_index_compact (priv, FALSE);
+}
+
+static gboolean
+contains_folded (const gchar *haystack,
+                 const gchar *needle,
+                 gsize        length)
+{
+    for (; *haystack; ++haystack)
+    {
+        gsize i = 0;
+
+        while (i < length && haystack[i] && g_ascii_tolower (haystack[i]) == needle[i])
+            ++i;
+
+        if (i == length)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+static gint
+compare_lengths (gconstpointer a,
+                 gconstpointer b)
+{
+    const GArray *first = *(GArray * const *) a;
+    const GArray *second = *(GArray * const *) b;
+
+    return (first->len > second->len) - (first->len < second->len);
+}
+
+static void
+clear_hit (gpointer data)
+{
+    GerminalIndexHit *hit = data;
+
+    g_free (hit->text);
+}
+
+static gboolean
+add_hit (GerminalScrollbackIndexPrivate *priv,
+         GArray                         *hits,
+         guint                           id,
+         const gchar                    *needle,
+         gsize                           length,
+         guint                           max_hits)
+{
+    IndexedRow *record = record_at (priv, id);
+
+    if (record && contains_folded (record->text, needle, length))
+    {
+        GerminalIndexHit hit = { record->document, record->row, g_strdup (record->text) };
+
+        g_array_append_val (hits, hit);
+    }
+
+    return hits->len < max_hits;
+}
+
+/* GerminalIndexHit for rows containing text (ASCII case folded), newest first */
+GArray *
+germinal_scrollback_index_search (GerminalScrollbackIndex *self,
+                                  const gchar             *text,
+                                  guint                    max_hits)
+{
+    g_return_val_if_fail (GERMINAL_IS_SCROLLBACK_INDEX (self), NULL);
+    g_return_val_if_fail (text != NULL, NULL);
+
+    GerminalScrollbackIndexPrivate *priv = germinal_scrollback_index_get_instance_private (self);
+    GArray *hits = g_array_new (FALSE, FALSE, sizeof (GerminalIndexHit));
+    g_autofree gchar *needle = g_ascii_strdown (text, -1);
+    gsize length = strlen (needle);
+
+    g_array_set_clear_func (hits, clear_hit);
+
+    if (!length || !max_hits)
+        return hits;
+
+    /* Too short for a trigram, go through everything */
+    if (length < 3)
+    {
+        for (guint i = priv->records->len; i > priv->head; --i)
+        {
+            if (!add_hit (priv, hits, priv->first_id + i - 1, needle, length, max_hits))
+                break;
+        }
+
+        return hits;
+    }
+
+    g_autoptr (GPtrArray) lists = g_ptr_array_new ();
+
+    collect_trigrams (priv, needle);
+
+    for (guint i = 0; i < priv->trigrams->len; ++i)
+    {
+        GArray *ids = g_hash_table_lookup (priv->postings, GUINT_TO_POINTER (g_array_index (priv->trigrams, guint, i)));
+
+        if (!ids)
+            return hits;
+
+        g_ptr_array_add (lists, ids);
+    }
+
+    g_ptr_array_sort (lists, compare_lengths);
+
+    GArray *shortest = lists->pdata[0];
+
+    for (guint i = shortest->len; i > 0; --i)
+    {
+        guint id = g_array_index (shortest, guint, i - 1);
+        gboolean everywhere = TRUE;
+
+        for (guint j = 1; everywhere && j < lists->len; ++j)
+        {
+            GArray *ids = lists->pdata[j];
+
+            everywhere = bsearch (&id, ids->data, ids->len, sizeof (guint), compare_ids) != NULL;
+        }
+
+        if (everywhere && !add_hit (priv, hits, id, needle, length, max_hits))
+            break;
+    }
+
+    return hits;
+}
+
+/* Close to what the index uses, in bytes */
+gsize
+germinal_scrollback_index_get_size (GerminalScrollbackIndex *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_SCROLLBACK_INDEX (self), 0);
+
+    GerminalScrollbackIndexPrivate *priv = germinal_scrollback_index_get_instance_private (self);
+
+    return priv->records_size +
+           priv->records->len * sizeof (gpointer) +
+           priv->n_postings * sizeof (guint) +
+           g_hash_table_size (priv->postings) * POSTING_LIST_OVERHEAD;
+}
+
+guint
+germinal_scrollback_index_get_n_rows (GerminalScrollbackIndex *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_SCROLLBACK_INDEX (self), 0);
+
+    GerminalScrollbackIndexPrivate *priv = germinal_scrollback_index_get_instance_private (self);
+
+    return priv->n_rows;
+}
+
+/* Until then, documents have no reason to send their rows */
+gboolean
+germinal_scrollback_index_is_started (GerminalScrollbackIndex *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_SCROLLBACK_INDEX (self), FALSE);
+
+    GerminalScrollbackIndexPrivate *priv = germinal_scrollback_index_get_instance_private (self);
+
+    return priv->started;
+}
+
+/* Someone is about to search, the documents get indexed from now on */
+void
+germinal_scrollback_index_start (GerminalScrollbackIndex *self)
+{
+    g_return_if_fail (GERMINAL_IS_SCROLLBACK_INDEX (self));
+
+    GerminalScrollbackIndexPrivate *priv = germinal_scrollback_index_get_instance_private (self);
+
+    if (priv->started)
+        return;
+
+    priv->started = TRUE;
+    g_signal_emit (self, signals[SIGNAL_STARTED], 0);
+}
+
+static void
+germinal_scrollback_index_finalize (GObject *object)
+{
+    GerminalScrollbackIndexPrivate *priv = germinal_scrollback_index_get_instance_private (GERMINAL_SCROLLBACK_INDEX (object));
+
+    g_clear_pointer (&priv->documents, g_hash_table_unref);
+    g_clear_pointer (&priv->records, g_ptr_array_unref);
+    g_clear_pointer (&priv->postings, g_hash_table_unref);
+    g_clear_pointer (&priv->trigrams, g_array_unref);
+
+    G_OBJECT_CLASS (germinal_scrollback_index_parent_class)->finalize (object);
+}
+
+static void
+germinal_scrollback_index_init (GerminalScrollbackIndex *self)
+{
+    GerminalScrollbackIndexPrivate *priv = germinal_scrollback_index_get_instance_private (self);
+
+    priv->documents = g_hash_table_new_full (NULL, NULL, NULL, document_free);
+    priv->records = g_ptr_array_new_with_free_func (g_free);
+    priv->postings = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify) g_array_unref);
+    priv->trigrams = g_array_new (FALSE, FALSE, sizeof (guint));
+}
+
+static void
+germinal_scrollback_index_class_init (GerminalScrollbackIndexClass *klass)
+{
+    G_OBJECT_CLASS (klass)->finalize = germinal_scrollback_index_finalize;
+
+    /* Documents should send all of their rows */
+    signals[SIGNAL_STARTED] = g_signal_new ("started",
+                                            G_TYPE_FROM_CLASS (klass),
+                                            G_SIGNAL_RUN_LAST,
+                                            0, NULL, NULL, NULL,
+                                            G_TYPE_NONE, 0);
+}
+
+GerminalScrollbackIndex *
+germinal_scrollback_index_new (gsize max_size)
+{
+    GerminalScrollbackIndex *self = g_object_new (GERMINAL_TYPE_SCROLLBACK_INDEX, NULL);
+    GerminalScrollbackIndexPrivate *priv = germinal_scrollback_index_get_instance_private (self);
+
+    priv->max_size = max_size;
+
+    return self;
+}
+
+/* Shared by every terminal of every window */
+GerminalScrollbackIndex *
+germinal_scrollback_index_get_default (void)
+{
+    static GerminalScrollbackIndex *index;
+
+    if (!index)
+        index = germinal_scrollback_index_new (GERMINAL_SCROLLBACK_INDEX_MAX_SIZE);
+
+    return index;
+}
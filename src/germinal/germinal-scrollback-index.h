@@ -0,0 +1,41 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/* What the index of every terminal's scrollback may use, oldest rows go first */
+#define GERMINAL_SCROLLBACK_INDEX_MAX_SIZE (64 * 1024 * 1024)
+
+#define GERMINAL_TYPE_SCROLLBACK_INDEX germinal_scrollback_index_get_type ()
+G_DECLARE_FINAL_TYPE (GerminalScrollbackIndex, germinal_scrollback_index, GERMINAL, SCROLLBACK_INDEX, GObject)
+
+/* A row of some document's scrollback where the text was found */
+typedef struct
+{
+    guint   document;
+    gint64  row;
+    gchar  *text;
+} GerminalIndexHit;
+
+GerminalScrollbackIndex *germinal_scrollback_index_new         (gsize max_size);
+GerminalScrollbackIndex *germinal_scrollback_index_get_default (void);
+
+gboolean germinal_scrollback_index_is_started      (GerminalScrollbackIndex *self);
+void     germinal_scrollback_index_start           (GerminalScrollbackIndex *self);
+
+guint    germinal_scrollback_index_add_document    (GerminalScrollbackIndex *self, gpointer owner);
+void     germinal_scrollback_index_remove_document (GerminalScrollbackIndex *self, guint document);
+gpointer germinal_scrollback_index_get_owner       (GerminalScrollbackIndex *self, guint document);
+
+void     germinal_scrollback_index_update          (GerminalScrollbackIndex *self, guint document, gint64 first_row, GPtrArray *rows);
+void     germinal_scrollback_index_trim            (GerminalScrollbackIndex *self, guint document, gint64 first_row);
+
+GArray  *germinal_scrollback_index_search          (GerminalScrollbackIndex *self, const gchar *text, guint max_hits);
+gsize    germinal_scrollback_index_get_size        (GerminalScrollbackIndex *self);
+guint    germinal_scrollback_index_get_n_rows      (GerminalScrollbackIndex *self);
+
+G_END_DECLS
@@ -0,0 +1,310 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-settings-backend.h"
+
+#include <string.h>
+
+/*
+ * The keyfile backend, without parsing the keyfile on a cold start.
+ *
+ * As long as the snapshot of the previous run is valid, reads are answered
+ * from the user values it recorded. The keyfile backend is only created once
+ * the main loop is idle (or as soon as something is written), from then on
+ * everything goes through it, and its changes are forwarded.
+ */
+
+#define SCHEMA_ID   "org.gnome.Germinal"
+#define SCHEMA_PATH "/org/gnome/Germinal/"
+#define ROOT_GROUP  "Germinal"
+
+struct _GerminalSettingsBackend
+{
+    GSettingsBackend parent_instance;
+};
+
+typedef struct
+{
+    gchar           *keyfile;
+    GSettingsSchema *schema;
+    /* What the keyfile held, until it is loaded */
+    GVariant        *user_values;
+    GSettings       *settings;
+    /* Our own writes, notified with their origin tag rather than forwarded */
+    gboolean         writing;
+    guint            load_source_id;
+} GerminalSettingsBackendPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GerminalSettingsBackend, germinal_settings_backend, G_TYPE_SETTINGS_BACKEND)
+
+/* The key name in our schema, NULL for paths we don't know about */
+static const gchar *
+germinal_settings_backend_key_name (GerminalSettingsBackend *self,
+                                    const gchar             *key)
+{
+    GerminalSettingsBackendPrivate *priv = germinal_settings_backend_get_instance_private (self);
+
+    if (!g_str_has_prefix (key, SCHEMA_PATH))
+        return NULL;
+
+    const gchar *name = key + strlen (SCHEMA_PATH);
+
+    return g_settings_schema_has_key (priv->schema, name) ? name : NULL;
+}
+
+static void
+germinal_settings_backend_notify (GerminalSettingsBackend *self,
+                                  const gchar             *name,
+                                  gpointer                 origin_tag)
+{
+    g_autofree gchar *key = g_strconcat (SCHEMA_PATH, name, NULL);
+
+    g_settings_backend_changed (G_SETTINGS_BACKEND (self), key, origin_tag);
+}
+
+static void
+on_keyfile_changed (GSettings   *settings G_GNUC_UNUSED,
+                    const gchar *name,
+                    gpointer     user_data)
+{
+    GerminalSettingsBackend *self = user_data;
+    GerminalSettingsBackendPrivate *priv = germinal_settings_backend_get_instance_private (self);
+
+    /* Edited behind our back */
+    if (!priv->writing)
+        germinal_settings_backend_notify (self, name, NULL);
+}
+
+static gboolean
+on_load (gpointer user_data)
+{
+    GerminalSettingsBackend *self = user_data;
+    GerminalSettingsBackendPrivate *priv = germinal_settings_backend_get_instance_private (self);
+
+    priv->load_source_id = 0;
+    germinal_settings_backend_load (self);
+
+    return G_SOURCE_REMOVE;
+}
+
+gboolean
+germinal_settings_backend_is_loaded (GerminalSettingsBackend *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_SETTINGS_BACKEND (self), FALSE);
+
+    GerminalSettingsBackendPrivate *priv = germinal_settings_backend_get_instance_private (self);
+
+    return priv->settings != NULL;
+}
+
+void
+germinal_settings_backend_load (GerminalSettingsBackend *self)
+{
+    g_return_if_fail (GERMINAL_IS_SETTINGS_BACKEND (self));
+
+    GerminalSettingsBackendPrivate *priv = germinal_settings_backend_get_instance_private (self);
+
+    if (priv->settings)
+        return;
+
+    g_clear_handle_id (&priv->load_source_id, g_source_remove);
+
+    g_autoptr (GSettingsBackend) backend = g_keyfile_settings_backend_new (priv->keyfile, SCHEMA_PATH, ROOT_GROUP);
+    g_auto (GStrv) names = g_settings_schema_list_keys (priv->schema);
+
+    priv->settings = g_settings_new_with_backend (SCHEMA_ID, backend);
+    g_signal_connect (priv->settings, "changed", G_CALLBACK (on_keyfile_changed), self);
+
+    /* The keyfile could have been edited since the snapshot was checked */
+    for (guint i = 0; names[i]; ++i)
+    {
+        g_autoptr (GVariant) before = g_variant_lookup_value (priv->user_values, names[i], NULL);
+        g_autoptr (GVariant) after = g_settings_get_user_value (priv->settings, names[i]);
+
+        if (before != after && (!before || !after || !g_variant_equal (before, after)))
+            germinal_settings_backend_notify (self, names[i], NULL);
+    }
+
+    g_clear_pointer (&priv->user_values, g_variant_unref);
+}
+
+static GVariant *
+germinal_settings_backend_read (GSettingsBackend   *backend,
+                                const gchar        *key,
+                                const GVariantType *expected_type,
+                                gboolean            default_value)
+{
+    GerminalSettingsBackend *self = GERMINAL_SETTINGS_BACKEND (backend);
+    GerminalSettingsBackendPrivate *priv = germinal_settings_backend_get_instance_private (self);
+    const gchar *name = germinal_settings_backend_key_name (self, key);
+
+    /* No defaults besides the schema's, as with the keyfile */
+    if (default_value || !name)
+        return NULL;
+
+    if (priv->settings)
+        return g_settings_get_user_value (priv->settings, name);
+
+    return g_variant_lookup_value (priv->user_values, name, expected_type);
+}
+
+static gboolean
+germinal_settings_backend_write_value (GerminalSettingsBackend *self,
+                                       const gchar             *key,
+                                       GVariant                *value)
+{
+    GerminalSettingsBackendPrivate *priv = germinal_settings_backend_get_instance_private (self);
+    const gchar *name = germinal_settings_backend_key_name (self, key);
+    gboolean written = TRUE;
+
+    if (!name)
+        return FALSE;
+
+    germinal_settings_backend_load (self);
+
+    priv->writing = TRUE;
+    if (value)
+        written = g_settings_set_value (priv->settings, name, value);
+    else
+        g_settings_reset (priv->settings, name);
+    priv->writing = FALSE;
+
+    return written;
+}
+
+static gboolean
+germinal_settings_backend_write (GSettingsBackend *backend,
+                                 const gchar      *key,
+                                 GVariant         *value,
+                                 gpointer          origin_tag)
+{
+    if (!germinal_settings_backend_write_value (GERMINAL_SETTINGS_BACKEND (backend), key, value))
+        return FALSE;
+
+    g_settings_backend_changed (backend, key, origin_tag);
+
+    return TRUE;
+}
+
+typedef struct
+{
+    GerminalSettingsBackend *self;
+    gboolean                 written;
+} WriteTree;
+
+static gboolean
+write_tree_value (gpointer key,
+                  gpointer value,
+                  gpointer user_data)
+{
+    WriteTree *write_tree = user_data;
+
+    /* A NULL value is a reset */
+    if (!germinal_settings_backend_write_value (write_tree->self, key, value))
+        write_tree->written = FALSE;
+
+    return FALSE;
+}
+
+static gboolean
+germinal_settings_backend_write_tree (GSettingsBackend *backend,
+                                      GTree            *tree,
+                                      gpointer          origin_tag)
+{
+    WriteTree write_tree = { GERMINAL_SETTINGS_BACKEND (backend), TRUE };
+
+    g_tree_foreach (tree, write_tree_value, &write_tree);
+    g_settings_backend_changed_tree (backend, tree, origin_tag);
+
+    return write_tree.written;
+}
+
+static void
+germinal_settings_backend_reset (GSettingsBackend *backend,
+                                 const gchar      *key,
+                                 gpointer          origin_tag)
+{
+    if (germinal_settings_backend_write_value (GERMINAL_SETTINGS_BACKEND (backend), key, NULL))
+        g_settings_backend_changed (backend, key, origin_tag);
+}
+
+static gboolean
+germinal_settings_backend_get_writable (GSettingsBackend *backend,
+                                        const gchar      *key)
+{
+    GerminalSettingsBackend *self = GERMINAL_SETTINGS_BACKEND (backend);
+    GerminalSettingsBackendPrivate *priv = germinal_settings_backend_get_instance_private (self);
+    const gchar *name = germinal_settings_backend_key_name (self, key);
+
+    if (!name)
+        return FALSE;
+
+    /* Until loaded, locks in the keyfile are not known yet: writing loads it and fails then */
+    return priv->settings ? g_settings_is_writable (priv->settings, name) : TRUE;
+}
+
+static GPermission *
+germinal_settings_backend_get_permission (GSettingsBackend *backend G_GNUC_UNUSED,
+                                          const gchar      *path    G_GNUC_UNUSED)
+{
+    return g_simple_permission_new (TRUE);
+}
+
+static void
+germinal_settings_backend_finalize (GObject *object)
+{
+    GerminalSettingsBackend *self = GERMINAL_SETTINGS_BACKEND (object);
+    GerminalSettingsBackendPrivate *priv = germinal_settings_backend_get_instance_private (self);
+
+    g_clear_handle_id (&priv->load_source_id, g_source_remove);
+    if (priv->settings)
+        g_signal_handlers_disconnect_by_data (priv->settings, self);
+    g_clear_object (&priv->settings);
+    g_clear_pointer (&priv->user_values, g_variant_unref);
+    g_clear_pointer (&priv->schema, g_settings_schema_unref);
+    g_clear_pointer (&priv->keyfile, g_free);
+
+    G_OBJECT_CLASS (germinal_settings_backend_parent_class)->finalize (object);
+}
+
+static void
+germinal_settings_backend_init (GerminalSettingsBackend *self G_GNUC_UNUSED)
+{
+}
+
+static void
+germinal_settings_backend_class_init (GerminalSettingsBackendClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+    GSettingsBackendClass *backend_class = G_SETTINGS_BACKEND_CLASS (klass);
+
+    object_class->finalize = germinal_settings_backend_finalize;
+
+    backend_class->read = germinal_settings_backend_read;
+    backend_class->write = germinal_settings_backend_write;
+    backend_class->write_tree = germinal_settings_backend_write_tree;
+    backend_class->reset = germinal_settings_backend_reset;
+    backend_class->get_writable = germinal_settings_backend_get_writable;
+    backend_class->get_permission = germinal_settings_backend_get_permission;
+}
+
+GSettingsBackend *
+germinal_settings_backend_new (const gchar *keyfile,
+                               GVariant    *user_values)
+{
+    g_return_val_if_fail (keyfile != NULL, NULL);
+    g_return_val_if_fail (user_values != NULL && g_variant_is_of_type (user_values, G_VARIANT_TYPE_VARDICT), NULL);
+
+    GerminalSettingsBackend *self = g_object_new (GERMINAL_TYPE_SETTINGS_BACKEND, NULL);
+    GerminalSettingsBackendPrivate *priv = germinal_settings_backend_get_instance_private (self);
+
+    priv->keyfile = g_strdup (keyfile);
+    priv->schema = g_settings_schema_source_lookup (g_settings_schema_source_get_default (), SCHEMA_ID, TRUE);
+    priv->user_values = g_variant_ref_sink (user_values);
+
+    /* After the first windows were shown */
+    priv->load_source_id = g_idle_add_full (G_PRIORITY_LOW, on_load, self, NULL);
+    g_source_set_name_by_id (priv->load_source_id, "[germinal] load-settings");
+
+    return G_SETTINGS_BACKEND (self);
+}
@@ -0,0 +1,20 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#define G_SETTINGS_ENABLE_BACKEND 1
+#include <gio/gio.h>
+#include <gio/gsettingsbackend.h>
+
+G_BEGIN_DECLS
+
+#define GERMINAL_TYPE_SETTINGS_BACKEND germinal_settings_backend_get_type ()
+G_DECLARE_FINAL_TYPE (GerminalSettingsBackend, germinal_settings_backend, GERMINAL, SETTINGS_BACKEND, GSettingsBackend)
+
+/* user_values is an a{sv} of what the keyfile held when the snapshot was taken */
+GSettingsBackend *germinal_settings_backend_new       (const gchar *keyfile, GVariant *user_values);
+gboolean          germinal_settings_backend_is_loaded (GerminalSettingsBackend *self);
+void              germinal_settings_backend_load      (GerminalSettingsBackend *self);
+
+G_END_DECLS
@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-settings-snapshot.h"
+
+#include <glib/gstdio.h>
+
+#include <errno.h>
+
+/*
+ * A GVariant, mapped from the user cache directory: the version that wrote
+ * it, the modification time (in nanoseconds, so that two saves within the
+ * same second still tell apart) and size of the settings source it was taken
+ * from, then the values, already validated and parsed, and the user values
+ * of every key as they were in the source.
+ */
+#define SNAPSHOT_TYPE G_VARIANT_TYPE ("(sxtsa(dddd)ia(dddd)a{sv})")
+
+static gboolean
+germinal_settings_snapshot_stamp (const gchar *source,
+                                  gint64      *mtime,
+                                  guint64     *size)
+{
+    GStatBuf buf;
+
+    if (g_stat (source, &buf))
+        return FALSE;
+
+    *mtime = (gint64) buf.st_mtim.tv_sec * G_GINT64_CONSTANT (1000000000) + buf.st_mtim.tv_nsec;
+    *size = (guint64) buf.st_size;
+
+    return TRUE;
+}
+
+static GdkRGBA
+rgba_from_doubles (const gdouble *components)
+{
+    return (GdkRGBA) { components[0], components[1], components[2], components[3] };
+}
+
+gboolean
+germinal_settings_snapshot_load (const gchar            *path,
+                                 const gchar            *source,
+                                 GerminalSettingsValues *values)
+{
+    g_return_val_if_fail (path != NULL, FALSE);
+    g_return_val_if_fail (source != NULL, FALSE);
+    g_return_val_if_fail (values != NULL, FALSE);
+
+    gint64 mtime;
+    guint64 size;
+
+    if (!germinal_settings_snapshot_stamp (source, &mtime, &size))
+        return FALSE;
+
+    g_autoptr (GMappedFile) file = g_mapped_file_new (path, FALSE, NULL);
+
+    if (!file)
+        return FALSE;
+
+    g_autoptr (GBytes) bytes = g_mapped_file_get_bytes (file);
+    g_autoptr (GVariant) snapshot = g_variant_new_from_bytes (SNAPSHOT_TYPE, bytes, FALSE);
+
+    /* Anything could have written there, don't trust it blindly */
+    if (!g_variant_is_normal_form (snapshot))
+        return FALSE;
+
+    const gchar *version, *font;
+    gint64 snapshot_mtime;
+    guint64 snapshot_size;
+    g_autoptr (GVariant) colors = NULL;
+    g_autoptr (GVariant) palette = NULL;
+    gint scrollback;
+    g_autoptr (GVariant) user_values = NULL;
+
+    g_variant_get (snapshot, "(&sxt&s@a(dddd)i@a(dddd)@a{sv})", &version, &snapshot_mtime, &snapshot_size, &font, &colors, &scrollback, &palette, &user_values);
+
+    if (g_strcmp0 (version, PACKAGE_STRING) || snapshot_mtime != mtime || snapshot_size != size)
+        return FALSE;
+
+    gsize n_colors = 0, n_palette = 0;
+    const gdouble *color_components = g_variant_get_fixed_array (colors, &n_colors, 4 * sizeof (gdouble));
+    const gdouble *palette_components = g_variant_get_fixed_array (palette, &n_palette, 4 * sizeof (gdouble));
+
+    if (n_colors != 2)
+        return FALSE;
+
+    values->font = g_strdup (font);
+    values->forecolor = rgba_from_doubles (&color_components[0]);
+    values->backcolor = rgba_from_doubles (&color_components[4]);
+    values->palette = g_new (GdkRGBA, n_palette);
+    values->palette_size = n_palette;
+    values->scrollback = scrollback;
+    values->user_values = g_steal_pointer (&user_values);
+
+    for (gsize i = 0; i < n_palette; ++i)
+        values->palette[i] = rgba_from_doubles (&palette_components[4 * i]);
+
+    return TRUE;
+}
+
+static void
+add_rgba (GVariantBuilder *builder,
+          const GdkRGBA   *rgba)
+{
+    g_variant_builder_add (builder, "(dddd)", (gdouble) rgba->red, (gdouble) rgba->green, (gdouble) rgba->blue, (gdouble) rgba->alpha);
+}
+
+gboolean
+germinal_settings_snapshot_save (const gchar                   *path,
+                                 const gchar                   *source,
+                                 const GerminalSettingsValues  *values,
+                                 GError                       **error)
+{
+    g_return_val_if_fail (path != NULL, FALSE);
+    g_return_val_if_fail (source != NULL, FALSE);
+    g_return_val_if_fail (values != NULL, FALSE);
+
+    gint64 mtime;
+    guint64 size;
+
+    /* No source yet (nothing was ever changed in dconf), nothing to validate against */
+    if (!germinal_settings_snapshot_stamp (source, &mtime, &size))
+        return TRUE;
+
+    GVariantBuilder colors, palette;
+
+    g_variant_builder_init (&colors, G_VARIANT_TYPE ("a(dddd)"));
+    add_rgba (&colors, &values->forecolor);
+    add_rgba (&colors, &values->backcolor);
+
+    g_variant_builder_init (&palette, G_VARIANT_TYPE ("a(dddd)"));
+    for (gsize i = 0; i < values->palette_size; ++i)
+        add_rgba (&palette, &values->palette[i]);
+
+    g_autoptr (GVariant) snapshot = g_variant_ref_sink (g_variant_new ("(sxtsa(dddd)ia(dddd)@a{sv})",
+                                                                       PACKAGE_STRING,
+                                                                       mtime,
+                                                                       size,
+                                                                       values->font ? values->font : "",
+                                                                       &colors,
+                                                                       values->scrollback,
+                                                                       &palette,
+                                                                       values->user_values ? values->user_values : g_variant_new ("a{sv}", NULL)));
+    g_autofree gchar *dir = g_path_get_dirname (path);
+
+    if (g_mkdir_with_parents (dir, 0700))
+    {
+        g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errno), "Couldn't create %s", dir);
+        return FALSE;
+    }
+
+    return g_file_set_contents (path, g_variant_get_data (snapshot), g_variant_get_size (snapshot), error);
+}
+
+void
+germinal_settings_values_clear (GerminalSettingsValues *values)
+{
+    g_return_if_fail (values != NULL);
+
+    g_clear_pointer (&values->font, g_free);
+    g_clear_pointer (&values->palette, g_free);
+    values->palette_size = 0;
+    g_clear_pointer (&values->user_values, g_variant_unref);
+}
@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <gdk/gdk.h>
+
+G_BEGIN_DECLS
+
+/* The parsed values terminals need, as found in the snapshot */
+typedef struct
+{
+    gchar   *font;
+    GdkRGBA  forecolor;
+    GdkRGBA  backcolor;
+    GdkRGBA *palette;
+    gsize    palette_size;
+    gint     scrollback;
+    /* a{sv} of every key set in the source, to answer reads before it is parsed */
+    GVariant *user_values;
+} GerminalSettingsValues;
+
+/* source is the file the settings come from, the snapshot is stale as soon as it changes */
+gboolean germinal_settings_snapshot_load  (const gchar *path, const gchar *source, GerminalSettingsValues *values);
+gboolean germinal_settings_snapshot_save  (const gchar *path, const gchar *source, const GerminalSettingsValues *values, GError **error);
+void     germinal_settings_values_clear   (GerminalSettingsValues *values);
+
+G_DEFINE_AUTO_CLEANUP_CLEAR_FUNC (GerminalSettingsValues, germinal_settings_values_clear)
+
+G_END_DECLS
@@ -2,26 +2,427 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "germinal-settings.h"
+#include "germinal-settings-backend.h"
+#include "germinal-settings-snapshot.h"
 
-#define G_SETTINGS_ENABLE_BACKEND 1
-#include <gio/gsettingsbackend.h>
+/*
+ * Every window and terminal shares the same GSettings, so that there is only
+ * one backend (and file monitor, with a keyfile) for the whole process, and
+ * the values terminals need are only parsed once, then borrowed.
+ */
+static GSettings *shared_settings;
 
-GSettings *
-germinal_settings_new (void)
+/*
+ * The shared settings are in delayed mode: edits (dragging a color, spinning
+ * the scrollback) are applied to terminals from memory right away, and only
+ * written to the backend once they stopped for that long.
+ */
+#define APPLY_DELAY_MS 500
+
+static guint apply_source_id;
+
+static struct
+{
+    PangoFontDescription *font;
+    gboolean              colors_valid;
+    GdkRGBA               forecolor;
+    GdkRGBA               backcolor;
+    gboolean              palette_valid;
+    GdkRGBA              *palette;
+    gsize                 palette_size;
+    gboolean              scrollback_valid;
+    gint                  scrollback;
+} cache;
+
+/*
+ * The values of the previous run, valid as long as the file the settings
+ * come from (the keyfile, or dconf's database) didn't change since.
+ */
+static gchar                 *snapshot_source;
+static gboolean               snapshot_valid;
+static GerminalSettingsValues snapshot;
+static guint                  snapshot_save_source_id;
+
+static gchar *
+germinal_settings_snapshot_path (void)
+{
+    return g_build_filename (g_get_user_cache_dir (), "germinal", "settings.snapshot", NULL);
+}
+
+static GVariant *
+germinal_settings_get_user_values (GSettings *settings)
+{
+    g_autoptr (GSettingsSchema) schema = NULL;
+    GVariantBuilder builder;
+
+    g_object_get (settings, "settings-schema", &schema, NULL);
+    g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+
+    g_auto (GStrv) keys = g_settings_schema_list_keys (schema);
+
+    for (guint i = 0; keys[i]; ++i)
+    {
+        g_autoptr (GVariant) value = g_settings_get_user_value (settings, keys[i]);
+
+        if (value)
+            g_variant_builder_add (&builder, "{sv}", keys[i], value);
+    }
+
+    return g_variant_ref_sink (g_variant_builder_end (&builder));
+}
+
+static gboolean
+germinal_settings_save_snapshot (gpointer user_data G_GNUC_UNUSED)
+{
+    g_autofree gchar *path = germinal_settings_snapshot_path ();
+    g_autoptr (GError) error = NULL;
+    GerminalSettingsValues values = { 0 };
+    gsize palette_size = 0;
+
+    snapshot_save_source_id = 0;
+
+    values.font = pango_font_description_to_string (germinal_settings_get_font ());
+    values.forecolor = *germinal_settings_get_forecolor ();
+    values.backcolor = *germinal_settings_get_backcolor ();
+    values.palette = (GdkRGBA *) germinal_settings_get_cached_palette (&palette_size);
+    values.palette_size = palette_size;
+    values.scrollback = germinal_settings_get_scrollback ();
+    values.user_values = germinal_settings_get_user_values (shared_settings);
+
+    if (!germinal_settings_snapshot_save (path, snapshot_source, &values, &error))
+        g_debug ("Couldn't save the settings snapshot: %s", error->message);
+
+    g_free (values.font);
+    g_variant_unref (values.user_values);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Called whenever a value had to be read from the settings rather than the snapshot */
+static void
+germinal_settings_schedule_snapshot (void)
+{
+    if (!snapshot_source || snapshot_save_source_id)
+        return;
+
+    /* Stamped with the source, which only changes once the edits are written */
+    if (shared_settings && g_settings_get_has_unapplied (shared_settings))
+        return;
+
+    snapshot_save_source_id = g_idle_add_full (G_PRIORITY_LOW, germinal_settings_save_snapshot, NULL, NULL);
+    g_source_set_name_by_id (snapshot_save_source_id, "[germinal] save-settings-snapshot");
+}
+
+static void
+germinal_settings_load_snapshot (const gchar *source)
+{
+    g_autofree gchar *path = germinal_settings_snapshot_path ();
+
+    snapshot_source = g_strdup (source);
+    snapshot_valid = germinal_settings_snapshot_load (path, source, &snapshot);
+}
+
+static void
+germinal_settings_drop_snapshot (void)
+{
+    snapshot_valid = FALSE;
+    germinal_settings_values_clear (&snapshot);
+    germinal_settings_schedule_snapshot ();
+}
+
+static gboolean
+germinal_settings_apply (gpointer user_data G_GNUC_UNUSED)
+{
+    apply_source_id = 0;
+    germinal_settings_flush ();
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+on_shared_settings_changed (GSettings   *settings,
+                            const gchar *key,
+                            gpointer     user_data G_GNUC_UNUSED)
+{
+    /* Either an edit of ours, held in memory, or something that came from the backend */
+    if (g_settings_get_has_unapplied (settings))
+    {
+        g_clear_handle_id (&apply_source_id, g_source_remove);
+        apply_source_id = g_timeout_add (APPLY_DELAY_MS, germinal_settings_apply, NULL);
+        g_source_set_name_by_id (apply_source_id, "[germinal] apply-settings");
+    }
+
+    germinal_settings_drop_snapshot ();
+
+    if (!g_strcmp0 (key, FONT_KEY))
+        g_clear_pointer (&cache.font, pango_font_description_free);
+    else if (!g_strcmp0 (key, FORECOLOR_KEY) || !g_strcmp0 (key, BACKCOLOR_KEY))
+        cache.colors_valid = FALSE;
+    else if (!g_strcmp0 (key, PALETTE_KEY))
+    {
+        g_clear_pointer (&cache.palette, g_free);
+        cache.palette_valid = FALSE;
+    }
+    else if (!g_strcmp0 (key, SCROLLBACK_KEY))
+        cache.scrollback_valid = FALSE;
+}
+
+static GSettings *
+germinal_settings_create (void)
 {
     g_autofree gchar *config_file_path = g_build_filename (g_get_user_config_dir (), "germinal", "settings", NULL);
     g_autoptr (GFile) config_file = g_file_new_for_path (config_file_path);
 
     if (g_file_query_exists (config_file, NULL /* cancellable */))
     {
-        g_autoptr (GSettingsBackend) backend = g_keyfile_settings_backend_new (config_file_path, "/org/gnome/Germinal/", "Germinal");
+        germinal_settings_load_snapshot (config_file_path);
+
+        g_autoptr (GSettingsBackend) backend = NULL;
+
+        /* The snapshot has all the values startup reads, the keyfile is only parsed once idle */
+        if (snapshot_valid)
+            backend = germinal_settings_backend_new (config_file_path, snapshot.user_values);
+        else
+            backend = g_keyfile_settings_backend_new (config_file_path, "/org/gnome/Germinal/", "Germinal");
 
         return g_settings_new_with_backend ("org.gnome.Germinal", backend);
     }
 
+    /* Other backends (memory) have nothing to validate a snapshot against */
+    g_autoptr (GSettingsBackend) default_backend = g_settings_backend_get_default ();
+    GType dconf_backend = g_type_from_name ("DConfSettingsBackend");
+
+    if (dconf_backend && g_type_is_a (G_OBJECT_TYPE (default_backend), dconf_backend))
+    {
+        g_autofree gchar *dconf_db = g_build_filename (g_get_user_config_dir (), "dconf", "user", NULL);
+
+        germinal_settings_load_snapshot (dconf_db);
+    }
+
     return g_settings_new ("org.gnome.Germinal");
 }
 
+GerminalSettingsChanges
+germinal_settings_changes_for_key (const gchar *key)
+{
+    if (!g_strcmp0 (key, AUDIBLE_BELL_KEY))
+        return GERMINAL_SETTINGS_CHANGE_BELL;
+    if (!g_strcmp0 (key, BACKCOLOR_KEY) || !g_strcmp0 (key, FORECOLOR_KEY) || !g_strcmp0 (key, PALETTE_KEY))
+        return GERMINAL_SETTINGS_CHANGE_COLORS;
+    if (!g_strcmp0 (key, FONT_KEY))
+        return GERMINAL_SETTINGS_CHANGE_FONT;
+    if (!g_strcmp0 (key, SCROLLBACK_KEY))
+        return GERMINAL_SETTINGS_CHANGE_SCROLLBACK;
+    if (!g_strcmp0 (key, WORD_CHAR_EXCEPTIONS_KEY))
+        return GERMINAL_SETTINGS_CHANGE_WORD_CHARS;
+
+    return GERMINAL_SETTINGS_CHANGE_NONE;
+}
+
+GSettings *
+germinal_settings_new (void)
+{
+    if (!shared_settings)
+    {
+        shared_settings = germinal_settings_create ();
+        g_settings_delay (shared_settings);
+        /* Connected first, so that the cache is up to date for every other handler */
+        g_signal_connect (shared_settings, "changed", G_CALLBACK (on_shared_settings_changed), NULL);
+    }
+
+    return g_object_ref (shared_settings);
+}
+
+void
+germinal_settings_flush (void)
+{
+    g_clear_handle_id (&apply_source_id, g_source_remove);
+
+    if (!shared_settings || !g_settings_get_has_unapplied (shared_settings))
+        return;
+
+    g_debug ("Writing the pending settings changes");
+    g_settings_apply (shared_settings);
+    germinal_settings_schedule_snapshot ();
+}
+
+const PangoFontDescription *
+germinal_settings_get_font (void)
+{
+    if (!cache.font)
+    {
+        g_autoptr (GSettings) settings = germinal_settings_new ();
+        g_autofree gchar *setting = snapshot_valid ? g_strdup (snapshot.font) : g_settings_get_string (settings, FONT_KEY);
+
+        cache.font = pango_font_description_from_string (setting);
+        if (!snapshot_valid)
+            germinal_settings_schedule_snapshot ();
+    }
+
+    return cache.font;
+}
+
+static void
+germinal_settings_ensure_colors (void)
+{
+    if (cache.colors_valid)
+        return;
+
+    g_autoptr (GSettings) settings = germinal_settings_new ();
+
+    if (snapshot_valid)
+    {
+        cache.forecolor = snapshot.forecolor;
+        cache.backcolor = snapshot.backcolor;
+        cache.colors_valid = TRUE;
+        return;
+    }
+
+    germinal_settings_schedule_snapshot ();
+
+    g_autofree gchar *fore_str = g_settings_get_string (settings, FORECOLOR_KEY);
+    g_autofree gchar *back_str = g_settings_get_string (settings, BACKCOLOR_KEY);
+
+    cache.forecolor = cache.backcolor = (GdkRGBA) { 0 };
+    gdk_rgba_parse (&cache.forecolor, fore_str);
+    gdk_rgba_parse (&cache.backcolor, back_str);
+    cache.colors_valid = TRUE;
+}
+
+const GdkRGBA *
+germinal_settings_get_forecolor (void)
+{
+    germinal_settings_ensure_colors ();
+
+    return &cache.forecolor;
+}
+
+const GdkRGBA *
+germinal_settings_get_backcolor (void)
+{
+    germinal_settings_ensure_colors ();
+
+    return &cache.backcolor;
+}
+
+const GdkRGBA *
+germinal_settings_get_cached_palette (gsize *palette_size)
+{
+    g_return_val_if_fail (palette_size != NULL, NULL);
+
+    if (!cache.palette_valid)
+    {
+        g_autoptr (GSettings) settings = germinal_settings_new ();
+        gsize size = snapshot.palette_size;
+        GdkRGBA *palette = snapshot_valid ? g_memdup2 (snapshot.palette, size * sizeof (GdkRGBA)) : germinal_settings_get_palette (settings, &size);
+
+        if (!snapshot_valid)
+            germinal_settings_schedule_snapshot ();
+
+        /* Resetting an invalid palette went through on_shared_settings_changed already */
+        g_free (cache.palette);
+        cache.palette = palette;
+        cache.palette_size = size;
+        cache.palette_valid = TRUE;
+    }
+
+    *palette_size = cache.palette_size;
+
+    return cache.palette;
+}
+
+gint
+germinal_settings_get_scrollback (void)
+{
+    if (!cache.scrollback_valid)
+    {
+        g_autoptr (GSettings) settings = germinal_settings_new ();
+
+        cache.scrollback = snapshot_valid ? snapshot.scrollback : g_settings_get_int (settings, SCROLLBACK_KEY);
+        cache.scrollback_valid = TRUE;
+        if (!snapshot_valid)
+            germinal_settings_schedule_snapshot ();
+    }
+
+    return cache.scrollback;
+}
+
+typedef struct
+{
+    const gchar *schema;
+    GSettings   *settings;
+    gint         natural_scroll;
+} PeripheralSettings;
+
+static void
+on_peripheral_settings_changed (GSettings   *settings G_GNUC_UNUSED,
+                                const gchar *key      G_GNUC_UNUSED,
+                                gpointer     user_data)
+{
+    PeripheralSettings *peripheral = user_data;
+
+    peripheral->natural_scroll = -1;
+}
+
+gboolean
+germinal_settings_get_natural_scroll (GdkInputSource source)
+{
+    static PeripheralSettings mouse = { "org.gnome.desktop.peripherals.mouse", NULL, -1 };
+    static PeripheralSettings touchpad = { "org.gnome.desktop.peripherals.touchpad", NULL, -1 };
+    PeripheralSettings *peripheral;
+
+    switch (source)
+    {
+        case GDK_SOURCE_MOUSE:
+            peripheral = &mouse;
+            break;
+        case GDK_SOURCE_TOUCHPAD:
+            peripheral = &touchpad;
+            break;
+        default:
+            return FALSE;
+    }
+
+    if (!peripheral->settings)
+    {
+        peripheral->settings = g_settings_new (peripheral->schema);
+        g_signal_connect (peripheral->settings, "changed::natural-scroll", G_CALLBACK (on_peripheral_settings_changed), peripheral);
+    }
+
+    if (peripheral->natural_scroll < 0)
+        peripheral->natural_scroll = g_settings_get_boolean (peripheral->settings, "natural-scroll");
+
+    return peripheral->natural_scroll;
+}
+
+gboolean
+germinal_settings_is_zero_keycode (guint keycode)
+{
+    static GArray *zero_keycodes;
+
+    if (!zero_keycodes)
+    {
+        g_autofree GdkKeymapKey *zero_keys = NULL;
+        gint n_keys = 0;
+
+        zero_keycodes = g_array_new (FALSE, FALSE, sizeof (guint));
+
+        if (gdk_display_map_keyval (gdk_display_get_default (), GDK_KEY_0, &zero_keys, &n_keys))
+        {
+            for (gint i = 0; i < n_keys; ++i)
+                g_array_append_val (zero_keycodes, zero_keys[i].keycode);
+        }
+    }
+
+    for (guint i = 0; i < zero_keycodes->len; ++i)
+    {
+        if (g_array_index (zero_keycodes, guint, i) == keycode)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
 GdkRGBA *
 germinal_settings_get_palette (GSettings *settings,
                                gsize     *palette_size)
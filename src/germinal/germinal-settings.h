@@ -12,15 +12,44 @@ G_BEGIN_DECLS
 #define AUDIBLE_BELL_KEY         "audible-bell"
 #define BACKCOLOR_KEY            "backcolor"
 #define DECORATED_KEY            "decorated"
+#define DROP_DOWN_KEY            "drop-down"
 #define FONT_KEY                 "font"
 #define FORECOLOR_KEY            "forecolor"
+#define MULTIPLEXER_KEY          "multiplexer"
 #define PALETTE_KEY              "palette"
 #define SCROLLBACK_KEY           "scrollback-lines"
+#define SPARE_WINDOWS_KEY        "spare-windows"
 #define STARTUP_COMMAND_KEY      "startup-command"
 #define TERM_KEY                 "term"
+#define TMUX_SESSIONS_KEY        "tmux-sessions"
 #define WORD_CHAR_EXCEPTIONS_KEY "word-char-exceptions"
 
+/* What terminals have to reconfigure when a key changes */
+typedef enum
+{
+    GERMINAL_SETTINGS_CHANGE_NONE       = 0,
+    GERMINAL_SETTINGS_CHANGE_BELL       = 1 << 0,
+    GERMINAL_SETTINGS_CHANGE_COLORS     = 1 << 1,
+    GERMINAL_SETTINGS_CHANGE_FONT       = 1 << 2,
+    GERMINAL_SETTINGS_CHANGE_SCROLLBACK = 1 << 3,
+    GERMINAL_SETTINGS_CHANGE_WORD_CHARS = 1 << 4,
+    GERMINAL_SETTINGS_CHANGE_ALL        = (1 << 5) - 1,
+} GerminalSettingsChanges;
+
+GerminalSettingsChanges germinal_settings_changes_for_key (const gchar *key);
+
 GSettings *germinal_settings_new         (void);
+/* Writes the edits the shared settings still only hold in memory */
+void       germinal_settings_flush       (void);
 GdkRGBA   *germinal_settings_get_palette (GSettings *settings, gsize *palette_size);
 
+/* Parsed once for the whole process, from the settings germinal_settings_new shares */
+const PangoFontDescription *germinal_settings_get_font           (void);
+const GdkRGBA              *germinal_settings_get_forecolor      (void);
+const GdkRGBA              *germinal_settings_get_backcolor      (void);
+const GdkRGBA              *germinal_settings_get_cached_palette (gsize *palette_size);
+gint                        germinal_settings_get_scrollback     (void);
+gboolean                    germinal_settings_get_natural_scroll (GdkInputSource source);
+gboolean                    germinal_settings_is_zero_keycode    (guint keycode);
+
 G_END_DECLS
@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-spawner.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ * Spawns processes on behalf of germinal, so that forking doesn't have to
+ * copy the page tables of a process holding a lot of scrollback.
+ *
+ * Reads "id\tcwd\targv..." lines on stdin and writes "id\tstatus\terror"
+ * lines on stdout once the child exits or failed to start.
+ */
+
+static GStrv       environ_template;
+static GHashTable *programs;
+static GMainLoop  *loop;
+
+static void
+reply (const gchar *id,
+       gint         status,
+       const gchar *error)
+{
+    g_autofree gchar *status_str = g_strdup_printf ("%d", status);
+    const gchar *fields[] = { id, status_str, error ? error : "", NULL };
+    g_autofree gchar *line = germinal_spawner_encode (fields);
+
+    fputs (line, stdout);
+    fputc ('\n', stdout);
+    fflush (stdout);
+}
+
+static void
+on_child_exited (GPid     pid,
+                 gint     status,
+                 gpointer user_data)
+{
+    g_autofree gchar *id = user_data;
+
+    reply (id, status, NULL);
+    g_spawn_close_pid (pid);
+}
+
+static const gchar *
+resolve_program (const gchar *name)
+{
+    if (strchr (name, '/'))
+        return name;
+
+    const gchar *path = g_hash_table_lookup (programs, name);
+
+    if (!path)
+    {
+        gchar *found = g_find_program_in_path (name);
+
+        if (!found)
+            return name;
+
+        g_hash_table_insert (programs, g_strdup (name), found);
+        path = found;
+    }
+
+    return path;
+}
+
+static void
+handle_request (const gchar *line)
+{
+    g_auto (GStrv) fields = germinal_spawner_decode (line);
+    g_autoptr (GError) error = NULL;
+    GPid pid;
+
+    if (g_strv_length (fields) < 3)
+        return;
+
+    const gchar *id = fields[0];
+    const gchar *cwd = fields[1];
+    gchar **argv = fields + 2;
+    g_autofree gchar *name = g_strdup (argv[0]);
+
+    argv[0] = g_strdup (resolve_program (name));
+
+    /* Our stdout is the reply channel, children must not write there */
+    GSpawnFlags flags = G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD | G_SPAWN_STDOUT_TO_DEV_NULL;
+    gboolean spawned = g_spawn_async (cwd, argv, environ_template, flags, NULL, NULL, &pid, &error);
+
+    /* The program may have moved since we cached its path */
+    if (!spawned && g_error_matches (error, G_SPAWN_ERROR, G_SPAWN_ERROR_NOENT) && g_hash_table_remove (programs, name))
+    {
+        g_clear_error (&error);
+        g_free (argv[0]);
+        argv[0] = g_strdup (resolve_program (name));
+        spawned = g_spawn_async (cwd, argv, environ_template, flags, NULL, NULL, &pid, &error);
+    }
+
+    if (!spawned)
+    {
+        reply (id, -1, error->message);
+        return;
+    }
+
+    g_child_watch_add (pid, on_child_exited, g_strdup (id));
+}
+
+static gboolean
+on_input (GIOChannel   *channel,
+          GIOCondition  condition G_GNUC_UNUSED,
+          gpointer      user_data G_GNUC_UNUSED)
+{
+    do
+    {
+        g_autofree gchar *line = NULL;
+        gsize terminator = 0;
+
+        switch (g_io_channel_read_line (channel, &line, NULL, &terminator, NULL))
+        {
+        case G_IO_STATUS_NORMAL:
+            line[terminator] = '\0';
+            handle_request (line);
+            break;
+        case G_IO_STATUS_AGAIN:
+            return G_SOURCE_CONTINUE;
+        default:
+            /* germinal went away */
+            g_main_loop_quit (loop);
+            return G_SOURCE_REMOVE;
+        }
+    } while (g_io_channel_get_buffer_condition (channel) & G_IO_IN);
+
+    return G_SOURCE_CONTINUE;
+}
+
+gint
+main (gint   argc G_GNUC_UNUSED,
+      gchar *argv[] G_GNUC_UNUSED)
+{
+    environ_template = g_get_environ ();
+    programs = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr (GIOChannel) channel = g_io_channel_unix_new (STDIN_FILENO);
+    g_io_channel_set_encoding (channel, NULL, NULL);
+    g_io_add_watch (channel, G_IO_IN | G_IO_HUP | G_IO_ERR, on_input, NULL);
+
+    g_main_loop_run (loop);
+
+    g_main_loop_unref (loop);
+    g_hash_table_unref (programs);
+    g_strfreev (environ_template);
+
+    return 0;
+}
@@ -0,0 +1,447 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-spawner.h"
+
+#include <glib/gi18n-lib.h>
+
+/*
+ * Launches processes that are not attached to a terminal (urls, one-shot
+ * tmux commands) through germinal-spawn-helper, started while we are still
+ * small. Forking the main process instead gets slower as scrollback grows.
+ */
+
+struct _GerminalSpawner
+{
+    GObject parent_instance;
+};
+
+typedef struct
+{
+    GerminalSpawnCallback callback;
+    gpointer              user_data;
+} GerminalSpawnRequest;
+
+typedef struct
+{
+    GSubprocess      *helper;
+    GOutputStream    *input;
+    GDataInputStream *output;
+    GCancellable     *cancellable;
+
+    /* Data waiting for the previous write to complete */
+    GString          *outbox;
+    gchar            *writing;
+
+    GHashTable       *requests;
+    guint             next_id;
+
+    /* For the in-process fallback */
+    GStrv             environ;
+
+    GHashTable       *uri_handlers;
+} GerminalSpawnerPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GerminalSpawner, germinal_spawner, G_TYPE_OBJECT)
+
+gchar *
+germinal_spawner_encode (const gchar * const *fields)
+{
+    g_return_val_if_fail (fields != NULL, NULL);
+
+    GString *line = g_string_new (NULL);
+
+    for (guint i = 0; fields[i]; ++i)
+    {
+        g_autofree gchar *field = g_strescape (fields[i], NULL);
+
+        if (i)
+            g_string_append_c (line, '\t');
+        g_string_append (line, field);
+    }
+
+    return g_string_free (line, FALSE);
+}
+
+GStrv
+germinal_spawner_decode (const gchar *line)
+{
+    g_return_val_if_fail (line != NULL, NULL);
+
+    GStrv fields = g_strsplit (line, "\t", -1);
+
+    for (guint i = 0; fields[i]; ++i)
+    {
+        gchar *field = g_strcompress (fields[i]);
+
+        g_free (fields[i]);
+        fields[i] = field;
+    }
+
+    return fields;
+}
+
+static void
+finish_request (GerminalSpawnRequest *request,
+                gint                  status,
+                const gchar          *error)
+{
+    if (request->callback)
+        request->callback (status, error, request->user_data);
+    g_free (request);
+}
+
+static void
+on_helper_gone (GerminalSpawner *self)
+{
+    GerminalSpawnerPrivate *priv = germinal_spawner_get_instance_private (self);
+    GHashTableIter iter;
+    gpointer request;
+
+    if (!priv->helper)
+        return;
+
+    g_debug ("spawn helper gone, spawning from the main process from now on");
+
+    g_clear_object (&priv->input);
+    g_clear_object (&priv->output);
+    g_clear_object (&priv->helper);
+
+    g_hash_table_iter_init (&iter, priv->requests);
+    while (g_hash_table_iter_next (&iter, NULL, &request))
+    {
+        g_hash_table_iter_steal (&iter);
+        finish_request (request, -1, _("The spawn helper exited"));
+    }
+}
+
+static void
+on_line_read (GObject      *source,
+              GAsyncResult *result,
+              gpointer      user_data)
+{
+    g_autoptr (GError) error = NULL;
+    g_autofree gchar *line = g_data_input_stream_read_line_finish (G_DATA_INPUT_STREAM (source), result, NULL, &error);
+
+    if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        return;
+
+    GerminalSpawner *self = GERMINAL_SPAWNER (user_data);
+    GerminalSpawnerPrivate *priv = germinal_spawner_get_instance_private (self);
+
+    if (!line)
+    {
+        on_helper_gone (self);
+        return;
+    }
+
+    /* id, status, error */
+    g_auto (GStrv) fields = germinal_spawner_decode (line);
+
+    if (g_strv_length (fields) == 3)
+    {
+        guint id = (guint) g_ascii_strtoull (fields[0], NULL, 10);
+        GerminalSpawnRequest *request = g_hash_table_lookup (priv->requests, GUINT_TO_POINTER (id));
+
+        if (request)
+        {
+            g_hash_table_steal (priv->requests, GUINT_TO_POINTER (id));
+            finish_request (request, (gint) g_ascii_strtoll (fields[1], NULL, 10), *fields[2] ? fields[2] : NULL);
+        }
+    }
+
+    g_data_input_stream_read_line_async (priv->output, G_PRIORITY_DEFAULT, priv->cancellable, on_line_read, self);
+}
+
+static void flush_outbox (GerminalSpawner *self);
+
+static void
+on_written (GObject      *source,
+            GAsyncResult *result,
+            gpointer      user_data)
+{
+    g_autoptr (GError) error = NULL;
+
+    if (!g_output_stream_write_all_finish (G_OUTPUT_STREAM (source), result, NULL, &error))
+    {
+        if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+            on_helper_gone (GERMINAL_SPAWNER (user_data));
+        return;
+    }
+
+    GerminalSpawnerPrivate *priv = germinal_spawner_get_instance_private (GERMINAL_SPAWNER (user_data));
+
+    g_clear_pointer (&priv->writing, g_free);
+    flush_outbox (GERMINAL_SPAWNER (user_data));
+}
+
+static void
+flush_outbox (GerminalSpawner *self)
+{
+    GerminalSpawnerPrivate *priv = germinal_spawner_get_instance_private (self);
+
+    if (priv->writing || !priv->outbox->len || !priv->input)
+        return;
+
+    gsize len = priv->outbox->len;
+
+    priv->writing = g_string_free (g_steal_pointer (&priv->outbox), FALSE);
+    priv->outbox = g_string_new (NULL);
+
+    g_output_stream_write_all_async (priv->input, priv->writing, len, G_PRIORITY_DEFAULT, priv->cancellable, on_written, self);
+}
+
+static void
+on_child_exited (GPid     pid,
+                 gint     status,
+                 gpointer user_data)
+{
+    finish_request (user_data, status, NULL);
+    g_spawn_close_pid (pid);
+}
+
+static void
+spawn_in_process (GerminalSpawner      *self,
+                  const gchar * const  *argv,
+                  GerminalSpawnRequest *request)
+{
+    GerminalSpawnerPrivate *priv = germinal_spawner_get_instance_private (self);
+    g_autoptr (GError) error = NULL;
+    GPid pid;
+
+    if (!g_spawn_async (g_get_home_dir (), (gchar **) argv, priv->environ, G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD,
+                        NULL, NULL, &pid, &error))
+    {
+        finish_request (request, -1, error->message);
+        return;
+    }
+
+    g_child_watch_add (pid, on_child_exited, request);
+}
+
+void
+germinal_spawner_spawn (GerminalSpawner       *self,
+                        const gchar * const   *argv,
+                        GerminalSpawnCallback  callback,
+                        gpointer               user_data)
+{
+    g_return_if_fail (GERMINAL_IS_SPAWNER (self));
+    g_return_if_fail (argv != NULL && argv[0] != NULL);
+
+    GerminalSpawnerPrivate *priv = germinal_spawner_get_instance_private (self);
+    GerminalSpawnRequest *request = g_new (GerminalSpawnRequest, 1);
+
+    request->callback = callback;
+    request->user_data = user_data;
+
+    if (!priv->helper)
+    {
+        spawn_in_process (self, argv, request);
+        return;
+    }
+
+    guint id = ++priv->next_id;
+    g_autofree gchar *id_str = g_strdup_printf ("%u", id);
+    g_autoptr (GStrvBuilder) builder = g_strv_builder_new ();
+
+    /* id, working directory, argv */
+    g_strv_builder_add (builder, id_str);
+    g_strv_builder_add (builder, g_get_home_dir ());
+    g_strv_builder_addv (builder, (const gchar **) argv);
+
+    g_auto (GStrv) fields = g_strv_builder_end (builder);
+    g_autofree gchar *line = germinal_spawner_encode ((const gchar * const *) fields);
+
+    g_hash_table_insert (priv->requests, GUINT_TO_POINTER (id), request);
+    g_string_append (priv->outbox, line);
+    g_string_append_c (priv->outbox, '\n');
+    flush_outbox (self);
+}
+
+static void
+on_uri_opened (gint         status G_GNUC_UNUSED,
+               const gchar *error,
+               gpointer     user_data)
+{
+    g_autofree gchar *uri = user_data;
+
+    if (error)
+        g_warning ("%s \"%s\": %s", _("Couldn't open"), uri, error);
+}
+
+static GAppInfo *
+germinal_spawner_get_uri_handler (GerminalSpawner *self,
+                                  const gchar     *uri)
+{
+    GerminalSpawnerPrivate *priv = germinal_spawner_get_instance_private (self);
+    g_autofree gchar *scheme = g_uri_parse_scheme (uri);
+    const gchar *key = scheme ? scheme : "";
+    GAppInfo *info = g_hash_table_lookup (priv->uri_handlers, key);
+
+    if (info)
+        return info;
+
+    const gchar *browser = g_getenv ("BROWSER");
+
+    /* BROWSER wins, then whatever handles the scheme, then xdg-open or firefox as before */
+    if (browser)
+        info = g_app_info_create_from_commandline (browser, NULL, G_APP_INFO_CREATE_SUPPORTS_URIS, NULL);
+    if (!info && scheme)
+        info = g_app_info_get_default_for_uri_scheme (scheme);
+    if (!info)
+    {
+        g_autofree gchar *xdg_open = g_find_program_in_path ("xdg-open");
+
+        info = g_app_info_create_from_commandline (xdg_open ? xdg_open : "firefox", NULL, G_APP_INFO_CREATE_SUPPORTS_URIS, NULL);
+    }
+
+    if (info)
+        g_hash_table_insert (priv->uri_handlers, g_strdup (key), info);
+
+    return info;
+}
+
+/* Expands the desktop entry field codes of the handler's command line for uri */
+static GStrv
+get_uri_argv (GAppInfo    *info,
+              const gchar *uri)
+{
+    const gchar *commandline = g_app_info_get_commandline (info);
+    g_auto (GStrv) args = NULL;
+    gboolean has_uri = FALSE;
+
+    if (!commandline || !g_shell_parse_argv (commandline, NULL, &args, NULL))
+        return NULL;
+
+    g_autoptr (GStrvBuilder) builder = g_strv_builder_new ();
+
+    for (guint i = 0; args[i]; ++i)
+    {
+        const gchar *arg = args[i];
+
+        if (!g_strcmp0 (arg, "%u") || !g_strcmp0 (arg, "%U") || !g_strcmp0 (arg, "%f") || !g_strcmp0 (arg, "%F"))
+        {
+            g_strv_builder_add (builder, uri);
+            has_uri = TRUE;
+        }
+        /* Other field codes and flatpak's @@u markers */
+        else if (!(arg[0] == '%' && arg[1] && !arg[2]) && g_strcmp0 (arg, "@@u") && g_strcmp0 (arg, "@@"))
+            g_strv_builder_add (builder, arg);
+    }
+
+    if (!has_uri)
+        g_strv_builder_add (builder, uri);
+
+    return g_strv_builder_end (builder);
+}
+
+void
+germinal_spawner_open_uri (GerminalSpawner *self,
+                           const gchar     *uri)
+{
+    g_return_if_fail (GERMINAL_IS_SPAWNER (self));
+    g_return_if_fail (uri != NULL);
+
+    GAppInfo *info = germinal_spawner_get_uri_handler (self, uri);
+    g_auto (GStrv) argv = info ? get_uri_argv (info, uri) : NULL;
+
+    if (!argv)
+    {
+        g_warning ("%s \"%s\"", _("Couldn't open"), uri);
+        return;
+    }
+
+    germinal_spawner_spawn (self, (const gchar * const *) argv, on_uri_opened, g_strdup (uri));
+}
+
+static void
+germinal_spawner_start_helper (GerminalSpawner *self)
+{
+    GerminalSpawnerPrivate *priv = germinal_spawner_get_instance_private (self);
+    const gchar *path = g_getenv ("GERMINAL_SPAWN_HELPER");
+    g_autoptr (GError) error = NULL;
+
+    if (!path)
+        path = LIBEXECDIR G_DIR_SEPARATOR_S "germinal-spawn-helper";
+
+    priv->helper = g_subprocess_new (G_SUBPROCESS_FLAGS_STDIN_PIPE | G_SUBPROCESS_FLAGS_STDOUT_PIPE, &error, path, NULL);
+
+    if (!priv->helper)
+    {
+        g_debug ("Couldn't start the spawn helper: %s", error->message);
+        return;
+    }
+
+    priv->input = g_object_ref (g_subprocess_get_stdin_pipe (priv->helper));
+    priv->output = g_data_input_stream_new (g_subprocess_get_stdout_pipe (priv->helper));
+
+    g_data_input_stream_read_line_async (priv->output, G_PRIORITY_DEFAULT, priv->cancellable, on_line_read, self);
+}
+
+static void
+germinal_spawner_dispose (GObject *object)
+{
+    GerminalSpawnerPrivate *priv = germinal_spawner_get_instance_private (GERMINAL_SPAWNER (object));
+
+    g_cancellable_cancel (priv->cancellable);
+
+    /* The helper exits once its stdin is closed */
+    if (priv->input)
+        g_output_stream_close (priv->input, NULL, NULL);
+
+    g_clear_object (&priv->input);
+    g_clear_object (&priv->output);
+    g_clear_object (&priv->helper);
+    g_clear_pointer (&priv->uri_handlers, g_hash_table_unref);
+
+    G_OBJECT_CLASS (germinal_spawner_parent_class)->dispose (object);
+}
+
+static void
+germinal_spawner_finalize (GObject *object)
+{
+    GerminalSpawnerPrivate *priv = germinal_spawner_get_instance_private (GERMINAL_SPAWNER (object));
+
+    g_hash_table_unref (priv->requests);
+    g_string_free (priv->outbox, TRUE);
+    g_free (priv->writing);
+    g_strfreev (priv->environ);
+    g_object_unref (priv->cancellable);
+
+    G_OBJECT_CLASS (germinal_spawner_parent_class)->finalize (object);
+}
+
+static void
+germinal_spawner_init (GerminalSpawner *self)
+{
+    GerminalSpawnerPrivate *priv = germinal_spawner_get_instance_private (self);
+
+    priv->cancellable = g_cancellable_new ();
+    priv->outbox = g_string_new (NULL);
+    priv->requests = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+    priv->environ = g_get_environ ();
+    priv->uri_handlers = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+
+    germinal_spawner_start_helper (self);
+}
+
+static void
+germinal_spawner_class_init (GerminalSpawnerClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    object_class->dispose  = germinal_spawner_dispose;
+    object_class->finalize = germinal_spawner_finalize;
+}
+
+/* Call early, the helper is forked from whatever size we are at the first call */
+GerminalSpawner *
+germinal_spawner_get_default (void)
+{
+    static GerminalSpawner *spawner;
+
+    if (!spawner)
+        spawner = g_object_new (GERMINAL_TYPE_SPAWNER, NULL);
+
+    return spawner;
+}
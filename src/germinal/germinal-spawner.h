@@ -0,0 +1,26 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define GERMINAL_TYPE_SPAWNER germinal_spawner_get_type ()
+G_DECLARE_FINAL_TYPE (GerminalSpawner, germinal_spawner, GERMINAL, SPAWNER, GObject)
+
+/* status is the wait status of the child, or -1 with error set if it couldn't be spawned */
+typedef void (*GerminalSpawnCallback) (gint         status,
+                                       const gchar *error,
+                                       gpointer     user_data);
+
+GerminalSpawner *germinal_spawner_get_default (void);
+void             germinal_spawner_spawn       (GerminalSpawner *self, const gchar * const *argv, GerminalSpawnCallback callback, gpointer user_data);
+void             germinal_spawner_open_uri    (GerminalSpawner *self, const gchar *uri);
+
+/* Line protocol shared with germinal-spawn-helper */
+gchar           *germinal_spawner_encode      (const gchar * const *fields);
+GStrv            germinal_spawner_decode      (const gchar *line);
+
+G_END_DECLS
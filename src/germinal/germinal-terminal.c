@@ -2,12 +2,23 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "germinal-terminal.h"
+#include "germinal-clipboard-provider.h"
+#include "germinal-font-warmup.h"
+#include "germinal-match-counter.h"
+#include "germinal-paste.h"
+#include "germinal-regex-cache.h"
+#include "germinal-scrollback-index.h"
 #include "germinal-settings.h"
+#include "germinal-spawner.h"
+#include "germinal-timings.h"
 #include "germinal-util.h"
 
 #define PCRE2_CODE_UNIT_WIDTH 0
 #include <pcre2.h>
 
+#include <signal.h>
+#include <string.h>
+
 struct _GerminalTerminal
 {
     VteTerminal parent_instance;
@@ -16,24 +27,115 @@ struct _GerminalTerminal
 typedef struct
 {
     GSettings *settings;
-    GSettings *mouse_settings;
-    GSettings *touchpad_settings;
+
+    GerminalTmux     *tmux;
+    gchar            *tmux_session;
+    GStrv             tmux_globals;
+    GerminalPtyChild *pty_child;
+    guint             child_resizes;
+
+    GerminalSettingsChanges pending_changes;
+    guint                   apply_settings_id;
+    guint                   reconfigurations;
 
     gchar     *url;
-    guint     *zero_keycodes;
-    guint      n_zero_keycodes;
+
+    /* What is highlighted, and what will be once typing stops */
+    gchar     *search_text;
+    gboolean   search_regex;
+    gchar     *pending_search;
+    gboolean   pending_regex;
+    guint      search_source_id;
+
+    /*
+     * Every match of the search, counted from copies of the rows. Rows above
+     * stable_end were already off screen when copied and can't change anymore.
+     */
+    GerminalMatchCounter *match_counter;
+    GPtrArray            *snapshot_rows;
+    gint64                snapshot_first;
+    gint64                snapshot_next;
+    gint64                rescan_from;
+    gint64                stable_end;
+    guint                 snapshot_id;
+
+    /* vte doesn't tell where its match is, so follow along */
+    gint64     match_row;
+    guint      match_nth;
+    gint64     locate_from;
+
+    /* Our rows in the index of every scrollback, from index_next on they may still change */
+    guint      index_document;
+    gint64     index_next;
+    guint      index_source_id;
+    gboolean   index_delayed;
+
+    /* What was last copied, while it still waits for someone to paste it */
+    GerminalClipboardProvider *pending_copy;
+
+    /* The paste still being fed to the pty, if any, and those waiting for it */
+    GCancellable *paste_cancellable;
+    gsize         paste_done;
+    gsize         paste_total;
+    GQueue        paste_queue;
+    gboolean      paste_bracketed;
+
+    /* A middle click vte is handling, pasted afterwards unless the application got it */
+    gulong        middle_click_commit_id;
+    guint         middle_click_source_id;
+    gboolean      middle_click_reported;
 
     GSignalGroup *settings_signals;
 } GerminalTerminalPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (GerminalTerminal, germinal_terminal, VTE_TYPE_TERMINAL)
 
+enum
+{
+    SIGNAL_SEARCH_CHANGED,
+    SIGNAL_PASTE_PROGRESS,
+    SIGNAL_PASTE_FINISHED,
+
+    N_SIGNALS
+};
+
+static guint signals[N_SIGNALS];
+
+/*
+ * Each search goes through the whole scrollback on the main thread, so with
+ * a large one, only search once typing stopped for that long.
+ */
+#define SEARCH_DELAY_MS          80
+#define SEARCH_IMMEDIATE_ROWS  2000
+
+/* Rows copied for the match counter per idle, so that input goes on */
+#define SNAPSHOT_CHUNK_ROWS    1000
+#define MATCH_MARKER_WIDTH        4
+
+/* Rows indexed per idle for the search across terminals, and how long the screen may go without */
+#define INDEX_CHUNK_ROWS        500
+#define INDEX_DELAY_MS          500
+
+/* The first window's command, started from main while GTK initializes */
+typedef struct
+{
+    GStrv             command;
+    VtePty           *pty;
+    GPid              pid;
+    gboolean          spawned;
+    gboolean          adopted;
+    gboolean          dropped;
+    GerminalTerminal *terminal;
+} GerminalPrespawn;
+
+static GerminalPrespawn *prespawn;
+
 static void
-update_scrollback (GSettings   *settings,
-                   const gchar *key,
+update_scrollback (GSettings   *settings G_GNUC_UNUSED,
+                   const gchar *key      G_GNUC_UNUSED,
                    gpointer     user_data)
 {
-    vte_terminal_set_scrollback_lines (VTE_TERMINAL (user_data), g_settings_get_int (settings, key));
+    vte_terminal_set_scrollback_lines (VTE_TERMINAL (user_data), germinal_settings_get_scrollback ());
 }
 
 static void
@@ -55,47 +157,99 @@ update_bell (GSettings   *settings,
 }
 
 static void
-update_font (GSettings   *settings,
-             const gchar *key,
+update_font (GSettings   *settings G_GNUC_UNUSED,
+             const gchar *key      G_GNUC_UNUSED,
              gpointer     user_data)
 {
-    g_autofree gchar *setting = g_settings_get_string (settings, key);
-    g_autoptr (PangoFontDescription) font = pango_font_description_from_string (setting);
+    const PangoFontDescription *font = germinal_settings_get_font ();
 
     vte_terminal_set_font (VTE_TERMINAL (user_data), font);
+    germinal_font_warmup (GTK_WIDGET (user_data), font);
 }
 
 static void
-update_colors (GSettings   *settings,
-               const gchar *key G_GNUC_UNUSED,
+update_colors (GSettings   *settings G_GNUC_UNUSED,
+               const gchar *key      G_GNUC_UNUSED,
                gpointer     user_data)
 {
-    g_autofree gchar *fore_str = g_settings_get_string (settings, FORECOLOR_KEY);
-    g_autofree gchar *back_str = g_settings_get_string (settings, BACKCOLOR_KEY);
-    GdkRGBA forecolor = { 0 }, backcolor = { 0 };
-    gdk_rgba_parse (&forecolor, fore_str);
-    gdk_rgba_parse (&backcolor, back_str);
-
     gsize palette_size = 0;
-    g_autofree GdkRGBA *palette = germinal_settings_get_palette (settings, &palette_size);
+    const GdkRGBA *palette = germinal_settings_get_cached_palette (&palette_size);
 
     if (palette)
-        vte_terminal_set_colors (VTE_TERMINAL (user_data), &forecolor, &backcolor, palette, palette_size);
+        vte_terminal_set_colors (VTE_TERMINAL (user_data),
+                                 germinal_settings_get_forecolor (),
+                                 germinal_settings_get_backcolor (),
+                                 palette,
+                                 palette_size);
+}
+
+static void
+germinal_terminal_apply_settings (GerminalTerminal        *self,
+                                  GerminalSettingsChanges  changes)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+    GSettings *settings = priv->settings;
+
+    if (changes & GERMINAL_SETTINGS_CHANGE_BELL)
+        update_bell (settings, AUDIBLE_BELL_KEY, self);
+    if (changes & GERMINAL_SETTINGS_CHANGE_COLORS)
+        update_colors (settings, NULL, self);
+    if (changes & GERMINAL_SETTINGS_CHANGE_FONT)
+        update_font (settings, FONT_KEY, self);
+    if (changes & GERMINAL_SETTINGS_CHANGE_SCROLLBACK)
+        update_scrollback (settings, SCROLLBACK_KEY, self);
+    if (changes & GERMINAL_SETTINGS_CHANGE_WORD_CHARS)
+        update_word_char_exceptions (settings, WORD_CHAR_EXCEPTIONS_KEY, self);
 }
 
 static gboolean
-germinal_terminal_is_zero (GerminalTerminal *self,
-                           guint             keycode)
+apply_pending_settings (GtkWidget     *widget,
+                        GdkFrameClock *frame_clock G_GNUC_UNUSED,
+                        gpointer       user_data   G_GNUC_UNUSED)
 {
+    GerminalTerminal *self = GERMINAL_TERMINAL (widget);
     GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+    GerminalSettingsChanges changes = priv->pending_changes;
 
-    for (guint i = 0; i < priv->n_zero_keycodes; ++i)
-    {
-        if (priv->zero_keycodes[i] == keycode)
-            return TRUE;
-    }
+    priv->pending_changes = GERMINAL_SETTINGS_CHANGE_NONE;
+    priv->apply_settings_id = 0;
+
+    germinal_terminal_apply_settings (self, changes);
+    g_debug ("Applied settings changes 0x%x (%u reconfigurations)", changes, ++priv->reconfigurations);
+
+    return G_SOURCE_REMOVE;
+}
+
+/*
+ * A theme switch changes several keys at once, collect them and reconfigure
+ * once, on the next frame, rather than once per key.
+ */
+static void
+on_settings_changed (GSettings   *settings G_GNUC_UNUSED,
+                     const gchar *key,
+                     gpointer     user_data)
+{
+    GerminalTerminal *self = GERMINAL_TERMINAL (user_data);
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+    GerminalSettingsChanges changes = germinal_settings_changes_for_key (key);
+
+    if (!changes)
+        return;
+
+    priv->pending_changes |= changes;
+
+    if (!priv->apply_settings_id)
+        priv->apply_settings_id = gtk_widget_add_tick_callback (GTK_WIDGET (self), apply_pending_settings, NULL, NULL);
+}
+
+guint
+germinal_terminal_get_reconfigurations (GerminalTerminal *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_TERMINAL (self), 0);
+
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
 
-    return FALSE;
+    return priv->reconfigurations;
 }
 
 const gchar *
@@ -132,43 +286,11 @@ germinal_terminal_open_url (GerminalTerminal *self)
     if (!url)
         return FALSE;
 
-    g_autoptr (GError) error = NULL;
-    g_autofree gchar *browser = g_strdup (g_getenv ("BROWSER"));
-
-    /* If BROWSER is not in env, try xdg-open or fallback to firefox */
-    if (!browser)
-        browser = g_find_program_in_path ("xdg-open");
-    if (!browser)
-        browser = g_strdup ("firefox");
-
-    gchar *cmd[] = {browser, (gchar *) url, NULL};
-
-    if (!germinal_terminal_spawn (self, cmd, &error))
-        g_warning ("%s \"%s %s\": %s", _("Couldn't exec"), browser, url, error->message);
+    germinal_spawner_open_uri (germinal_spawner_get_default (), url);
 
     return TRUE;
 }
 
-gboolean
-germinal_terminal_spawn (GerminalTerminal *self,
-                         gchar           **cmd,
-                         GError          **error)
-{
-    g_return_val_if_fail (GERMINAL_IS_TERMINAL (self), FALSE);
-    g_return_val_if_fail (cmd != NULL, FALSE);
-
-    g_auto (GStrv) env = g_get_environ ();
-
-    return g_spawn_async (g_get_home_dir (),
-                          cmd,
-                          env,
-                          G_SPAWN_SEARCH_PATH,
-                          NULL, /* child setup */
-                          NULL, /* child setup data */
-                          NULL, /* child pid */
-                          error);
-}
-
 #define ZOOM_FACTOR 1.2
 
 void
@@ -212,6 +334,151 @@ on_terminal_command_spawned (VteTerminal *terminal  G_GNUC_UNUSED,
     }
 }
 
+static GStrv
+germinal_terminal_get_envp (GSettings *settings)
+{
+    g_autofree gchar *term = g_settings_get_string (settings, TERM_KEY);
+
+    return g_environ_setenv (g_get_environ (), "TERM", term, TRUE);
+}
+
+static void
+germinal_prespawn_free (GerminalPrespawn *p)
+{
+    g_strfreev (p->command);
+    g_clear_object (&p->pty);
+    g_clear_weak_pointer (&p->terminal);
+    g_free (p);
+}
+
+static void
+germinal_prespawn_kill (GerminalPrespawn *p)
+{
+    if (p->pid <= 0)
+        return;
+
+    kill (p->pid, SIGHUP);
+    /* Only reaps it if the main loop still runs, init does otherwise */
+    g_child_watch_add (p->pid, (GChildWatchFunc) g_spawn_close_pid, NULL);
+}
+
+static void
+on_prespawned (GObject      *source,
+               GAsyncResult *result,
+               gpointer      user_data)
+{
+    GerminalPrespawn *p = user_data;
+    g_autoptr (GError) error = NULL;
+
+    p->spawned = TRUE;
+
+    if (!vte_pty_spawn_finish (VTE_PTY (source), result, &p->pid, &error))
+    {
+        p->pid = -1;
+        g_debug ("Couldn't start the startup command early: %s", error->message);
+    }
+
+    /* Nobody adopted it yet, this will be looked at then */
+    if (!p->adopted && !p->dropped)
+        return;
+
+    if (p->terminal && p->pid > 0)
+        vte_terminal_watch_child (VTE_TERMINAL (p->terminal), p->pid);
+    else if (p->terminal)
+        on_terminal_command_spawned (VTE_TERMINAL (p->terminal), -1, error, NULL);
+    else
+        germinal_prespawn_kill (p);
+
+    germinal_prespawn_free (p);
+}
+
+void
+germinal_terminal_prespawn (GStrv command)
+{
+    g_return_if_fail (command && command[0]);
+    g_return_if_fail (!prespawn);
+
+    g_autoptr (GSettings) settings = germinal_settings_new ();
+    g_auto (GStrv) envp = germinal_terminal_get_envp (settings);
+    g_autoptr (GError) error = NULL;
+    g_autoptr (VtePty) pty = vte_pty_new_sync (VTE_PTY_DEFAULT, NULL, &error);
+
+    if (!pty)
+    {
+        g_debug ("Couldn't start the startup command early: %s", error->message);
+        g_strfreev (command);
+        return;
+    }
+
+    germinal_timings_mark (GERMINAL_TIMING_PTY_OPENED);
+
+    prespawn = g_new0 (GerminalPrespawn, 1);
+    prespawn->command = command;
+    prespawn->pty = g_steal_pointer (&pty);
+    prespawn->pid = -1;
+
+    /* Until a terminal adopts the pty, the kernel buffers whatever the child writes */
+    vte_pty_spawn_async (prespawn->pty, g_get_home_dir (), command, envp, G_SPAWN_SEARCH_PATH,
+                         NULL,  /* child_setup */
+                         NULL,  /* child_setup_data */
+                         NULL,  /* child_setup_data_destroy */
+                         -1,    /* timeout */
+                         NULL,  /* cancellable */
+                         on_prespawned,
+                         prespawn);
+}
+
+void
+germinal_terminal_drop_prespawn (void)
+{
+    GerminalPrespawn *p = g_steal_pointer (&prespawn);
+
+    if (!p)
+        return;
+
+    /* Still spawning, on_prespawned will clean up */
+    if (!p->spawned)
+    {
+        p->dropped = TRUE;
+        return;
+    }
+
+    germinal_prespawn_kill (p);
+    germinal_prespawn_free (p);
+}
+
+static gboolean
+germinal_terminal_adopt_prespawn (GerminalTerminal *self,
+                                  GStrv             command)
+{
+    if (!prespawn || !g_strv_equal ((const gchar * const *) prespawn->command, (const gchar * const *) command))
+        return FALSE;
+
+    /* It couldn't start, let the usual path report why */
+    if (prespawn->spawned && prespawn->pid <= 0)
+    {
+        germinal_terminal_drop_prespawn ();
+        return FALSE;
+    }
+
+    GerminalPrespawn *p = g_steal_pointer (&prespawn);
+
+    g_debug ("Adopting the startup command started early");
+    vte_terminal_set_pty (VTE_TERMINAL (self), p->pty);
+
+    if (!p->spawned)
+    {
+        p->adopted = TRUE;
+        g_set_weak_pointer (&p->terminal, self);
+        return TRUE;
+    }
+
+    vte_terminal_watch_child (VTE_TERMINAL (self), p->pid);
+    germinal_prespawn_free (p);
+
+    return TRUE;
+}
+
 void
 germinal_terminal_spawn_command (GerminalTerminal *self,
                                  GStrv             command_override)
@@ -233,8 +500,12 @@ germinal_terminal_spawn_command (GerminalTerminal *self,
         }
     }
 
-    g_autofree gchar *term = g_settings_get_string (priv->settings, TERM_KEY);
-    g_auto (GStrv) envp = g_environ_setenv (g_get_environ (), "TERM", term, TRUE);
+    priv->child_resizes = 0;
+
+    if (germinal_terminal_adopt_prespawn (self, command))
+        return;
+
+    g_auto (GStrv) envp = germinal_terminal_get_envp (priv->settings);
 
     vte_terminal_spawn_async (VTE_TERMINAL (self), VTE_PTY_DEFAULT, g_get_home_dir (), command, envp, G_SPAWN_SEARCH_PATH,
                               NULL,  /* child_setup */
@@ -244,6 +515,154 @@ germinal_terminal_spawn_command (GerminalTerminal *self,
                               NULL,  /* cancellable */
                               on_terminal_command_spawned,
                               NULL);
+    /* vte opened the pty synchronously, only the fork happens asynchronously */
+    germinal_timings_mark (GERMINAL_TIMING_PTY_OPENED);
+}
+
+void
+germinal_terminal_attach (GerminalTerminal *self,
+                          GerminalPtyChild *child)
+{
+    g_return_if_fail (GERMINAL_IS_TERMINAL (self));
+    g_return_if_fail (GERMINAL_IS_PTY_CHILD (child));
+
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    /* The child is already running, child reaps it rather than VteTerminal */
+    g_set_object (&priv->pty_child, child);
+    priv->child_resizes = 0;
+    vte_terminal_set_pty (VTE_TERMINAL (self), germinal_pty_child_get_pty (child));
+}
+
+GerminalPtyChild *
+germinal_terminal_get_pty_child (GerminalTerminal *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_TERMINAL (self), NULL);
+
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    return priv->pty_child;
+}
+
+guint
+germinal_terminal_get_child_resizes (GerminalTerminal *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_TERMINAL (self), 0);
+
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    return priv->child_resizes;
+}
+
+static void germinal_terminal_schedule_snapshot (GerminalTerminal *self, gint64 from);
+static void germinal_terminal_schedule_index (GerminalTerminal *self, gint64 from);
+static void on_index_started (GerminalScrollbackIndex *index, gpointer user_data);
+static void germinal_terminal_settle_copy (GerminalTerminal *self);
+static void germinal_terminal_end_bracketed_paste (GerminalTerminal *self);
+static void germinal_terminal_release_primary_paste (GerminalTerminal *self, gboolean paste);
+
+static void
+germinal_terminal_size_allocate (GtkWidget *widget,
+                                 gint       width,
+                                 gint       height,
+                                 gint       baseline)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (GERMINAL_TERMINAL (widget));
+    VteTerminal *terminal = VTE_TERMINAL (widget);
+    glong columns = vte_terminal_get_column_count (terminal);
+    glong rows = vte_terminal_get_row_count (terminal);
+
+    GTK_WIDGET_CLASS (germinal_terminal_parent_class)->size_allocate (widget, width, height, baseline);
+
+    /* Rows were rewrapped, whatever was counted or indexed is off */
+    if (columns != vte_terminal_get_column_count (terminal))
+    {
+        germinal_terminal_schedule_snapshot (GERMINAL_TERMINAL (widget), G_MININT64);
+        germinal_terminal_schedule_index (GERMINAL_TERMINAL (widget), G_MININT64);
+    }
+
+    /* vte forwards any grid change to the pty, which the child gets as SIGWINCH */
+    if (!vte_terminal_get_pty (terminal))
+        return;
+
+    if (columns == vte_terminal_get_column_count (terminal) && rows == vte_terminal_get_row_count (terminal))
+        return;
+
+    g_debug ("Child resized from %ldx%ld to %ldx%ld (%u resizes)",
+             columns, rows, vte_terminal_get_column_count (terminal), vte_terminal_get_row_count (terminal), ++priv->child_resizes);
+}
+
+/* Where the matches are in the scrollback, along the right edge */
+static void
+germinal_terminal_snapshot_matches (GerminalTerminal *self,
+                                    GtkSnapshot      *snapshot)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+    const GArray *rows = priv->match_counter ? germinal_match_counter_get_rows (priv->match_counter) : NULL;
+
+    if (!priv->search_text || !rows || !rows->len)
+        return;
+
+    GtkAdjustment *vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (self));
+    gdouble lower = gtk_adjustment_get_lower (vadjustment);
+    gdouble range = gtk_adjustment_get_upper (vadjustment) - lower;
+    gint width = gtk_widget_get_width (GTK_WIDGET (self));
+    gint height = gtk_widget_get_height (GTK_WIDGET (self));
+
+    if (range <= 0 || width <= MATCH_MARKER_WIDTH)
+        return;
+
+    GdkRGBA color;
+    gfloat marker_height = MAX (height / range, 2);
+    gint last_y = -1;
+
+    gtk_widget_get_color (GTK_WIDGET (self), &color);
+
+    for (guint i = 0; i < rows->len; ++i)
+    {
+        gint64 row = g_array_index (rows, GerminalMatchRow, i).row;
+        gint y = (row - lower) * height / range;
+        gboolean current = row == priv->match_row;
+
+        /* Thousands of matches end up on the same few pixels */
+        if (y == last_y && !current)
+            continue;
+        last_y = y;
+
+        GdkRGBA marker = color;
+        marker.alpha *= current ? 1. : .5;
+        gtk_snapshot_append_color (snapshot, &marker, &GRAPHENE_RECT_INIT (width - MATCH_MARKER_WIDTH, y, MATCH_MARKER_WIDTH, marker_height));
+    }
+}
+
+static void
+germinal_terminal_snapshot (GtkWidget   *widget,
+                            GtkSnapshot *snapshot)
+{
+    GTK_WIDGET_CLASS (germinal_terminal_parent_class)->snapshot (widget, snapshot);
+
+    germinal_terminal_snapshot_matches (GERMINAL_TERMINAL (widget), snapshot);
+
+    if (G_UNLIKELY (!germinal_timings_has (GERMINAL_TIMING_FIRST_FRAME)) && germinal_timings_has (GERMINAL_TIMING_FIRST_CHILD_BYTE))
+        germinal_timings_mark (GERMINAL_TIMING_FIRST_FRAME);
+}
+
+static void
+on_first_contents_changed (VteTerminal *terminal,
+                           gpointer     user_data G_GNUC_UNUSED)
+{
+    g_signal_handlers_disconnect_by_func (terminal, on_first_contents_changed, NULL);
+    germinal_timings_mark (GERMINAL_TIMING_FIRST_CHILD_BYTE);
+}
+
+static void
+on_char_size_changed (VteTerminal *terminal,
+                      guint        width  G_GNUC_UNUSED,
+                      guint        height G_GNUC_UNUSED,
+                      gpointer     user_data G_GNUC_UNUSED)
+{
+    g_signal_handlers_disconnect_by_func (terminal, on_char_size_changed, NULL);
+    germinal_timings_mark (GERMINAL_TIMING_FONT_LOADED);
 }
 
 static gboolean
@@ -253,7 +672,6 @@ on_scroll (GtkEventControllerScroll *controller,
            gpointer                  user_data)
 {
     GerminalTerminal *self = GERMINAL_TERMINAL (user_data);
-    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
 
     if (!(gtk_event_controller_get_current_event_state (GTK_EVENT_CONTROLLER (controller)) & GDK_CONTROL_MASK))
         return GDK_EVENT_PROPAGATE;
@@ -261,22 +679,9 @@ on_scroll (GtkEventControllerScroll *controller,
     if (dy == 0)
         return GDK_EVENT_PROPAGATE;
 
-    gboolean natural_scroll = FALSE;
-
     GdkEvent *event = gtk_event_controller_get_current_event (GTK_EVENT_CONTROLLER (controller));
     GdkDevice *device = gdk_event_get_device (event);
-
-    switch (gdk_device_get_source (device))
-    {
-        case GDK_SOURCE_MOUSE:
-            natural_scroll = g_settings_get_boolean (priv->mouse_settings, "natural-scroll");
-            break;
-        case GDK_SOURCE_TOUCHPAD:
-            natural_scroll = g_settings_get_boolean (priv->touchpad_settings, "natural-scroll");
-            break;
-        default:
-            break;
-    }
+    gboolean natural_scroll = germinal_settings_get_natural_scroll (gdk_device_get_source (device));
 
     if ((dy < 0) != natural_scroll)
         germinal_terminal_zoom_in (self);
@@ -291,10 +696,32 @@ germinal_terminal_dispose (GObject *object)
 {
     GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (GERMINAL_TERMINAL (object));
 
+    if (priv->apply_settings_id)
+    {
+        gtk_widget_remove_tick_callback (GTK_WIDGET (object), priv->apply_settings_id);
+        priv->apply_settings_id = 0;
+    }
+
+    g_clear_handle_id (&priv->search_source_id, g_source_remove);
+    g_clear_handle_id (&priv->snapshot_id, g_source_remove);
+    g_clear_handle_id (&priv->index_source_id, g_source_remove);
+    germinal_terminal_settle_copy (GERMINAL_TERMINAL (object));
+    germinal_terminal_release_primary_paste (GERMINAL_TERMINAL (object), FALSE);
+    germinal_terminal_end_bracketed_paste (GERMINAL_TERMINAL (object));
+    g_cancellable_cancel (priv->paste_cancellable);
+    g_queue_clear_full (&priv->paste_queue, g_free);
+    if (priv->index_document)
+    {
+        germinal_scrollback_index_remove_document (germinal_scrollback_index_get_default (), priv->index_document);
+        priv->index_document = 0;
+    }
+    if (priv->match_counter)
+        g_signal_handlers_disconnect_by_data (priv->match_counter, object);
+    g_clear_object (&priv->match_counter);
     g_clear_object (&priv->settings_signals);
+    g_clear_object (&priv->tmux);
+    g_clear_object (&priv->pty_child);
     g_clear_object (&priv->settings);
-    g_clear_object (&priv->mouse_settings);
-    g_clear_object (&priv->touchpad_settings);
 
     G_OBJECT_CLASS (germinal_terminal_parent_class)->dispose (object);
 }
@@ -305,48 +732,49 @@ germinal_terminal_finalize (GObject *object)
     GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (GERMINAL_TERMINAL (object));
 
     g_clear_pointer (&priv->url, g_free);
-    g_clear_pointer (&priv->zero_keycodes, g_free);
+    g_clear_pointer (&priv->tmux_session, g_free);
+    g_clear_pointer (&priv->tmux_globals, g_strfreev);
+    g_clear_pointer (&priv->search_text, g_free);
+    g_clear_pointer (&priv->pending_search, g_free);
+    g_clear_pointer (&priv->snapshot_rows, g_ptr_array_unref);
 
     G_OBJECT_CLASS (germinal_terminal_parent_class)->finalize (object);
 }
 
 static gboolean on_key_pressed (GtkEventControllerKey *controller, guint keyval, guint keycode, GdkModifierType state, gpointer user_data);
+static gboolean on_legacy_event (GtkEventControllerLegacy *controller, GdkEvent *event, gpointer user_data);
+static void on_matches_changed (GerminalMatchCounter *counter, gpointer user_data);
+static void on_search_contents_changed (VteTerminal *terminal, gpointer user_data);
 
 static void
 germinal_terminal_init (GerminalTerminal *self)
 {
     GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
-    g_autofree GdkKeymapKey *zero_keys = NULL;
     g_autoptr (GError) error = NULL;
-    gint n_keys;
 
     GSettings *settings = priv->settings = germinal_settings_new ();
-    priv->mouse_settings = g_settings_new ("org.gnome.desktop.peripherals.mouse");
-    priv->touchpad_settings = g_settings_new ("org.gnome.desktop.peripherals.touchpad");
 
     priv->settings_signals = g_signal_group_new (G_TYPE_SETTINGS);
-    g_signal_group_connect (priv->settings_signals, "changed::" AUDIBLE_BELL_KEY,         G_CALLBACK (update_bell),                self);
-    g_signal_group_connect (priv->settings_signals, "changed::" BACKCOLOR_KEY,            G_CALLBACK (update_colors),              self);
-    g_signal_group_connect (priv->settings_signals, "changed::" FORECOLOR_KEY,            G_CALLBACK (update_colors),              self);
-    g_signal_group_connect (priv->settings_signals, "changed::" PALETTE_KEY,              G_CALLBACK (update_colors),              self);
-    g_signal_group_connect (priv->settings_signals, "changed::" FONT_KEY,                 G_CALLBACK (update_font),                self);
-    g_signal_group_connect (priv->settings_signals, "changed::" SCROLLBACK_KEY,           G_CALLBACK (update_scrollback),          self);
-    g_signal_group_connect (priv->settings_signals, "changed::" WORD_CHAR_EXCEPTIONS_KEY, G_CALLBACK (update_word_char_exceptions), self);
+    g_signal_group_connect (priv->settings_signals, "changed", G_CALLBACK (on_settings_changed), self);
     g_signal_group_set_target (priv->settings_signals, settings);
 
-    update_bell                 (settings, AUDIBLE_BELL_KEY,         self);
-    update_colors               (settings, NULL,                     self);
-    update_font                 (settings, FONT_KEY,                 self);
-    update_scrollback           (settings, SCROLLBACK_KEY,           self);
-    update_word_char_exceptions (settings, WORD_CHAR_EXCEPTIONS_KEY, self);
+    germinal_terminal_apply_settings (self, GERMINAL_SETTINGS_CHANGE_ALL);
 
-    if (gdk_display_map_keyval (gdk_display_get_default (), GDK_KEY_0, &zero_keys, &n_keys))
-    {
-        priv->n_zero_keycodes = (guint) n_keys;
-        priv->zero_keycodes = g_new (guint, priv->n_zero_keycodes);
+    priv->match_counter = germinal_match_counter_new ();
+    priv->rescan_from = priv->stable_end = G_MAXINT64;
+    priv->match_row = -1;
+    priv->locate_from = G_MININT64;
+    g_signal_connect (priv->match_counter, "changed", G_CALLBACK (on_matches_changed), self);
+    g_signal_connect (self, "contents-changed", G_CALLBACK (on_search_contents_changed), NULL);
+
+    priv->index_document = germinal_scrollback_index_add_document (germinal_scrollback_index_get_default (), self);
+    g_signal_connect_object (germinal_scrollback_index_get_default (), "started", G_CALLBACK (on_index_started), self, 0);
 
-        for (guint i = 0; i < priv->n_zero_keycodes; ++i)
-            priv->zero_keycodes[i] = zero_keys[i].keycode;
+    /* Only the first terminal matters for the startup timeline */
+    if (!germinal_timings_has (GERMINAL_TIMING_FIRST_CHILD_BYTE))
+    {
+        g_signal_connect (self, "contents-changed",  G_CALLBACK (on_first_contents_changed), NULL);
+        g_signal_connect (self, "char-size-changed", G_CALLBACK (on_char_size_changed),      NULL);
     }
 
     GtkEventController *key_ctrl = gtk_event_controller_key_new ();
@@ -359,6 +787,11 @@ germinal_terminal_init (GerminalTerminal *self)
     g_signal_connect (scroll_ctrl, "scroll", G_CALLBACK (on_scroll), self);
     gtk_widget_add_controller (GTK_WIDGET (self), scroll_ctrl);
 
+    GtkEventController *legacy_ctrl = gtk_event_controller_legacy_new ();
+    gtk_event_controller_set_propagation_phase (legacy_ctrl, GTK_PHASE_CAPTURE);
+    g_signal_connect (legacy_ctrl, "event", G_CALLBACK (on_legacy_event), self);
+    gtk_widget_add_controller (GTK_WIDGET (self), legacy_ctrl);
+
     VteTerminal *term = VTE_TERMINAL (self);
 
     vte_terminal_set_mouse_autohide      (term, TRUE);
@@ -366,10 +799,9 @@ germinal_terminal_init (GerminalTerminal *self)
     vte_terminal_set_scroll_on_keystroke (term, TRUE);
     vte_terminal_search_set_wrap_around  (term, TRUE);
 
-    g_autoptr (VteRegex) url_regexp = vte_regex_new_for_match (URL_REGEXP,
-                                                              strlen (URL_REGEXP),
-                                                              PCRE2_CASELESS | PCRE2_NOTEMPTY | PCRE2_MULTILINE,
-                                                              &error);
+    g_autoptr (VteRegex) url_regexp = germinal_regex_cache_get_match (URL_REGEXP,
+                                                                     PCRE2_CASELESS | PCRE2_NOTEMPTY | PCRE2_MULTILINE,
+                                                                     &error);
 
     if (error)
     {
@@ -389,81 +821,429 @@ copy_text (const gchar *text)
     gdk_clipboard_set_text (gdk_display_get_primary_clipboard (display), text);
 }
 
-void
-germinal_terminal_copy (GerminalTerminal *self)
+/*
+ * The HTML isn't serialized until someone pastes it, the selection it comes
+ * from has to be read before we change it though: clicks and searches do.
+ */
+static void
+germinal_terminal_settle_copy (GerminalTerminal *self)
 {
-    g_return_if_fail (GERMINAL_IS_TERMINAL (self));
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    if (!priv->pending_copy)
+        return;
+
+    germinal_clipboard_provider_resolve (priv->pending_copy);
+    g_clear_weak_pointer (&priv->pending_copy);
+}
+
+static void
+germinal_terminal_copy_selection (GerminalTerminal *self,
+                                  gboolean          html)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    if (!vte_terminal_get_has_selection (VTE_TERMINAL (self)))
+        return;
+
+    germinal_terminal_settle_copy (self);
 
-    vte_terminal_copy_clipboard_format (VTE_TERMINAL (self), VTE_FORMAT_TEXT);
+    g_autoptr (GdkContentProvider) provider = germinal_clipboard_provider_new (VTE_TERMINAL (self), html);
+
+    /* Both share whatever gets serialized */
+    gdk_clipboard_set_content (gtk_widget_get_clipboard (GTK_WIDGET (self)), provider);
+    gdk_clipboard_set_content (gtk_widget_get_primary_clipboard (GTK_WIDGET (self)), provider);
+    g_set_weak_pointer (&priv->pending_copy, GERMINAL_CLIPBOARD_PROVIDER (provider));
 }
 
 void
-germinal_terminal_copy_html (GerminalTerminal *self)
+germinal_terminal_copy (GerminalTerminal *self)
 {
     g_return_if_fail (GERMINAL_IS_TERMINAL (self));
 
-    vte_terminal_copy_clipboard_format (VTE_TERMINAL (self), VTE_FORMAT_HTML);
+    germinal_terminal_copy_selection (self, FALSE);
 }
 
 void
-germinal_terminal_paste (GerminalTerminal *self)
+germinal_terminal_copy_html (GerminalTerminal *self)
 {
     g_return_if_fail (GERMINAL_IS_TERMINAL (self));
 
-    vte_terminal_paste_clipboard (VTE_TERMINAL (self));
+    germinal_terminal_copy_selection (self, TRUE);
 }
 
-gboolean
-germinal_terminal_copy_url (GerminalTerminal *self)
+static void
+on_middle_click_commit (VteTerminal *terminal G_GNUC_UNUSED,
+                        const gchar *text     G_GNUC_UNUSED,
+                        guint        size     G_GNUC_UNUSED,
+                        gpointer     user_data)
 {
-    g_return_val_if_fail (GERMINAL_IS_TERMINAL (self), FALSE);
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (GERMINAL_TERMINAL (user_data));
 
-    const gchar *url = germinal_terminal_get_url (self);
+    /* vte reported the click to the application */
+    priv->middle_click_reported = TRUE;
+}
 
-    if (!url)
-        return FALSE;
+static gboolean
+on_middle_click_handled (gpointer user_data)
+{
+    GerminalTerminal *self = GERMINAL_TERMINAL (user_data);
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
 
-    copy_text (url);
+    priv->middle_click_source_id = 0;
+    germinal_terminal_release_primary_paste (self, TRUE);
 
-    return TRUE;
+    return G_SOURCE_REMOVE;
 }
 
+/*
+ * vte pastes the primary selection on a middle click, unless the application
+ * tracks the mouse and shift isn't held: the click is reported to it then.
+ * That only shows once vte handled the click, so vte is kept from pasting on
+ * its own meanwhile, and the paste goes through ours afterwards if nothing
+ * was reported.
+ */
 static void
-launch_cmd (GerminalTerminal *self,
-            const gchar      *_cmd)
+germinal_terminal_hold_primary_paste (GerminalTerminal *self)
 {
-    g_auto (GStrv) cmd = NULL;
-    g_autoptr (GError) error = NULL;
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+    GtkSettings *settings = gtk_widget_get_settings (GTK_WIDGET (self));
+    gboolean primary_paste = FALSE;
 
-    if (!g_shell_parse_argv (_cmd, NULL, &cmd, &error))
-    {
-        g_warning ("%s", error->message);
+    g_object_get (settings, "gtk-enable-primary-paste", &primary_paste, NULL);
+
+    if (!primary_paste || priv->middle_click_commit_id)
         return;
-    }
 
-    if (!germinal_terminal_spawn (self, cmd, &error))
-        g_warning ("%s", error->message);
+    g_object_set (settings, "gtk-enable-primary-paste", FALSE, NULL);
+    priv->middle_click_reported = FALSE;
+    priv->middle_click_commit_id = g_signal_connect (self, "commit", G_CALLBACK (on_middle_click_commit), self);
+    priv->middle_click_source_id = g_idle_add_full (G_PRIORITY_HIGH, on_middle_click_handled, self, NULL);
+    g_source_set_name_by_id (priv->middle_click_source_id, "[germinal] middle-click");
 }
 
 static gboolean
-on_key_pressed (GtkEventControllerKey *controller G_GNUC_UNUSED,
-                guint                  keyval,
-                guint                  keycode,
-                GdkModifierType        state,
-                gpointer               user_data)
+on_legacy_event (GtkEventControllerLegacy *controller G_GNUC_UNUSED,
+                 GdkEvent                 *event,
+                 gpointer                  user_data)
 {
     GerminalTerminal *self = GERMINAL_TERMINAL (user_data);
 
-    if (!(state & GDK_CONTROL_MASK))
-        return GDK_EVENT_PROPAGATE;
-
-    switch (keyval)
+    if (gdk_event_get_event_type (event) == GDK_BUTTON_PRESS)
     {
-    /* Clipboard */
-    case GDK_KEY_C:
-        germinal_terminal_copy (self);
-        return GDK_EVENT_STOP;
-    case GDK_KEY_V:
+        germinal_terminal_settle_copy (self);
+        if (gdk_button_event_get_button (event) == GDK_BUTTON_MIDDLE)
+            germinal_terminal_hold_primary_paste (self);
+    }
+
+    return GDK_EVENT_PROPAGATE;
+}
+
+#define BRACKETED_PASTE_START "\033[200~"
+#define BRACKETED_PASTE_END   "\033[201~"
+
+static void
+on_probe_commit (VteTerminal *terminal G_GNUC_UNUSED,
+                 const gchar *text,
+                 guint        size,
+                 gpointer     user_data)
+{
+    gboolean *bracketed = user_data;
+
+    *bracketed = size >= strlen (BRACKETED_PASTE_START) && !memcmp (text, BRACKETED_PASTE_START, strlen (BRACKETED_PASTE_START));
+}
+
+/*
+ * vte doesn't tell whether the application asked for bracketed paste, but
+ * pasting nothing through it does: that sends an empty bracketed paste then,
+ * which applications take as nothing, and nothing at all otherwise.
+ */
+static gboolean
+germinal_terminal_get_bracketed_paste (GerminalTerminal *self)
+{
+    gboolean bracketed = FALSE;
+    gulong commit_id = g_signal_connect (self, "commit", G_CALLBACK (on_probe_commit), &bracketed);
+
+    vte_terminal_paste_text (VTE_TERMINAL (self), "");
+    g_signal_handler_disconnect (self, commit_id);
+
+    return bracketed;
+}
+
+/* Wherever the running paste stopped, the application is told it's over */
+static void
+germinal_terminal_end_bracketed_paste (GerminalTerminal *self)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    if (!priv->paste_bracketed)
+        return;
+
+    priv->paste_bracketed = FALSE;
+    vte_terminal_feed_child (VTE_TERMINAL (self), BRACKETED_PASTE_END, -1);
+}
+
+/*
+ * A bracketed paste is bracketed once, around all of it, so its chunks are
+ * sanitized here the way vte would. Otherwise vte sanitizes each of them,
+ * and brackets them if the application asks for bracketed paste meanwhile.
+ */
+static void
+paste_chunk (const gchar *chunk,
+             gsize        length,
+             gpointer     user_data)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (GERMINAL_TERMINAL (user_data));
+
+    if (priv->paste_bracketed)
+    {
+        gsize sanitized_length = 0;
+        g_autofree gchar *sanitized = germinal_paste_sanitize (chunk, length, &sanitized_length);
+
+        vte_terminal_feed_child (VTE_TERMINAL (user_data), sanitized, (gssize) sanitized_length);
+        return;
+    }
+
+    g_autofree gchar *text = g_strndup (chunk, length);
+
+    vte_terminal_paste_text (VTE_TERMINAL (user_data), text);
+}
+
+static void
+on_paste_progress (gsize    bytes_done,
+                   gsize    n_bytes,
+                   gpointer user_data)
+{
+    GerminalTerminal *self = GERMINAL_TERMINAL (user_data);
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    priv->paste_done = bytes_done;
+    priv->paste_total = n_bytes;
+    g_signal_emit (self, signals[SIGNAL_PASTE_PROGRESS], 0);
+}
+
+static void germinal_terminal_paste_text (GerminalTerminal *self, const gchar *text);
+
+static void
+on_paste_done (GObject      *source G_GNUC_UNUSED,
+               GAsyncResult *result,
+               gpointer      user_data)
+{
+    g_autoptr (GerminalTerminal) self = user_data;
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+    g_autoptr (GError) error = NULL;
+    gdouble throughput = -1;
+
+    g_clear_object (&priv->paste_cancellable);
+    germinal_terminal_end_bracketed_paste (self);
+
+    if (germinal_paste_finish (result, &throughput, &error))
+        g_debug ("Pasted %" G_GSIZE_FORMAT " bytes at %.0f bytes/s", priv->paste_total, throughput);
+    else
+    {
+        /* What was pasted after it would make no sense without it */
+        g_queue_clear_full (&priv->paste_queue, g_free);
+        if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+            g_warning ("Couldn't paste: %s", error->message);
+    }
+
+    priv->paste_done = priv->paste_total = 0;
+    g_signal_emit (self, signals[SIGNAL_PASTE_FINISHED], 0, throughput);
+
+    /* Small ones go right away, until the next big one starts */
+    while (!priv->paste_cancellable && !g_queue_is_empty (&priv->paste_queue))
+    {
+        g_autofree gchar *next = g_queue_pop_head (&priv->paste_queue);
+
+        if (gtk_widget_get_realized (GTK_WIDGET (self)))
+            germinal_terminal_paste_text (self, next);
+    }
+}
+
+static void
+germinal_terminal_paste_text (GerminalTerminal *self,
+                              const gchar      *text)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+    VtePty *pty = vte_terminal_get_pty (VTE_TERMINAL (self));
+    gsize length = strlen (text);
+
+    /* Even a small one would land in the middle of the running one */
+    if (priv->paste_cancellable)
+    {
+        g_queue_push_tail (&priv->paste_queue, g_strdup (text));
+        return;
+    }
+
+    if (!pty || length <= GERMINAL_PASTE_CHUNK_SIZE)
+    {
+        vte_terminal_paste_text (VTE_TERMINAL (self), text);
+        return;
+    }
+
+    g_autoptr (GBytes) bytes = g_bytes_new (text, length);
+
+    priv->paste_cancellable = g_cancellable_new ();
+    priv->paste_bracketed = germinal_terminal_get_bracketed_paste (self);
+    if (priv->paste_bracketed)
+        vte_terminal_feed_child (VTE_TERMINAL (self), BRACKETED_PASTE_START, -1);
+
+    germinal_paste_async (vte_pty_get_fd (pty), bytes, paste_chunk, self, priv->paste_cancellable,
+                          on_paste_progress, self, on_paste_done, g_object_ref (self));
+}
+
+static void
+on_clipboard_text (GObject      *source,
+                   GAsyncResult *result,
+                   gpointer      user_data)
+{
+    g_autoptr (GerminalTerminal) self = user_data;
+    g_autofree gchar *text = gdk_clipboard_read_text_finish (GDK_CLIPBOARD (source), result, NULL);
+
+    if (text && gtk_widget_get_realized (GTK_WIDGET (self)))
+        germinal_terminal_paste_text (self, text);
+}
+
+void
+germinal_terminal_paste (GerminalTerminal *self)
+{
+    g_return_if_fail (GERMINAL_IS_TERMINAL (self));
+
+    gdk_clipboard_read_text_async (gtk_widget_get_clipboard (GTK_WIDGET (self)), NULL, on_clipboard_text, g_object_ref (self));
+}
+
+static void
+germinal_terminal_release_primary_paste (GerminalTerminal *self,
+                                         gboolean          paste)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    if (!priv->middle_click_commit_id)
+        return;
+
+    g_clear_handle_id (&priv->middle_click_source_id, g_source_remove);
+    g_clear_signal_handler (&priv->middle_click_commit_id, self);
+    gtk_settings_reset_property (gtk_widget_get_settings (GTK_WIDGET (self)), "gtk-enable-primary-paste");
+
+    if (paste && !priv->middle_click_reported)
+        gdk_clipboard_read_text_async (gtk_widget_get_primary_clipboard (GTK_WIDGET (self)), NULL, on_clipboard_text, g_object_ref (self));
+}
+
+void
+germinal_terminal_cancel_paste (GerminalTerminal *self)
+{
+    g_return_if_fail (GERMINAL_IS_TERMINAL (self));
+
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    g_queue_clear_full (&priv->paste_queue, g_free);
+    g_cancellable_cancel (priv->paste_cancellable);
+}
+
+/* How much of the running paste got through, FALSE if there is none */
+gboolean
+germinal_terminal_get_paste_progress (GerminalTerminal *self,
+                                      gsize            *done,
+                                      gsize            *total)
+{
+    g_return_val_if_fail (GERMINAL_IS_TERMINAL (self), FALSE);
+
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    if (done)
+        *done = priv->paste_done;
+    if (total)
+        *total = priv->paste_total;
+
+    return priv->paste_cancellable != NULL;
+}
+
+gboolean
+germinal_terminal_copy_url (GerminalTerminal *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_TERMINAL (self), FALSE);
+
+    const gchar *url = germinal_terminal_get_url (self);
+
+    if (!url)
+        return FALSE;
+
+    copy_text (url);
+
+    return TRUE;
+}
+
+void
+germinal_terminal_set_tmux (GerminalTerminal *self,
+                            GerminalTmux     *tmux)
+{
+    g_return_if_fail (GERMINAL_IS_TERMINAL (self));
+    g_return_if_fail (!tmux || GERMINAL_IS_TMUX (tmux));
+
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    g_set_object (&priv->tmux, tmux);
+}
+
+/* globals are tmux and its global options, picking the server the session lives on */
+void
+germinal_terminal_set_tmux_session (GerminalTerminal    *self,
+                                    const gchar * const *globals,
+                                    const gchar         *session)
+{
+    g_return_if_fail (GERMINAL_IS_TERMINAL (self));
+
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    g_free (priv->tmux_session);
+    priv->tmux_session = g_strdup (session);
+    g_strfreev (priv->tmux_globals);
+    priv->tmux_globals = g_strdupv ((GStrv) globals);
+}
+
+static void
+send_tmux_command (GerminalTerminal *self,
+                   const gchar      *command)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    if (priv->tmux && germinal_tmux_send (priv->tmux, command))
+        return;
+
+    /* (Re)connect lazily, the session may not exist yet or may have been restarted */
+    g_autoptr (GError) error = NULL;
+
+    g_clear_object (&priv->tmux);
+    priv->tmux = germinal_tmux_new ((const gchar * const *) priv->tmux_globals, priv->tmux_session, &error);
+
+    if (priv->tmux && germinal_tmux_send (priv->tmux, command))
+        return;
+
+    if (error)
+        g_debug ("Couldn't start tmux control client: %s", error->message);
+
+    germinal_tmux_run_detached ((const gchar * const *) priv->tmux_globals, command);
+}
+
+static gboolean
+on_key_pressed (GtkEventControllerKey *controller G_GNUC_UNUSED,
+                guint                  keyval,
+                guint                  keycode,
+                GdkModifierType        state,
+                gpointer               user_data)
+{
+    GerminalTerminal *self = GERMINAL_TERMINAL (user_data);
+
+    if (!(state & GDK_CONTROL_MASK))
+        return GDK_EVENT_PROPAGATE;
+
+    switch (keyval)
+    {
+    /* Clipboard */
+    case GDK_KEY_C:
+        germinal_terminal_copy (self);
+        return GDK_EVENT_STOP;
+    case GDK_KEY_V:
         germinal_terminal_paste (self);
         return GDK_EVENT_STOP;
     /* Zoom */
@@ -485,40 +1265,40 @@ on_key_pressed (GtkEventControllerKey *controller G_GNUC_UNUSED,
         return GDK_EVENT_STOP;
     /* Window split (inspired by terminator) */
     case GDK_KEY_O:
-        launch_cmd (self, "tmux split-window -v");
+        send_tmux_command (self, "split-window -v");
         return GDK_EVENT_STOP;
     case GDK_KEY_E:
-        launch_cmd (self, "tmux split-window -h");
+        send_tmux_command (self, "split-window -h");
         return GDK_EVENT_STOP;
     /* Next/Previous window (tab) */
     case GDK_KEY_Tab:
-        launch_cmd (self, "tmux next-window");
+        send_tmux_command (self, "next-window");
         return GDK_EVENT_STOP;
     case GDK_KEY_ISO_Left_Tab:
-        launch_cmd (self, "tmux previous-window");
+        send_tmux_command (self, "previous-window");
         return GDK_EVENT_STOP;
     /* New window (tab) */
     case GDK_KEY_T:
-        launch_cmd (self, "tmux new-window");
+        send_tmux_command (self, "new-window");
         return GDK_EVENT_STOP;
     /* Next/Previous pane */
     case GDK_KEY_N:
-        launch_cmd (self, "tmux select-pane -t :.+");
+        send_tmux_command (self, "select-pane -t :.+");
         return GDK_EVENT_STOP;
     case GDK_KEY_P:
-        launch_cmd (self, "tmux select-pane -t :.-");
+        send_tmux_command (self, "select-pane -t :.-");
         return GDK_EVENT_STOP;
     /* Close current pane */
     case GDK_KEY_W:
-        launch_cmd (self, "tmux kill-pane");
+        send_tmux_command (self, "kill-pane");
         return GDK_EVENT_STOP;
     /* Resize current pane */
     case GDK_KEY_X:
-        launch_cmd (self, "tmux resize-pane -Z");
+        send_tmux_command (self, "resize-pane -Z");
         return GDK_EVENT_STOP;
     }
 
-    if (germinal_terminal_is_zero (self, keycode))
+    if (germinal_settings_is_zero_keycode (keycode))
     {
         germinal_terminal_reset_zoom (self);
         return GDK_EVENT_STOP;
@@ -527,24 +1307,464 @@ on_key_pressed (GtkEventControllerKey *controller G_GNUC_UNUSED,
     return GDK_EVENT_PROPAGATE;
 }
 
-gboolean
-germinal_terminal_search (GerminalTerminal *self,
-                          const gchar      *text)
+static gint64
+screen_top (VteTerminal *terminal)
 {
-    g_return_val_if_fail (GERMINAL_IS_TERMINAL (self), FALSE);
-    g_return_val_if_fail (text != NULL, FALSE);
+    GtkAdjustment *vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (terminal));
+
+    return gtk_adjustment_get_upper (vadjustment) - vte_terminal_get_row_count (terminal);
+}
+
+/* vte only ends the text of a row with a newline when it isn't soft-wrapped into the next one */
+static gboolean
+row_is_wrapped (VteTerminal *terminal,
+                gint64       row)
+{
+    glong columns = vte_terminal_get_column_count (terminal);
+    g_autofree gchar *text = vte_terminal_get_text_range_format (terminal, VTE_FORMAT_TEXT, row, columns - 1, row + 1, 0, NULL);
+
+    return text && !strchr (text, '\n');
+}
+
+/* The first row of the line row is part of, as far back as lower */
+static gint64
+line_start (VteTerminal *terminal,
+            gint64       row,
+            gint64       lower)
+{
+    while (row > lower && row_is_wrapped (terminal, row - 1))
+        --row;
+
+    return row;
+}
+
+/*
+ * The text of the line starting at row, its soft-wrapped rows joined like
+ * vte does when searching, up to end. n_rows is how many rows it spans.
+ */
+static gchar *
+line_text (VteTerminal *terminal,
+           gint64       row,
+           gint64       end,
+           gint64      *n_rows)
+{
+    glong columns = vte_terminal_get_column_count (terminal);
+    gint64 last = row;
 
+    while (last + 1 < end && row_is_wrapped (terminal, last))
+        ++last;
+
+    gchar *text = vte_terminal_get_text_range_format (terminal, VTE_FORMAT_TEXT, row, 0, last, columns, NULL);
+
+    *n_rows = last - row + 1;
+
+    return text ? text : g_strdup ("");
+}
+
+/* Rows that scrolled off the screen are final, the ones on it get indexed again once they changed */
+static gboolean
+germinal_terminal_index_rows (gpointer user_data)
+{
+    GerminalTerminal *self = GERMINAL_TERMINAL (user_data);
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+    GerminalScrollbackIndex *index = germinal_scrollback_index_get_default ();
+    VteTerminal *terminal = VTE_TERMINAL (self);
+    GtkAdjustment *vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (self));
+    gint64 lower = gtk_adjustment_get_lower (vadjustment);
+    gint64 end = gtk_adjustment_get_upper (vadjustment);
+    gint64 top = screen_top (terminal);
+    gint64 first = line_start (terminal, MAX (priv->index_next, lower), lower);
+    gint64 last = first;
+    g_autoptr (GPtrArray) rows = g_ptr_array_new_with_free_func (g_free);
+
+    germinal_scrollback_index_trim (index, priv->index_document, lower);
+
+    /* Lines are indexed on their first row, like the search counts them */
+    for (gint64 n_rows; last < end && last - first < INDEX_CHUNK_ROWS; last += n_rows)
+    {
+        g_ptr_array_add (rows, line_text (terminal, last, end, &n_rows));
+        for (gint64 i = 1; i < n_rows; ++i)
+            g_ptr_array_add (rows, g_strdup (""));
+    }
+
+    germinal_scrollback_index_update (index, priv->index_document, first, rows);
+    priv->index_next = MIN (last, top);
+
+    if (last < end)
+        return G_SOURCE_CONTINUE;
+
+    priv->index_source_id = 0;
+
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+on_index_delay (gpointer user_data)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (GERMINAL_TERMINAL (user_data));
+
+    priv->index_delayed = FALSE;
+    priv->index_source_id = g_idle_add_full (G_PRIORITY_LOW, germinal_terminal_index_rows, user_data, NULL);
+    g_source_set_name_by_id (priv->index_source_id, "[germinal] index-scrollback");
+
+    return G_SOURCE_REMOVE;
+}
+
+/*
+ * Nothing gets indexed before the first search across terminals. Rows
+ * that changed on the screen only get indexed again after a while, not
+ * on each bit of output, anything else goes right away.
+ */
+static void
+germinal_terminal_schedule_index (GerminalTerminal *self,
+                                  gint64            from)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+    gboolean delayed = (from == G_MAXINT64);
+
+    if (!priv->index_document || !germinal_scrollback_index_is_started (germinal_scrollback_index_get_default ()))
+        return;
+
+    priv->index_next = MIN (priv->index_next, from);
+
+    if (priv->index_source_id && (delayed || !priv->index_delayed))
+        return;
+
+    g_clear_handle_id (&priv->index_source_id, g_source_remove);
+    priv->index_delayed = delayed;
+
+    if (delayed)
+        priv->index_source_id = g_timeout_add_full (G_PRIORITY_LOW, INDEX_DELAY_MS, on_index_delay, self, NULL);
+    else
+        priv->index_source_id = g_idle_add_full (G_PRIORITY_LOW, germinal_terminal_index_rows, self, NULL);
+    g_source_set_name_by_id (priv->index_source_id, "[germinal] index-scrollback");
+}
+
+static void
+on_index_started (GerminalScrollbackIndex *index G_GNUC_UNUSED,
+                  gpointer                 user_data)
+{
+    germinal_terminal_schedule_index (GERMINAL_TERMINAL (user_data), G_MININT64);
+}
+
+/* Copy rows in chunks, then hand them to the counter to look for matches in a thread */
+static gboolean
+germinal_terminal_snapshot_rows (gpointer user_data)
+{
+    GerminalTerminal *self = GERMINAL_TERMINAL (user_data);
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+    VteTerminal *terminal = VTE_TERMINAL (self);
+    GtkAdjustment *vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (self));
+    gint64 lower = gtk_adjustment_get_lower (vadjustment);
+    gint64 end = gtk_adjustment_get_upper (vadjustment);
+
+    /* Output in a soft-wrapped row changes its whole line */
+    if (priv->rescan_from > lower && priv->rescan_from < end)
+        priv->rescan_from = line_start (terminal, priv->rescan_from, lower);
+
+    if (!priv->snapshot_rows)
+    {
+        priv->snapshot_rows = g_ptr_array_new_with_free_func (g_free);
+        priv->snapshot_first = priv->snapshot_next = MAX (priv->rescan_from, lower);
+        priv->rescan_from = G_MAXINT64;
+        priv->stable_end = G_MAXINT64;
+    }
+    else if (priv->rescan_from < priv->snapshot_next)
+    {
+        /* Output changed rows we already copied */
+        if (priv->rescan_from <= priv->snapshot_first)
+        {
+            priv->snapshot_first = MAX (priv->rescan_from, lower);
+            g_ptr_array_set_size (priv->snapshot_rows, 0);
+        }
+        else
+        {
+            g_ptr_array_set_size (priv->snapshot_rows, priv->rescan_from - priv->snapshot_first);
+        }
+        priv->snapshot_next = priv->snapshot_first + priv->snapshot_rows->len;
+        priv->rescan_from = G_MAXINT64;
+    }
+
+    priv->stable_end = MIN (priv->stable_end, screen_top (terminal));
+
+    /* The matches of a line are counted on its first row, the others are left empty */
+    for (gint64 n = 0, n_rows; priv->snapshot_next < end && n < SNAPSHOT_CHUNK_ROWS; n += n_rows, priv->snapshot_next += n_rows)
+    {
+        g_ptr_array_add (priv->snapshot_rows, line_text (terminal, priv->snapshot_next, end, &n_rows));
+        for (gint64 i = 1; i < n_rows; ++i)
+            g_ptr_array_add (priv->snapshot_rows, g_strdup (""));
+    }
+
+    if (priv->snapshot_next < end)
+        return G_SOURCE_CONTINUE;
+
+    priv->snapshot_id = 0;
+    germinal_match_counter_trim (priv->match_counter, lower);
+    germinal_match_counter_scan (priv->match_counter, priv->snapshot_first, g_steal_pointer (&priv->snapshot_rows));
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+germinal_terminal_schedule_snapshot (GerminalTerminal *self,
+                                     gint64            from)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    if (!priv->search_text || !priv->match_counter)
+        return;
+
+    priv->rescan_from = MIN (priv->rescan_from, from);
+
+    /* Results come in order, the next scan starts once this one is in */
+    if (priv->snapshot_id || germinal_match_counter_is_scanning (priv->match_counter))
+        return;
+
+    priv->snapshot_id = g_idle_add_full (G_PRIORITY_LOW, germinal_terminal_snapshot_rows, self, NULL);
+    g_source_set_name_by_id (priv->snapshot_id, "[germinal] search-snapshot");
+}
+
+static void
+on_search_contents_changed (VteTerminal *terminal,
+                            gpointer     user_data G_GNUC_UNUSED)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (GERMINAL_TERMINAL (terminal));
+
+    germinal_terminal_schedule_index (GERMINAL_TERMINAL (terminal), G_MAXINT64);
+
+    if (priv->search_text)
+        germinal_terminal_schedule_snapshot (GERMINAL_TERMINAL (terminal), priv->stable_end);
+}
+
+/* Index of the first row with matches at or after row */
+static guint
+find_match_row (const GArray *rows,
+                gint64        row)
+{
+    guint low = 0, high = rows->len;
+
+    while (low < high)
+    {
+        guint middle = low + (high - low) / 2;
+
+        if (g_array_index (rows, GerminalMatchRow, middle).row < row)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+static gboolean
+germinal_terminal_is_counting (GerminalTerminal *self)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    return priv->snapshot_id || priv->rescan_from != G_MAXINT64 || germinal_match_counter_is_scanning (priv->match_counter);
+}
+
+static void
+on_matches_changed (GerminalMatchCounter *counter,
+                    gpointer              user_data)
+{
+    GerminalTerminal *self = GERMINAL_TERMINAL (user_data);
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+    const GArray *rows = germinal_match_counter_get_rows (counter);
+
+    /* Like vte, start from what is in view */
+    if (priv->locate_from != G_MININT64 && (rows->len || !germinal_terminal_is_counting (self)))
+    {
+        guint index = find_match_row (rows, priv->locate_from);
+
+        priv->match_row = rows->len ? g_array_index (rows, GerminalMatchRow, index % rows->len).row : -1;
+        priv->match_nth = 0;
+        priv->locate_from = G_MININT64;
+    }
+
+    /* Output came while the counter was busy */
+    if (priv->rescan_from != G_MAXINT64 && !germinal_match_counter_is_scanning (counter))
+        germinal_terminal_schedule_snapshot (self, G_MAXINT64);
+
+    gtk_widget_queue_draw (GTK_WIDGET (self));
+    g_signal_emit (self, signals[SIGNAL_SEARCH_CHANGED], 0);
+}
+
+/* Count matches for the search from scratch, text is NULL when it stops */
+static void
+germinal_terminal_count_matches (GerminalTerminal *self,
+                                 const gchar      *text,
+                                 gboolean          regex,
+                                 gboolean          refine)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+    GtkAdjustment *vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (self));
+
+    g_clear_handle_id (&priv->snapshot_id, g_source_remove);
+    g_clear_pointer (&priv->snapshot_rows, g_ptr_array_unref);
+    priv->stable_end = G_MAXINT64;
+    priv->rescan_from = text ? G_MININT64 : G_MAXINT64;
+
+    /* A longer search still matches where the shorter one was */
+    if (!text)
+        priv->locate_from = G_MININT64;
+    else if (refine && priv->match_row >= 0)
+        priv->locate_from = priv->match_row;
+    else
+        priv->locate_from = gtk_adjustment_get_value (vadjustment);
+    priv->match_row = -1;
+
+    /* vte already compiled it, it can only fail the same way */
+    germinal_match_counter_set_pattern (priv->match_counter, text, regex, NULL);
+    germinal_terminal_schedule_snapshot (self, G_MININT64);
+}
+
+static void
+germinal_terminal_move_match (GerminalTerminal *self,
+                              gint              direction)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+    const GArray *rows = germinal_match_counter_get_rows (priv->match_counter);
+
+    if (!rows->len)
+        return;
+
+    GtkAdjustment *vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (self));
+    gint64 from = priv->match_row >= 0 ? priv->match_row : (gint64) gtk_adjustment_get_value (vadjustment);
+    guint index = find_match_row (rows, from);
+    gboolean current = priv->match_row >= 0 && index < rows->len && g_array_index (rows, GerminalMatchRow, index).row == priv->match_row;
+
+    if (direction > 0)
+    {
+        if (current && priv->match_nth + 1 < g_array_index (rows, GerminalMatchRow, index).matches)
+        {
+            ++priv->match_nth;
+        }
+        else
+        {
+            index = (index + (current ? 1 : 0)) % rows->len;
+            priv->match_row = g_array_index (rows, GerminalMatchRow, index).row;
+            priv->match_nth = 0;
+        }
+    }
+    else
+    {
+        if (current && priv->match_nth > 0)
+        {
+            --priv->match_nth;
+        }
+        else
+        {
+            index = (index ? index : rows->len) - 1;
+            priv->match_row = g_array_index (rows, GerminalMatchRow, index).row;
+            priv->match_nth = g_array_index (rows, GerminalMatchRow, index).matches - 1;
+        }
+    }
+
+    gtk_widget_queue_draw (GTK_WIDGET (self));
+    g_signal_emit (self, signals[SIGNAL_SEARCH_CHANGED], 0);
+}
+
+static gboolean
+germinal_terminal_run_search (gpointer user_data)
+{
+    GerminalTerminal *self = GERMINAL_TERMINAL (user_data);
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+    g_autofree gchar *text = g_steal_pointer (&priv->pending_search);
+    gboolean regex = priv->pending_regex;
     g_autoptr (GError) error = NULL;
-    g_autoptr (VteRegex) regex = vte_regex_new_for_search (text, -1, PCRE2_CASELESS | PCRE2_MULTILINE, &error);
+
+    priv->search_source_id = 0;
+
+    if (!text)
+        return G_SOURCE_REMOVE;
+
+    /*
+     * vte wants PCRE2_MULTILINE, which PCRE2_LITERAL doesn't allow, but plain
+     * text escaped is all literal characters: pcre2 then only looks for its
+     * first and required characters, no backtracking.
+     */
+    g_autofree gchar *pattern = regex ? NULL : g_regex_escape_string (text, -1);
+    g_autoptr (VteRegex) search = germinal_regex_cache_get_search (regex ? text : pattern, PCRE2_CASELESS | PCRE2_MULTILINE, &error);
 
     if (error)
     {
         vte_terminal_search_set_regex (VTE_TERMINAL (self), NULL, 0);
-        return FALSE;
+        g_clear_pointer (&priv->search_text, g_free);
+        germinal_terminal_count_matches (self, NULL, FALSE, FALSE);
+        return G_SOURCE_REMOVE;
     }
 
-    vte_terminal_search_set_regex (VTE_TERMINAL (self), regex, 0);
-    return vte_terminal_search_find_next (VTE_TERMINAL (self));
+    /*
+     * Typing one more character can only narrow the current match down, so
+     * go on from there. Anything else starts over from what is in view.
+     */
+    gboolean refine = priv->search_text && regex == priv->search_regex && g_str_has_prefix (text, priv->search_text);
+
+    germinal_terminal_settle_copy (self);
+
+    if (!refine)
+        vte_terminal_unselect_all (VTE_TERMINAL (self));
+
+    g_free (priv->search_text);
+    priv->search_text = g_steal_pointer (&text);
+    priv->search_regex = regex;
+
+    germinal_terminal_count_matches (self, priv->search_text, regex, refine);
+    vte_terminal_search_set_regex (VTE_TERMINAL (self), search, 0);
+
+    /*
+     * vte goes on from the row after the selection, but the refined match is
+     * most likely on the same row as the current one. Step back to the match
+     * before it first, without wrapping around: if there is none, vte drops
+     * the selection and the next search starts from the start of the buffer,
+     * the oldest scrollback row, not from the top of the view.
+     */
+    if (refine)
+    {
+        vte_terminal_search_set_wrap_around (VTE_TERMINAL (self), FALSE);
+        vte_terminal_search_find_previous (VTE_TERMINAL (self));
+        vte_terminal_search_set_wrap_around (VTE_TERMINAL (self), TRUE);
+    }
+
+    vte_terminal_search_find_next (VTE_TERMINAL (self));
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Run what is still waiting for typing to stop, the user wants to move on */
+static void
+germinal_terminal_flush_search (GerminalTerminal *self)
+{
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    if (priv->search_source_id)
+    {
+        g_clear_handle_id (&priv->search_source_id, g_source_remove);
+        germinal_terminal_run_search (self);
+    }
+}
+
+void
+germinal_terminal_search (GerminalTerminal *self,
+                          const gchar      *text,
+                          gboolean          regex)
+{
+    g_return_if_fail (GERMINAL_IS_TERMINAL (self));
+    g_return_if_fail (text != NULL);
+
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+    GtkAdjustment *vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (self));
+    guint delay = gtk_adjustment_get_upper (vadjustment) > SEARCH_IMMEDIATE_ROWS ? SEARCH_DELAY_MS : 0;
+
+    /* Whatever was still waiting is stale now */
+    g_clear_handle_id (&priv->search_source_id, g_source_remove);
+    g_free (priv->pending_search);
+    priv->pending_search = g_strdup (text);
+    priv->pending_regex = regex;
+
+    priv->search_source_id = g_timeout_add (delay, germinal_terminal_run_search, self);
+    g_source_set_name_by_id (priv->search_source_id, "[germinal] search");
 }
 
 gboolean
@@ -552,6 +1772,10 @@ germinal_terminal_search_next (GerminalTerminal *self)
 {
     g_return_val_if_fail (GERMINAL_IS_TERMINAL (self), FALSE);
 
+    germinal_terminal_flush_search (self);
+    germinal_terminal_settle_copy (self);
+    germinal_terminal_move_match (self, 1);
+
     return vte_terminal_search_find_next (VTE_TERMINAL (self));
 }
 
@@ -560,6 +1784,10 @@ germinal_terminal_search_prev (GerminalTerminal *self)
 {
     g_return_val_if_fail (GERMINAL_IS_TERMINAL (self), FALSE);
 
+    germinal_terminal_flush_search (self);
+    germinal_terminal_settle_copy (self);
+    germinal_terminal_move_match (self, -1);
+
     return vte_terminal_search_find_previous (VTE_TERMINAL (self));
 }
 
@@ -568,16 +1796,76 @@ germinal_terminal_search_stop (GerminalTerminal *self)
 {
     g_return_if_fail (GERMINAL_IS_TERMINAL (self));
 
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    g_clear_handle_id (&priv->search_source_id, g_source_remove);
+    g_clear_pointer (&priv->pending_search, g_free);
+    g_clear_pointer (&priv->search_text, g_free);
+
+    germinal_terminal_count_matches (self, NULL, FALSE, FALSE);
     vte_terminal_search_set_regex (VTE_TERMINAL (self), NULL, 0);
 }
 
+/* Brings row in the middle of the view, as far as the scrollback allows */
+void
+germinal_terminal_scroll_to_row (GerminalTerminal *self,
+                                 gint64            row)
+{
+    g_return_if_fail (GERMINAL_IS_TERMINAL (self));
+
+    GtkAdjustment *vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (self));
+
+    gtk_adjustment_set_value (vadjustment, row - vte_terminal_get_row_count (VTE_TERMINAL (self)) / 2);
+}
+
+/* FALSE until the first count for the search is in */
+gboolean
+germinal_terminal_get_search_matches (GerminalTerminal *self,
+                                      guint            *current,
+                                      guint            *total)
+{
+    g_return_val_if_fail (GERMINAL_IS_TERMINAL (self), FALSE);
+
+    GerminalTerminalPrivate *priv = germinal_terminal_get_instance_private (self);
+
+    *total = germinal_match_counter_get_n_matches (priv->match_counter);
+    *current = priv->match_row >= 0 && *total ? MIN (germinal_match_counter_count_before (priv->match_counter, priv->match_row) + priv->match_nth + 1, *total) : 0;
+
+    return priv->search_text && priv->locate_from == G_MININT64;
+}
+
 static void
 germinal_terminal_class_init (GerminalTerminalClass *klass)
 {
     GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+    GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
 
     gobject_class->dispose = germinal_terminal_dispose;
     gobject_class->finalize = germinal_terminal_finalize;
+
+    /* The search matches, their count or the current one changed */
+    signals[SIGNAL_SEARCH_CHANGED] = g_signal_new ("search-changed",
+                                                   G_TYPE_FROM_CLASS (klass),
+                                                   G_SIGNAL_RUN_LAST,
+                                                   0, NULL, NULL, NULL,
+                                                   G_TYPE_NONE, 0);
+
+    /* More of a paste went through, see germinal_terminal_get_paste_progress() */
+    signals[SIGNAL_PASTE_PROGRESS] = g_signal_new ("paste-progress",
+                                                   G_TYPE_FROM_CLASS (klass),
+                                                   G_SIGNAL_RUN_LAST,
+                                                   0, NULL, NULL, NULL,
+                                                   G_TYPE_NONE, 0);
+
+    /* A paste is over, with its throughput in bytes per second if it all went through, or -1 */
+    signals[SIGNAL_PASTE_FINISHED] = g_signal_new ("paste-finished",
+                                                   G_TYPE_FROM_CLASS (klass),
+                                                   G_SIGNAL_RUN_LAST,
+                                                   0, NULL, NULL, NULL,
+                                                   G_TYPE_NONE, 1, G_TYPE_DOUBLE);
+
+    widget_class->size_allocate = germinal_terminal_size_allocate;
+    widget_class->snapshot      = germinal_terminal_snapshot;
 }
 
 GtkWidget *
@@ -5,6 +5,9 @@
 
 #include <glib/gi18n-lib.h>
 
+#include "germinal-pty-child.h"
+#include "germinal-tmux.h"
+
 #include <vte/vte.h>
 
 G_BEGIN_DECLS
@@ -19,17 +22,30 @@ gboolean     germinal_terminal_copy_url    (GerminalTerminal *self);
 void         germinal_terminal_copy        (GerminalTerminal *self);
 void         germinal_terminal_copy_html   (GerminalTerminal *self);
 void         germinal_terminal_paste       (GerminalTerminal *self);
-gboolean     germinal_terminal_spawn       (GerminalTerminal *self, gchar **cmd, GError **error);
+void         germinal_terminal_cancel_paste (GerminalTerminal *self);
+gboolean     germinal_terminal_get_paste_progress (GerminalTerminal *self, gsize *done, gsize *total);
 void         germinal_terminal_zoom_in     (GerminalTerminal *self);
 void         germinal_terminal_zoom_out    (GerminalTerminal *self);
 void         germinal_terminal_reset_zoom  (GerminalTerminal *self);
 
 void         germinal_terminal_spawn_command (GerminalTerminal *self, GStrv command);
+void         germinal_terminal_set_tmux      (GerminalTerminal *self, GerminalTmux *tmux);
+void         germinal_terminal_set_tmux_session (GerminalTerminal *self, const gchar * const *globals, const gchar *session);
+
+void              germinal_terminal_attach        (GerminalTerminal *self, GerminalPtyChild *child);
+GerminalPtyChild *germinal_terminal_get_pty_child (GerminalTerminal *self);
+guint             germinal_terminal_get_child_resizes (GerminalTerminal *self);
+guint             germinal_terminal_get_reconfigurations (GerminalTerminal *self);
 
-gboolean     germinal_terminal_search      (GerminalTerminal *self, const gchar *text);
+void         germinal_terminal_search      (GerminalTerminal *self, const gchar *text, gboolean regex);
 gboolean     germinal_terminal_search_next (GerminalTerminal *self);
 gboolean     germinal_terminal_search_prev (GerminalTerminal *self);
 void         germinal_terminal_search_stop (GerminalTerminal *self);
+gboolean     germinal_terminal_get_search_matches (GerminalTerminal *self, guint *current, guint *total);
+void         germinal_terminal_scroll_to_row (GerminalTerminal *self, gint64 row);
+
+void         germinal_terminal_prespawn      (GStrv command);
+void         germinal_terminal_drop_prespawn (void);
 
 GtkWidget *germinal_terminal_new (void);
 
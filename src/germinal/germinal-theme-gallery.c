@@ -0,0 +1,453 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-theme-gallery.h"
+#include "germinal-settings.h"
+#include "germinal-theme.h"
+
+#include <glib/gi18n-lib.h>
+
+#define PREVIEW_WIDTH  160
+#define PREVIEW_HEIGHT 32
+
+struct _GerminalThemeGallery
+{
+    GtkWidget parent_instance;
+};
+
+typedef struct
+{
+    GSettings    *settings;
+    GListStore   *themes;
+    GtkWidget    *import_button;
+    GCancellable *cancellable;
+} GerminalThemeGalleryPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GerminalThemeGallery, germinal_theme_gallery, GTK_TYPE_WIDGET)
+
+static gchar *
+germinal_theme_gallery_library_path (void)
+{
+    return g_build_filename (g_get_user_data_dir (), "germinal", "themes", NULL);
+}
+
+/* --- Previews --------------------------------------------------------- */
+
+static void
+draw_preview (GtkDrawingArea *area      G_GNUC_UNUSED,
+              cairo_t        *cr,
+              gint            width,
+              gint            height,
+              gpointer        user_data)
+{
+    GerminalTheme *theme = GERMINAL_THEME (user_data);
+    const GdkRGBA *palette = germinal_theme_get_palette (theme);
+    gdouble cell = MIN ((width - height) / 8.0, height / 2.0);
+
+    gdk_cairo_set_source_rgba (cr, germinal_theme_get_background (theme));
+    cairo_paint (cr);
+
+    /* The foreground as a text line would be, then both palette rows */
+    gdk_cairo_set_source_rgba (cr, germinal_theme_get_foreground (theme));
+    cairo_rectangle (cr, height / 4.0, height * 3.0 / 8.0, height / 2.0, height / 4.0);
+    cairo_fill (cr);
+
+    for (guint i = 0; i < GERMINAL_THEME_N_COLORS; ++i)
+    {
+        gdk_cairo_set_source_rgba (cr, &palette[i]);
+        cairo_rectangle (cr, height + (i % 8) * cell, (i / 8) * cell, cell, cell);
+        cairo_fill (cr);
+    }
+}
+
+static void
+on_setup_row (GtkSignalListItemFactory *factory   G_GNUC_UNUSED,
+              GtkListItem              *item,
+              gpointer                  user_data G_GNUC_UNUSED)
+{
+    GtkWidget *box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 12);
+    GtkWidget *preview = gtk_drawing_area_new ();
+    GtkWidget *label = gtk_label_new (NULL);
+
+    gtk_drawing_area_set_content_width (GTK_DRAWING_AREA (preview), PREVIEW_WIDTH);
+    gtk_drawing_area_set_content_height (GTK_DRAWING_AREA (preview), PREVIEW_HEIGHT);
+    gtk_label_set_xalign (GTK_LABEL (label), 0.0);
+    gtk_label_set_ellipsize (GTK_LABEL (label), PANGO_ELLIPSIZE_END);
+
+    gtk_widget_set_margin_start  (box, 6);
+    gtk_widget_set_margin_end    (box, 6);
+    gtk_widget_set_margin_top    (box, 3);
+    gtk_widget_set_margin_bottom (box, 3);
+    gtk_box_append (GTK_BOX (box), preview);
+    gtk_box_append (GTK_BOX (box), label);
+    gtk_list_item_set_child (item, box);
+}
+
+/* Only rows in view get bound, so only those are ever drawn */
+static void
+on_bind_row (GtkSignalListItemFactory *factory   G_GNUC_UNUSED,
+             GtkListItem              *item,
+             gpointer                  user_data G_GNUC_UNUSED)
+{
+    GerminalTheme *theme = gtk_list_item_get_item (item);
+    GtkWidget *preview = gtk_widget_get_first_child (gtk_list_item_get_child (item));
+
+    gtk_drawing_area_set_draw_func (GTK_DRAWING_AREA (preview), draw_preview, g_object_ref (theme), g_object_unref);
+    gtk_label_set_text (GTK_LABEL (gtk_widget_get_next_sibling (preview)), germinal_theme_get_name (theme));
+}
+
+static void
+on_unbind_row (GtkSignalListItemFactory *factory   G_GNUC_UNUSED,
+               GtkListItem              *item,
+               gpointer                  user_data G_GNUC_UNUSED)
+{
+    GtkWidget *preview = gtk_widget_get_first_child (gtk_list_item_get_child (item));
+
+    gtk_drawing_area_set_draw_func (GTK_DRAWING_AREA (preview), NULL, NULL, NULL);
+}
+
+/* --- Applying --------------------------------------------------------- */
+
+static void
+on_theme_activated (GtkListView *list_view G_GNUC_UNUSED,
+                    guint        position,
+                    gpointer     user_data)
+{
+    GerminalThemeGallery *self = GERMINAL_THEME_GALLERY (user_data);
+    GerminalThemeGalleryPrivate *priv = germinal_theme_gallery_get_instance_private (self);
+    g_autoptr (GerminalTheme) theme = g_list_model_get_item (G_LIST_MODEL (priv->themes), position);
+    const GdkRGBA *palette = germinal_theme_get_palette (theme);
+    g_autofree gchar *forecolor = gdk_rgba_to_string (germinal_theme_get_foreground (theme));
+    g_autofree gchar *backcolor = gdk_rgba_to_string (germinal_theme_get_background (theme));
+    g_auto (GStrv) colors = g_new0 (gchar *, GERMINAL_THEME_N_COLORS + 1);
+
+    for (guint i = 0; i < GERMINAL_THEME_N_COLORS; ++i)
+        colors[i] = gdk_rgba_to_string (&palette[i]);
+
+    /* Terminals pick the three up in the same frame, then it's a single write */
+    g_settings_set_string (priv->settings, FORECOLOR_KEY, forecolor);
+    g_settings_set_string (priv->settings, BACKCOLOR_KEY, backcolor);
+    g_settings_set_strv (priv->settings, PALETTE_KEY, (const gchar * const *) colors);
+    germinal_settings_flush ();
+}
+
+/* --- Importing -------------------------------------------------------- */
+
+typedef struct
+{
+    /* NULL to only look for deleted themes */
+    GFile      *directory;
+    GHashTable *known;
+    /* Sources of known themes whose file was deleted */
+    GHashTable *gone;
+} ImportData;
+
+static void
+import_data_free (gpointer data)
+{
+    ImportData *import = data;
+
+    g_clear_object (&import->directory);
+    g_hash_table_unref (import->known);
+    g_hash_table_unref (import->gone);
+    g_free (import);
+}
+
+static void
+import_themes (GTask        *task,
+               gpointer      source_object G_GNUC_UNUSED,
+               gpointer      task_data,
+               GCancellable *cancellable)
+{
+    ImportData *import = task_data;
+    g_autoptr (GError) error = NULL;
+    g_autoptr (GPtrArray) themes = g_ptr_array_new_with_free_func (g_object_unref);
+    g_autoptr (GHashTable) seen = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    g_autofree gchar *directory = NULL;
+
+    if (import->directory)
+    {
+        g_autoptr (GFileEnumerator) children = g_file_enumerate_children (import->directory,
+                                                                         G_FILE_ATTRIBUTE_STANDARD_NAME ","
+                                                                         G_FILE_ATTRIBUTE_STANDARD_TYPE ","
+                                                                         GERMINAL_THEME_FILE_ATTRIBUTES,
+                                                                         G_FILE_QUERY_INFO_NONE, cancellable, &error);
+        GFileInfo *info;
+        GFile *child;
+
+        if (!children)
+        {
+            g_task_return_error (task, g_steal_pointer (&error));
+            return;
+        }
+
+        while (g_file_enumerator_iterate (children, &info, &child, cancellable, &error) && info)
+        {
+            if (g_file_info_get_file_type (info) != G_FILE_TYPE_REGULAR)
+                continue;
+
+            gchar *path = g_file_get_path (child);
+            GerminalTheme *known = g_hash_table_lookup (import->known, path);
+            g_autoptr (GError) theme_error = NULL;
+
+            g_hash_table_add (seen, path);
+
+            /* Already validated when it was first imported */
+            if (known && germinal_theme_is_up_to_date (known, info))
+                continue;
+
+            GerminalTheme *theme = germinal_theme_load (child, cancellable, &theme_error);
+
+            if (theme)
+                g_ptr_array_add (themes, theme);
+            else
+                g_debug ("Skipping %s: %s", path, theme_error->message);
+        }
+
+        if (error)
+        {
+            g_task_return_error (task, g_steal_pointer (&error));
+            return;
+        }
+
+        directory = g_file_get_path (import->directory);
+    }
+
+    GHashTableIter iter;
+    const gchar *source;
+
+    g_hash_table_iter_init (&iter, import->known);
+    while (g_hash_table_iter_next (&iter, (gpointer *) &source, NULL))
+    {
+        g_autofree gchar *dirname = g_path_get_dirname (source);
+
+        if (g_hash_table_contains (seen, source))
+            continue;
+
+        /* The imported directory was just enumerated, the others need a look */
+        if (!g_strcmp0 (dirname, directory) || !g_file_test (source, G_FILE_TEST_EXISTS))
+            g_hash_table_add (import->gone, g_strdup (source));
+    }
+
+    g_task_return_pointer (task, g_steal_pointer (&themes), (GDestroyNotify) g_ptr_array_unref);
+}
+
+static void
+on_themes_imported (GObject      *source,
+                    GAsyncResult *result,
+                    gpointer      user_data G_GNUC_UNUSED)
+{
+    GerminalThemeGallery *self = GERMINAL_THEME_GALLERY (source);
+    GerminalThemeGalleryPrivate *priv = germinal_theme_gallery_get_instance_private (self);
+    ImportData *import = g_task_get_task_data (G_TASK (result));
+    g_autoptr (GError) error = NULL;
+    g_autoptr (GPtrArray) themes = g_task_propagate_pointer (G_TASK (result), &error);
+
+    /* Disposed while importing */
+    if (!priv->themes)
+        return;
+
+    gtk_widget_set_sensitive (priv->import_button, TRUE);
+
+    if (!themes)
+    {
+        if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+            g_warning ("Couldn't import themes: %s", error->message);
+        return;
+    }
+
+    if (!themes->len && !g_hash_table_size (import->gone))
+        return;
+
+    GListModel *model = G_LIST_MODEL (priv->themes);
+    g_autoptr (GHashTable) positions = g_hash_table_new (g_str_hash, g_str_equal);
+
+    /* Their files were deleted since they were imported */
+    for (guint i = g_list_model_get_n_items (model); i > 0; --i)
+    {
+        g_autoptr (GerminalTheme) theme = g_list_model_get_item (model, i - 1);
+
+        if (g_hash_table_contains (import->gone, germinal_theme_get_source (theme)))
+            g_list_store_remove (priv->themes, i - 1);
+    }
+
+    for (guint i = 0; i < g_list_model_get_n_items (model); ++i)
+    {
+        g_autoptr (GerminalTheme) theme = g_list_model_get_item (model, i);
+
+        g_hash_table_insert (positions, (gpointer) germinal_theme_get_source (theme), GUINT_TO_POINTER (i + 1));
+    }
+
+    /* Files that changed since they were imported replace their old version */
+    for (guint i = 0; i < themes->len; ++i)
+    {
+        GerminalTheme *theme = themes->pdata[i];
+        guint position = GPOINTER_TO_UINT (g_hash_table_lookup (positions, germinal_theme_get_source (theme)));
+
+        if (position)
+            g_list_store_splice (priv->themes, position - 1, 1, (gpointer *) &theme, 1);
+        else
+            g_list_store_append (priv->themes, theme);
+    }
+
+    g_autofree gchar *path = germinal_theme_gallery_library_path ();
+
+    if (!germinal_theme_library_save (path, model, &error))
+        g_warning ("Couldn't save the imported themes: %s", error->message);
+}
+
+static void
+germinal_theme_gallery_scan (GerminalThemeGallery *self,
+                             GFile                *directory)
+{
+    GerminalThemeGalleryPrivate *priv = germinal_theme_gallery_get_instance_private (self);
+    GListModel *model = G_LIST_MODEL (priv->themes);
+    ImportData *import = g_new (ImportData, 1);
+
+    import->directory = directory ? g_object_ref (directory) : NULL;
+    import->known = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_object_unref);
+    import->gone = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+    for (guint i = 0; i < g_list_model_get_n_items (model); ++i)
+    {
+        GerminalTheme *theme = g_list_model_get_item (model, i);
+
+        g_hash_table_insert (import->known, (gpointer) germinal_theme_get_source (theme), theme);
+    }
+
+    g_autoptr (GTask) task = g_task_new (self, priv->cancellable, on_themes_imported, NULL);
+
+    gtk_widget_set_sensitive (priv->import_button, FALSE);
+    g_task_set_name (task, directory ? "[germinal] import-themes" : "[germinal] prune-themes");
+    g_task_set_task_data (task, import, import_data_free);
+    g_task_run_in_thread (task, import_themes);
+}
+
+void
+germinal_theme_gallery_import (GerminalThemeGallery *self,
+                               GFile                *directory)
+{
+    g_return_if_fail (GERMINAL_IS_THEME_GALLERY (self));
+    g_return_if_fail (G_IS_FILE (directory));
+
+    germinal_theme_gallery_scan (self, directory);
+}
+
+static void
+on_folder_selected (GObject      *source,
+                    GAsyncResult *result,
+                    gpointer      user_data)
+{
+    g_autoptr (GerminalThemeGallery) self = user_data;
+    g_autoptr (GFile) directory = gtk_file_dialog_select_folder_finish (GTK_FILE_DIALOG (source), result, NULL);
+
+    if (directory)
+        germinal_theme_gallery_import (self, directory);
+}
+
+static void
+on_import_clicked (GtkButton *button G_GNUC_UNUSED,
+                   gpointer   user_data)
+{
+    GerminalThemeGallery *self = GERMINAL_THEME_GALLERY (user_data);
+    g_autoptr (GtkFileDialog) dialog = gtk_file_dialog_new ();
+    GtkRoot *root = gtk_widget_get_root (GTK_WIDGET (self));
+
+    gtk_file_dialog_set_title (dialog, _("Import themes"));
+    gtk_file_dialog_select_folder (dialog, GTK_IS_WINDOW (root) ? GTK_WINDOW (root) : NULL, NULL, on_folder_selected, g_object_ref (self));
+}
+
+/* --- Widget ----------------------------------------------------------- */
+
+GListModel *
+germinal_theme_gallery_get_themes (GerminalThemeGallery *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_THEME_GALLERY (self), NULL);
+
+    GerminalThemeGalleryPrivate *priv = germinal_theme_gallery_get_instance_private (self);
+
+    return G_LIST_MODEL (priv->themes);
+}
+
+static void
+germinal_theme_gallery_dispose (GObject *object)
+{
+    GerminalThemeGallery *self = GERMINAL_THEME_GALLERY (object);
+    GerminalThemeGalleryPrivate *priv = germinal_theme_gallery_get_instance_private (self);
+
+    g_cancellable_cancel (priv->cancellable);
+    g_clear_object (&priv->cancellable);
+    g_clear_object (&priv->settings);
+    g_clear_object (&priv->themes);
+
+    for (GtkWidget *child = gtk_widget_get_first_child (GTK_WIDGET (self)); child != NULL; )
+    {
+        GtkWidget *next = gtk_widget_get_next_sibling (child);
+        gtk_widget_unparent (child);
+        child = next;
+    }
+
+    G_OBJECT_CLASS (germinal_theme_gallery_parent_class)->dispose (object);
+}
+
+static void
+germinal_theme_gallery_init (GerminalThemeGallery *self)
+{
+    GerminalThemeGalleryPrivate *priv = germinal_theme_gallery_get_instance_private (self);
+
+    priv->themes = g_list_store_new (GERMINAL_TYPE_THEME);
+    priv->cancellable = g_cancellable_new ();
+}
+
+static void
+germinal_theme_gallery_class_init (GerminalThemeGalleryClass *klass)
+{
+    G_OBJECT_CLASS (klass)->dispose = germinal_theme_gallery_dispose;
+
+    GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
+    gtk_widget_class_set_layout_manager_type (widget_class, GTK_TYPE_BOX_LAYOUT);
+    gtk_widget_class_set_css_name (widget_class, "germinal-theme-gallery");
+}
+
+GtkWidget *
+germinal_theme_gallery_new (GSettings *settings)
+{
+    GerminalThemeGallery *self = g_object_new (GERMINAL_TYPE_THEME_GALLERY, NULL);
+    GerminalThemeGalleryPrivate *priv = germinal_theme_gallery_get_instance_private (self);
+    g_autofree gchar *path = germinal_theme_gallery_library_path ();
+    g_autoptr (GPtrArray) themes = germinal_theme_library_load (path);
+
+    priv->settings = g_object_ref (settings);
+    g_list_store_splice (priv->themes, 0, 0, themes->pdata, themes->len);
+
+    gtk_orientable_set_orientation (GTK_ORIENTABLE (gtk_widget_get_layout_manager (GTK_WIDGET (self))),
+                                    GTK_ORIENTATION_VERTICAL);
+
+    GtkListItemFactory *factory = gtk_signal_list_item_factory_new ();
+    g_signal_connect (factory, "setup",  G_CALLBACK (on_setup_row),  NULL);
+    g_signal_connect (factory, "bind",   G_CALLBACK (on_bind_row),   NULL);
+    g_signal_connect (factory, "unbind", G_CALLBACK (on_unbind_row), NULL);
+
+    GtkNoSelection *selection = gtk_no_selection_new (G_LIST_MODEL (g_object_ref (priv->themes)));
+    GtkWidget *list_view = gtk_list_view_new (GTK_SELECTION_MODEL (selection), factory);
+    gtk_list_view_set_single_click_activate (GTK_LIST_VIEW (list_view), TRUE);
+    g_signal_connect_object (list_view, "activate", G_CALLBACK (on_theme_activated), self, 0);
+
+    GtkWidget *scrolled = gtk_scrolled_window_new ();
+    gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scrolled), GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+    gtk_scrolled_window_set_min_content_height (GTK_SCROLLED_WINDOW (scrolled), 240);
+    gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (scrolled), list_view);
+    gtk_widget_set_parent (scrolled, GTK_WIDGET (self));
+
+    priv->import_button = gtk_button_new_with_mnemonic (_("_Import Themes…"));
+    gtk_widget_set_halign (priv->import_button, GTK_ALIGN_END);
+    gtk_widget_set_margin_top (priv->import_button, 6);
+    g_signal_connect_object (priv->import_button, "clicked", G_CALLBACK (on_import_clicked), self, 0);
+    gtk_widget_set_parent (priv->import_button, GTK_WIDGET (self));
+
+    /* Drop the themes whose file was deleted since they were imported */
+    if (themes->len)
+        germinal_theme_gallery_scan (self, NULL);
+
+    return GTK_WIDGET (self);
+}
@@ -0,0 +1,18 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <gtk/gtk.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define GERMINAL_TYPE_THEME_GALLERY germinal_theme_gallery_get_type ()
+G_DECLARE_FINAL_TYPE (GerminalThemeGallery, germinal_theme_gallery, GERMINAL, THEME_GALLERY, GtkWidget)
+
+GtkWidget  *germinal_theme_gallery_new        (GSettings *settings);
+GListModel *germinal_theme_gallery_get_themes (GerminalThemeGallery *self);
+void        germinal_theme_gallery_import     (GerminalThemeGallery *self, GFile *directory);
+
+G_END_DECLS
@@ -0,0 +1,670 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-theme.h"
+
+#include <glib/gstdio.h>
+
+#include <errno.h>
+#include <string.h>
+
+/* Where each color lives, both while parsing and in the library */
+enum
+{
+    COLOR_FOREGROUND,
+    COLOR_BACKGROUND,
+    COLOR_PALETTE,
+    N_COLORS = COLOR_PALETTE + GERMINAL_THEME_N_COLORS,
+};
+
+#define ALL_PALETTE_COLORS (((1u << GERMINAL_THEME_N_COLORS) - 1) << COLOR_PALETTE)
+
+/* Each scheme is validated once on import, then stored as RGBA */
+#define LIBRARY_TYPE G_VARIANT_TYPE ("a(sxtsa(dddd))")
+
+struct _GerminalTheme
+{
+    GObject parent_instance;
+};
+
+typedef struct
+{
+    gchar   *name;
+    gchar   *source;
+    gint64   mtime;
+    guint64  size;
+    GdkRGBA  colors[N_COLORS];
+} GerminalThemePrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GerminalTheme, germinal_theme, G_TYPE_OBJECT)
+
+/* What the parsers found so far */
+typedef struct
+{
+    gchar   *name;
+    GdkRGBA  colors[N_COLORS];
+    guint32  found;
+} ThemeColors;
+
+static void
+theme_colors_set (ThemeColors   *colors,
+                  guint          index,
+                  const GdkRGBA *rgba)
+{
+    colors->colors[index] = *rgba;
+    colors->found |= 1u << index;
+}
+
+/* gdk_rgba_parse doesn't know about X11's rgb:rr/gg/bb */
+static gboolean
+parse_color (GdkRGBA     *rgba,
+             const gchar *value)
+{
+    if (g_str_has_prefix (value, "rgb:"))
+    {
+        g_auto (GStrv) components = g_strsplit (value + 4, "/", -1);
+
+        if (g_strv_length (components) != 3)
+            return FALSE;
+
+        gdouble channels[3];
+
+        for (guint i = 0; i < 3; ++i)
+        {
+            gchar *end = NULL;
+            gsize len = strlen (components[i]);
+            guint64 channel = g_ascii_strtoull (components[i], &end, 16);
+
+            if (!len || len > 4 || *end)
+                return FALSE;
+
+            channels[i] = (gdouble) channel / (gdouble) ((1u << (4 * len)) - 1);
+        }
+
+        *rgba = (GdkRGBA) { channels[0], channels[1], channels[2], 1.0 };
+        return TRUE;
+    }
+
+    return gdk_rgba_parse (rgba, value);
+}
+
+static gchar *
+unquote (gchar *value)
+{
+    g_strstrip (value);
+
+    gsize len = strlen (value);
+
+    if (len >= 2 && (value[0] == '"' || value[0] == '\'') && value[len - 1] == value[0])
+    {
+        value[len - 1] = '\0';
+        ++value;
+    }
+
+    return value;
+}
+
+/* --- Xresources ------------------------------------------------------- */
+
+typedef struct
+{
+    ThemeColors *colors;
+    GHashTable  *defines;
+} XresourcesParser;
+
+static void
+parse_xresources_line (XresourcesParser *parser,
+                       gchar            *line)
+{
+    g_strstrip (line);
+
+    if (!*line || *line == '!')
+        return;
+
+    if (g_str_has_prefix (line, "#define"))
+    {
+        g_auto (GStrv) define = g_strsplit_set (line + strlen ("#define"), " \t", -1);
+        const gchar *name = NULL;
+
+        for (guint i = 0; define[i]; ++i)
+        {
+            if (!*define[i])
+                continue;
+            if (!name)
+                name = define[i];
+            else
+            {
+                g_hash_table_insert (parser->defines, g_strdup (name), g_strdup (define[i]));
+                break;
+            }
+        }
+        return;
+    }
+
+    gchar *separator = strchr (line, ':');
+
+    if (!separator)
+        return;
+
+    *separator = '\0';
+
+    /* *.color4, URxvt*foreground... only the last component matters */
+    gchar *resource = g_strstrip (line);
+    gchar *last = MAX (strrchr (resource, '.'), strrchr (resource, '*'));
+    const gchar *value = unquote (separator + 1);
+    const gchar *defined = g_hash_table_lookup (parser->defines, value);
+    guint index;
+    GdkRGBA rgba;
+
+    if (last)
+        resource = last + 1;
+
+    if (!g_ascii_strcasecmp (resource, "foreground"))
+        index = COLOR_FOREGROUND;
+    else if (!g_ascii_strcasecmp (resource, "background"))
+        index = COLOR_BACKGROUND;
+    else if (!g_ascii_strncasecmp (resource, "color", 5))
+    {
+        guint64 n;
+
+        if (!g_ascii_string_to_unsigned (resource + 5, 10, 0, GERMINAL_THEME_N_COLORS - 1, &n, NULL))
+            return;
+        index = COLOR_PALETTE + n;
+    }
+    else
+        return;
+
+    if (parse_color (&rgba, defined ? defined : value))
+        theme_colors_set (parser->colors, index, &rgba);
+}
+
+/* --- base16 ----------------------------------------------------------- */
+
+/* Which base16 color each ANSI color is, as base16-shell does */
+static const guint base16_ansi[GERMINAL_THEME_N_COLORS] = {
+    0x00, 0x08, 0x0B, 0x0A, 0x0D, 0x0E, 0x0C, 0x05,
+    0x03, 0x08, 0x0B, 0x0A, 0x0D, 0x0E, 0x0C, 0x07,
+};
+
+static void
+parse_base16_line (ThemeColors *colors,
+                   GdkRGBA     *base,
+                   guint32     *found,
+                   gchar       *line)
+{
+    gchar *comment = strchr (line, '#');
+    gchar *separator = strchr (line, ':');
+
+    /* Both quoted "#rrggbb" values and comments are a thing */
+    if (comment && (!separator || comment < separator))
+        return;
+    if (!separator)
+        return;
+
+    *separator = '\0';
+
+    gchar *key = g_strstrip (line);
+    gchar *value = separator + 1;
+
+    comment = strstr (value, " #");
+    if (comment)
+        *comment = '\0';
+    value = unquote (value);
+
+    if (!g_strcmp0 (key, "scheme") || !g_strcmp0 (key, "name"))
+    {
+        g_free (colors->name);
+        colors->name = g_strdup (value);
+        return;
+    }
+
+    guint64 n;
+
+    if (!g_str_has_prefix (key, "base") || !g_ascii_string_to_unsigned (key + 4, 16, 0, 0x0F, &n, NULL) || strlen (key) != 6)
+        return;
+
+    g_autofree gchar *color = g_strconcat (*value == '#' ? "" : "#", value, NULL);
+
+    if (gdk_rgba_parse (&base[n], color))
+        *found |= 1u << n;
+}
+
+/* --- iTerm2 ----------------------------------------------------------- */
+
+typedef struct
+{
+    ThemeColors *colors;
+    guint        depth;
+    gboolean     in_text;
+    GString     *text;
+    gchar       *color_key;
+    gchar       *component_key;
+    GdkRGBA      color;
+} ItermParser;
+
+static void
+iterm_start_element (GMarkupParseContext  *context        G_GNUC_UNUSED,
+                     const gchar          *element_name,
+                     const gchar         **attribute_names  G_GNUC_UNUSED,
+                     const gchar         **attribute_values G_GNUC_UNUSED,
+                     gpointer              user_data,
+                     GError              **error            G_GNUC_UNUSED)
+{
+    ItermParser *parser = user_data;
+
+    if (!g_strcmp0 (element_name, "dict"))
+    {
+        if (++parser->depth == 2)
+            parser->color = (GdkRGBA) { 0.0, 0.0, 0.0, 1.0 };
+    }
+    else if (!g_strcmp0 (element_name, "key") || !g_strcmp0 (element_name, "real"))
+    {
+        parser->in_text = TRUE;
+        g_string_truncate (parser->text, 0);
+    }
+}
+
+static gint
+iterm_color_index (const gchar *key)
+{
+    if (!g_strcmp0 (key, "Foreground Color"))
+        return COLOR_FOREGROUND;
+    if (!g_strcmp0 (key, "Background Color"))
+        return COLOR_BACKGROUND;
+
+    /* Not the "Ansi 1 Color (Light)" variants of newer versions */
+    if (key && g_str_has_prefix (key, "Ansi "))
+    {
+        gchar *end = NULL;
+        guint64 n = g_ascii_strtoull (key + 5, &end, 10);
+
+        if (end != key + 5 && !g_strcmp0 (end, " Color") && n < GERMINAL_THEME_N_COLORS)
+            return COLOR_PALETTE + n;
+    }
+
+    return -1;
+}
+
+static void
+iterm_end_element (GMarkupParseContext  *context      G_GNUC_UNUSED,
+                   const gchar          *element_name,
+                   gpointer              user_data,
+                   GError              **error        G_GNUC_UNUSED)
+{
+    ItermParser *parser = user_data;
+
+    parser->in_text = FALSE;
+
+    if (!g_strcmp0 (element_name, "dict"))
+    {
+        gint index = parser->depth == 2 ? iterm_color_index (parser->color_key) : -1;
+
+        if (index >= 0)
+            theme_colors_set (parser->colors, index, &parser->color);
+        --parser->depth;
+    }
+    else if (!g_strcmp0 (element_name, "key"))
+    {
+        gchar **key = parser->depth == 1 ? &parser->color_key : &parser->component_key;
+
+        g_free (*key);
+        *key = g_strdup (parser->text->str);
+    }
+    else if (!g_strcmp0 (element_name, "real") && parser->depth == 2)
+    {
+        gdouble value = CLAMP (g_ascii_strtod (parser->text->str, NULL), 0.0, 1.0);
+
+        if (!g_strcmp0 (parser->component_key, "Red Component"))
+            parser->color.red = value;
+        else if (!g_strcmp0 (parser->component_key, "Green Component"))
+            parser->color.green = value;
+        else if (!g_strcmp0 (parser->component_key, "Blue Component"))
+            parser->color.blue = value;
+        else if (!g_strcmp0 (parser->component_key, "Alpha Component"))
+            parser->color.alpha = value;
+    }
+}
+
+static void
+iterm_text (GMarkupParseContext  *context   G_GNUC_UNUSED,
+            const gchar          *text,
+            gsize                 text_len,
+            gpointer              user_data,
+            GError              **error     G_GNUC_UNUSED)
+{
+    ItermParser *parser = user_data;
+
+    if (parser->in_text)
+        g_string_append_len (parser->text, text, text_len);
+}
+
+static const GMarkupParser iterm_parser = {
+    .start_element = iterm_start_element,
+    .end_element   = iterm_end_element,
+    .text          = iterm_text,
+};
+
+static gboolean
+parse_iterm (GInputStream  *stream,
+             ThemeColors   *colors,
+             GCancellable  *cancellable,
+             GError       **error)
+{
+    ItermParser parser = { .colors = colors, .text = g_string_new (NULL) };
+    g_autoptr (GMarkupParseContext) context = g_markup_parse_context_new (&iterm_parser, G_MARKUP_IGNORE_QUALIFIED, &parser, NULL);
+    gchar buffer[4096];
+    gssize read = 0;
+    gboolean ret = TRUE;
+
+    while (ret && (read = g_input_stream_read (stream, buffer, sizeof (buffer), cancellable, error)) > 0)
+        ret = g_markup_parse_context_parse (context, buffer, read, error);
+
+    ret = ret && read == 0 && g_markup_parse_context_end_parse (context, error);
+
+    g_string_free (parser.text, TRUE);
+    g_free (parser.color_key);
+    g_free (parser.component_key);
+
+    return ret;
+}
+
+/* --- Loading ---------------------------------------------------------- */
+
+static gboolean
+parse_lines (GInputStream  *stream,
+             gboolean       base16,
+             ThemeColors   *colors,
+             GCancellable  *cancellable,
+             GError       **error)
+{
+    g_autoptr (GDataInputStream) data = g_data_input_stream_new (stream);
+    g_autoptr (GHashTable) defines = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    XresourcesParser xresources = { colors, defines };
+    GdkRGBA base[16];
+    guint32 found = 0;
+    gchar *line;
+    GError *local_error = NULL;
+
+    while ((line = g_data_input_stream_read_line_utf8 (data, NULL, cancellable, &local_error)))
+    {
+        if (base16)
+            parse_base16_line (colors, base, &found, line);
+        else
+            parse_xresources_line (&xresources, line);
+        g_free (line);
+    }
+
+    if (local_error)
+    {
+        g_propagate_error (error, local_error);
+        return FALSE;
+    }
+
+    if (base16 && found == 0xFFFF)
+    {
+        theme_colors_set (colors, COLOR_FOREGROUND, &base[0x05]);
+        theme_colors_set (colors, COLOR_BACKGROUND, &base[0x00]);
+        for (guint i = 0; i < GERMINAL_THEME_N_COLORS; ++i)
+            theme_colors_set (colors, COLOR_PALETTE + i, &base[base16_ansi[i]]);
+    }
+
+    return TRUE;
+}
+
+static gchar *
+name_from_basename (const gchar *basename)
+{
+    const gchar *extension = strrchr (basename, '.');
+
+    /* .Xresources would end up with no name at all */
+    if (!extension || extension == basename)
+        return g_strdup (basename);
+
+    return g_strndup (basename, extension - basename);
+}
+
+/* In nanoseconds, a scheme rewritten within the same second is still a new one */
+static gint64
+file_info_get_mtime (GFileInfo *info)
+{
+    return (gint64) g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED) * G_GINT64_CONSTANT (1000000000) +
+           g_file_info_get_attribute_uint32 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED_NSEC);
+}
+
+GerminalTheme *
+germinal_theme_load (GFile         *file,
+                     GCancellable  *cancellable,
+                     GError       **error)
+{
+    g_return_val_if_fail (G_IS_FILE (file), NULL);
+
+    g_autoptr (GFileInputStream) stream = g_file_read (file, cancellable, error);
+
+    if (!stream)
+        return NULL;
+
+    g_autoptr (GFileInfo) info = g_file_input_stream_query_info (stream, GERMINAL_THEME_FILE_ATTRIBUTES, cancellable, error);
+
+    if (!info)
+        return NULL;
+
+    g_autofree gchar *basename = g_file_get_basename (file);
+    ThemeColors colors = { 0 };
+    gboolean parsed;
+
+    if (g_str_has_suffix (basename, ".itermcolors"))
+        parsed = parse_iterm (G_INPUT_STREAM (stream), &colors, cancellable, error);
+    else
+        parsed = parse_lines (G_INPUT_STREAM (stream), g_str_has_suffix (basename, ".yaml") || g_str_has_suffix (basename, ".yml"), &colors, cancellable, error);
+
+    if (!parsed)
+    {
+        g_free (colors.name);
+        return NULL;
+    }
+
+    if ((colors.found & ALL_PALETTE_COLORS) != ALL_PALETTE_COLORS)
+    {
+        g_free (colors.name);
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "%s doesn't define the 16 terminal colors", basename);
+        return NULL;
+    }
+
+    /* Schemes that only define the palette */
+    if (!(colors.found & (1u << COLOR_FOREGROUND)))
+        colors.colors[COLOR_FOREGROUND] = colors.colors[COLOR_PALETTE + 7];
+    if (!(colors.found & (1u << COLOR_BACKGROUND)))
+        colors.colors[COLOR_BACKGROUND] = colors.colors[COLOR_PALETTE];
+
+    GerminalTheme *self = g_object_new (GERMINAL_TYPE_THEME, NULL);
+    GerminalThemePrivate *priv = germinal_theme_get_instance_private (self);
+
+    priv->name = colors.name ? colors.name : name_from_basename (basename);
+    priv->source = g_file_get_path (file);
+    priv->mtime = file_info_get_mtime (info);
+    priv->size = g_file_info_get_size (info);
+    memcpy (priv->colors, colors.colors, sizeof (priv->colors));
+
+    return self;
+}
+
+/* --- Accessors -------------------------------------------------------- */
+
+const gchar *
+germinal_theme_get_name (GerminalTheme *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_THEME (self), NULL);
+
+    GerminalThemePrivate *priv = germinal_theme_get_instance_private (self);
+
+    return priv->name;
+}
+
+const gchar *
+germinal_theme_get_source (GerminalTheme *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_THEME (self), NULL);
+
+    GerminalThemePrivate *priv = germinal_theme_get_instance_private (self);
+
+    return priv->source;
+}
+
+const GdkRGBA *
+germinal_theme_get_foreground (GerminalTheme *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_THEME (self), NULL);
+
+    GerminalThemePrivate *priv = germinal_theme_get_instance_private (self);
+
+    return &priv->colors[COLOR_FOREGROUND];
+}
+
+const GdkRGBA *
+germinal_theme_get_background (GerminalTheme *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_THEME (self), NULL);
+
+    GerminalThemePrivate *priv = germinal_theme_get_instance_private (self);
+
+    return &priv->colors[COLOR_BACKGROUND];
+}
+
+const GdkRGBA *
+germinal_theme_get_palette (GerminalTheme *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_THEME (self), NULL);
+
+    GerminalThemePrivate *priv = germinal_theme_get_instance_private (self);
+
+    return &priv->colors[COLOR_PALETTE];
+}
+
+/* info needs GERMINAL_THEME_FILE_ATTRIBUTES */
+gboolean
+germinal_theme_is_up_to_date (GerminalTheme *self,
+                              GFileInfo     *info)
+{
+    g_return_val_if_fail (GERMINAL_IS_THEME (self), FALSE);
+    g_return_val_if_fail (G_IS_FILE_INFO (info), FALSE);
+
+    GerminalThemePrivate *priv = germinal_theme_get_instance_private (self);
+
+    return priv->mtime == file_info_get_mtime (info) &&
+           priv->size == (guint64) g_file_info_get_size (info);
+}
+
+/* --- Library ---------------------------------------------------------- */
+
+GPtrArray *
+germinal_theme_library_load (const gchar *path)
+{
+    g_return_val_if_fail (path != NULL, NULL);
+
+    GPtrArray *themes = g_ptr_array_new_with_free_func (g_object_unref);
+    g_autoptr (GMappedFile) file = g_mapped_file_new (path, FALSE, NULL);
+
+    if (!file)
+        return themes;
+
+    g_autoptr (GBytes) bytes = g_mapped_file_get_bytes (file);
+    g_autoptr (GVariant) library = g_variant_new_from_bytes (LIBRARY_TYPE, bytes, FALSE);
+
+    if (!g_variant_is_normal_form (library))
+        return themes;
+
+    GVariantIter iter;
+    const gchar *source, *name;
+    gint64 mtime;
+    guint64 size;
+    GVariant *colors;
+
+    g_variant_iter_init (&iter, library);
+    while (g_variant_iter_next (&iter, "(&sxt&s@a(dddd))", &source, &mtime, &size, &name, &colors))
+    {
+        gsize n_components = 0;
+        const gdouble *components = g_variant_get_fixed_array (colors, &n_components, 4 * sizeof (gdouble));
+
+        if (n_components == N_COLORS)
+        {
+            GerminalTheme *theme = g_object_new (GERMINAL_TYPE_THEME, NULL);
+            GerminalThemePrivate *priv = germinal_theme_get_instance_private (theme);
+
+            priv->name = g_strdup (name);
+            priv->source = g_strdup (source);
+            priv->mtime = mtime;
+            priv->size = size;
+            for (guint i = 0; i < N_COLORS; ++i)
+                priv->colors[i] = (GdkRGBA) { components[4 * i], components[4 * i + 1], components[4 * i + 2], components[4 * i + 3] };
+
+            g_ptr_array_add (themes, theme);
+        }
+
+        g_variant_unref (colors);
+    }
+
+    return themes;
+}
+
+gboolean
+germinal_theme_library_save (const gchar  *path,
+                             GListModel   *themes,
+                             GError      **error)
+{
+    g_return_val_if_fail (path != NULL, FALSE);
+    g_return_val_if_fail (G_IS_LIST_MODEL (themes), FALSE);
+
+    GVariantBuilder library;
+
+    g_variant_builder_init (&library, LIBRARY_TYPE);
+
+    for (guint i = 0; i < g_list_model_get_n_items (themes); ++i)
+    {
+        g_autoptr (GerminalTheme) theme = g_list_model_get_item (themes, i);
+        GerminalThemePrivate *priv = germinal_theme_get_instance_private (theme);
+        GVariantBuilder colors;
+
+        g_variant_builder_init (&colors, G_VARIANT_TYPE ("a(dddd)"));
+        for (guint c = 0; c < N_COLORS; ++c)
+        {
+            const GdkRGBA *rgba = &priv->colors[c];
+
+            g_variant_builder_add (&colors, "(dddd)", (gdouble) rgba->red, (gdouble) rgba->green, (gdouble) rgba->blue, (gdouble) rgba->alpha);
+        }
+
+        g_variant_builder_add (&library, "(sxtsa(dddd))", priv->source, priv->mtime, priv->size, priv->name, &colors);
+    }
+
+    g_autoptr (GVariant) variant = g_variant_ref_sink (g_variant_builder_end (&library));
+    g_autofree gchar *dir = g_path_get_dirname (path);
+
+    if (g_mkdir_with_parents (dir, 0700))
+    {
+        g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errno), "Couldn't create %s", dir);
+        return FALSE;
+    }
+
+    return g_file_set_contents (path, g_variant_get_data (variant), g_variant_get_size (variant), error);
+}
+
+static void
+germinal_theme_finalize (GObject *object)
+{
+    GerminalThemePrivate *priv = germinal_theme_get_instance_private (GERMINAL_THEME (object));
+
+    g_free (priv->name);
+    g_free (priv->source);
+
+    G_OBJECT_CLASS (germinal_theme_parent_class)->finalize (object);
+}
+
+static void
+germinal_theme_class_init (GerminalThemeClass *klass)
+{
+    G_OBJECT_CLASS (klass)->finalize = germinal_theme_finalize;
+}
+
+static void
+germinal_theme_init (GerminalTheme *self G_GNUC_UNUSED)
+{
+}
@@ -0,0 +1,33 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <gdk/gdk.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define GERMINAL_THEME_N_COLORS 16
+
+/* What germinal_theme_is_up_to_date needs to know about a file */
+#define GERMINAL_THEME_FILE_ATTRIBUTES G_FILE_ATTRIBUTE_TIME_MODIFIED "," G_FILE_ATTRIBUTE_TIME_MODIFIED_NSEC "," G_FILE_ATTRIBUTE_STANDARD_SIZE
+
+#define GERMINAL_TYPE_THEME germinal_theme_get_type ()
+G_DECLARE_FINAL_TYPE (GerminalTheme, germinal_theme, GERMINAL, THEME, GObject)
+
+/* iTerm2 (.itermcolors), base16 (.yaml) or Xresources (anything else) */
+GerminalTheme *germinal_theme_load            (GFile *file, GCancellable *cancellable, GError **error);
+
+const gchar   *germinal_theme_get_name        (GerminalTheme *self);
+const gchar   *germinal_theme_get_source      (GerminalTheme *self);
+const GdkRGBA *germinal_theme_get_foreground  (GerminalTheme *self);
+const GdkRGBA *germinal_theme_get_background  (GerminalTheme *self);
+const GdkRGBA *germinal_theme_get_palette     (GerminalTheme *self);
+gboolean       germinal_theme_is_up_to_date   (GerminalTheme *self, GFileInfo *info);
+
+/* Imported themes, already validated and parsed */
+GPtrArray     *germinal_theme_library_load    (const gchar *path);
+gboolean       germinal_theme_library_save    (const gchar *path, GListModel *themes, GError **error);
+
+G_END_DECLS
@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-timings.h"
+
+static const gchar *phase_names[GERMINAL_TIMING_N_PHASES] = {
+    [GERMINAL_TIMING_PROCESS_START]    = "process start",
+    [GERMINAL_TIMING_SETTINGS_LOADED]  = "settings loaded",
+    [GERMINAL_TIMING_FONT_LOADED]      = "font loaded",
+    [GERMINAL_TIMING_WINDOW_MAPPED]    = "window mapped",
+    [GERMINAL_TIMING_PTY_OPENED]       = "pty opened",
+    [GERMINAL_TIMING_FIRST_CHILD_BYTE] = "first child byte",
+    [GERMINAL_TIMING_FIRST_FRAME]      = "first frame",
+};
+
+/* Only the first occurrence of each phase counts, that is the first window's */
+static gint64   marks[GERMINAL_TIMING_N_PHASES];
+static gboolean enabled;
+
+void
+germinal_timings_enable (void)
+{
+    enabled = TRUE;
+}
+
+gboolean
+germinal_timings_has (GerminalTiming phase)
+{
+    g_return_val_if_fail (phase < GERMINAL_TIMING_N_PHASES, FALSE);
+
+    return marks[phase] != 0;
+}
+
+void
+germinal_timings_mark (GerminalTiming phase)
+{
+    g_return_if_fail (phase < GERMINAL_TIMING_N_PHASES);
+
+    if (marks[phase])
+        return;
+
+    marks[phase] = g_get_monotonic_time ();
+
+    if (phase == GERMINAL_TIMING_PROCESS_START && g_getenv ("GERMINAL_TIMINGS"))
+        enabled = TRUE;
+
+    if (phase != GERMINAL_TIMING_FIRST_FRAME || !enabled)
+        return;
+
+    g_autofree gchar *timeline = germinal_timings_format (marks);
+
+    g_printerr ("%s", timeline);
+}
+
+gchar *
+germinal_timings_format (const gint64 *_marks)
+{
+    g_return_val_if_fail (_marks != NULL, NULL);
+
+    GString *timeline = g_string_new ("Startup timeline (ms since process start):\n");
+    gint64 start = _marks[GERMINAL_TIMING_PROCESS_START];
+
+    for (guint i = GERMINAL_TIMING_PROCESS_START + 1; i < GERMINAL_TIMING_N_PHASES; ++i)
+    {
+        if (!_marks[i] || !start)
+            g_string_append_printf (timeline, "  %-18s %10s\n", phase_names[i], "-");
+        else
+            g_string_append_printf (timeline, "  %-18s %10.2f\n", phase_names[i], (_marks[i] - start) / 1000.0);
+    }
+
+    return g_string_free (timeline, FALSE);
+}
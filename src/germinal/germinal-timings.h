@@ -0,0 +1,31 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Startup phases, in the order they usually happen */
+typedef enum
+{
+    GERMINAL_TIMING_PROCESS_START,
+    GERMINAL_TIMING_SETTINGS_LOADED,
+    GERMINAL_TIMING_FONT_LOADED,
+    GERMINAL_TIMING_WINDOW_MAPPED,
+    GERMINAL_TIMING_PTY_OPENED,
+    GERMINAL_TIMING_FIRST_CHILD_BYTE,
+    GERMINAL_TIMING_FIRST_FRAME,
+
+    GERMINAL_TIMING_N_PHASES
+} GerminalTiming;
+
+void      germinal_timings_enable (void);
+void      germinal_timings_mark   (GerminalTiming phase);
+gboolean  germinal_timings_has    (GerminalTiming phase);
+
+/* marks are monotonic times, 0 for phases that weren't reached */
+gchar    *germinal_timings_format (const gint64 *marks);
+
+G_END_DECLS
@@ -0,0 +1,776 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-tmux-view.h"
+#include "germinal-tmux.h"
+
+#include <stdio.h>
+#include <string.h>
+
+struct _GerminalTmuxView
+{
+    GtkWidget parent_instance;
+};
+
+enum
+{
+    PROP_ACTIVE_TERMINAL = 1,
+
+    N_PROPS
+};
+
+static GParamSpec *properties[N_PROPS];
+
+enum
+{
+    SIGNAL_TERMINAL_ADDED,
+    SIGNAL_EXITED,
+
+    N_SIGNALS
+};
+
+static guint signals[N_SIGNALS];
+
+typedef struct
+{
+    GerminalTerminal *terminal;
+    guint             window;
+    gboolean          syncing;
+} GerminalTmuxViewPane;
+
+typedef struct
+{
+    GtkWidget *fixed;
+    gchar     *layout;
+    gchar     *visible_layout;
+    guint      active_pane;
+} GerminalTmuxViewWindow;
+
+typedef struct
+{
+    GerminalTmux     *tmux;
+    GSignalGroup     *tmux_signals;
+
+    GtkWidget        *stack;
+    GHashTable       *panes;
+    GHashTable       *windows;
+    guint             active_window;
+    GerminalTerminal *active_terminal;
+
+    /* Panes created before the first list-windows reply have content we need to fetch */
+    gboolean          syncing;
+
+    glong             cell_width;
+    glong             cell_height;
+    guint             columns;
+    guint             rows;
+    guint             relayout_source_id;
+} GerminalTmuxViewPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GerminalTmuxView, germinal_tmux_view, GTK_TYPE_WIDGET)
+
+typedef struct
+{
+    GerminalTmuxView *view;
+    guint             pane;
+} GerminalTmuxViewRequest;
+
+static void
+pane_free (gpointer data)
+{
+    GerminalTmuxViewPane *pane = data;
+    GtkWidget *terminal = GTK_WIDGET (pane->terminal);
+    GtkWidget *parent = gtk_widget_get_parent (terminal);
+
+    if (parent)
+        gtk_fixed_remove (GTK_FIXED (parent), terminal);
+
+    g_object_unref (pane->terminal);
+    g_free (pane);
+}
+
+static void
+window_free (gpointer data)
+{
+    GerminalTmuxViewWindow *window = data;
+
+    g_free (window->layout);
+    g_free (window->visible_layout);
+    g_free (window);
+}
+
+static gboolean
+parse_id (const gchar  *str,
+          gchar         prefix,
+          guint        *id)
+{
+    gchar *end = NULL;
+
+    if (!str || *str != prefix)
+        return FALSE;
+
+    guint64 n = g_ascii_strtoull (str + 1, &end, 10);
+
+    if (end == str + 1 || n > G_MAXUINT)
+        return FALSE;
+
+    *id = (guint) n;
+
+    return TRUE;
+}
+
+static void
+set_active_terminal (GerminalTmuxView *self,
+                     GerminalTerminal *terminal)
+{
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+
+    if (!g_set_object (&priv->active_terminal, terminal))
+        return;
+
+    if (terminal && gtk_widget_get_mapped (GTK_WIDGET (terminal)))
+        gtk_widget_grab_focus (GTK_WIDGET (terminal));
+
+    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_ACTIVE_TERMINAL]);
+}
+
+static void
+update_active_terminal (GerminalTmuxView *self)
+{
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+    GerminalTmuxViewWindow *window = g_hash_table_lookup (priv->windows, GUINT_TO_POINTER (priv->active_window));
+
+    if (!window)
+        return;
+
+    GerminalTmuxViewPane *pane = g_hash_table_lookup (priv->panes, GUINT_TO_POINTER (window->active_pane));
+
+    if (pane)
+        set_active_terminal (self, pane->terminal);
+}
+
+static void
+on_pane_commit (VteTerminal *terminal,
+                gchar       *text,
+                guint        size,
+                gpointer     user_data)
+{
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (GERMINAL_TMUX_VIEW (user_data));
+    guint id = GPOINTER_TO_UINT (g_object_get_data (G_OBJECT (terminal), "germinal-tmux-pane"));
+    g_autoptr (GString) command = g_string_new (NULL);
+
+    /* Hexadecimal keys go through untouched, whatever the bytes are */
+    g_string_append_printf (command, "send-keys -t %%%u -H", id);
+    for (guint i = 0; i < size; ++i)
+        g_string_append_printf (command, " %02x", (guint8) text[i]);
+
+    germinal_tmux_send (priv->tmux, command->str);
+}
+
+static void
+on_pane_focus_enter (GtkEventControllerFocus *controller,
+                     gpointer                 user_data)
+{
+    GerminalTmuxView *self = GERMINAL_TMUX_VIEW (user_data);
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+    GtkWidget *terminal = gtk_event_controller_get_widget (GTK_EVENT_CONTROLLER (controller));
+    guint id = GPOINTER_TO_UINT (g_object_get_data (G_OBJECT (terminal), "germinal-tmux-pane"));
+    GerminalTmuxViewPane *pane = g_hash_table_lookup (priv->panes, GUINT_TO_POINTER (id));
+
+    if (!pane)
+        return;
+
+    GerminalTmuxViewWindow *window = g_hash_table_lookup (priv->windows, GUINT_TO_POINTER (pane->window));
+
+    if (window && window->active_pane != id)
+    {
+        g_autofree gchar *command = g_strdup_printf ("select-pane -t %%%u", id);
+
+        window->active_pane = id;
+        germinal_tmux_send (priv->tmux, command);
+    }
+
+    set_active_terminal (self, pane->terminal);
+}
+
+static void
+on_cursor_position (GerminalTmux *tmux     G_GNUC_UNUSED,
+                    const gchar  *response,
+                    gboolean      failed,
+                    gpointer      user_data)
+{
+    g_autofree GerminalTmuxViewRequest *request = user_data;
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (request->view);
+    GerminalTmuxViewPane *pane = g_hash_table_lookup (priv->panes, GUINT_TO_POINTER (request->pane));
+    guint x, y;
+
+    if (!pane)
+        return;
+
+    pane->syncing = FALSE;
+
+    if (failed || sscanf (response, "%u %u", &x, &y) != 2)
+        return;
+
+    g_autofree gchar *move = g_strdup_printf ("\033[%u;%uH", y + 1, x + 1);
+    vte_terminal_feed (VTE_TERMINAL (pane->terminal), move, -1);
+}
+
+static void
+on_pane_captured (GerminalTmux *tmux     G_GNUC_UNUSED,
+                  const gchar  *response,
+                  gboolean      failed,
+                  gpointer      user_data)
+{
+    g_autofree GerminalTmuxViewRequest *request = user_data;
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (request->view);
+    GerminalTmuxViewPane *pane = g_hash_table_lookup (priv->panes, GUINT_TO_POINTER (request->pane));
+
+    if (!pane || failed)
+        return;
+
+    VteTerminal *terminal = VTE_TERMINAL (pane->terminal);
+    g_auto (GStrv) lines = g_strsplit (response, "\n", -1);
+
+    vte_terminal_feed (terminal, "\033[H\033[2J", -1);
+    for (guint i = 0; lines[i]; ++i)
+    {
+        if (i)
+            vte_terminal_feed (terminal, "\r\n", 2);
+        vte_terminal_feed (terminal, lines[i], -1);
+    }
+}
+
+static GerminalTmuxViewPane *
+get_pane (GerminalTmuxView *self,
+          guint             id)
+{
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+    GerminalTmuxViewPane *pane = g_hash_table_lookup (priv->panes, GUINT_TO_POINTER (id));
+
+    if (pane)
+        return pane;
+
+    pane = g_new0 (GerminalTmuxViewPane, 1);
+    pane->terminal = GERMINAL_TERMINAL (g_object_ref_sink (germinal_terminal_new ()));
+    pane->window = G_MAXUINT;
+    pane->syncing = priv->syncing;
+    g_hash_table_insert (priv->panes, GUINT_TO_POINTER (id), pane);
+
+    GtkWidget *terminal = GTK_WIDGET (pane->terminal);
+
+    g_object_set_data (G_OBJECT (terminal), "germinal-tmux-pane", GUINT_TO_POINTER (id));
+    germinal_terminal_set_tmux (pane->terminal, priv->tmux);
+    g_signal_connect_object (terminal, "commit", G_CALLBACK (on_pane_commit), self, 0);
+
+    GtkEventController *focus_ctrl = gtk_event_controller_focus_new ();
+    g_signal_connect (focus_ctrl, "enter", G_CALLBACK (on_pane_focus_enter), self);
+    gtk_widget_add_controller (terminal, focus_ctrl);
+
+    if (pane->syncing)
+    {
+        /* Sent back to back so that no output gets in between */
+        g_autofree gchar *capture = g_strdup_printf ("capture-pane -p -e -t %%%u", id);
+        g_autofree gchar *cursor = g_strdup_printf ("display-message -p -t %%%u '#{cursor_x} #{cursor_y}'", id);
+        GerminalTmuxViewRequest *capture_request = g_new (GerminalTmuxViewRequest, 1);
+        GerminalTmuxViewRequest *cursor_request = g_new (GerminalTmuxViewRequest, 1);
+
+        *capture_request = *cursor_request = (GerminalTmuxViewRequest) { self, id };
+        germinal_tmux_command (priv->tmux, capture, on_pane_captured, capture_request);
+        germinal_tmux_command (priv->tmux, cursor, on_cursor_position, cursor_request);
+    }
+
+    g_signal_emit (self, signals[SIGNAL_TERMINAL_ADDED], 0, pane->terminal);
+
+    return pane;
+}
+
+static GerminalTmuxViewWindow *
+get_window (GerminalTmuxView *self,
+            guint             id)
+{
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+    GerminalTmuxViewWindow *window = g_hash_table_lookup (priv->windows, GUINT_TO_POINTER (id));
+
+    if (window)
+        return window;
+
+    window = g_new0 (GerminalTmuxViewWindow, 1);
+    window->fixed = gtk_fixed_new ();
+    window->active_pane = G_MAXUINT;
+    g_hash_table_insert (priv->windows, GUINT_TO_POINTER (id), window);
+
+    g_autofree gchar *name = g_strdup_printf ("@%u", id);
+    gtk_stack_add_named (GTK_STACK (priv->stack), window->fixed, name);
+
+    return window;
+}
+
+static void
+remove_window (GerminalTmuxView *self,
+               guint             id)
+{
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+    GerminalTmuxViewWindow *window = g_hash_table_lookup (priv->windows, GUINT_TO_POINTER (id));
+    GHashTableIter iter;
+    gpointer value;
+
+    if (!window)
+        return;
+
+    g_hash_table_iter_init (&iter, priv->panes);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+        GerminalTmuxViewPane *pane = value;
+
+        if (pane->window == id)
+        {
+            if (pane->terminal == priv->active_terminal)
+                set_active_terminal (self, NULL);
+            g_hash_table_iter_remove (&iter);
+        }
+    }
+
+    gtk_stack_remove (GTK_STACK (priv->stack), window->fixed);
+    g_hash_table_remove (priv->windows, GUINT_TO_POINTER (id));
+}
+
+static gboolean
+update_cell_size (GerminalTmuxView *self)
+{
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+    GHashTableIter iter;
+    gpointer value;
+
+    g_hash_table_iter_init (&iter, priv->panes);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+        VteTerminal *terminal = VTE_TERMINAL (((GerminalTmuxViewPane *) value)->terminal);
+        glong width = vte_terminal_get_char_width (terminal);
+        glong height = vte_terminal_get_char_height (terminal);
+
+        if (width > 0 && height > 0)
+        {
+            gboolean changed = (width != priv->cell_width || height != priv->cell_height);
+
+            priv->cell_width = width;
+            priv->cell_height = height;
+
+            return changed;
+        }
+    }
+
+    return FALSE;
+}
+
+static void
+apply_layout (GerminalTmuxView *self,
+              guint             id)
+{
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+    GerminalTmuxViewWindow *window = g_hash_table_lookup (priv->windows, GUINT_TO_POINTER (id));
+
+    if (!window || !window->layout)
+        return;
+
+    g_autoptr (GArray) all = germinal_tmux_parse_layout (window->layout);
+    g_autoptr (GArray) visible = germinal_tmux_parse_layout (window->visible_layout ? window->visible_layout : window->layout);
+
+    if (!all || !visible)
+    {
+        g_warning ("Couldn't parse tmux layout '%s'", window->layout);
+        return;
+    }
+
+    g_autoptr (GHashTable) alive = g_hash_table_new (NULL, NULL);
+
+    for (guint i = 0; i < all->len; ++i)
+    {
+        GerminalTmuxPane *leaf = &g_array_index (all, GerminalTmuxPane, i);
+        GerminalTmuxViewPane *pane = get_pane (self, leaf->id);
+        GtkWidget *terminal = GTK_WIDGET (pane->terminal);
+
+        pane->window = id;
+        g_hash_table_add (alive, GUINT_TO_POINTER (leaf->id));
+
+        /* Panes hidden by a zoomed pane stay alive */
+        gtk_widget_set_visible (terminal, FALSE);
+
+        if (gtk_widget_get_parent (terminal) != window->fixed)
+        {
+            if (gtk_widget_get_parent (terminal))
+                gtk_fixed_remove (GTK_FIXED (gtk_widget_get_parent (terminal)), terminal);
+            gtk_fixed_put (GTK_FIXED (window->fixed), terminal, 0, 0);
+        }
+    }
+
+    if (!priv->cell_width)
+        update_cell_size (self);
+
+    for (guint i = 0; i < visible->len; ++i)
+    {
+        GerminalTmuxPane *leaf = &g_array_index (visible, GerminalTmuxPane, i);
+        GerminalTmuxViewPane *pane = g_hash_table_lookup (priv->panes, GUINT_TO_POINTER (leaf->id));
+
+        if (!pane)
+            continue;
+
+        vte_terminal_set_size (VTE_TERMINAL (pane->terminal), leaf->width, leaf->height);
+        gtk_fixed_move (GTK_FIXED (window->fixed), GTK_WIDGET (pane->terminal),
+                        (gdouble) (leaf->x * priv->cell_width),
+                        (gdouble) (leaf->y * priv->cell_height));
+        gtk_widget_set_visible (GTK_WIDGET (pane->terminal), TRUE);
+    }
+
+    /* Killed panes */
+    GHashTableIter iter;
+    gpointer key, value;
+
+    g_hash_table_iter_init (&iter, priv->panes);
+    while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+        GerminalTmuxViewPane *pane = value;
+
+        if (pane->window == id && !g_hash_table_contains (alive, key))
+        {
+            if (pane->terminal == priv->active_terminal)
+                set_active_terminal (self, NULL);
+            g_hash_table_iter_remove (&iter);
+        }
+    }
+}
+
+static void
+set_layout (GerminalTmuxView *self,
+            guint             id,
+            const gchar      *layout,
+            const gchar      *visible_layout)
+{
+    GerminalTmuxViewWindow *window = get_window (self, id);
+
+    g_free (window->layout);
+    g_free (window->visible_layout);
+    window->layout = g_strdup (layout);
+    window->visible_layout = g_strdup (visible_layout);
+
+    apply_layout (self, id);
+}
+
+static void
+set_active_window (GerminalTmuxView *self,
+                   guint             id)
+{
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+    GerminalTmuxViewWindow *window = get_window (self, id);
+
+    priv->active_window = id;
+    gtk_stack_set_visible_child (GTK_STACK (priv->stack), window->fixed);
+    update_active_terminal (self);
+}
+
+static void
+on_windows_listed (GerminalTmux *tmux     G_GNUC_UNUSED,
+                   const gchar  *response,
+                   gboolean      failed,
+                   gpointer      user_data)
+{
+    GerminalTmuxView *self = GERMINAL_TMUX_VIEW (user_data);
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+
+    if (failed)
+        return;
+
+    g_auto (GStrv) lines = g_strsplit (response, "\n", -1);
+    g_autoptr (GHashTable) listed = g_hash_table_new (NULL, NULL);
+    guint active = G_MAXUINT;
+
+    for (guint i = 0; lines[i]; ++i)
+    {
+        /* <window id> <active> <active pane id> <layout> <visible layout> */
+        g_auto (GStrv) fields = g_strsplit (lines[i], " ", 5);
+        guint id, pane;
+
+        if (g_strv_length (fields) != 5 || !parse_id (fields[0], '@', &id) || !parse_id (fields[2], '%', &pane))
+            continue;
+
+        g_hash_table_add (listed, GUINT_TO_POINTER (id));
+        set_layout (self, id, fields[3], fields[4]);
+        get_window (self, id)->active_pane = pane;
+
+        if (!g_strcmp0 (fields[1], "1"))
+            active = id;
+    }
+
+    g_autoptr (GList) known = g_hash_table_get_keys (priv->windows);
+
+    for (GList *l = known; l; l = l->next)
+    {
+        if (!g_hash_table_contains (listed, l->data))
+            remove_window (self, GPOINTER_TO_UINT (l->data));
+    }
+
+    priv->syncing = FALSE;
+
+    if (active != G_MAXUINT)
+        set_active_window (self, active);
+}
+
+static void
+list_windows (GerminalTmuxView *self)
+{
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+
+    germinal_tmux_command (priv->tmux,
+                           "list-windows -F '#{window_id} #{window_active} #{pane_id} #{window_layout} #{window_visible_layout}'",
+                           on_windows_listed,
+                           self);
+}
+
+static void
+on_output (GerminalTmuxView *self,
+           const gchar      *line)
+{
+    const gchar *data = strchr (line, ' ');
+    guint id;
+
+    if (!data || !parse_id (line, '%', &id))
+        return;
+
+    GerminalTmuxViewPane *pane = get_pane (self, id);
+
+    /* Anything received before the capture is already part of it */
+    if (pane->syncing)
+        return;
+
+    g_autoptr (GBytes) bytes = germinal_tmux_unescape (data + 1);
+    gsize len = 0;
+    const gchar *buf = g_bytes_get_data (bytes, &len);
+
+    vte_terminal_feed (VTE_TERMINAL (pane->terminal), buf, (gssize) len);
+}
+
+static void
+on_notification (GerminalTmux *tmux G_GNUC_UNUSED,
+                 const gchar  *line,
+                 gpointer      user_data)
+{
+    GerminalTmuxView *self = GERMINAL_TMUX_VIEW (user_data);
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+
+    if (g_str_has_prefix (line, "%output "))
+    {
+        on_output (self, line + strlen ("%output "));
+        return;
+    }
+
+    g_auto (GStrv) fields = g_strsplit (line, " ", -1);
+    guint n_fields = g_strv_length (fields);
+    guint id, pane;
+
+    if (!g_strcmp0 (fields[0], "%layout-change") && n_fields >= 3 && parse_id (fields[1], '@', &id))
+    {
+        set_layout (self, id, fields[2], (n_fields >= 4) ? fields[3] : NULL);
+        if (id == priv->active_window)
+            update_active_terminal (self);
+    }
+    else if (!g_strcmp0 (fields[0], "%window-add") || !g_strcmp0 (fields[0], "%session-changed"))
+        list_windows (self);
+    else if ((!g_strcmp0 (fields[0], "%window-close") || !g_strcmp0 (fields[0], "%unlinked-window-close")) &&
+             n_fields >= 2 && parse_id (fields[1], '@', &id))
+        remove_window (self, id);
+    else if (!g_strcmp0 (fields[0], "%session-window-changed") && n_fields >= 3 && parse_id (fields[2], '@', &id))
+        set_active_window (self, id);
+    else if (!g_strcmp0 (fields[0], "%window-pane-changed") && n_fields >= 3 &&
+             parse_id (fields[1], '@', &id) && parse_id (fields[2], '%', &pane))
+    {
+        get_window (self, id)->active_pane = pane;
+        if (id == priv->active_window)
+            update_active_terminal (self);
+    }
+}
+
+static void
+on_tmux_exited (GerminalTmux *tmux G_GNUC_UNUSED,
+                gpointer      user_data)
+{
+    g_signal_emit (user_data, signals[SIGNAL_EXITED], 0);
+}
+
+static gboolean
+relayout (gpointer user_data)
+{
+    GerminalTmuxView *self = GERMINAL_TMUX_VIEW (user_data);
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+    GHashTableIter iter;
+    gpointer key;
+
+    priv->relayout_source_id = 0;
+
+    g_hash_table_iter_init (&iter, priv->windows);
+    while (g_hash_table_iter_next (&iter, &key, NULL))
+        apply_layout (self, GPOINTER_TO_UINT (key));
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+germinal_tmux_view_size_allocate (GtkWidget *widget,
+                                  gint       width,
+                                  gint       height,
+                                  gint       baseline)
+{
+    GerminalTmuxView *self = GERMINAL_TMUX_VIEW (widget);
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+
+    GTK_WIDGET_CLASS (germinal_tmux_view_parent_class)->size_allocate (widget, width, height, baseline);
+
+    /* Zooming changes the cell size, positions have to follow */
+    if (update_cell_size (self) && !priv->relayout_source_id)
+    {
+        priv->relayout_source_id = g_idle_add (relayout, self);
+        g_source_set_name_by_id (priv->relayout_source_id, "[germinal] tmux-relayout");
+    }
+
+    if (!priv->tmux || !priv->cell_width || !priv->cell_height)
+        return;
+
+    guint columns = (guint) MAX (width / priv->cell_width, 1);
+    guint rows = (guint) MAX (height / priv->cell_height, 1);
+
+    if (columns == priv->columns && rows == priv->rows)
+        return;
+
+    priv->columns = columns;
+    priv->rows = rows;
+
+    g_autofree gchar *command = g_strdup_printf ("refresh-client -C %ux%u", columns, rows);
+    germinal_tmux_send (priv->tmux, command);
+}
+
+gboolean
+germinal_tmux_view_start (GerminalTmuxView    *self,
+                          const gchar * const *argv,
+                          GError             **error)
+{
+    g_return_val_if_fail (GERMINAL_IS_TMUX_VIEW (self), FALSE);
+    g_return_val_if_fail (argv != NULL, FALSE);
+
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+
+    g_return_val_if_fail (priv->tmux == NULL, FALSE);
+
+    priv->tmux = germinal_tmux_new_for_argv (argv, error);
+
+    if (!priv->tmux)
+        return FALSE;
+
+    priv->syncing = TRUE;
+    g_signal_group_set_target (priv->tmux_signals, priv->tmux);
+    list_windows (self);
+
+    return TRUE;
+}
+
+GerminalTerminal *
+germinal_tmux_view_get_active_terminal (GerminalTmuxView *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_TMUX_VIEW (self), NULL);
+
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+
+    return priv->active_terminal;
+}
+
+static void
+germinal_tmux_view_get_property (GObject    *object,
+                                 guint       prop_id,
+                                 GValue     *value,
+                                 GParamSpec *pspec)
+{
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (GERMINAL_TMUX_VIEW (object));
+
+    switch (prop_id)
+    {
+    case PROP_ACTIVE_TERMINAL:
+        g_value_set_object (value, priv->active_terminal);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+germinal_tmux_view_dispose (GObject *object)
+{
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (GERMINAL_TMUX_VIEW (object));
+
+    g_clear_handle_id (&priv->relayout_source_id, g_source_remove);
+    g_clear_object (&priv->tmux_signals);
+
+    /* Pending replies point to us, make sure none gets delivered */
+    if (priv->tmux)
+        g_object_run_dispose (G_OBJECT (priv->tmux));
+    g_clear_object (&priv->tmux);
+
+    g_clear_object (&priv->active_terminal);
+    g_clear_pointer (&priv->panes, g_hash_table_unref);
+    g_clear_pointer (&priv->windows, g_hash_table_unref);
+    g_clear_pointer (&priv->stack, gtk_widget_unparent);
+
+    G_OBJECT_CLASS (germinal_tmux_view_parent_class)->dispose (object);
+}
+
+static void
+germinal_tmux_view_init (GerminalTmuxView *self)
+{
+    GerminalTmuxViewPrivate *priv = germinal_tmux_view_get_instance_private (self);
+
+    priv->panes = g_hash_table_new_full (NULL, NULL, NULL, pane_free);
+    priv->windows = g_hash_table_new_full (NULL, NULL, NULL, window_free);
+    priv->active_window = G_MAXUINT;
+
+    priv->stack = gtk_stack_new ();
+    gtk_widget_set_parent (priv->stack, GTK_WIDGET (self));
+
+    priv->tmux_signals = g_signal_group_new (GERMINAL_TYPE_TMUX);
+    g_signal_group_connect (priv->tmux_signals, "notification", G_CALLBACK (on_notification), self);
+    g_signal_group_connect (priv->tmux_signals, "exited",       G_CALLBACK (on_tmux_exited),  self);
+}
+
+static void
+germinal_tmux_view_class_init (GerminalTmuxViewClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+    GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
+
+    object_class->dispose      = germinal_tmux_view_dispose;
+    object_class->get_property = germinal_tmux_view_get_property;
+
+    widget_class->size_allocate = germinal_tmux_view_size_allocate;
+
+    gtk_widget_class_set_layout_manager_type (widget_class, GTK_TYPE_BIN_LAYOUT);
+    gtk_widget_class_set_css_name (widget_class, "germinal-tmux-view");
+
+    properties[PROP_ACTIVE_TERMINAL] = g_param_spec_object ("active-terminal", NULL, NULL,
+                                                            GERMINAL_TYPE_TERMINAL,
+                                                            G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+    g_object_class_install_properties (object_class, N_PROPS, properties);
+
+    signals[SIGNAL_TERMINAL_ADDED] = g_signal_new ("terminal-added",
+                                                   G_TYPE_FROM_CLASS (klass),
+                                                   G_SIGNAL_RUN_LAST,
+                                                   0, NULL, NULL, NULL,
+                                                   G_TYPE_NONE, 1, GERMINAL_TYPE_TERMINAL);
+
+    signals[SIGNAL_EXITED] = g_signal_new ("exited",
+                                           G_TYPE_FROM_CLASS (klass),
+                                           G_SIGNAL_RUN_LAST,
+                                           0, NULL, NULL, NULL,
+                                           G_TYPE_NONE, 0);
+}
+
+GtkWidget *
+germinal_tmux_view_new (void)
+{
+    return g_object_new (GERMINAL_TYPE_TMUX_VIEW, NULL);
+}
@@ -0,0 +1,17 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "germinal-terminal.h"
+
+G_BEGIN_DECLS
+
+#define GERMINAL_TYPE_TMUX_VIEW germinal_tmux_view_get_type ()
+G_DECLARE_FINAL_TYPE (GerminalTmuxView, germinal_tmux_view, GERMINAL, TMUX_VIEW, GtkWidget)
+
+GtkWidget        *germinal_tmux_view_new                 (void);
+gboolean          germinal_tmux_view_start               (GerminalTmuxView *self, const gchar * const *argv, GError **error);
+GerminalTerminal *germinal_tmux_view_get_active_terminal (GerminalTmuxView *self);
+
+G_END_DECLS
@@ -0,0 +1,794 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-tmux.h"
+#include "germinal-spawner.h"
+
+#include <string.h>
+
+struct _GerminalTmux
+{
+    GObject parent_instance;
+};
+
+enum
+{
+    SIGNAL_NOTIFICATION,
+    SIGNAL_EXITED,
+
+    N_SIGNALS
+};
+
+static guint signals[N_SIGNALS];
+
+typedef struct
+{
+    GerminalTmuxCallback callback;
+    gpointer             user_data;
+    gboolean             batched;
+} GerminalTmuxReply;
+
+typedef struct
+{
+    GSubprocess      *process;
+    GOutputStream    *input;
+    GDataInputStream *output;
+    GCancellable     *cancellable;
+
+    /* Data waiting for the previous write to complete */
+    GString          *outbox;
+    gchar            *writing;
+
+    /* Commands queued while another batch is being processed */
+    GString          *pending;
+    guint             n_pending;
+    gint64            pending_since;
+
+    /* Batched commands written to tmux, waiting for their %end */
+    guint             n_in_flight;
+    gint64            in_flight_since;
+
+    /* One entry per command we wrote, in order */
+    GQueue            replies;
+    GString          *block;
+    gboolean          in_block;
+    gboolean          block_is_ours;
+
+    gboolean          exited;
+
+    /* tmux and its global options, like -L, picking the server */
+    GStrv             globals;
+} GerminalTmuxPrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GerminalTmux, germinal_tmux, G_TYPE_OBJECT)
+
+/* A one-shot tmux command line, for the server the global options pick */
+gchar *
+germinal_tmux_command_line (const gchar * const *globals,
+                            const gchar         *command)
+{
+    g_return_val_if_fail (command != NULL, NULL);
+
+    g_autoptr (GString) cmdline = g_string_new (NULL);
+
+    for (guint i = 0; globals && globals[i]; ++i)
+    {
+        g_autofree gchar *quoted = g_shell_quote (globals[i]);
+
+        g_string_append (cmdline, quoted);
+        g_string_append_c (cmdline, ' ');
+    }
+
+    if (!cmdline->len)
+        g_string_append (cmdline, "tmux ");
+
+    g_string_append (cmdline, command);
+
+    return g_string_free (g_steal_pointer (&cmdline), FALSE);
+}
+
+typedef struct
+{
+    gint64 start;
+    gchar *cmdline;
+} RunTiming;
+
+static void
+on_detached_exited (gint         status G_GNUC_UNUSED,
+                    const gchar *error,
+                    gpointer     user_data)
+{
+    RunTiming *timing = user_data;
+
+    if (error)
+        g_warning ("%s", error);
+    else
+        g_debug ("%s: applied %.2f ms after the keypress", timing->cmdline, (g_get_monotonic_time () - timing->start) / 1000.0);
+
+    g_free (timing->cmdline);
+    g_free (timing);
+}
+
+/* When there is no control client to send commands to, through a one-shot tmux */
+void
+germinal_tmux_run_detached (const gchar * const *globals,
+                            const gchar         *commands)
+{
+    g_return_if_fail (commands != NULL);
+
+    g_autofree gchar *cmdline = germinal_tmux_command_line (globals, commands);
+    g_auto (GStrv) argv = NULL;
+    g_autoptr (GError) error = NULL;
+    gint64 start = g_get_monotonic_time ();
+
+    if (!g_shell_parse_argv (cmdline, NULL, &argv, &error))
+    {
+        g_warning ("%s", error->message);
+        return;
+    }
+
+    RunTiming *timing = g_new (RunTiming, 1);
+    timing->start = start;
+    timing->cmdline = g_steal_pointer (&cmdline);
+    germinal_spawner_spawn (germinal_spawner_get_default (), (const gchar * const *) argv, on_detached_exited, timing);
+}
+
+/* No reply will ever come, callbacks still get to free what they were given */
+static void
+fail_replies (GerminalTmux *self)
+{
+    GerminalTmuxPrivate *priv = germinal_tmux_get_instance_private (self);
+    GerminalTmuxReply *reply;
+
+    while ((reply = g_queue_pop_head (&priv->replies)))
+    {
+        if (reply->callback)
+            reply->callback (self, NULL, TRUE, reply->user_data);
+        g_free (reply);
+    }
+}
+
+static void
+on_exited (GerminalTmux *self)
+{
+    GerminalTmuxPrivate *priv = germinal_tmux_get_instance_private (self);
+
+    if (priv->exited)
+        return;
+
+    priv->exited = TRUE;
+
+    /* Nothing will ever read what is still queued, hand it over to a one-shot client */
+    if (priv->n_pending)
+    {
+        g_debug ("tmux: control client gone, running %u queued command(s) detached", priv->n_pending);
+        germinal_tmux_run_detached ((const gchar * const *) priv->globals, priv->pending->str);
+        g_string_truncate (priv->pending, 0);
+        priv->n_pending = 0;
+    }
+
+    g_object_ref (self);
+    fail_replies (self);
+    g_signal_emit (self, signals[SIGNAL_EXITED], 0);
+    g_object_unref (self);
+}
+
+static void on_written (GObject *source, GAsyncResult *result, gpointer user_data);
+
+static void
+flush_outbox (GerminalTmux *self)
+{
+    GerminalTmuxPrivate *priv = germinal_tmux_get_instance_private (self);
+
+    if (priv->writing || !priv->outbox->len)
+        return;
+
+    priv->writing = g_string_free (g_steal_pointer (&priv->outbox), FALSE);
+    priv->outbox = g_string_new (NULL);
+
+    g_output_stream_write_all_async (priv->input,
+                                     priv->writing,
+                                     strlen (priv->writing),
+                                     G_PRIORITY_HIGH,
+                                     priv->cancellable,
+                                     on_written,
+                                     self);
+}
+
+static void
+on_written (GObject      *source,
+            GAsyncResult *result,
+            gpointer      user_data)
+{
+    g_autoptr (GError) error = NULL;
+
+    if (!g_output_stream_write_all_finish (G_OUTPUT_STREAM (source), result, NULL, &error))
+    {
+        /* Disposed meanwhile, the stream couldn't be closed while we were writing to it */
+        if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        {
+            g_output_stream_close (G_OUTPUT_STREAM (source), NULL, NULL);
+            return;
+        }
+
+        g_debug ("tmux: %s", error->message);
+        on_exited (GERMINAL_TMUX (user_data));
+        return;
+    }
+
+    GerminalTmux *self = GERMINAL_TMUX (user_data);
+    GerminalTmuxPrivate *priv = germinal_tmux_get_instance_private (self);
+
+    g_clear_pointer (&priv->writing, g_free);
+    flush_outbox (self);
+}
+
+static void
+write_command (GerminalTmux         *self,
+               const gchar          *command,
+               guint                 n_commands,
+               GerminalTmuxCallback  callback,
+               gpointer              user_data)
+{
+    GerminalTmuxPrivate *priv = germinal_tmux_get_instance_private (self);
+
+    /* tmux answers each command of a list with its own block */
+    for (guint i = 0; i < n_commands; ++i)
+    {
+        GerminalTmuxReply *reply = g_new0 (GerminalTmuxReply, 1);
+        reply->callback = callback;
+        reply->user_data = user_data;
+        reply->batched = (callback == NULL);
+        g_queue_push_tail (&priv->replies, reply);
+    }
+
+    g_string_append (priv->outbox, command);
+    g_string_append_c (priv->outbox, '\n');
+    flush_outbox (self);
+}
+
+static void
+maybe_flush (GerminalTmux *self)
+{
+    GerminalTmuxPrivate *priv = germinal_tmux_get_instance_private (self);
+
+    if (priv->exited || priv->n_in_flight || !priv->n_pending)
+        return;
+
+    priv->n_in_flight = priv->n_pending;
+    priv->in_flight_since = priv->pending_since;
+    priv->n_pending = 0;
+
+    write_command (self, priv->pending->str, priv->n_in_flight, NULL, NULL);
+    g_string_truncate (priv->pending, 0);
+}
+
+static void
+on_block_end (GerminalTmux *self,
+              gboolean      failed)
+{
+    GerminalTmuxPrivate *priv = germinal_tmux_get_instance_private (self);
+    g_autofree GerminalTmuxReply *reply = g_queue_pop_head (&priv->replies);
+
+    if (!reply)
+        return;
+
+    if (reply->callback)
+        reply->callback (self, priv->block->str, failed, reply->user_data);
+
+    if (!reply->batched || !priv->n_in_flight)
+        return;
+
+    /* tmux drops what follows a failed command in a list, without a block for it */
+    if (failed)
+    {
+        while (--priv->n_in_flight)
+            g_free (g_queue_pop_head (&priv->replies));
+    }
+    else
+        --priv->n_in_flight;
+
+    if (!priv->n_in_flight)
+    {
+        g_debug ("tmux: command batch applied %.2f ms after the first keypress",
+                 (g_get_monotonic_time () - priv->in_flight_since) / 1000.0);
+        maybe_flush (self);
+    }
+}
+
+static void
+on_line_read (GObject      *source,
+              GAsyncResult *result,
+              gpointer      user_data)
+{
+    g_autoptr (GError) error = NULL;
+    g_autofree gchar *line = g_data_input_stream_read_line_finish (G_DATA_INPUT_STREAM (source), result, NULL, &error);
+
+    if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        return;
+
+    /* Handlers may drop the last external reference */
+    g_autoptr (GerminalTmux) self = g_object_ref (GERMINAL_TMUX (user_data));
+    GerminalTmuxPrivate *priv = germinal_tmux_get_instance_private (self);
+
+    if (!line || g_str_has_prefix (line, "%exit"))
+    {
+        on_exited (self);
+        return;
+    }
+
+    if (priv->in_block)
+    {
+        gboolean end = g_str_has_prefix (line, "%end ");
+
+        if (end || g_str_has_prefix (line, "%error "))
+        {
+            priv->in_block = FALSE;
+            if (priv->block_is_ours)
+                on_block_end (self, !end);
+        }
+        else
+        {
+            if (priv->block->len)
+                g_string_append_c (priv->block, '\n');
+            g_string_append (priv->block, line);
+        }
+    }
+    else if (g_str_has_prefix (line, "%begin "))
+    {
+        /* %begin <time> <number> <flags>, flags is 1 for commands sent by this client */
+        priv->in_block = TRUE;
+        priv->block_is_ours = g_str_has_suffix (line, " 1");
+        g_string_truncate (priv->block, 0);
+    }
+    else
+        g_signal_emit (self, signals[SIGNAL_NOTIFICATION], 0, line);
+
+    if (priv->output)
+        g_data_input_stream_read_line_async (priv->output, G_PRIORITY_HIGH, priv->cancellable, on_line_read, self);
+}
+
+gboolean
+germinal_tmux_send (GerminalTmux *self,
+                    const gchar  *command)
+{
+    g_return_val_if_fail (GERMINAL_IS_TMUX (self), FALSE);
+    g_return_val_if_fail (command != NULL, FALSE);
+
+    GerminalTmuxPrivate *priv = germinal_tmux_get_instance_private (self);
+
+    if (priv->exited)
+        return FALSE;
+
+    if (priv->n_pending++)
+        g_string_append (priv->pending, " ; ");
+    else
+        priv->pending_since = g_get_monotonic_time ();
+
+    g_string_append (priv->pending, command);
+    maybe_flush (self);
+
+    return TRUE;
+}
+
+gboolean
+germinal_tmux_command (GerminalTmux         *self,
+                       const gchar          *command,
+                       GerminalTmuxCallback  callback,
+                       gpointer              user_data)
+{
+    g_return_val_if_fail (GERMINAL_IS_TMUX (self), FALSE);
+    g_return_val_if_fail (command != NULL, FALSE);
+    g_return_val_if_fail (callback != NULL, FALSE);
+
+    GerminalTmuxPrivate *priv = germinal_tmux_get_instance_private (self);
+
+    if (priv->exited)
+        return FALSE;
+
+    write_command (self, command, 1, callback, user_data);
+
+    return TRUE;
+}
+
+GStrv
+germinal_tmux_control_argv (const gchar * const *command)
+{
+    g_return_val_if_fail (command != NULL, NULL);
+
+    if (!command[0])
+        return NULL;
+
+    g_autofree gchar *name = g_path_get_basename (command[0]);
+
+    if (g_strcmp0 (name, "tmux") != 0)
+        return NULL;
+
+    g_autoptr (GStrvBuilder) builder = g_strv_builder_new ();
+
+    g_strv_builder_add (builder, command[0]);
+    g_strv_builder_add (builder, "-C");
+
+    for (guint i = 1; command[i]; ++i)
+    {
+        /* Already in control mode */
+        if (!g_strcmp0 (command[i], "-C") || !g_strcmp0 (command[i], "-CC"))
+            continue;
+        g_strv_builder_add (builder, command[i]);
+    }
+
+    return g_strv_builder_end (builder);
+}
+
+/*
+ * Skips getopt-style options at the start of args, with_arg listing the ones
+ * taking an argument. Returns the index of the first non-option argument and
+ * sets *value to the argument of option wanted, if found.
+ */
+static guint
+skip_options (const gchar * const *args,
+              const gchar         *with_arg,
+              gchar                wanted,
+              const gchar        **value)
+{
+    guint i = 0;
+
+    for (; args[i] && args[i][0] == '-' && args[i][1]; ++i)
+    {
+        if (!g_strcmp0 (args[i], "--"))
+            return i + 1;
+
+        for (const gchar *c = args[i] + 1; *c; ++c)
+        {
+            if (!strchr (with_arg, *c))
+                continue;
+
+            const gchar *arg = c[1] ? c + 1 : args[i + 1];
+
+            if (!c[1] && arg)
+                ++i;
+            if (*c == wanted && value)
+                *value = arg;
+            break;
+        }
+    }
+
+    return i;
+}
+
+/* globals is set to tmux and its global options, for a control client of the same server */
+GStrv
+germinal_tmux_session_argv (const gchar * const  *command,
+                            GerminalTmuxSessions  sessions,
+                            guint                 index,
+                            gchar               **session,
+                            GStrv                *globals)
+{
+    g_return_val_if_fail (command != NULL, NULL);
+    g_return_val_if_fail (session != NULL, NULL);
+    g_return_val_if_fail (globals != NULL, NULL);
+
+    *session = NULL;
+    *globals = NULL;
+
+    if (!command[0])
+        return NULL;
+
+    g_autofree gchar *name = g_path_get_basename (command[0]);
+
+    if (g_strcmp0 (name, "tmux") != 0)
+        return NULL;
+
+    /* tmux [global options] new-session|attach-session [options] */
+    guint n_globals = 1 + skip_options (command + 1, "cfLST", 0, NULL);
+    g_autoptr (GStrvBuilder) globals_builder = g_strv_builder_new ();
+
+    for (guint i = 0; i < n_globals; ++i)
+    {
+        /* Our control client picks its own mode */
+        if (g_strcmp0 (command[i], "-C") && g_strcmp0 (command[i], "-CC"))
+            g_strv_builder_add (globals_builder, command[i]);
+    }
+
+    *globals = g_strv_builder_end (globals_builder);
+    const gchar *subcommand = command[n_globals];
+    const gchar *base = NULL;
+
+    if (!g_strcmp0 (subcommand, "new-session") || !g_strcmp0 (subcommand, "new"))
+        skip_options (command + n_globals + 1, "ceFfnstxy", 's', &base);
+    else if (!g_strcmp0 (subcommand, "attach-session") || !g_strcmp0 (subcommand, "attach") || !g_strcmp0 (subcommand, "a"))
+        skip_options (command + n_globals + 1, "cft", 't', &base);
+
+    if (!base)
+        return NULL;
+
+    /* The first window keeps the configured command, so it still creates the session if needed */
+    if (sessions == GERMINAL_TMUX_SESSIONS_SHARED || index == 0)
+    {
+        *session = g_strdup (base);
+        return NULL;
+    }
+
+    g_autoptr (GStrvBuilder) builder = g_strv_builder_new ();
+    g_autofree gchar *own = g_strdup_printf ("%s-%u", base, index);
+
+    for (guint i = 0; i < n_globals; ++i)
+        g_strv_builder_add (builder, command[i]);
+
+    switch (sessions)
+    {
+    case GERMINAL_TMUX_SESSIONS_GROUPED:
+        /* Shares the windows of base but has its own current window, and goes away with us */
+        g_strv_builder_addv (builder, (const gchar *[]) { "new-session", "-t", base, "-s", own, ";",
+                                                          "set-option", "destroy-unattached", "on", NULL });
+        break;
+    case GERMINAL_TMUX_SESSIONS_PER_WINDOW:
+        g_strv_builder_addv (builder, (const gchar *[]) { "new-session", "-A", "-s", own, NULL });
+        break;
+    case GERMINAL_TMUX_SESSIONS_SHARED:
+    default:
+        g_assert_not_reached ();
+    }
+
+    *session = g_steal_pointer (&own);
+
+    return g_strv_builder_end (builder);
+}
+
+static gboolean
+parse_number (const gchar **p,
+              gchar         separator,
+              guint        *value)
+{
+    gchar *end = NULL;
+    guint64 n = g_ascii_strtoull (*p, &end, 10);
+
+    if (end == *p || n > G_MAXUINT || (separator && *end != separator))
+        return FALSE;
+
+    *value = (guint) n;
+    *p = separator ? end + 1 : end;
+
+    return TRUE;
+}
+
+static gboolean
+parse_layout_cell (const gchar **p,
+                   GArray       *panes)
+{
+    GerminalTmuxPane pane = { 0 };
+
+    if (!parse_number (p, 'x', &pane.width) ||
+        !parse_number (p, ',', &pane.height) ||
+        !parse_number (p, ',', &pane.x) ||
+        !parse_number (p, 0, &pane.y))
+    {
+        return FALSE;
+    }
+
+    gchar close = 0;
+
+    switch (**p)
+    {
+    case ',':
+        ++*p;
+        if (!parse_number (p, 0, &pane.id))
+            return FALSE;
+        g_array_append_val (panes, pane);
+        return TRUE;
+    case '{':
+        close = '}';
+        break;
+    case '[':
+        close = ']';
+        break;
+    default:
+        return FALSE;
+    }
+
+    for (++*p; ; ++*p)
+    {
+        if (!parse_layout_cell (p, panes))
+            return FALSE;
+
+        if (**p == close)
+        {
+            ++*p;
+            return TRUE;
+        }
+
+        if (**p != ',')
+            return FALSE;
+    }
+}
+
+/* Only the leaves of the layout tree matter to us, returns an array of GerminalTmuxPane */
+GArray *
+germinal_tmux_parse_layout (const gchar *layout)
+{
+    g_return_val_if_fail (layout != NULL, NULL);
+
+    const gchar *p = strchr (layout, ',');
+
+    if (!p)
+        return NULL;
+
+    g_autoptr (GArray) panes = g_array_new (FALSE, FALSE, sizeof (GerminalTmuxPane));
+
+    ++p;
+
+    if (!parse_layout_cell (&p, panes) || *p)
+        return NULL;
+
+    return g_steal_pointer (&panes);
+}
+
+/* %output escapes every byte below space and backslash as \ooo */
+GBytes *
+germinal_tmux_unescape (const gchar *data)
+{
+    g_return_val_if_fail (data != NULL, NULL);
+
+    gsize len = strlen (data);
+    guint8 *buf = g_malloc (len + 1);
+    gsize n = 0;
+
+    for (gsize i = 0; i < len; ++i)
+    {
+        if (data[i] == '\\' && i + 3 < len &&
+            data[i + 1] >= '0' && data[i + 1] <= '7' &&
+            data[i + 2] >= '0' && data[i + 2] <= '7' &&
+            data[i + 3] >= '0' && data[i + 3] <= '7')
+        {
+            buf[n++] = (guint8) (((data[i + 1] - '0') << 6) | ((data[i + 2] - '0') << 3) | (data[i + 3] - '0'));
+            i += 3;
+        }
+        else
+            buf[n++] = (guint8) data[i];
+    }
+
+    return g_bytes_new_take (buf, n);
+}
+
+static void
+germinal_tmux_dispose (GObject *object)
+{
+    GerminalTmuxPrivate *priv = germinal_tmux_get_instance_private (GERMINAL_TMUX (object));
+
+    if (priv->cancellable)
+        g_cancellable_cancel (priv->cancellable);
+
+    /*
+     * Closing stdin detaches the control client. A write still pending
+     * would make that fail, on_written closes it once cancelled instead.
+     */
+    if (priv->input && !g_output_stream_has_pending (priv->input))
+        g_output_stream_close (priv->input, NULL, NULL);
+
+    fail_replies (GERMINAL_TMUX (object));
+
+    g_clear_object (&priv->input);
+    g_clear_object (&priv->output);
+    g_clear_object (&priv->process);
+    g_clear_object (&priv->cancellable);
+
+    G_OBJECT_CLASS (germinal_tmux_parent_class)->dispose (object);
+}
+
+static void
+germinal_tmux_finalize (GObject *object)
+{
+    GerminalTmuxPrivate *priv = germinal_tmux_get_instance_private (GERMINAL_TMUX (object));
+
+    g_queue_clear (&priv->replies);
+    g_string_free (priv->block, TRUE);
+    g_string_free (priv->pending, TRUE);
+    g_string_free (priv->outbox, TRUE);
+    g_free (priv->writing);
+    g_strfreev (priv->globals);
+
+    G_OBJECT_CLASS (germinal_tmux_parent_class)->finalize (object);
+}
+
+static void
+germinal_tmux_init (GerminalTmux *self)
+{
+    GerminalTmuxPrivate *priv = germinal_tmux_get_instance_private (self);
+
+    g_queue_init (&priv->replies);
+    priv->block = g_string_new (NULL);
+    priv->pending = g_string_new (NULL);
+    priv->outbox = g_string_new (NULL);
+    priv->cancellable = g_cancellable_new ();
+}
+
+static void
+germinal_tmux_class_init (GerminalTmuxClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    object_class->dispose  = germinal_tmux_dispose;
+    object_class->finalize = germinal_tmux_finalize;
+
+    signals[SIGNAL_NOTIFICATION] = g_signal_new ("notification",
+                                                 G_TYPE_FROM_CLASS (klass),
+                                                 G_SIGNAL_RUN_LAST,
+                                                 0, NULL, NULL, NULL,
+                                                 G_TYPE_NONE, 1, G_TYPE_STRING);
+
+    signals[SIGNAL_EXITED] = g_signal_new ("exited",
+                                           G_TYPE_FROM_CLASS (klass),
+                                           G_SIGNAL_RUN_LAST,
+                                           0, NULL, NULL, NULL,
+                                           G_TYPE_NONE, 0);
+}
+
+GerminalTmux *
+germinal_tmux_new_for_argv (const gchar * const *argv,
+                            GError             **error)
+{
+    g_return_val_if_fail (argv != NULL && argv[0] != NULL, NULL);
+
+    g_autoptr (GSubprocessLauncher) launcher = g_subprocess_launcher_new (G_SUBPROCESS_FLAGS_STDIN_PIPE |
+                                                                          G_SUBPROCESS_FLAGS_STDOUT_PIPE |
+                                                                          G_SUBPROCESS_FLAGS_STDERR_SILENCE);
+
+    /* We want our own sessions, not the one we may have been started from */
+    g_subprocess_launcher_unsetenv (launcher, "TMUX");
+    g_subprocess_launcher_set_cwd (launcher, g_get_home_dir ());
+
+    g_autoptr (GSubprocess) process = g_subprocess_launcher_spawnv (launcher, argv, error);
+
+    if (!process)
+        return NULL;
+
+    GerminalTmux *self = g_object_new (GERMINAL_TYPE_TMUX, NULL);
+    GerminalTmuxPrivate *priv = germinal_tmux_get_instance_private (self);
+
+    priv->process = g_steal_pointer (&process);
+    priv->input = g_object_ref (g_subprocess_get_stdin_pipe (priv->process));
+    priv->output = g_data_input_stream_new (g_subprocess_get_stdout_pipe (priv->process));
+
+    g_data_input_stream_read_line_async (priv->output, G_PRIORITY_HIGH, priv->cancellable, on_line_read, self);
+
+    return self;
+}
+
+/* The control client for session, globals are tmux and its options as given by germinal_tmux_session_argv() */
+GStrv
+germinal_tmux_attach_argv (const gchar * const *globals,
+                           const gchar         *session)
+{
+    g_autoptr (GStrvBuilder) builder = g_strv_builder_new ();
+
+    if (globals && globals[0])
+        g_strv_builder_addv (builder, (const gchar **) globals);
+    else
+        g_strv_builder_add (builder, "tmux");
+
+    g_strv_builder_addv (builder, (const gchar *[]) { "-C", "attach-session", "-f", "ignore-size,no-output", NULL });
+
+    /* Without a session, tmux picks the most recently used one */
+    if (session)
+        g_strv_builder_addv (builder, (const gchar *[]) { "-t", session, NULL });
+
+    return g_strv_builder_end (builder);
+}
+
+GerminalTmux *
+germinal_tmux_new (const gchar * const *globals,
+                   const gchar         *session,
+                   GError             **error)
+{
+    g_auto (GStrv) argv = germinal_tmux_attach_argv (globals, session);
+    GerminalTmux *self = germinal_tmux_new_for_argv ((const gchar * const *) argv, error);
+
+    if (self)
+    {
+        GerminalTmuxPrivate *priv = germinal_tmux_get_instance_private (self);
+
+        priv->globals = g_strdupv ((GStrv) globals);
+    }
+
+    return self;
+}
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define GERMINAL_TYPE_TMUX germinal_tmux_get_type ()
+G_DECLARE_FINAL_TYPE (GerminalTmux, germinal_tmux, GERMINAL, TMUX, GObject)
+
+/* How windows share tmux sessions, matching the tmux-sessions setting */
+typedef enum
+{
+    GERMINAL_TMUX_SESSIONS_SHARED,
+    GERMINAL_TMUX_SESSIONS_GROUPED,
+    GERMINAL_TMUX_SESSIONS_PER_WINDOW,
+} GerminalTmuxSessions;
+
+typedef struct
+{
+    guint id;
+    guint width;
+    guint height;
+    guint x;
+    guint y;
+} GerminalTmuxPane;
+
+/* response is NULL if the control client went away before replying */
+typedef void (*GerminalTmuxCallback) (GerminalTmux *tmux,
+                                      const gchar  *response,
+                                      gboolean      failed,
+                                      gpointer      user_data);
+
+GerminalTmux *germinal_tmux_new          (const gchar * const *globals, const gchar *session, GError **error);
+GerminalTmux *germinal_tmux_new_for_argv (const gchar * const *argv, GError **error);
+gboolean      germinal_tmux_send         (GerminalTmux *self, const gchar *command);
+gboolean      germinal_tmux_command      (GerminalTmux *self, const gchar *command, GerminalTmuxCallback callback, gpointer user_data);
+void          germinal_tmux_run_detached (const gchar * const *globals, const gchar *commands);
+
+GStrv         germinal_tmux_control_argv (const gchar * const *command);
+GStrv         germinal_tmux_session_argv (const gchar * const *command, GerminalTmuxSessions sessions, guint index, gchar **session, GStrv *globals);
+GStrv         germinal_tmux_attach_argv  (const gchar * const *globals, const gchar *session);
+gchar        *germinal_tmux_command_line (const gchar * const *globals, const gchar *command);
+GArray       *germinal_tmux_parse_layout (const gchar *layout);
+GBytes       *germinal_tmux_unescape     (const gchar *data);
+
+G_END_DECLS
@@ -1,10 +1,22 @@
 // SPDX-FileCopyrightText: 2018-2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include "germinal-export.h"
+#include "germinal-global-search.h"
 #include "germinal-preferences.h"
 #include "germinal-settings.h"
+#include "germinal-timings.h"
 #include "germinal-window.h"
 
+#include <stdlib.h>
+
+#ifdef GDK_WINDOWING_X11
+#include <gdk/x11/gdkx.h>
+#endif
+
+/* How long the throughput of a big paste stays on screen */
+#define PASTE_REPORT_SECONDS 3
+
 struct _GerminalWindow
 {
     AdwApplicationWindow parent_instance;
@@ -13,6 +25,8 @@ struct _GerminalWindow
 enum
 {
     PROP_TERMINAL = 1,
+    PROP_TMUX_VIEW,
+    PROP_TABS,
 
     N_PROPS
 };
@@ -21,50 +35,109 @@ typedef struct
 {
     GSettings        *settings;
     GerminalTerminal *terminal;
+    GerminalTmuxView *tmux_view;
+    AdwTabView       *tab_view;
+    gboolean          tabs;
 
     GSignalGroup     *settings_signals;
     GSignalGroup     *terminal_signals;
     GSignalGroup     *search_entry_signals;
 
+    GtkWidget        *content;
     GtkWidget        *header_bar;
     GtkWidget        *search_button;
     GtkWidget        *popover;
-    GMenu            *url_section;
+    GActionMap       *actions;
 
     GtkWidget        *search_bar;
     GtkWidget        *search_entry;
+    GtkWidget        *search_regex_button;
+    GtkWidget        *search_matches_label;
 
-    guint             spawn_source_id;
+    GtkWidget        *export_bar;
+    GtkWidget        *export_progress;
+    GCancellable     *export_cancellable;
+
+    GtkWidget        *paste_bar;
+    GtkWidget        *paste_label;
+    GtkWidget        *paste_progress;
+    GtkWidget        *paste_cancel_button;
+    guint             paste_report_id;
+
+    GStrv             pending_command;
 } GerminalWindowPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (GerminalWindow, germinal_window, ADW_TYPE_APPLICATION_WINDOW)
 
-typedef struct {
-    GerminalWindow   *win;
-    GerminalTerminal *term;
-    GStrv             command;
-} GerminalCommandData;
-
+/* The grid the terminal will get once maximized on its monitor, so that the child starts at its final size */
 static void
-germinal_command_data_free (gpointer user_data)
+germinal_window_fit_terminal (GerminalWindow *self)
 {
-    g_autofree GerminalCommandData *data = user_data;
-    g_strfreev (data->command);
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+    GtkWidget *terminal = GTK_WIDGET (priv->terminal);
+    VteTerminal *vte = VTE_TERMINAL (priv->terminal);
+    GdkDisplay *display = gtk_widget_get_display (terminal);
+
+    GdkSurface *surface = gtk_native_get_surface (GTK_NATIVE (self));
+    g_autoptr (GdkMonitor) monitor = surface ? gdk_display_get_monitor_at_surface (display, surface) : NULL;
+
+    if (monitor)
+        g_object_ref (monitor);
+
+    if (!monitor)
+        monitor = g_list_model_get_item (gdk_display_get_monitors (display), 0);
+
+    glong char_width = vte_terminal_get_char_width (vte);
+    glong char_height = vte_terminal_get_char_height (vte);
+
+    if (!monitor || char_width <= 0 || char_height <= 0)
+        return;
+
+    GdkRectangle area;
+    gdk_monitor_get_geometry (monitor, &area);
+#ifdef GDK_WINDOWING_X11
+    if (GDK_IS_X11_MONITOR (monitor))
+        gdk_x11_monitor_get_workarea (monitor, &area);
+#endif
+
+    /*
+     * Only X11 tells where panels are, elsewhere the whole monitor is all we
+     * know of and the guess is too large by their size.
+     */
+
+    /* Whatever vte adds around the grid (padding) */
+    gint natural_width = 0, natural_height = 0;
+    gtk_widget_measure (terminal, GTK_ORIENTATION_HORIZONTAL, -1, NULL, &natural_width, NULL, NULL);
+    gtk_widget_measure (terminal, GTK_ORIENTATION_VERTICAL, -1, NULL, &natural_height, NULL, NULL);
+
+    /* And what the window adds around the terminal: header bar, tab bar, client side borders */
+    gint window_width = 0, window_height = 0;
+    gtk_widget_measure (GTK_WIDGET (self), GTK_ORIENTATION_HORIZONTAL, -1, NULL, &window_width, NULL, NULL);
+    gtk_widget_measure (GTK_WIDGET (self), GTK_ORIENTATION_VERTICAL, -1, NULL, &window_height, NULL, NULL);
+
+    area.width -= MAX (window_width - natural_width, 0) + natural_width - char_width * vte_terminal_get_column_count (vte);
+    area.height -= MAX (window_height - natural_height, 0) + natural_height - char_height * vte_terminal_get_row_count (vte);
+
+    glong columns = MAX (area.width / char_width, 1);
+    glong rows = MAX (area.height / char_height, 1);
+
+    g_debug ("Spawning at %ldx%ld on a %dx%d area", columns, rows, area.width, area.height);
+    vte_terminal_set_size (vte, columns, rows);
 }
 
-static gboolean
-germinal_spawn_command (gpointer user_data)
+/* Font metrics are only known once realized, which is when we can size the pty and spawn */
+static void
+on_terminal_realized (GtkWidget *terminal,
+                      gpointer   user_data)
 {
-    GerminalCommandData *data = user_data;
-    GerminalWindowPrivate *priv = germinal_window_get_instance_private (data->win);
-
-    if (!gtk_widget_get_realized (GTK_WIDGET (data->win)) || !gtk_widget_get_realized (GTK_WIDGET (data->term)))
-        return G_SOURCE_CONTINUE;
+    GerminalWindow *self = GERMINAL_WINDOW (user_data);
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
 
-    priv->spawn_source_id = 0;
-    germinal_terminal_spawn_command (data->term, g_steal_pointer (&data->command));
+    g_signal_handlers_disconnect_by_func (terminal, on_terminal_realized, self);
 
-    return G_SOURCE_REMOVE;
+    /* vte creates the pty at the terminal's current size */
+    germinal_window_fit_terminal (self);
+    germinal_terminal_spawn_command (priv->terminal, g_steal_pointer (&priv->pending_command));
 }
 
 void
@@ -75,13 +148,40 @@ germinal_window_spawn_command (GerminalWindow *self,
 
     GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
 
-    GerminalCommandData *data = g_new0 (GerminalCommandData, 1);
-    data->win = self;
-    data->term = priv->terminal;
-    data->command = command;
+    if (priv->tmux_view)
+    {
+        g_auto (GStrv) argv = command;
+        g_autoptr (GError) error = NULL;
+
+        if (!germinal_tmux_view_start (priv->tmux_view, (const gchar * const *) argv, &error))
+        {
+            g_critical ("%s", error->message);
+            exit (EXIT_FAILURE);
+        }
+
+        return;
+    }
+
+    if (priv->tab_view)
+    {
+        germinal_window_open_tab (self, command, TRUE);
+        return;
+    }
+
+    g_strfreev (priv->pending_command);
+    priv->pending_command = command;
 
-    priv->spawn_source_id = g_idle_add_full (G_PRIORITY_DEFAULT_IDLE, germinal_spawn_command, data, germinal_command_data_free);
-    g_source_set_name_by_id (priv->spawn_source_id, "[germinal] spawn-command");
+    if (gtk_widget_get_realized (GTK_WIDGET (priv->terminal)))
+    {
+        on_terminal_realized (GTK_WIDGET (priv->terminal), self);
+        return;
+    }
+
+    g_signal_connect_object (priv->terminal, "realize", G_CALLBACK (on_terminal_realized), self, 0);
+
+    /* Hidden windows (spares, drop-down) start their command right away */
+    if (!gtk_widget_get_visible (GTK_WIDGET (self)))
+        gtk_widget_realize (GTK_WIDGET (priv->terminal));
 }
 
 static void
@@ -95,6 +195,39 @@ update_decorated (GSettings   *settings,
         gtk_widget_set_visible (priv->header_bar, g_settings_get_boolean (settings, key));
 }
 
+static void germinal_window_set_terminal (GerminalWindow *self, GerminalTerminal *terminal);
+static void update_search_matches (GerminalWindow *self);
+static void update_paste_bar (GerminalWindow *self);
+
+static void
+germinal_window_set_popover_parent (GerminalWindow *self,
+                                    GtkWidget      *parent)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+
+    if (!priv->popover || gtk_widget_get_parent (priv->popover) == parent)
+        return;
+
+    g_object_ref (priv->popover);
+    gtk_widget_unparent (priv->popover);
+    gtk_widget_set_parent (priv->popover, parent);
+    g_object_unref (priv->popover);
+}
+
+static void
+on_popover_closed (GtkPopover *popover G_GNUC_UNUSED,
+                   gpointer    user_data)
+{
+    GerminalWindow *self = GERMINAL_WINDOW (user_data);
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+
+    /* Don't stay attached to a pane that may go away */
+    if (priv->content)
+        germinal_window_set_popover_parent (self, priv->content);
+}
+
+static void germinal_window_ensure_popover (GerminalWindow *self);
+
 static void
 on_click_pressed (GtkGestureClick *gesture,
                   gint             n_press G_GNUC_UNUSED,
@@ -104,26 +237,28 @@ on_click_pressed (GtkGestureClick *gesture,
 {
     GerminalWindow *self = GERMINAL_WINDOW (user_data);
     GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+    GerminalTerminal *terminal = GERMINAL_TERMINAL (gtk_event_controller_get_widget (GTK_EVENT_CONTROLLER (gesture)));
     guint button = gtk_gesture_single_get_current_button (GTK_GESTURE_SINGLE (gesture));
     GdkModifierType state = gtk_event_controller_get_current_event_state (GTK_EVENT_CONTROLLER (gesture));
 
     /* Shift + Left click */
     if (button == GDK_BUTTON_PRIMARY && (state & GDK_SHIFT_MASK))
     {
-        germinal_terminal_update_url (priv->terminal, x, y);
-        germinal_terminal_open_url (priv->terminal);
+        germinal_terminal_update_url (terminal, x, y);
+        germinal_terminal_open_url (terminal);
     }
     else if (button == GDK_BUTTON_SECONDARY)
     {
-        germinal_terminal_update_url (priv->terminal, x, y);
-        gboolean has_url = germinal_terminal_get_url (priv->terminal) != NULL;
+        germinal_window_set_terminal (self, terminal);
+        germinal_terminal_update_url (terminal, x, y);
+        gboolean has_url = germinal_terminal_get_url (terminal) != NULL;
 
-        g_menu_remove_all (priv->url_section);
-        if (has_url)
-        {
-            g_menu_append (priv->url_section, _("Copy url"), "ctx.copy-url");
-            g_menu_append (priv->url_section, _("Open url"), "ctx.open-url");
-        }
+        germinal_window_ensure_popover (self);
+        g_simple_action_set_enabled (G_SIMPLE_ACTION (g_action_map_lookup_action (priv->actions, "copy-url")), has_url);
+        g_simple_action_set_enabled (G_SIMPLE_ACTION (g_action_map_lookup_action (priv->actions, "open-url")), has_url);
+
+        /* The menu follows whichever pane was clicked */
+        germinal_window_set_popover_parent (self, GTK_WIDGET (terminal));
 
         GdkRectangle rect = { (gint) x, (gint) y, 1, 1 };
         gtk_popover_set_pointing_to (GTK_POPOVER (priv->popover), &rect);
@@ -141,6 +276,13 @@ on_child_exited (VteTerminal *vteterminal G_GNUC_UNUSED,
     gtk_window_close (GTK_WINDOW (user_data));
 }
 
+static void
+on_tmux_exited (GerminalTmuxView *view G_GNUC_UNUSED,
+                gpointer          user_data)
+{
+    gtk_window_close (GTK_WINDOW (user_data));
+}
+
 static void
 on_window_title_changed (VteTerminal *vteterminal,
                          const gchar *prop G_GNUC_UNUSED,
@@ -150,13 +292,494 @@ on_window_title_changed (VteTerminal *vteterminal,
     gtk_window_set_title (GTK_WINDOW (user_data), title);
 }
 
+static void
+germinal_window_set_terminal (GerminalWindow   *self,
+                              GerminalTerminal *terminal)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+
+    if (!g_set_object (&priv->terminal, terminal))
+        return;
+
+    g_signal_group_set_target (priv->terminal_signals, terminal);
+    update_search_matches (self);
+    update_paste_bar (self);
+
+    if (terminal)
+        on_window_title_changed (VTE_TERMINAL (terminal), NULL, self);
+}
+
+static void
+germinal_window_add_terminal (GerminalWindow   *self,
+                              GerminalTerminal *terminal)
+{
+    GtkGesture *gesture = gtk_gesture_click_new ();
+    gtk_gesture_single_set_button (GTK_GESTURE_SINGLE (gesture), 0);
+    g_signal_connect (gesture, "pressed", G_CALLBACK (on_click_pressed), self);
+    gtk_widget_add_controller (GTK_WIDGET (terminal), GTK_EVENT_CONTROLLER (gesture));
+}
+
+static void
+on_terminal_added (GerminalTmuxView *view G_GNUC_UNUSED,
+                   GerminalTerminal *terminal,
+                   gpointer          user_data)
+{
+    germinal_window_add_terminal (GERMINAL_WINDOW (user_data), terminal);
+}
+
+static void
+on_active_terminal_changed (GerminalTmuxView *view,
+                            GParamSpec       *pspec G_GNUC_UNUSED,
+                            gpointer          user_data)
+{
+    germinal_window_set_terminal (GERMINAL_WINDOW (user_data), germinal_tmux_view_get_active_terminal (view));
+}
+
+/* --- Built-in tabs and splits ------------------------------------------ */
+
+/*
+ * Each tab page is an AdwBin "slot". Until the page is first shown, the slot
+ * only holds the GerminalPtyChild of its process, and no terminal widget.
+ * Once shown, it holds either a terminal or a tree of GtkPaned.
+ */
+#define SLOT_PTY_CHILD "germinal-pty-child"
+
+static GStrv
+germinal_window_get_tab_command (GerminalWindow *self)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+    g_autofree gchar *setting = g_settings_get_string (priv->settings, STARTUP_COMMAND_KEY);
+    g_auto (GStrv) command = NULL;
+    g_auto (GStrv) control = NULL;
+    g_autoptr (GError) error = NULL;
+
+    if (!g_shell_parse_argv (setting, NULL, &command, &error))
+        g_warning ("%s", error->message);
+
+    /* Every tab attaching the same tmux session would only mirror it */
+    if (command && !(control = germinal_tmux_control_argv ((const gchar * const *) command)))
+        return g_steal_pointer (&command);
+
+    g_autofree gchar *shell = vte_get_user_shell ();
+    gchar *argv[] = { shell ? shell : (gchar *) "/bin/sh", NULL };
+
+    return g_strdupv (argv);
+}
+
+static GerminalPtyChild *
+germinal_window_spawn_child (GerminalWindow *self,
+                             GStrv           command_override,
+                             glong           columns,
+                             glong           rows)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+    g_auto (GStrv) command = command_override ? command_override : germinal_window_get_tab_command (self);
+    g_autofree gchar *term = g_settings_get_string (priv->settings, TERM_KEY);
+    g_auto (GStrv) envp = g_environ_setenv (g_get_environ (), "TERM", term, TRUE);
+    g_autoptr (GError) error = NULL;
+
+    GerminalPtyChild *child = germinal_pty_child_new ((const gchar * const *) command, (const gchar * const *) envp, columns, rows, &error);
+
+    if (!child)
+        g_warning ("%s \"%s\": %s", _("Couldn't exec"), command[0], error->message);
+
+    return child;
+}
+
+static void
+collect_terminals (GtkWidget *widget,
+                   GPtrArray *terminals)
+{
+    if (GERMINAL_IS_TERMINAL (widget))
+    {
+        if (gtk_widget_get_visible (widget))
+            g_ptr_array_add (terminals, widget);
+        return;
+    }
+
+    for (GtkWidget *child = gtk_widget_get_first_child (widget); child; child = gtk_widget_get_next_sibling (child))
+    {
+        if (gtk_widget_get_visible (child))
+            collect_terminals (child, terminals);
+    }
+}
+
+static GerminalTerminal *
+first_terminal (GtkWidget *widget)
+{
+    g_autoptr (GPtrArray) terminals = g_ptr_array_new ();
+
+    collect_terminals (widget, terminals);
+
+    return terminals->len ? terminals->pdata[0] : NULL;
+}
+
+static void
+replace_child (GtkWidget *parent,
+               GtkWidget *old,
+               GtkWidget *child)
+{
+    if (!GTK_IS_PANED (parent))
+        adw_bin_set_child (ADW_BIN (parent), child);
+    else if (gtk_paned_get_start_child (GTK_PANED (parent)) == old)
+        gtk_paned_set_start_child (GTK_PANED (parent), child);
+    else
+        gtk_paned_set_end_child (GTK_PANED (parent), child);
+}
+
+static void
+germinal_window_focus_pane (GerminalWindow *self,
+                            GtkWidget      *pane)
+{
+    GerminalTerminal *terminal = first_terminal (pane);
+
+    if (!terminal)
+        return;
+
+    germinal_window_set_terminal (self, terminal);
+    gtk_widget_grab_focus (GTK_WIDGET (terminal));
+}
+
+/* Returns whether some pane was hidden by a zoom */
+static gboolean
+unzoom (GtkWidget *widget)
+{
+    gboolean changed = FALSE;
+
+    if (ADW_IS_BIN (widget))
+        return unzoom (adw_bin_get_child (ADW_BIN (widget)));
+
+    if (!GTK_IS_PANED (widget))
+        return FALSE;
+
+    GtkWidget *children[] = { gtk_paned_get_start_child (GTK_PANED (widget)), gtk_paned_get_end_child (GTK_PANED (widget)) };
+
+    for (guint i = 0; i < G_N_ELEMENTS (children); ++i)
+    {
+        if (!gtk_widget_get_visible (children[i]))
+        {
+            gtk_widget_set_visible (children[i], TRUE);
+            changed = TRUE;
+        }
+        changed |= unzoom (children[i]);
+    }
+
+    return changed;
+}
+
+static void
+germinal_window_remove_pane (GerminalWindow *self,
+                             GtkWidget      *pane)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+    GtkWidget *parent = gtk_widget_get_parent (pane);
+    GtkWidget *anchor = priv->popover ? gtk_widget_get_parent (priv->popover) : NULL;
+
+    if (anchor && (anchor == pane || gtk_widget_is_ancestor (anchor, pane)))
+    {
+        gtk_popover_popdown (GTK_POPOVER (priv->popover));
+        germinal_window_set_popover_parent (self, priv->content);
+    }
+
+    if (!GTK_IS_PANED (parent))
+    {
+        /* Last pane of its tab, pane is either the slot itself or its terminal */
+        GtkWidget *slot = ADW_IS_BIN (pane) ? pane : parent;
+
+        adw_tab_view_close_page (priv->tab_view, adw_tab_view_get_page (priv->tab_view, slot));
+        return;
+    }
+
+    GtkPaned *paned = GTK_PANED (parent);
+    GtkWidget *sibling = gtk_paned_get_start_child (paned) == pane ? gtk_paned_get_end_child (paned) : gtk_paned_get_start_child (paned);
+
+    g_object_ref (sibling);
+    gtk_paned_set_start_child (paned, NULL);
+    gtk_paned_set_end_child (paned, NULL);
+    replace_child (gtk_widget_get_parent (parent), parent, sibling);
+    unzoom (sibling);
+    gtk_widget_set_visible (sibling, TRUE);
+    germinal_window_focus_pane (self, sibling);
+    g_object_unref (sibling);
+}
+
+static void
+on_pane_exited (GerminalPtyChild *child G_GNUC_UNUSED,
+                gint              status,
+                gpointer          user_data)
+{
+    GtkWidget *pane = GTK_WIDGET (user_data);
+    GtkRoot *root = gtk_widget_get_root (pane);
+
+    if (status)
+        g_warning ("child exited with code %d", status);
+
+    if (GERMINAL_IS_WINDOW (root))
+        germinal_window_remove_pane (GERMINAL_WINDOW (root), pane);
+}
+
+static void
+on_pane_title_changed (VteTerminal *vteterminal,
+                       const gchar *prop G_GNUC_UNUSED,
+                       gpointer     user_data)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
+    GtkWidget *slot = gtk_widget_get_ancestor (GTK_WIDGET (vteterminal), ADW_TYPE_BIN);
+    g_autofree gchar *title = vte_terminal_dup_termprop_string_by_id (vteterminal, VTE_PROPERTY_ID_XTERM_TITLE, NULL);
+
+    if (slot && title)
+        adw_tab_page_set_title (adw_tab_view_get_page (priv->tab_view, slot), title);
+}
+
+static void
+on_pane_focused (GtkEventControllerFocus *controller,
+                 gpointer                 user_data)
+{
+    GtkWidget *terminal = gtk_event_controller_get_widget (GTK_EVENT_CONTROLLER (controller));
+
+    germinal_window_set_terminal (GERMINAL_WINDOW (user_data), GERMINAL_TERMINAL (terminal));
+}
+
+static GtkWidget *
+germinal_window_create_pane (GerminalWindow   *self,
+                             GerminalPtyChild *child)
+{
+    GerminalTerminal *terminal = GERMINAL_TERMINAL (germinal_terminal_new ());
+
+    germinal_terminal_attach (terminal, child);
+    germinal_window_add_terminal (self, terminal);
+
+    GtkEventController *focus_ctrl = gtk_event_controller_focus_new ();
+    g_signal_connect (focus_ctrl, "enter", G_CALLBACK (on_pane_focused), self);
+    gtk_widget_add_controller (GTK_WIDGET (terminal), focus_ctrl);
+
+    g_signal_connect_object (child,    "exited",                                      G_CALLBACK (on_pane_exited),        terminal, 0);
+    g_signal_connect_object (terminal, "termprop-changed::" VTE_TERMPROP_XTERM_TITLE, G_CALLBACK (on_pane_title_changed), self,     0);
+
+    return GTK_WIDGET (terminal);
+}
+
+static void
+germinal_window_show_slot (GerminalWindow *self,
+                           GtkWidget      *slot)
+{
+    GerminalPtyChild *child = g_object_get_data (G_OBJECT (slot), SLOT_PTY_CHILD);
+
+    /* First time this tab is shown, now is the time to pay for a terminal */
+    if (child)
+    {
+        GtkWidget *terminal = germinal_window_create_pane (self, child);
+
+        g_signal_handlers_disconnect_by_data (child, slot);
+        adw_bin_set_child (ADW_BIN (slot), terminal);
+        g_object_set_data (G_OBJECT (slot), SLOT_PTY_CHILD, NULL);
+    }
+
+    germinal_window_focus_pane (self, slot);
+}
+
+static void
+on_selected_page_changed (AdwTabView *view,
+                          GParamSpec *pspec G_GNUC_UNUSED,
+                          gpointer    user_data)
+{
+    AdwTabPage *page = adw_tab_view_get_selected_page (view);
+
+    if (page)
+        germinal_window_show_slot (GERMINAL_WINDOW (user_data), adw_tab_page_get_child (page));
+}
+
+static void
+on_n_pages_changed (AdwTabView *view,
+                    GParamSpec *pspec G_GNUC_UNUSED,
+                    gpointer    user_data)
+{
+    if (!adw_tab_view_get_n_pages (view))
+        gtk_window_close (GTK_WINDOW (user_data));
+}
+
+static void
+germinal_window_get_grid_size (GerminalWindow *self,
+                               glong          *columns,
+                               glong          *rows)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+
+    *columns = priv->terminal ? vte_terminal_get_column_count (VTE_TERMINAL (priv->terminal)) : 0;
+    *rows    = priv->terminal ? vte_terminal_get_row_count (VTE_TERMINAL (priv->terminal))    : 0;
+}
+
+void
+germinal_window_open_tab (GerminalWindow *self,
+                          GStrv           command,
+                          gboolean        select)
+{
+    g_return_if_fail (GERMINAL_IS_WINDOW (self));
+
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+    glong columns, rows;
+
+    g_return_if_fail (priv->tab_view != NULL);
+
+    germinal_window_get_grid_size (self, &columns, &rows);
+
+    g_autoptr (GerminalPtyChild) child = germinal_window_spawn_child (self, command, columns, rows);
+
+    if (!child)
+    {
+        if (!adw_tab_view_get_n_pages (priv->tab_view))
+            gtk_window_close (GTK_WINDOW (self));
+        return;
+    }
+
+    GtkWidget *slot = adw_bin_new ();
+
+    g_object_set_data_full (G_OBJECT (slot), SLOT_PTY_CHILD, g_object_ref (child), g_object_unref);
+    g_signal_connect_object (child, "exited", G_CALLBACK (on_pane_exited), slot, 0);
+
+    AdwTabPage *page = adw_tab_view_append (priv->tab_view, slot);
+    adw_tab_page_set_title (page, _("Terminal"));
+
+    if (select)
+        adw_tab_view_set_selected_page (priv->tab_view, page);
+}
+
+static void
+germinal_window_split (GerminalWindow *self,
+                       GtkOrientation  orientation)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+    glong columns, rows;
+
+    if (!priv->terminal)
+        return;
+
+    germinal_window_get_grid_size (self, &columns, &rows);
+
+    if (orientation == GTK_ORIENTATION_HORIZONTAL)
+        columns /= 2;
+    else
+        rows /= 2;
+
+    g_autoptr (GerminalPtyChild) child = germinal_window_spawn_child (self, NULL, columns, rows);
+
+    if (!child)
+        return;
+
+    GtkWidget *terminal = g_object_ref (GTK_WIDGET (priv->terminal));
+    GtkWidget *pane = germinal_window_create_pane (self, child);
+    GtkWidget *paned = gtk_paned_new (orientation);
+
+    unzoom (gtk_widget_get_ancestor (terminal, ADW_TYPE_BIN));
+    replace_child (gtk_widget_get_parent (terminal), terminal, paned);
+    gtk_paned_set_start_child (GTK_PANED (paned), terminal);
+    gtk_paned_set_end_child (GTK_PANED (paned), pane);
+    g_object_unref (terminal);
+
+    germinal_window_focus_pane (self, pane);
+}
+
+static void
+germinal_window_cycle_pane (GerminalWindow *self,
+                            gint            direction)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+    AdwTabPage *page = adw_tab_view_get_selected_page (priv->tab_view);
+
+    if (!page)
+        return;
+
+    GtkWidget *slot = adw_tab_page_get_child (page);
+    g_autoptr (GPtrArray) terminals = g_ptr_array_new ();
+    guint index = 0;
+
+    unzoom (slot);
+    collect_terminals (slot, terminals);
+
+    if (!terminals->len)
+        return;
+
+    g_ptr_array_find (terminals, priv->terminal, &index);
+    index = (index + terminals->len + direction) % terminals->len;
+    germinal_window_focus_pane (self, terminals->pdata[index]);
+}
+
+static void
+germinal_window_toggle_zoom (GerminalWindow *self)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+
+    if (!priv->terminal)
+        return;
+
+    GtkWidget *pane = GTK_WIDGET (priv->terminal);
+    GtkWidget *slot = gtk_widget_get_ancestor (pane, ADW_TYPE_BIN);
+
+    if (!slot || unzoom (slot))
+        return;
+
+    /* Hide every sibling on the way up to the slot */
+    for (GtkWidget *parent = gtk_widget_get_parent (pane); parent != slot; pane = parent, parent = gtk_widget_get_parent (parent))
+    {
+        GtkPaned *paned = GTK_PANED (parent);
+        GtkWidget *sibling = gtk_paned_get_start_child (paned) == pane ? gtk_paned_get_end_child (paned) : gtk_paned_get_start_child (paned);
+
+        gtk_widget_set_visible (sibling, FALSE);
+    }
+}
+
+static gboolean
+germinal_window_handle_tab_key (GerminalWindow *self,
+                                guint           keyval)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+
+    /* Same shortcuts as with tmux */
+    switch (keyval)
+    {
+    case GDK_KEY_O:
+        germinal_window_split (self, GTK_ORIENTATION_VERTICAL);
+        return TRUE;
+    case GDK_KEY_E:
+        germinal_window_split (self, GTK_ORIENTATION_HORIZONTAL);
+        return TRUE;
+    case GDK_KEY_Tab:
+        if (!adw_tab_view_select_next_page (priv->tab_view))
+            adw_tab_view_set_selected_page (priv->tab_view, adw_tab_view_get_nth_page (priv->tab_view, 0));
+        return TRUE;
+    case GDK_KEY_ISO_Left_Tab:
+        if (!adw_tab_view_select_previous_page (priv->tab_view))
+            adw_tab_view_set_selected_page (priv->tab_view, adw_tab_view_get_nth_page (priv->tab_view, adw_tab_view_get_n_pages (priv->tab_view) - 1));
+        return TRUE;
+    case GDK_KEY_T:
+        germinal_window_open_tab (self, NULL, TRUE);
+        return TRUE;
+    case GDK_KEY_N:
+        germinal_window_cycle_pane (self, 1);
+        return TRUE;
+    case GDK_KEY_P:
+        germinal_window_cycle_pane (self, -1);
+        return TRUE;
+    case GDK_KEY_W:
+        if (priv->terminal)
+            germinal_pty_child_terminate (germinal_terminal_get_pty_child (priv->terminal));
+        return TRUE;
+    case GDK_KEY_X:
+        germinal_window_toggle_zoom (self);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
 static void
 action_copy (GSimpleAction *action G_GNUC_UNUSED,
              GVariant      *param G_GNUC_UNUSED,
              gpointer       user_data)
 {
     GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
-    germinal_terminal_copy (priv->terminal);
+    if (priv->terminal)
+        germinal_terminal_copy (priv->terminal);
 }
 
 static void
@@ -165,7 +788,8 @@ action_copy_html (GSimpleAction *action G_GNUC_UNUSED,
                   gpointer       user_data)
 {
     GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
-    germinal_terminal_copy_html (priv->terminal);
+    if (priv->terminal)
+        germinal_terminal_copy_html (priv->terminal);
 }
 
 static void
@@ -174,7 +798,8 @@ action_paste (GSimpleAction *action G_GNUC_UNUSED,
               gpointer       user_data)
 {
     GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
-    germinal_terminal_paste (priv->terminal);
+    if (priv->terminal)
+        germinal_terminal_paste (priv->terminal);
 }
 
 static void
@@ -183,7 +808,8 @@ action_copy_url (GSimpleAction *action G_GNUC_UNUSED,
                  gpointer       user_data)
 {
     GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
-    germinal_terminal_copy_url (priv->terminal);
+    if (priv->terminal)
+        germinal_terminal_copy_url (priv->terminal);
 }
 
 static void
@@ -192,7 +818,8 @@ action_open_url (GSimpleAction *action G_GNUC_UNUSED,
                  gpointer       user_data)
 {
     GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
-    germinal_terminal_open_url (priv->terminal);
+    if (priv->terminal)
+        germinal_terminal_open_url (priv->terminal);
 }
 
 static void
@@ -200,26 +827,298 @@ action_zoom_in (GSimpleAction *action G_GNUC_UNUSED,
                 GVariant      *param G_GNUC_UNUSED,
                 gpointer       user_data)
 {
-    GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
-    germinal_terminal_zoom_in (priv->terminal);
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
+    if (priv->terminal)
+        germinal_terminal_zoom_in (priv->terminal);
+}
+
+static void
+action_zoom_out (GSimpleAction *action G_GNUC_UNUSED,
+                 GVariant      *param G_GNUC_UNUSED,
+                 gpointer       user_data)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
+    if (priv->terminal)
+        germinal_terminal_zoom_out (priv->terminal);
+}
+
+static void
+action_reset_zoom (GSimpleAction *action G_GNUC_UNUSED,
+                   GVariant      *param G_GNUC_UNUSED,
+                   gpointer       user_data)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
+    if (priv->terminal)
+        germinal_terminal_reset_zoom (priv->terminal);
+}
+
+static void
+on_export_progress (gint64   rows_done,
+                    gint64   n_rows,
+                    gpointer user_data)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
+
+    if (priv->export_progress)
+        gtk_progress_bar_set_fraction (GTK_PROGRESS_BAR (priv->export_progress), n_rows ? (gdouble) rows_done / n_rows : 1.0);
+}
+
+static void
+on_export_done (GObject      *source,
+                GAsyncResult *result,
+                gpointer      user_data)
+{
+    g_autoptr (GerminalWindow) self = user_data;
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+    g_autoptr (GError) error = NULL;
+
+    g_clear_object (&priv->export_cancellable);
+
+    /* Closed meanwhile */
+    if (!priv->export_bar)
+        return;
+
+    gtk_revealer_set_reveal_child (GTK_REVEALER (priv->export_bar), FALSE);
+
+    if (germinal_export_finish (VTE_TERMINAL (source), result, &error) || g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        return;
+
+    AdwDialog *alert = adw_alert_dialog_new (_("Couldn't save the scrollback"), error->message);
+    adw_alert_dialog_add_response (ADW_ALERT_DIALOG (alert), "close", _("Close"));
+    adw_dialog_present (alert, GTK_WIDGET (self));
+}
+
+static void
+on_export_cancel_clicked (GtkButton *button G_GNUC_UNUSED,
+                          gpointer   user_data)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
+
+    g_cancellable_cancel (priv->export_cancellable);
+}
+
+/* A bar sliding down below the header bar, with a label, a progress bar and a Cancel button */
+static GtkWidget *
+germinal_window_add_progress_bar (GerminalWindow *self,
+                                  GtkWidget     **label,
+                                  GtkWidget     **progress,
+                                  GtkWidget     **cancel_button,
+                                  GCallback       on_cancel_clicked)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+
+    GtkWidget *bar_label = gtk_label_new (NULL);
+
+    GtkWidget *bar_progress = gtk_progress_bar_new ();
+    gtk_widget_set_hexpand (bar_progress, TRUE);
+    gtk_widget_set_valign (bar_progress, GTK_ALIGN_CENTER);
+
+    GtkWidget *bar_cancel_button = gtk_button_new_with_label (_("Cancel"));
+    gtk_widget_add_css_class (bar_cancel_button, "flat");
+    g_signal_connect_object (bar_cancel_button, "clicked", on_cancel_clicked, self, 0);
+
+    GtkWidget *box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 12);
+    gtk_widget_set_margin_start (box, 12);
+    gtk_widget_set_margin_end (box, 6);
+    gtk_box_append (GTK_BOX (box), bar_label);
+    gtk_box_append (GTK_BOX (box), bar_progress);
+    gtk_box_append (GTK_BOX (box), bar_cancel_button);
+
+    GtkWidget *bar = gtk_revealer_new ();
+    gtk_revealer_set_transition_type (GTK_REVEALER (bar), GTK_REVEALER_TRANSITION_TYPE_SLIDE_DOWN);
+    gtk_revealer_set_child (GTK_REVEALER (bar), box);
+
+    gtk_box_insert_child_after (GTK_BOX (gtk_widget_get_parent (priv->header_bar)), bar, priv->header_bar);
+
+    if (label)
+        *label = bar_label;
+    if (progress)
+        *progress = bar_progress;
+    if (cancel_button)
+        *cancel_button = bar_cancel_button;
+
+    return bar;
+}
+
+/* Only built for the first export */
+static void
+germinal_window_ensure_export_bar (GerminalWindow *self)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+    GtkWidget *label;
+
+    if (priv->export_bar)
+        return;
+
+    priv->export_bar = germinal_window_add_progress_bar (self, &label, &priv->export_progress, NULL,
+                                                         G_CALLBACK (on_export_cancel_clicked));
+    gtk_label_set_label (GTK_LABEL (label), _("Saving scrollback…"));
+}
+
+static void
+on_export_file_chosen (GObject      *source,
+                       GAsyncResult *result,
+                       gpointer      user_data)
+{
+    g_autoptr (GerminalWindow) self = user_data;
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+    g_autoptr (GFile) file = gtk_file_dialog_save_finish (GTK_FILE_DIALOG (source), result, NULL);
+
+    if (!file || !priv->terminal || priv->export_cancellable)
+        return;
+
+    germinal_window_ensure_export_bar (self);
+    gtk_progress_bar_set_fraction (GTK_PROGRESS_BAR (priv->export_progress), 0.0);
+    gtk_revealer_set_reveal_child (GTK_REVEALER (priv->export_bar), TRUE);
+
+    priv->export_cancellable = g_cancellable_new ();
+    germinal_export_async (VTE_TERMINAL (priv->terminal), file, germinal_export_format_for_file (file),
+                           germinal_settings_get_forecolor (), germinal_settings_get_backcolor (),
+                           pango_font_description_get_family (germinal_settings_get_font ()),
+                           priv->export_cancellable, on_export_progress, self, on_export_done, g_object_ref (self));
+}
+
+static GListModel *
+export_filters (void)
+{
+    GListStore *filters = g_list_store_new (GTK_TYPE_FILE_FILTER);
+    const struct { const gchar *name; const gchar *pattern; } formats[] = {
+        { N_("Plain text"),          "*.txt"  },
+        { N_("HTML"),                "*.html" },
+        { N_("Text with colors (ANSI)"), "*.ansi" },
+    };
+
+    for (guint i = 0; i < G_N_ELEMENTS (formats); ++i)
+    {
+        g_autoptr (GtkFileFilter) filter = gtk_file_filter_new ();
+
+        gtk_file_filter_set_name (filter, _(formats[i].name));
+        gtk_file_filter_add_pattern (filter, formats[i].pattern);
+        g_list_store_append (filters, filter);
+    }
+
+    return G_LIST_MODEL (filters);
+}
+
+/* The format follows the extension: .html, .ansi or plain text */
+static void
+action_save_scrollback (GSimpleAction *action G_GNUC_UNUSED,
+                        GVariant      *param G_GNUC_UNUSED,
+                        gpointer       user_data)
+{
+    GerminalWindow *self = GERMINAL_WINDOW (user_data);
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+
+    if (!priv->terminal || priv->export_cancellable)
+        return;
+
+    g_autoptr (GtkFileDialog) dialog = gtk_file_dialog_new ();
+    g_autoptr (GListModel) filters = export_filters ();
+
+    gtk_file_dialog_set_title (dialog, _("Save Scrollback"));
+    gtk_file_dialog_set_initial_name (dialog, "scrollback.txt");
+    gtk_file_dialog_set_filters (dialog, filters);
+    gtk_file_dialog_save (dialog, GTK_WINDOW (self), NULL, on_export_file_chosen, g_object_ref (self));
+}
+
+static void
+on_paste_cancel_clicked (GtkButton *button G_GNUC_UNUSED,
+                         gpointer   user_data)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
+
+    if (priv->terminal)
+        germinal_terminal_cancel_paste (priv->terminal);
+}
+
+/* Only built for the first big paste */
+static void
+germinal_window_ensure_paste_bar (GerminalWindow *self)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+
+    if (priv->paste_bar)
+        return;
+
+    priv->paste_bar = germinal_window_add_progress_bar (self, &priv->paste_label, &priv->paste_progress, &priv->paste_cancel_button,
+                                                        G_CALLBACK (on_paste_cancel_clicked));
+    gtk_widget_add_css_class (priv->paste_label, "numeric");
+}
+
+/* Shows how far the current terminal's paste got, if it has one going */
+static void
+update_paste_bar (GerminalWindow *self)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+    gsize done = 0, total = 0;
+
+    if (priv->terminal && germinal_terminal_get_paste_progress (priv->terminal, &done, &total))
+    {
+        germinal_window_ensure_paste_bar (self);
+        g_clear_handle_id (&priv->paste_report_id, g_source_remove);
+
+        g_autofree gchar *done_size = g_format_size (done);
+        g_autofree gchar *total_size = g_format_size (total);
+        /* Translators: how much of the clipboard was pasted so far, then its size */
+        g_autofree gchar *label = g_strdup_printf (_("Pasting %s of %s…"), done_size, total_size);
+
+        gtk_label_set_label (GTK_LABEL (priv->paste_label), label);
+        gtk_progress_bar_set_fraction (GTK_PROGRESS_BAR (priv->paste_progress), total ? (gdouble) done / total : 0.0);
+        gtk_widget_set_visible (priv->paste_cancel_button, TRUE);
+        gtk_revealer_set_reveal_child (GTK_REVEALER (priv->paste_bar), TRUE);
+        return;
+    }
+
+    if (priv->paste_bar && !priv->paste_report_id)
+        gtk_revealer_set_reveal_child (GTK_REVEALER (priv->paste_bar), FALSE);
+}
+
+static gboolean
+hide_paste_report (gpointer user_data)
+{
+    GerminalWindow *self = GERMINAL_WINDOW (user_data);
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+
+    priv->paste_report_id = 0;
+    update_paste_bar (self);
+
+    return G_SOURCE_REMOVE;
 }
 
 static void
-action_zoom_out (GSimpleAction *action G_GNUC_UNUSED,
-                 GVariant      *param G_GNUC_UNUSED,
-                 gpointer       user_data)
+on_terminal_paste_progress (GerminalTerminal *terminal G_GNUC_UNUSED,
+                            gpointer          user_data)
 {
-    GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
-    germinal_terminal_zoom_out (priv->terminal);
+    update_paste_bar (GERMINAL_WINDOW (user_data));
 }
 
+/* Leaves the throughput on screen for a bit once everything went through */
 static void
-action_reset_zoom (GSimpleAction *action G_GNUC_UNUSED,
-                   GVariant      *param G_GNUC_UNUSED,
-                   gpointer       user_data)
+on_terminal_paste_finished (GerminalTerminal *terminal G_GNUC_UNUSED,
+                            gdouble           throughput,
+                            gpointer          user_data)
 {
-    GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
-    germinal_terminal_reset_zoom (priv->terminal);
+    GerminalWindow *self = GERMINAL_WINDOW (user_data);
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+
+    if (throughput < 0 || !priv->paste_bar)
+    {
+        update_paste_bar (self);
+        return;
+    }
+
+    g_autofree gchar *rate = g_format_size ((guint64) throughput);
+    /* Translators: the throughput of the paste, like "12.3 MB" */
+    g_autofree gchar *label = g_strdup_printf (_("Pasted at %s/s"), rate);
+
+    gtk_label_set_label (GTK_LABEL (priv->paste_label), label);
+    gtk_progress_bar_set_fraction (GTK_PROGRESS_BAR (priv->paste_progress), 1.0);
+    gtk_widget_set_visible (priv->paste_cancel_button, FALSE);
+    gtk_revealer_set_reveal_child (GTK_REVEALER (priv->paste_bar), TRUE);
+
+    g_clear_handle_id (&priv->paste_report_id, g_source_remove);
+    priv->paste_report_id = g_timeout_add_seconds (PASTE_REPORT_SECONDS, hide_paste_report, self);
+    g_source_set_name_by_id (priv->paste_report_id, "[germinal] paste report");
 }
 
 static void
@@ -227,7 +1126,14 @@ action_preferences (GSimpleAction *action G_GNUC_UNUSED,
                     GVariant      *param G_GNUC_UNUSED,
                     gpointer       user_data)
 {
-    adw_dialog_present (germinal_preferences_new (), GTK_WIDGET (user_data));
+    germinal_preferences_present (GTK_WIDGET (user_data));
+}
+
+static void
+on_preferences_clicked (GtkButton *button G_GNUC_UNUSED,
+                        gpointer   user_data)
+{
+    germinal_preferences_present (GTK_WIDGET (user_data));
 }
 
 static void
@@ -244,17 +1150,111 @@ update_search_state (GerminalWindow *self)
     GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
     const gchar *text = gtk_editable_get_text (GTK_EDITABLE (priv->search_entry));
 
+    if (!priv->terminal)
+        return;
+
     if (text && *text)
-        germinal_terminal_search (priv->terminal, text);
+        germinal_terminal_search (priv->terminal, text, gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (priv->search_regex_button)));
     else
         germinal_terminal_search_stop (priv->terminal);
 }
 
+/* "n of m", once the terminal is done counting */
+static void
+update_search_matches (GerminalWindow *self)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+    guint current = 0, total = 0;
+
+    if (!priv->search_matches_label)
+        return;
+
+    if (!priv->terminal || !germinal_terminal_get_search_matches (priv->terminal, &current, &total))
+    {
+        gtk_label_set_label (GTK_LABEL (priv->search_matches_label), NULL);
+        return;
+    }
+
+    if (!total)
+    {
+        gtk_label_set_label (GTK_LABEL (priv->search_matches_label), _("No matches"));
+        return;
+    }
+
+    /* Translators: the current search match, then how many there are */
+    g_autofree gchar *label = g_strdup_printf (_("%u of %u"), current, total);
+
+    gtk_label_set_label (GTK_LABEL (priv->search_matches_label), label);
+}
+
+static void
+on_terminal_search_changed (GerminalTerminal *terminal G_GNUC_UNUSED,
+                            gpointer          user_data)
+{
+    update_search_matches (GERMINAL_WINDOW (user_data));
+}
+
+static void on_search_changed (GtkSearchEntry *entry, gpointer user_data);
+static void on_search_entry_next_match (GtkSearchEntry *entry, gpointer user_data);
+static void on_search_entry_prev_match (GtkSearchEntry *entry, gpointer user_data);
+static void on_stop_search (GtkSearchEntry *entry, gpointer user_data);
+
+static void
+on_search_regex_toggled (GtkToggleButton *button G_GNUC_UNUSED,
+                         gpointer         user_data)
+{
+    update_search_state (GERMINAL_WINDOW (user_data));
+}
+
+/* Most windows never search, only build the search bar when first needed */
+static void
+germinal_window_ensure_search_bar (GerminalWindow *self)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+
+    if (priv->search_bar)
+        return;
+
+    GtkWidget *search_entry = priv->search_entry = gtk_search_entry_new ();
+    gtk_widget_set_hexpand (search_entry, TRUE);
+    /* The terminal knows how large its scrollback is, it debounces */
+    gtk_search_entry_set_search_delay (GTK_SEARCH_ENTRY (search_entry), 0);
+
+    GtkWidget *search_regex_button = priv->search_regex_button = gtk_toggle_button_new_with_label (".*");
+    gtk_widget_set_tooltip_text (search_regex_button, _("Regular expression"));
+    gtk_widget_add_css_class (search_regex_button, "flat");
+    g_signal_connect_object (search_regex_button, "toggled", G_CALLBACK (on_search_regex_toggled), self, 0);
+
+    GtkWidget *search_matches_label = priv->search_matches_label = gtk_label_new (NULL);
+    gtk_widget_add_css_class (search_matches_label, "dim-label");
+    gtk_widget_add_css_class (search_matches_label, "numeric");
+
+    GtkWidget *search_box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 6);
+    gtk_box_append (GTK_BOX (search_box), search_entry);
+    gtk_box_append (GTK_BOX (search_box), search_matches_label);
+    gtk_box_append (GTK_BOX (search_box), search_regex_button);
+
+    GtkWidget *search_bar = priv->search_bar = gtk_revealer_new ();
+    gtk_revealer_set_transition_type (GTK_REVEALER (search_bar), GTK_REVEALER_TRANSITION_TYPE_SLIDE_DOWN);
+    gtk_revealer_set_child (GTK_REVEALER (search_bar), search_box);
+
+    priv->search_entry_signals = g_signal_group_new (GTK_TYPE_SEARCH_ENTRY);
+    g_signal_group_connect (priv->search_entry_signals, "search-changed", G_CALLBACK (on_search_changed),         self);
+    g_signal_group_connect (priv->search_entry_signals, "activate",       G_CALLBACK (on_search_entry_next_match), self);
+    g_signal_group_connect (priv->search_entry_signals, "next-match",     G_CALLBACK (on_search_entry_next_match), self);
+    g_signal_group_connect (priv->search_entry_signals, "previous-match", G_CALLBACK (on_search_entry_prev_match), self);
+    g_signal_group_connect (priv->search_entry_signals, "stop-search",    G_CALLBACK (on_stop_search),             self);
+    g_signal_group_set_target (priv->search_entry_signals, search_entry);
+
+    gtk_box_insert_child_after (GTK_BOX (gtk_widget_get_parent (priv->header_bar)), search_bar, priv->header_bar);
+}
+
 static void
 show_search (GerminalWindow *self)
 {
     GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
 
+    germinal_window_ensure_search_bar (self);
     gtk_revealer_set_reveal_child (GTK_REVEALER (priv->search_bar), TRUE);
     gtk_widget_grab_focus (priv->search_entry);
     update_search_state (self);
@@ -265,9 +1265,16 @@ hide_search (GerminalWindow *self)
 {
     GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
 
+    if (!priv->search_bar)
+        return;
+
     gtk_revealer_set_reveal_child (GTK_REVEALER (priv->search_bar), FALSE);
-    germinal_terminal_search_stop (priv->terminal);
-    gtk_widget_grab_focus (GTK_WIDGET (priv->terminal));
+
+    if (priv->terminal)
+    {
+        germinal_terminal_search_stop (priv->terminal);
+        gtk_widget_grab_focus (GTK_WIDGET (priv->terminal));
+    }
 }
 
 static void
@@ -292,7 +1299,8 @@ on_search_entry_next_match (GtkSearchEntry *entry G_GNUC_UNUSED,
                             gpointer        user_data)
 {
     GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
-    germinal_terminal_search_next (priv->terminal);
+    if (priv->terminal)
+        germinal_terminal_search_next (priv->terminal);
 }
 
 static void
@@ -300,7 +1308,8 @@ on_search_entry_prev_match (GtkSearchEntry *entry G_GNUC_UNUSED,
                             gpointer        user_data)
 {
     GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (user_data));
-    germinal_terminal_search_prev (priv->terminal);
+    if (priv->terminal)
+        germinal_terminal_search_prev (priv->terminal);
 }
 
 static void
@@ -322,6 +1331,12 @@ on_window_key_pressed (GtkEventControllerKey *controller G_GNUC_UNUSED,
     GerminalWindow *self = GERMINAL_WINDOW (user_data);
     GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
 
+    if ((state & GDK_CONTROL_MASK) && keyval == GDK_KEY_F)
+    {
+        germinal_global_search_present (GTK_WIDGET (self));
+        return GDK_EVENT_STOP;
+    }
+
     if ((state & GDK_CONTROL_MASK) && keyval == GDK_KEY_f)
     {
         if (!gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (priv->search_button)))
@@ -331,9 +1346,92 @@ on_window_key_pressed (GtkEventControllerKey *controller G_GNUC_UNUSED,
         return GDK_EVENT_STOP;
     }
 
+    if (priv->tab_view && (state & GDK_CONTROL_MASK) && germinal_window_handle_tab_key (self, keyval))
+        return GDK_EVENT_STOP;
+
     return GDK_EVENT_PROPAGATE;
 }
 
+/* Same for every window, the url entries only show up when their actions are enabled */
+static GMenuModel *
+germinal_window_get_menu_model (void)
+{
+    static GMenu *menu;
+
+    if (menu)
+        return G_MENU_MODEL (menu);
+
+    menu = g_menu_new ();
+
+    g_autoptr (GMenu) url_section = g_menu_new ();
+    g_autoptr (GMenuItem) copy_url = g_menu_item_new (_("Copy url"), "ctx.copy-url");
+    g_autoptr (GMenuItem) open_url = g_menu_item_new (_("Open url"), "ctx.open-url");
+    g_menu_item_set_attribute (copy_url, "hidden-when", "s", "action-disabled");
+    g_menu_item_set_attribute (open_url, "hidden-when", "s", "action-disabled");
+    g_menu_append_item (url_section, copy_url);
+    g_menu_append_item (url_section, open_url);
+    g_menu_append_section (menu, NULL, G_MENU_MODEL (url_section));
+
+    g_autoptr (GMenu) clipboard_section = g_menu_new ();
+    g_menu_append (clipboard_section, _("Copy"),         "ctx.copy");
+    g_menu_append (clipboard_section, _("Copy as HTML"), "ctx.copy-html");
+    g_menu_append (clipboard_section, _("Paste"),        "ctx.paste");
+    g_menu_append_section (menu, NULL, G_MENU_MODEL (clipboard_section));
+
+    g_autoptr (GMenu) export_section = g_menu_new ();
+    g_menu_append (export_section, _("Save scrollback…"), "ctx.save-scrollback");
+    g_menu_append_section (menu, NULL, G_MENU_MODEL (export_section));
+
+    g_autoptr (GMenu) zoom_section = g_menu_new ();
+    g_menu_append (zoom_section, _("Zoom in"),    "ctx.zoom-in");
+    g_menu_append (zoom_section, _("Zoom out"),   "ctx.zoom-out");
+    g_menu_append (zoom_section, _("Reset zoom"), "ctx.reset-zoom");
+    g_menu_append_section (menu, NULL, G_MENU_MODEL (zoom_section));
+
+    g_autoptr (GMenu) prefs_section = g_menu_new ();
+    g_menu_append (prefs_section, _("Preferences"), "ctx.preferences");
+    g_menu_append_section (menu, NULL, G_MENU_MODEL (prefs_section));
+
+    g_autoptr (GMenu) quit_section = g_menu_new ();
+    g_menu_append (quit_section, _("Quit"), "ctx.quit");
+    g_menu_append_section (menu, NULL, G_MENU_MODEL (quit_section));
+
+    return G_MENU_MODEL (menu);
+}
+
+/* The context menu and its actions are only built on the first right click */
+static void
+germinal_window_ensure_popover (GerminalWindow *self)
+{
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+
+    if (priv->popover)
+        return;
+
+    static const GActionEntry ctx_actions[] = {
+        { .name = "copy-url",    .activate = action_copy_url    },
+        { .name = "open-url",    .activate = action_open_url    },
+        { .name = "copy",        .activate = action_copy        },
+        { .name = "copy-html",   .activate = action_copy_html   },
+        { .name = "paste",       .activate = action_paste       },
+        { .name = "save-scrollback", .activate = action_save_scrollback },
+        { .name = "zoom-in",     .activate = action_zoom_in     },
+        { .name = "zoom-out",    .activate = action_zoom_out    },
+        { .name = "reset-zoom",  .activate = action_reset_zoom  },
+        { .name = "preferences", .activate = action_preferences },
+        { .name = "quit",        .activate = action_quit        },
+    };
+
+    priv->actions = G_ACTION_MAP (g_simple_action_group_new ());
+    g_action_map_add_action_entries (priv->actions, ctx_actions, G_N_ELEMENTS (ctx_actions), self);
+    gtk_widget_insert_action_group (GTK_WIDGET (self), "ctx", G_ACTION_GROUP (priv->actions));
+
+    priv->popover = gtk_popover_menu_new_from_model (germinal_window_get_menu_model ());
+    gtk_popover_set_has_arrow (GTK_POPOVER (priv->popover), FALSE);
+    gtk_widget_set_parent (priv->popover, priv->content);
+    g_signal_connect_object (priv->popover, "closed", G_CALLBACK (on_popover_closed), self, 0);
+}
+
 static void
 germinal_window_set_property (GObject      *object,
                               guint         prop_id,
@@ -347,6 +1445,12 @@ germinal_window_set_property (GObject      *object,
     case PROP_TERMINAL:
         priv->terminal = g_value_dup_object (value);
         break;
+    case PROP_TMUX_VIEW:
+        priv->tmux_view = g_value_dup_object (value);
+        break;
+    case PROP_TABS:
+        priv->tabs = g_value_get_boolean (value);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
     }
@@ -357,24 +1461,15 @@ germinal_window_constructed (GObject *object)
 {
     GerminalWindow *self = GERMINAL_WINDOW (object);
     GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
-    GtkWidget *terminal = GTK_WIDGET (priv->terminal);
 
     G_OBJECT_CLASS (germinal_window_parent_class)->constructed (object);
 
-    GtkWidget *search_entry = priv->search_entry = gtk_search_entry_new ();
-    gtk_widget_set_hexpand (search_entry, TRUE);
-
-    GtkWidget *search_bar = priv->search_bar = gtk_revealer_new ();
-    gtk_revealer_set_transition_type (GTK_REVEALER (search_bar), GTK_REVEALER_TRANSITION_TYPE_SLIDE_DOWN);
-    gtk_revealer_set_child (GTK_REVEALER (search_bar), search_entry);
+    if (priv->tabs)
+        priv->tab_view = ADW_TAB_VIEW (adw_tab_view_new ());
 
-    priv->search_entry_signals = g_signal_group_new (GTK_TYPE_SEARCH_ENTRY);
-    g_signal_group_connect (priv->search_entry_signals, "search-changed", G_CALLBACK (on_search_changed),         self);
-    g_signal_group_connect (priv->search_entry_signals, "activate",       G_CALLBACK (on_search_entry_next_match), self);
-    g_signal_group_connect (priv->search_entry_signals, "next-match",     G_CALLBACK (on_search_entry_next_match), self);
-    g_signal_group_connect (priv->search_entry_signals, "previous-match", G_CALLBACK (on_search_entry_prev_match), self);
-    g_signal_group_connect (priv->search_entry_signals, "stop-search",    G_CALLBACK (on_stop_search),             self);
-    g_signal_group_set_target (priv->search_entry_signals, search_entry);
+    GtkWidget *content = priv->content = priv->tab_view  ? GTK_WIDGET (priv->tab_view)  :
+                                         priv->tmux_view ? GTK_WIDGET (priv->tmux_view) :
+                                                           GTK_WIDGET (priv->terminal);
 
     GtkEventController *window_key_ctrl = gtk_event_controller_key_new ();
     gtk_event_controller_set_propagation_phase (window_key_ctrl, GTK_PHASE_CAPTURE);
@@ -393,77 +1488,42 @@ germinal_window_constructed (GObject *object)
     GtkWidget *prefs_button = gtk_button_new_from_icon_name ("preferences-system-symbolic");
     gtk_widget_set_tooltip_text (prefs_button, _("Preferences"));
     gtk_widget_add_css_class (prefs_button, "flat");
-    gtk_actionable_set_action_name (GTK_ACTIONABLE (prefs_button), "ctx.preferences");
+    g_signal_connect_object (prefs_button, "clicked", G_CALLBACK (on_preferences_clicked), self, 0);
     adw_header_bar_pack_end (ADW_HEADER_BAR (header_bar), prefs_button);
 
     GtkWidget *box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
     gtk_box_append (GTK_BOX (box), header_bar);
-    gtk_box_append (GTK_BOX (box), search_bar);
-    gtk_box_append (GTK_BOX (box), terminal);
-    gtk_widget_set_vexpand (terminal, TRUE);
+    if (priv->tab_view)
+    {
+        GtkWidget *tab_bar = adw_tab_bar_new ();
+        adw_tab_bar_set_view (ADW_TAB_BAR (tab_bar), priv->tab_view);
+        gtk_box_append (GTK_BOX (box), tab_bar);
+    }
+    gtk_box_append (GTK_BOX (box), content);
+    gtk_widget_set_vexpand (content, TRUE);
 
     adw_application_window_set_content (ADW_APPLICATION_WINDOW (self), box);
-    gtk_widget_grab_focus (terminal);
+    gtk_widget_grab_focus (content);
 
     update_decorated (priv->settings, DECORATED_KEY, self);
 
-    static const GActionEntry ctx_actions[] = {
-        { .name = "copy-url",    .activate = action_copy_url    },
-        { .name = "open-url",    .activate = action_open_url    },
-        { .name = "copy",        .activate = action_copy        },
-        { .name = "copy-html",   .activate = action_copy_html   },
-        { .name = "paste",       .activate = action_paste       },
-        { .name = "zoom-in",     .activate = action_zoom_in     },
-        { .name = "zoom-out",    .activate = action_zoom_out    },
-        { .name = "reset-zoom",  .activate = action_reset_zoom  },
-        { .name = "preferences", .activate = action_preferences },
-        { .name = "quit",        .activate = action_quit        },
-    };
-
-    g_autoptr (GSimpleActionGroup) ag = g_simple_action_group_new ();
-    g_action_map_add_action_entries (G_ACTION_MAP (ag), ctx_actions, G_N_ELEMENTS (ctx_actions), self);
-    gtk_widget_insert_action_group (GTK_WIDGET (self), "ctx", G_ACTION_GROUP (ag));
-
-    priv->url_section = g_menu_new ();
-
-    g_autoptr (GMenu) menu = g_menu_new ();
-    g_menu_append_section (menu, NULL, G_MENU_MODEL (priv->url_section));
-
-    g_autoptr (GMenu) clipboard_section = g_menu_new ();
-    g_menu_append (clipboard_section, _("Copy"),         "ctx.copy");
-    g_menu_append (clipboard_section, _("Copy as HTML"), "ctx.copy-html");
-    g_menu_append (clipboard_section, _("Paste"),        "ctx.paste");
-    g_menu_append_section (menu, NULL, G_MENU_MODEL (clipboard_section));
-
-    g_autoptr (GMenu) zoom_section = g_menu_new ();
-    g_menu_append (zoom_section, _("Zoom in"),    "ctx.zoom-in");
-    g_menu_append (zoom_section, _("Zoom out"),   "ctx.zoom-out");
-    g_menu_append (zoom_section, _("Reset zoom"), "ctx.reset-zoom");
-    g_menu_append_section (menu, NULL, G_MENU_MODEL (zoom_section));
-
-    g_autoptr (GMenu) prefs_section = g_menu_new ();
-    g_menu_append (prefs_section, _("Preferences"), "ctx.preferences");
-    g_menu_append_section (menu, NULL, G_MENU_MODEL (prefs_section));
-
-    g_autoptr (GMenu) quit_section = g_menu_new ();
-    g_menu_append (quit_section, _("Quit"), "ctx.quit");
-    g_menu_append_section (menu, NULL, G_MENU_MODEL (quit_section));
-
-    priv->popover = gtk_popover_menu_new_from_model (G_MENU_MODEL (menu));
-    gtk_popover_set_has_arrow (GTK_POPOVER (priv->popover), FALSE);
-    gtk_widget_set_parent (priv->popover, terminal);
-
-    GtkGesture *gesture = gtk_gesture_click_new ();
-    gtk_gesture_single_set_button (GTK_GESTURE_SINGLE (gesture), 0);
-    g_signal_connect (gesture, "pressed", G_CALLBACK (on_click_pressed), self);
-    gtk_widget_add_controller (terminal, GTK_EVENT_CONTROLLER (gesture));
-
-    priv->terminal_signals = g_signal_group_new (VTE_TYPE_TERMINAL);
-    g_signal_group_connect (priv->terminal_signals, "child-exited",                                G_CALLBACK (on_child_exited),         self);
-    g_signal_group_connect (priv->terminal_signals, "termprop-changed::" VTE_TERMPROP_XTERM_TITLE, G_CALLBACK (on_window_title_changed), self);
-    g_signal_group_set_target (priv->terminal_signals, priv->terminal);
-
-    on_window_title_changed (VTE_TERMINAL (terminal), NULL, self);
+    if (priv->tmux_view)
+    {
+        g_signal_connect (priv->tmux_view, "terminal-added",         G_CALLBACK (on_terminal_added),          self);
+        g_signal_connect (priv->tmux_view, "notify::active-terminal", G_CALLBACK (on_active_terminal_changed), self);
+        g_signal_connect (priv->tmux_view, "exited",                 G_CALLBACK (on_tmux_exited),             self);
+    }
+    else if (priv->tab_view)
+    {
+        g_signal_connect (priv->tab_view, "notify::selected-page", G_CALLBACK (on_selected_page_changed), self);
+        g_signal_connect (priv->tab_view, "notify::n-pages",       G_CALLBACK (on_n_pages_changed),       self);
+    }
+    else
+    {
+        germinal_window_add_terminal (self, priv->terminal);
+        g_signal_group_set_target (priv->terminal_signals, priv->terminal);
+        on_window_title_changed (VTE_TERMINAL (priv->terminal), NULL, self);
+    }
 }
 
 static void
@@ -471,18 +1531,35 @@ germinal_window_dispose (GObject *object)
 {
     GerminalWindowPrivate *priv = germinal_window_get_instance_private (GERMINAL_WINDOW (object));
 
-    g_clear_handle_id (&priv->spawn_source_id, g_source_remove);
+    if (priv->tab_view)
+        g_signal_handlers_disconnect_by_data (priv->tab_view, object);
+    priv->tab_view = NULL;
+    priv->content = NULL;
     g_clear_pointer (&priv->popover, gtk_widget_unparent);
-    g_clear_object (&priv->url_section);
+    g_clear_object (&priv->actions);
+    /* The export still has to come back, to a window with no bar left */
+    g_cancellable_cancel (priv->export_cancellable);
+    priv->export_bar = priv->export_progress = NULL;
+    g_clear_handle_id (&priv->paste_report_id, g_source_remove);
     g_clear_object (&priv->search_entry_signals);
     g_clear_object (&priv->settings_signals);
     g_clear_object (&priv->settings);
     g_clear_object (&priv->terminal_signals);
     g_clear_object (&priv->terminal);
+    g_clear_object (&priv->tmux_view);
+    g_clear_pointer (&priv->pending_command, g_strfreev);
 
     G_OBJECT_CLASS (germinal_window_parent_class)->dispose (object);
 }
 
+static void
+germinal_window_map (GtkWidget *widget)
+{
+    GTK_WIDGET_CLASS (germinal_window_parent_class)->map (widget);
+
+    germinal_timings_mark (GERMINAL_TIMING_WINDOW_MAPPED);
+}
+
 static void
 germinal_window_init (GerminalWindow *self)
 {
@@ -493,21 +1570,51 @@ germinal_window_init (GerminalWindow *self)
     priv->settings_signals = g_signal_group_new (G_TYPE_SETTINGS);
     g_signal_group_connect (priv->settings_signals, "changed::" DECORATED_KEY, G_CALLBACK (update_decorated), self);
     g_signal_group_set_target (priv->settings_signals, settings);
+
+    priv->terminal_signals = g_signal_group_new (GERMINAL_TYPE_TERMINAL);
+    g_signal_group_connect (priv->terminal_signals, "child-exited",                                G_CALLBACK (on_child_exited),            self);
+    g_signal_group_connect (priv->terminal_signals, "termprop-changed::" VTE_TERMPROP_XTERM_TITLE, G_CALLBACK (on_window_title_changed),    self);
+    g_signal_group_connect (priv->terminal_signals, "search-changed",                              G_CALLBACK (on_terminal_search_changed), self);
+    g_signal_group_connect (priv->terminal_signals, "paste-progress",                              G_CALLBACK (on_terminal_paste_progress), self);
+    g_signal_group_connect (priv->terminal_signals, "paste-finished",                              G_CALLBACK (on_terminal_paste_finished), self);
 }
 
 static void
 germinal_window_class_init (GerminalWindowClass *klass)
 {
     GObjectClass *object_class = G_OBJECT_CLASS (klass);
+    GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
 
     object_class->constructed  = germinal_window_constructed;
     object_class->dispose      = germinal_window_dispose;
     object_class->set_property = germinal_window_set_property;
 
+    widget_class->map = germinal_window_map;
+
     g_object_class_install_property (object_class, PROP_TERMINAL,
         g_param_spec_object ("terminal", NULL, NULL,
                              GERMINAL_TYPE_TERMINAL,
                              G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS));
+
+    g_object_class_install_property (object_class, PROP_TMUX_VIEW,
+        g_param_spec_object ("tmux-view", NULL, NULL,
+                             GERMINAL_TYPE_TMUX_VIEW,
+                             G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS));
+
+    g_object_class_install_property (object_class, PROP_TABS,
+        g_param_spec_boolean ("tabs", NULL, NULL,
+                              FALSE,
+                              G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS));
+}
+
+GerminalTerminal *
+germinal_window_get_terminal (GerminalWindow *self)
+{
+    g_return_val_if_fail (GERMINAL_IS_WINDOW (self), NULL);
+
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+
+    return priv->terminal;
 }
 
 void
@@ -519,11 +1626,38 @@ germinal_window_present (GerminalWindow *self)
     gtk_window_present (GTK_WINDOW (self));
 }
 
+/* Show and focus terminal, whichever tab or zoomed pane it is in */
+void
+germinal_window_reveal_terminal (GerminalWindow   *self,
+                                 GerminalTerminal *terminal)
+{
+    g_return_if_fail (GERMINAL_IS_WINDOW (self));
+    g_return_if_fail (GERMINAL_IS_TERMINAL (terminal));
+
+    GerminalWindowPrivate *priv = germinal_window_get_instance_private (self);
+
+    if (priv->tab_view)
+    {
+        GtkWidget *slot = gtk_widget_get_ancestor (GTK_WIDGET (terminal), ADW_TYPE_BIN);
+
+        if (slot)
+        {
+            adw_tab_view_set_selected_page (priv->tab_view, adw_tab_view_get_page (priv->tab_view, slot));
+            if (!gtk_widget_get_visible (GTK_WIDGET (terminal)))
+                unzoom (slot);
+        }
+    }
+
+    germinal_window_set_terminal (self, terminal);
+    gtk_widget_grab_focus (GTK_WIDGET (terminal));
+    germinal_window_present (self);
+}
+
 GtkWidget *
 germinal_window_new (GtkApplication   *application,
                      GerminalTerminal *terminal)
 {
-    g_return_val_if_fail (GTK_IS_APPLICATION (application), NULL);
+    g_return_val_if_fail (!application || GTK_IS_APPLICATION (application), NULL);
     g_return_val_if_fail (GERMINAL_IS_TERMINAL (terminal), NULL);
 
     return g_object_new (GERMINAL_TYPE_WINDOW,
@@ -531,3 +1665,27 @@ germinal_window_new (GtkApplication   *application,
                          "terminal",    terminal,
                          NULL);
 }
+
+GtkWidget *
+germinal_window_new_for_tmux (GtkApplication   *application,
+                              GerminalTmuxView *view)
+{
+    g_return_val_if_fail (GTK_IS_APPLICATION (application), NULL);
+    g_return_val_if_fail (GERMINAL_IS_TMUX_VIEW (view), NULL);
+
+    return g_object_new (GERMINAL_TYPE_WINDOW,
+                         "application", application,
+                         "tmux-view",   view,
+                         NULL);
+}
+
+GtkWidget *
+germinal_window_new_with_tabs (GtkApplication *application)
+{
+    g_return_val_if_fail (GTK_IS_APPLICATION (application), NULL);
+
+    return g_object_new (GERMINAL_TYPE_WINDOW,
+                         "application", application,
+                         "tabs",        TRUE,
+                         NULL);
+}
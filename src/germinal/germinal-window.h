@@ -4,6 +4,7 @@
 #pragma once
 
 #include "germinal-terminal.h"
+#include "germinal-tmux-view.h"
 
 #include <adwaita.h>
 
@@ -13,7 +14,12 @@ G_BEGIN_DECLS
 G_DECLARE_FINAL_TYPE (GerminalWindow, germinal_window, GERMINAL, WINDOW, AdwApplicationWindow)
 
 GtkWidget *germinal_window_new           (GtkApplication *application, GerminalTerminal *terminal);
+GtkWidget *germinal_window_new_for_tmux  (GtkApplication *application, GerminalTmuxView *view);
+GtkWidget *germinal_window_new_with_tabs (GtkApplication *application);
 void       germinal_window_present       (GerminalWindow *self);
+GerminalTerminal *germinal_window_get_terminal (GerminalWindow *self);
 void       germinal_window_spawn_command (GerminalWindow *self, GStrv command);
+void       germinal_window_open_tab      (GerminalWindow *self, GStrv command, gboolean select);
+void       germinal_window_reveal_terminal (GerminalWindow *self, GerminalTerminal *terminal);
 
 G_END_DECLS
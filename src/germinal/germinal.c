@@ -1,26 +1,409 @@
 // SPDX-FileCopyrightText: 2011-2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include "germinal-settings.h"
+#include "germinal-spawner.h"
+#include "germinal-timings.h"
 #include "germinal-window.h"
 
 #include <stdlib.h>
 
+#define SESSION_INDEX_KEY "germinal-tmux-session-index"
+
+/* Hidden windows, built and with their command running, waiting to be presented */
+static GQueue     spare_windows = G_QUEUE_INIT;
+static guint      refill_source_id;
+static gboolean   more_windows_wanted;
+static GSettings *app_settings;
+
+static gboolean
+germinal_window_list_uses_index (GList *windows,
+                                 guint  index)
+{
+    for (GList *w = windows; w; w = w->next)
+    {
+        /* Stored off by one on windows so that NULL means none */
+        if (GPOINTER_TO_UINT (g_object_get_data (w->data, SESSION_INDEX_KEY)) == index + 1)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/* Smallest index no open or spare window uses */
+static guint
+germinal_get_session_index (GtkApplication *application)
+{
+    guint index = 0;
+
+    while (germinal_window_list_uses_index (gtk_application_get_windows (application), index) ||
+           germinal_window_list_uses_index (spare_windows.head, index))
+    {
+        ++index;
+    }
+
+    return index;
+}
+
+static GStrv
+germinal_get_startup_command (GApplication *application,
+                              GSettings    *settings,
+                              guint        *index,
+                              gchar       **session,
+                              GStrv        *globals)
+{
+    g_autofree gchar *setting = g_settings_get_string (settings, STARTUP_COMMAND_KEY);
+    g_autofree gchar *strategy = g_settings_get_string (settings, TMUX_SESSIONS_KEY);
+    GerminalTmuxSessions sessions = GERMINAL_TMUX_SESSIONS_SHARED;
+    g_auto (GStrv) command = NULL;
+
+    if (!g_shell_parse_argv (setting, NULL, &command, NULL))
+        return NULL;
+
+    if (!g_strcmp0 (strategy, "grouped"))
+        sessions = GERMINAL_TMUX_SESSIONS_GROUPED;
+    else if (!g_strcmp0 (strategy, "per-window"))
+        sessions = GERMINAL_TMUX_SESSIONS_PER_WINDOW;
+
+    *index = germinal_get_session_index (GTK_APPLICATION (application));
+
+    GStrv argv = germinal_tmux_session_argv ((const gchar * const *) command, sessions, *index, session, globals);
+
+    return argv ? argv : g_steal_pointer (&command);
+}
+
+static GerminalWindow *
+germinal_create_tmux_window (GApplication *application,
+                             GStrv         command)
+{
+    GStrv argv = NULL;
+
+    if (!command || !(argv = germinal_tmux_control_argv ((const gchar * const *) command)))
+    {
+        g_warning ("%s", _("The startup command doesn't run tmux, not using tmux control mode"));
+        return NULL;
+    }
+
+    GerminalTmuxView *view = GERMINAL_TMUX_VIEW (germinal_tmux_view_new ());
+    GerminalWindow *window = GERMINAL_WINDOW (germinal_window_new_for_tmux (GTK_APPLICATION (application), view));
+
+    germinal_window_present (window);
+    germinal_window_spawn_command (window, argv);
+
+    return window;
+}
+
 static void
-germinal_create_window (GApplication *application,
-                        GStrv         command)
+germinal_create_tabbed_window (GApplication *application,
+                               GStrv         command,
+                               gint          n_tabs)
 {
-    GerminalTerminal *terminal = GERMINAL_TERMINAL (germinal_terminal_new ());
-    GerminalWindow *window = GERMINAL_WINDOW (germinal_window_new (GTK_APPLICATION (application), terminal));
+    GerminalWindow *window = GERMINAL_WINDOW (germinal_window_new_with_tabs (GTK_APPLICATION (application)));
 
     germinal_window_present (window);
     germinal_window_spawn_command (window, command);
+
+    /* Only the first tab gets a terminal for now, the others just get their process */
+    for (gint i = 1; i < n_tabs; ++i)
+        germinal_window_open_tab (window, NULL, FALSE);
 }
 
 static void
-germinal_startup (GApplication *application G_GNUC_UNUSED,
-                  gpointer      user_data   G_GNUC_UNUSED)
+on_spare_window_destroyed (GtkWidget *window,
+                           gpointer   user_data G_GNUC_UNUSED)
+{
+    /* Its command exited before we needed it */
+    g_queue_remove (&spare_windows, window);
+}
+
+/* A window with its command already running, but neither shown nor part of the application yet */
+static GerminalWindow *
+germinal_create_hidden_window (GApplication *application)
 {
+    g_autofree gchar *session = NULL;
+    g_auto (GStrv) globals = NULL;
+    guint index = 0;
+    GStrv command = germinal_get_startup_command (application, app_settings, &index, &session, &globals);
+    GerminalTerminal *terminal = GERMINAL_TERMINAL (germinal_terminal_new ());
+
+    germinal_terminal_set_tmux_session (terminal, (const gchar * const *) globals, session);
+
+    GerminalWindow *window = GERMINAL_WINDOW (germinal_window_new (NULL, terminal));
+
+    if (session)
+        g_object_set_data (G_OBJECT (window), SESSION_INDEX_KEY, GUINT_TO_POINTER (index + 1));
+
+    /* Sized for the monitor it will most likely be presented on */
+    germinal_window_spawn_command (window, command);
+
+    return window;
+}
+
+static GerminalWindow *
+germinal_create_spare_window (GApplication *application)
+{
+    /* Not part of the application until presented, or it would keep it alive */
+    GerminalWindow *window = germinal_create_hidden_window (application);
+
+    g_signal_connect (window, "destroy", G_CALLBACK (on_spare_window_destroyed), NULL);
+
+    return window;
+}
+
+/*
+ * Only once a second window was asked for: most sessions never open one.
+ * In a shared tmux session, a spare client would mirror the open window.
+ */
+static gboolean
+germinal_wants_spare_windows (void)
+{
+    g_autofree gchar *multiplexer = g_settings_get_string (app_settings, MULTIPLEXER_KEY);
+    g_autofree gchar *strategy = g_settings_get_string (app_settings, TMUX_SESSIONS_KEY);
+
+    if (!more_windows_wanted || g_strcmp0 (multiplexer, "tmux"))
+        return FALSE;
+
+    return !g_strcmp0 (strategy, "grouped") || !g_strcmp0 (strategy, "per-window");
+}
+
+static gboolean
+germinal_refill_spare_windows (gpointer user_data)
+{
+    GApplication *application = G_APPLICATION (user_data);
+    guint n_spare = (guint) g_settings_get_int (app_settings, SPARE_WINDOWS_KEY);
+
+    /* One window per iteration, so that we don't hold up the frame clock */
+    if (germinal_wants_spare_windows () && spare_windows.length < n_spare)
+    {
+        g_queue_push_tail (&spare_windows, germinal_create_spare_window (application));
+        return G_SOURCE_CONTINUE;
+    }
+
+    refill_source_id = 0;
+    return G_SOURCE_REMOVE;
+}
+
+static void
+germinal_schedule_refill (GApplication *application)
+{
+    if (refill_source_id)
+        return;
+
+    refill_source_id = g_idle_add_full (G_PRIORITY_LOW, germinal_refill_spare_windows, application, NULL);
+    g_source_set_name_by_id (refill_source_id, "[germinal] refill-spare-windows");
+}
+
+static void
+germinal_drop_spare_windows (void)
+{
+    GtkWindow *window;
+
+    while ((window = g_queue_pop_head (&spare_windows)))
+    {
+        g_signal_handlers_disconnect_by_func (window, on_spare_window_destroyed, NULL);
+        gtk_window_destroy (window);
+    }
+}
+
+static void
+on_spare_settings_changed (GSettings   *settings G_GNUC_UNUSED,
+                           const gchar *key      G_GNUC_UNUSED,
+                           gpointer     user_data)
+{
+    /* What the spare windows run is outdated */
+    germinal_drop_spare_windows ();
+    germinal_schedule_refill (G_APPLICATION (user_data));
+}
+
+static GerminalWindow *
+germinal_take_spare_window (GApplication *application)
+{
+    GerminalWindow *window = g_queue_pop_head (&spare_windows);
+
+    if (!window)
+        return NULL;
+
+    g_signal_handlers_disconnect_by_func (window, on_spare_window_destroyed, NULL);
+    gtk_window_set_application (GTK_WINDOW (window), GTK_APPLICATION (application));
+    germinal_window_present (window);
+
+    return window;
+}
+
+/* --- Drop-down window ----------------------------------------------------- */
+
+static GerminalWindow *drop_down;
+static gint64          drop_down_toggled_at;
+
+static void
+on_drop_down_destroyed (GtkWidget *window G_GNUC_UNUSED,
+                        gpointer   user_data G_GNUC_UNUSED)
+{
+    drop_down = NULL;
+}
+
+static void
+on_drop_down_child_exited (VteTerminal *terminal,
+                           gint         status G_GNUC_UNUSED,
+                           gpointer     user_data G_GNUC_UNUSED)
+{
+    /* Closing only hides it, don't keep a dead terminal around */
+    gtk_window_destroy (GTK_WINDOW (gtk_widget_get_root (GTK_WIDGET (terminal))));
+}
+
+static void
+germinal_create_drop_down (GApplication *application)
+{
+    drop_down = germinal_create_hidden_window (application);
+
+    gtk_window_set_application (GTK_WINDOW (drop_down), GTK_APPLICATION (application));
+    gtk_window_set_hide_on_close (GTK_WINDOW (drop_down), TRUE);
+    g_signal_connect (drop_down, "destroy", G_CALLBACK (on_drop_down_destroyed), NULL);
+    g_signal_connect_after (germinal_window_get_terminal (drop_down), "child-exited", G_CALLBACK (on_drop_down_child_exited), NULL);
+
+    /* Have the surface and frame clock ready for the first toggle */
+    gtk_widget_realize (GTK_WIDGET (drop_down));
+}
+
+static void
+on_drop_down_painted (GdkFrameClock *clock,
+                      gpointer       user_data G_GNUC_UNUSED)
+{
+    gint64 elapsed = g_get_monotonic_time () - drop_down_toggled_at;
+    gint64 frame = 0;
+
+    g_signal_handlers_disconnect_by_func (clock, on_drop_down_painted, NULL);
+    gdk_frame_clock_get_refresh_info (clock, 0, &frame, NULL);
+
+    g_debug ("drop-down: first frame painted %.2f ms after the toggle (frame budget %.2f ms)", elapsed / 1000.0, frame / 1000.0);
+    if (frame && elapsed > frame)
+        g_debug ("drop-down: toggle took more than one frame");
+}
+
+static void
+action_toggle_drop_down (GSimpleAction *action G_GNUC_UNUSED,
+                         GVariant      *param  G_GNUC_UNUSED,
+                         gpointer       user_data)
+{
+    drop_down_toggled_at = g_get_monotonic_time ();
+
+    if (!drop_down)
+        germinal_create_drop_down (G_APPLICATION (user_data));
+
+    /* Hiding keeps the window realized, with its terminal and scrollback */
+    if (gtk_widget_get_visible (GTK_WIDGET (drop_down)))
+    {
+        gtk_widget_set_visible (GTK_WIDGET (drop_down), FALSE);
+        g_debug ("drop-down: hidden in %.2f ms", (g_get_monotonic_time () - drop_down_toggled_at) / 1000.0);
+        return;
+    }
+
+    GdkFrameClock *clock = gtk_widget_get_frame_clock (GTK_WIDGET (drop_down));
+
+    if (clock)
+        g_signal_connect (clock, "after-paint", G_CALLBACK (on_drop_down_painted), NULL);
+
+    germinal_window_present (drop_down);
+}
+
+static void
+germinal_create_window (GApplication *application,
+                        GStrv         command,
+                        gint          n_tabs)
+{
+    g_autoptr (GSettings) settings = germinal_settings_new ();
+    g_autofree gchar *multiplexer = g_settings_get_string (settings, MULTIPLEXER_KEY);
+    g_autofree gchar *session = NULL;
+    g_auto (GStrv) globals = NULL;
+    GerminalWindow *window = NULL;
+    guint index = 0;
+
+    if (!g_strcmp0 (multiplexer, "native"))
+    {
+        germinal_create_tabbed_window (application, command, n_tabs);
+        return;
+    }
+
+    /* An explicit command is never a tmux session we could drive */
+    gboolean startup = !command;
+
+    if (gtk_application_get_windows (GTK_APPLICATION (application)))
+        more_windows_wanted = TRUE;
+
+    if (startup && !g_strcmp0 (multiplexer, "tmux") && germinal_take_spare_window (application))
+    {
+        germinal_schedule_refill (application);
+        return;
+    }
+
+    if (startup)
+        command = germinal_get_startup_command (application, settings, &index, &session, &globals);
+
+    if (startup && !g_strcmp0 (multiplexer, "tmux-control"))
+        window = germinal_create_tmux_window (application, command);
+
+    if (!window)
+    {
+        GerminalTerminal *terminal = GERMINAL_TERMINAL (germinal_terminal_new ());
+
+        germinal_terminal_set_tmux_session (terminal, (const gchar * const *) globals, session);
+        window = GERMINAL_WINDOW (germinal_window_new (GTK_APPLICATION (application), terminal));
+        germinal_window_present (window);
+        germinal_window_spawn_command (window, g_steal_pointer (&command));
+    }
+
+    if (session)
+        g_object_set_data (G_OBJECT (window), SESSION_INDEX_KEY, GUINT_TO_POINTER (index + 1));
+
+    g_strfreev (command);
+    /* The first window didn't want it, the settings changed since */
+    germinal_terminal_drop_prespawn ();
+    germinal_schedule_refill (application);
+}
+
+static void
+germinal_startup (GApplication *application,
+                  gpointer      user_data G_GNUC_UNUSED)
+{
+    /* Fork the spawn helper while we are still small */
+    germinal_spawner_get_default ();
     adw_style_manager_set_color_scheme (adw_style_manager_get_default (), ADW_COLOR_SCHEME_PREFER_DARK);
+
+    app_settings = germinal_settings_new ();
+    germinal_timings_mark (GERMINAL_TIMING_SETTINGS_LOADED);
+    g_signal_connect (app_settings, "changed::" MULTIPLEXER_KEY,     G_CALLBACK (on_spare_settings_changed), application);
+    g_signal_connect (app_settings, "changed::" SPARE_WINDOWS_KEY,   G_CALLBACK (on_spare_settings_changed), application);
+    g_signal_connect (app_settings, "changed::" STARTUP_COMMAND_KEY, G_CALLBACK (on_spare_settings_changed), application);
+    g_signal_connect (app_settings, "changed::" TERM_KEY,            G_CALLBACK (on_spare_settings_changed), application);
+    g_signal_connect (app_settings, "changed::" TMUX_SESSIONS_KEY,   G_CALLBACK (on_spare_settings_changed), application);
+
+    static const GActionEntry app_actions[] = {
+        { .name = "toggle-drop-down", .activate = action_toggle_drop_down },
+    };
+
+    g_action_map_add_action_entries (G_ACTION_MAP (application), app_actions, G_N_ELEMENTS (app_actions), application);
+
+    /* Pay for the startup before the first request rather than on it */
+    if (g_application_get_flags (application) & G_APPLICATION_IS_SERVICE)
+    {
+        if (g_settings_get_boolean (app_settings, DROP_DOWN_KEY))
+            germinal_create_drop_down (application);
+        germinal_schedule_refill (application);
+    }
+}
+
+static void
+germinal_shutdown (GApplication *application G_GNUC_UNUSED,
+                   gpointer      user_data   G_GNUC_UNUSED)
+{
+    g_clear_handle_id (&refill_source_id, g_source_remove);
+    germinal_drop_spare_windows ();
+    if (drop_down)
+        gtk_window_destroy (GTK_WINDOW (drop_down));
+    /* Applied writes are asynchronous, make sure they reach dconf before exiting */
+    germinal_settings_flush ();
+    g_settings_sync ();
+    g_clear_object (&app_settings);
 }
 
 static gint
@@ -36,24 +419,100 @@ germinal_command_line (GApplication            *application,
         return 0;
     }
 
+    if (g_variant_dict_contains (dict, "toggle-drop-down"))
+    {
+        g_action_group_activate_action (G_ACTION_GROUP (application), "toggle-drop-down", NULL);
+        return EXIT_SUCCESS;
+    }
+
     g_autoptr (GVariant) v = g_variant_dict_lookup_value (dict, G_OPTION_REMAINING, NULL);
     GStrv command = (v) ? g_variant_dup_strv (v, NULL) : NULL;
+    gint n_tabs = 1;
 
-    germinal_create_window (application, command);
+    g_variant_dict_lookup (dict, "tabs", "i", &n_tabs);
+
+    germinal_create_window (application, command, n_tabs);
     return EXIT_SUCCESS;
 }
 
+static gint
+germinal_handle_local_options (GApplication *application G_GNUC_UNUSED,
+                               GVariantDict *options,
+                               gpointer      user_data   G_GNUC_UNUSED)
+{
+    /* Printed by whichever process ends up being the primary instance, this one if nothing runs yet */
+    if (g_variant_dict_contains (options, "timings"))
+    {
+        germinal_timings_enable ();
+        g_variant_dict_remove (options, "timings");
+    }
+
+    return -1;
+}
+
 static void
 germinal_activate (GApplication *application,
                    G_GNUC_UNUSED gpointer user_data)
 {
-    germinal_create_window (application, NULL);
+    germinal_create_window (application, NULL, 1);
+}
+
+/* Get the first window's command going while GTK initializes, unless another instance is to handle us */
+static void
+germinal_prespawn (GApplication *application,
+                   gint          argc,
+                   gchar        *argv[])
+{
+    /* Options or an explicit command, leave them to the usual path */
+    if (argc > 2 || (argc == 2 && g_strcmp0 (argv[1], "--timings")))
+        return;
+
+    g_autoptr (GDBusConnection) bus = g_bus_get_sync (G_BUS_TYPE_SESSION, NULL, NULL);
+
+    if (!bus)
+        return;
+
+    g_autoptr (GVariant) reply = g_dbus_connection_call_sync (bus,
+                                                              "org.freedesktop.DBus",
+                                                              "/org/freedesktop/DBus",
+                                                              "org.freedesktop.DBus",
+                                                              "NameHasOwner",
+                                                              g_variant_new ("(s)", g_application_get_application_id (application)),
+                                                              G_VARIANT_TYPE ("(b)"),
+                                                              G_DBUS_CALL_FLAGS_NONE,
+                                                              -1,
+                                                              NULL,
+                                                              NULL);
+    gboolean remote = TRUE;
+
+    if (reply)
+        g_variant_get (reply, "(b)", &remote);
+
+    if (remote)
+        return;
+
+    g_autoptr (GSettings) settings = germinal_settings_new ();
+    g_autofree gchar *multiplexer = g_settings_get_string (settings, MULTIPLEXER_KEY);
+    g_autofree gchar *session = NULL;
+    g_auto (GStrv) globals = NULL;
+    guint index = 0;
+
+    /* Only a plain terminal window runs the startup command as is */
+    if (g_strcmp0 (multiplexer, "tmux"))
+        return;
+
+    GStrv command = germinal_get_startup_command (application, settings, &index, &session, &globals);
+
+    if (command)
+        germinal_terminal_prespawn (command);
 }
 
 gint
 main (gint   argc,
       gchar *argv[])
 {
+    germinal_timings_mark (GERMINAL_TIMING_PROCESS_START);
+
     textdomain (GETTEXT_PACKAGE);
     bindtextdomain (GETTEXT_PACKAGE, LOCALEDIR);
     bind_textdomain_codeset (GETTEXT_PACKAGE, "UTF-8");
@@ -62,17 +521,28 @@ main (gint   argc,
     GApplication *gapp = G_APPLICATION (app);
 
     g_application_add_main_option (gapp, "version",          'v', 0, G_OPTION_ARG_NONE,         N_("display the version"),   NULL);
+    g_application_add_main_option (gapp, "toggle-drop-down", 0,   0, G_OPTION_ARG_NONE,         N_("show or hide the drop-down window"), NULL);
+    g_application_add_main_option (gapp, "tabs",             't', 0, G_OPTION_ARG_INT,          N_("the number of tabs to open, with built-in tabs"), "N");
+    g_application_add_main_option (gapp, "timings",          0,   0, G_OPTION_ARG_NONE,         N_("print how long each startup phase took"), NULL);
     g_application_add_main_option (gapp, G_OPTION_REMAINING, 'e', 0, G_OPTION_ARG_STRING_ARRAY, N_("the command to launch"), "command");
 
     gulong startup_id   = g_signal_connect (gapp, "startup",      G_CALLBACK (germinal_startup),      NULL);
     gulong activate_id  = g_signal_connect (gapp, "activate",     G_CALLBACK (germinal_activate),     NULL);
     gulong cmd_line_id  = g_signal_connect (gapp, "command-line", G_CALLBACK (germinal_command_line), NULL);
+    gulong shutdown_id  = g_signal_connect (gapp, "shutdown",     G_CALLBACK (germinal_shutdown),     NULL);
+    gulong options_id   = g_signal_connect (gapp, "handle-local-options", G_CALLBACK (germinal_handle_local_options), NULL);
+
+    germinal_prespawn (gapp, argc, argv);
 
     gint ret = g_application_run (gapp, argc, argv);
 
+    germinal_terminal_drop_prespawn ();
+
     g_signal_handler_disconnect (gapp, startup_id);
     g_signal_handler_disconnect (gapp, activate_id);
     g_signal_handler_disconnect (gapp, cmd_line_id);
+    g_signal_handler_disconnect (gapp, shutdown_id);
+    g_signal_handler_disconnect (gapp, options_id);
 
     return ret;
 }
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*
+ * What copying a 100k lines selection costs on the main thread. Copying
+ * serializes the text right away, as vte can drop the selection before
+ * anyone pastes, so that is what both Copy and Copy as HTML block on. The
+ * HTML is only rendered once something asks for text/html, it used to be
+ * rendered when copying too.
+ */
+
+#include "germinal-clipboard-provider.h"
+
+#define N_LINES 100000
+#define N_RUNS  5
+
+static VteTerminal *
+make_selection (GtkWidget **window)
+{
+    GtkWidget *terminal = vte_terminal_new ();
+
+    vte_terminal_set_scrollback_lines (VTE_TERMINAL (terminal), N_LINES);
+
+    *window = gtk_window_new ();
+    gtk_window_set_child (GTK_WINDOW (*window), terminal);
+    gtk_window_present (GTK_WINDOW (*window));
+
+    while (!gtk_widget_get_mapped (terminal))
+        g_main_context_iteration (NULL, TRUE);
+
+    for (guint i = 0; i < N_LINES; ++i)
+    {
+        g_autofree gchar *line = g_strdup_printf ("%6u some \033[1mbuild\033[0m output, \033[31mwarning\033[0m: unused variable\r\n", i);
+
+        vte_terminal_feed (VTE_TERMINAL (terminal), line, -1);
+    }
+    while (g_main_context_iteration (NULL, FALSE));
+    vte_terminal_select_all (VTE_TERMINAL (terminal));
+    g_assert_true (vte_terminal_get_has_selection (VTE_TERMINAL (terminal)));
+
+    return VTE_TERMINAL (terminal);
+}
+
+static void
+bench_copy (VteTerminal *terminal,
+            const gchar *name,
+            gboolean     html)
+{
+    gint64 start = g_get_monotonic_time ();
+
+    for (guint i = 0; i < N_RUNS; ++i)
+    {
+        g_autoptr (GdkContentProvider) provider = germinal_clipboard_provider_new (terminal, html);
+    }
+
+    g_print ("%-14s %10.3f ms per copy\n", name, (g_get_monotonic_time () - start) / 1000.0 / N_RUNS);
+}
+
+static void
+bench_html (VteTerminal *terminal)
+{
+    gint64 start = g_get_monotonic_time ();
+
+    for (guint i = 0; i < N_RUNS; ++i)
+    {
+        gsize length = 0;
+        g_autofree gchar *markup = vte_terminal_get_text_selected_full (terminal, VTE_FORMAT_HTML, &length);
+    }
+
+    g_print ("%-14s %10.3f ms per paste\n", "text/html", (g_get_monotonic_time () - start) / 1000.0 / N_RUNS);
+}
+
+gint
+main (void)
+{
+    GtkWidget *window;
+
+    if (!g_getenv ("DISPLAY") && !g_getenv ("WAYLAND_DISPLAY"))
+    {
+        g_print ("no display available\n");
+        return 77;
+    }
+
+    gtk_init ();
+
+    VteTerminal *terminal = make_selection (&window);
+
+    bench_copy (terminal, "copy", FALSE);
+    bench_copy (terminal, "copy as html", TRUE);
+    bench_html (terminal);
+
+    gtk_window_destroy (GTK_WINDOW (window));
+
+    return 0;
+}
@@ -0,0 +1,209 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-clipboard-provider.h"
+
+#include <string.h>
+
+static VteTerminal *
+make_selection (GtkWidget **window)
+{
+    GtkWidget *terminal = vte_terminal_new ();
+
+    *window = gtk_window_new ();
+    gtk_window_set_child (GTK_WINDOW (*window), terminal);
+    gtk_window_present (GTK_WINDOW (*window));
+
+    while (!gtk_widget_get_mapped (terminal))
+        g_main_context_iteration (NULL, TRUE);
+
+    vte_terminal_feed (VTE_TERMINAL (terminal), "hello \033[1mworld\033[0m\r\n", -1);
+    while (g_main_context_iteration (NULL, FALSE));
+    vte_terminal_select_all (VTE_TERMINAL (terminal));
+    g_assert_true (vte_terminal_get_has_selection (VTE_TERMINAL (terminal)));
+
+    return VTE_TERMINAL (terminal);
+}
+
+typedef struct
+{
+    gboolean  done;
+    GError   *error;
+} WriteResult;
+
+static void
+on_written (GObject      *source,
+            GAsyncResult *result,
+            gpointer      user_data)
+{
+    WriteResult *write = user_data;
+
+    gdk_content_provider_write_mime_type_finish (GDK_CONTENT_PROVIDER (source), result, &write->error);
+    write->done = TRUE;
+}
+
+/* What a paste from another process would get, NULL if the format isn't provided */
+static gchar *
+write_mime_type (GdkContentProvider *provider,
+                 const gchar        *mime_type)
+{
+    g_autoptr (GOutputStream) stream = g_memory_output_stream_new_resizable ();
+    WriteResult write = { 0 };
+
+    gdk_content_provider_write_mime_type_async (provider, mime_type, stream, G_PRIORITY_DEFAULT, NULL, on_written, &write);
+    while (!write.done)
+        g_main_context_iteration (NULL, TRUE);
+
+    if (write.error)
+    {
+        g_assert_error (write.error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED);
+        g_error_free (write.error);
+        return NULL;
+    }
+
+    return g_strndup (g_memory_output_stream_get_data (G_MEMORY_OUTPUT_STREAM (stream)),
+                      g_memory_output_stream_get_data_size (G_MEMORY_OUTPUT_STREAM (stream)));
+}
+
+static gboolean
+has_mime_type (GdkContentProvider *provider,
+               const gchar        *mime_type)
+{
+    g_autoptr (GdkContentFormats) formats = gdk_content_provider_ref_formats (provider);
+
+    return gdk_content_formats_contain_mime_type (formats, mime_type);
+}
+
+static void
+test_formats (void)
+{
+    GtkWidget *window;
+    VteTerminal *terminal = make_selection (&window);
+    g_autoptr (GdkContentProvider) text = germinal_clipboard_provider_new (terminal, FALSE);
+    g_autoptr (GdkContentProvider) html = germinal_clipboard_provider_new (terminal, TRUE);
+    g_autoptr (GdkContentFormats) formats = gdk_content_provider_ref_formats (text);
+
+    g_assert_true (gdk_content_formats_contain_gtype (formats, G_TYPE_STRING));
+    g_assert_true (has_mime_type (text, "text/plain;charset=utf-8"));
+    g_assert_true (has_mime_type (text, "UTF8_STRING"));
+    g_assert_false (has_mime_type (text, "text/html"));
+    g_assert_true (has_mime_type (html, "text/html"));
+
+    g_autofree gchar *plain = write_mime_type (html, "text/plain;charset=utf-8");
+    g_autofree gchar *markup = write_mime_type (html, "text/html");
+    g_autofree gchar *refused = write_mime_type (text, "text/html");
+
+    g_assert_true (g_str_has_prefix (plain, "hello world"));
+    g_assert_nonnull (strstr (markup, "<b>world</b>"));
+    g_assert_null (refused);
+
+    gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static void
+on_content_changed (GdkContentProvider *provider G_GNUC_UNUSED,
+                    gpointer            user_data)
+{
+    ++*(guint *) user_data;
+}
+
+static void
+test_selection_gone (void)
+{
+    GtkWidget *window;
+    VteTerminal *terminal = make_selection (&window);
+    g_autoptr (GdkContentProvider) provider = germinal_clipboard_provider_new (terminal, TRUE);
+    guint changes = 0;
+
+    g_signal_connect (provider, "content-changed", G_CALLBACK (on_content_changed), &changes);
+
+    /* Output, a reset or a redraw drop the selection before anyone pasted */
+    vte_terminal_unselect_all (terminal);
+    vte_terminal_reset (terminal, TRUE, TRUE);
+
+    /* The text was kept, the HTML wasn't and isn't offered anymore */
+    g_autofree gchar *plain = write_mime_type (provider, "text/plain");
+    g_autofree gchar *markup = write_mime_type (provider, "text/html");
+
+    g_assert_true (g_str_has_prefix (plain, "hello world"));
+    g_assert_null (markup);
+    g_assert_false (has_mime_type (provider, "text/html"));
+    g_assert_cmpuint (changes, ==, 1);
+
+    gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static void
+test_resolved (void)
+{
+    GtkWidget *window;
+    VteTerminal *terminal = make_selection (&window);
+    g_autoptr (GdkContentProvider) provider = germinal_clipboard_provider_new (terminal, TRUE);
+
+    /* What the terminal does before changing the selection itself */
+    germinal_clipboard_provider_resolve (GERMINAL_CLIPBOARD_PROVIDER (provider));
+    vte_terminal_unselect_all (terminal);
+
+    g_autofree gchar *markup = write_mime_type (provider, "text/html");
+
+    g_assert_true (has_mime_type (provider, "text/html"));
+    g_assert_nonnull (strstr (markup, "<b>world</b>"));
+
+    gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static void
+test_shared (void)
+{
+    GtkWidget *window;
+    VteTerminal *terminal = make_selection (&window);
+    g_autoptr (GdkContentProvider) provider = germinal_clipboard_provider_new (terminal, TRUE);
+    GdkClipboard *clipboard = gtk_widget_get_clipboard (GTK_WIDGET (terminal));
+    GdkClipboard *primary = gtk_widget_get_primary_clipboard (GTK_WIDGET (terminal));
+
+    gdk_clipboard_set_content (clipboard, provider);
+    gdk_clipboard_set_content (primary, provider);
+    vte_terminal_unselect_all (terminal);
+
+    /* Both still paste the same text, served from the one copy */
+    g_assert_true (gdk_clipboard_get_content (clipboard) == gdk_clipboard_get_content (primary));
+
+    g_auto (GValue) from_clipboard = G_VALUE_INIT;
+    g_auto (GValue) from_primary = G_VALUE_INIT;
+
+    g_value_init (&from_clipboard, G_TYPE_STRING);
+    g_value_init (&from_primary, G_TYPE_STRING);
+    g_assert_true (gdk_content_provider_get_value (gdk_clipboard_get_content (clipboard), &from_clipboard, NULL));
+    g_assert_true (gdk_content_provider_get_value (gdk_clipboard_get_content (primary), &from_primary, NULL));
+    g_assert_true (g_str_has_prefix (g_value_get_string (&from_clipboard), "hello world"));
+    g_assert_cmpstr (g_value_get_string (&from_clipboard), ==, g_value_get_string (&from_primary));
+
+    gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static void
+test_no_display (void)
+{
+    g_test_skip ("no display available");
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+    g_test_init (&argc, &argv, NULL);
+
+    if (!g_getenv ("DISPLAY") && !g_getenv ("WAYLAND_DISPLAY"))
+    {
+        g_test_add_func ("/clipboard-provider/no-display", test_no_display);
+        return g_test_run ();
+    }
+
+    gtk_init ();
+
+    g_test_add_func ("/clipboard-provider/formats",        test_formats);
+    g_test_add_func ("/clipboard-provider/selection-gone", test_selection_gone);
+    g_test_add_func ("/clipboard-provider/resolved",       test_resolved);
+    g_test_add_func ("/clipboard-provider/shared",         test_shared);
+
+    return g_test_run ();
+}
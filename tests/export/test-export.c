@@ -0,0 +1,304 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-export.h"
+
+#include <string.h>
+
+static gchar *
+to_ansi (const gchar *html)
+{
+    GString *ansi = g_string_new (NULL);
+
+    germinal_export_html_to_ansi (html, ansi);
+
+    return g_string_free (ansi, FALSE);
+}
+
+static void
+test_plain (void)
+{
+    g_autofree gchar *ansi = to_ansi ("<pre>ls -l<br>total 0</pre>");
+
+    g_assert_cmpstr (ansi, ==, "ls -l\ntotal 0");
+}
+
+static void
+test_entities (void)
+{
+    g_autofree gchar *ansi = to_ansi ("a &lt;b&gt; &amp;&amp; &quot;c&quot; &#233; &#x263a; & d");
+
+    g_assert_cmpstr (ansi, ==, "a <b> && \"c\" é ☺ & d");
+}
+
+static void
+test_attributes (void)
+{
+    g_autofree gchar *ansi = to_ansi ("<b>bold</b> <u>under</u>");
+
+    g_assert_cmpstr (ansi, ==, "\033[0;1mbold\033[0m \033[0;4munder\033[0m");
+}
+
+static void
+test_colors (void)
+{
+    g_autofree gchar *ansi = to_ansi ("<font color=\"#ff8000\"><span style=\"background-color: #000010\">x</span>y</font>");
+
+    g_assert_cmpstr (ansi, ==, "\033[0;38;2;255;128;0;48;2;0;0;16mx\033[0;38;2;255;128;0my\033[0m");
+}
+
+static void
+test_nesting (void)
+{
+    g_autofree gchar *ansi = to_ansi ("<b><i>both</i>bold</b>none");
+
+    g_assert_cmpstr (ansi, ==, "\033[0;1;3mboth\033[0;1mbold\033[0mnone\033[0m");
+}
+
+static void
+test_unknown_tags (void)
+{
+    /* Still have to be popped by their closing tag */
+    g_autofree gchar *ansi = to_ansi ("<b><em>x</em>y</b>");
+
+    g_assert_cmpstr (ansi, ==, "\033[0;1mx\033[0;1my\033[0m");
+}
+
+static void
+test_format_for_file (void)
+{
+    const struct { const gchar *path; GerminalExportFormat format; } cases[] = {
+        { "/tmp/scrollback.txt",  GERMINAL_EXPORT_TEXT },
+        { "/tmp/scrollback",      GERMINAL_EXPORT_TEXT },
+        { "/tmp/scrollback.html", GERMINAL_EXPORT_HTML },
+        { "/tmp/scrollback.HTM",  GERMINAL_EXPORT_HTML },
+        { "/tmp/scrollback.ansi", GERMINAL_EXPORT_ANSI },
+        { "/tmp/html.d/log",      GERMINAL_EXPORT_TEXT },
+    };
+
+    for (guint i = 0; i < G_N_ELEMENTS (cases); ++i)
+    {
+        g_autoptr (GFile) file = g_file_new_for_path (cases[i].path);
+
+        g_assert_cmpint (germinal_export_format_for_file (file), ==, cases[i].format);
+    }
+}
+
+/* --- Exporting a terminal ------------------------------------------------ */
+
+typedef struct
+{
+    VteTerminal  *terminal;
+    GCancellable *cancellable;
+    gint64        rows_done;
+    gint64        n_rows;
+    guint         n_progress;
+    gboolean      cancel;
+    gboolean      flood;
+    gboolean      done;
+    gboolean      success;
+    GError       *error;
+} Export;
+
+static VteTerminal *
+show_terminal (GtkWidget **window,
+               glong       scrollback_lines)
+{
+    GtkWidget *terminal = vte_terminal_new ();
+
+    vte_terminal_set_scrollback_lines (VTE_TERMINAL (terminal), scrollback_lines);
+
+    *window = gtk_window_new ();
+    gtk_window_set_child (GTK_WINDOW (*window), terminal);
+    gtk_window_present (GTK_WINDOW (*window));
+
+    while (!gtk_widget_get_mapped (terminal))
+        g_main_context_iteration (NULL, TRUE);
+
+    return VTE_TERMINAL (terminal);
+}
+
+static void
+feed_lines (VteTerminal *terminal,
+            const gchar *prefix,
+            guint        n_lines)
+{
+    g_autoptr (GString) text = g_string_new (NULL);
+
+    for (guint i = 0; i < n_lines; ++i)
+        g_string_append_printf (text, "%s %u\r\n", prefix, i);
+
+    vte_terminal_feed (terminal, text->str, text->len);
+}
+
+static void
+on_progress (gint64   rows_done,
+             gint64   n_rows,
+             gpointer user_data)
+{
+    Export *export = user_data;
+
+    g_assert_cmpint (rows_done, >=, export->rows_done);
+    g_assert_cmpint (rows_done, <=, n_rows);
+    export->rows_done = rows_done;
+    export->n_rows = n_rows;
+
+    if (export->n_progress++)
+        return;
+
+    if (export->cancel)
+        g_cancellable_cancel (export->cancellable);
+
+    /* The rows that weren't written yet drop out of the scrollback */
+    if (export->flood)
+        feed_lines (export->terminal, "new", 20000);
+}
+
+static void
+on_exported (GObject      *source,
+             GAsyncResult *result,
+             gpointer      user_data)
+{
+    Export *export = user_data;
+
+    export->success = germinal_export_finish (VTE_TERMINAL (source), result, &export->error);
+    export->done = TRUE;
+}
+
+static void
+run_export (Export *export,
+            GFile  *file)
+{
+    const GdkRGBA black = { 0, 0, 0, 1 }, white = { 1, 1, 1, 1 };
+
+    export->cancellable = g_cancellable_new ();
+    germinal_export_async (export->terminal, file, GERMINAL_EXPORT_TEXT, &black, &white, NULL,
+                           export->cancellable, on_progress, export, on_exported, export);
+
+    while (!export->done)
+        g_main_context_iteration (NULL, TRUE);
+
+    g_clear_object (&export->cancellable);
+}
+
+static GFile *
+temp_file (const gchar *contents)
+{
+    g_autofree gchar *path = g_build_filename (g_get_tmp_dir (), "scrollback.txt", NULL);
+
+    g_assert_true (g_file_set_contents (path, contents, -1, NULL));
+
+    return g_file_new_for_path (path);
+}
+
+static gchar *
+file_contents (GFile *file)
+{
+    gchar *contents = NULL;
+
+    g_assert_true (g_file_load_contents (file, NULL, &contents, NULL, NULL, NULL));
+
+    return contents;
+}
+
+static void
+test_export_chunks (void)
+{
+    GtkWidget *window;
+    Export export = { .terminal = show_terminal (&window, 10000) };
+    g_autoptr (GFile) file = temp_file ("");
+
+    feed_lines (export.terminal, "line", 5000);
+    run_export (&export, file);
+
+    g_assert_no_error (export.error);
+    g_assert_true (export.success);
+
+    /* A chunk at a time, up to every row there was */
+    g_assert_cmpuint (export.n_progress, >, 2);
+    g_assert_cmpint (export.rows_done, ==, export.n_rows);
+
+    g_autofree gchar *contents = file_contents (file);
+    g_assert_nonnull (strstr (contents, "line 0\n"));
+    g_assert_nonnull (strstr (contents, "line 4999\n"));
+
+    gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static void
+test_export_cancel (void)
+{
+    GtkWidget *window;
+    Export export = { .terminal = show_terminal (&window, 10000), .cancel = TRUE };
+    g_autoptr (GFile) file = temp_file ("what was there before");
+
+    feed_lines (export.terminal, "line", 5000);
+    run_export (&export, file);
+
+    g_assert_error (export.error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+    g_assert_false (export.success);
+    g_clear_error (&export.error);
+
+    /* Left alone */
+    g_autofree gchar *contents = file_contents (file);
+    g_assert_cmpstr (contents, ==, "what was there before");
+
+    gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static void
+test_export_dropped_rows (void)
+{
+    GtkWidget *window;
+    Export export = { .terminal = show_terminal (&window, 5000), .flood = TRUE };
+    g_autoptr (GFile) file = temp_file ("");
+
+    feed_lines (export.terminal, "line", 5000);
+    run_export (&export, file);
+
+    g_assert_no_error (export.error);
+    g_assert_true (export.success);
+    g_assert_cmpint (export.rows_done, ==, export.n_rows);
+
+    /* The first chunk got written, the rows gone since are skipped, what came after isn't part of it */
+    g_autofree gchar *contents = file_contents (file);
+    g_assert_nonnull (strstr (contents, "line 0\n"));
+    g_assert_null (strstr (contents, "line 4999\n"));
+    g_assert_null (strstr (contents, "new "));
+
+    gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static void
+test_no_display (void)
+{
+    g_test_skip ("no display available");
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+    g_test_init (&argc, &argv, G_TEST_OPTION_ISOLATE_DIRS, NULL);
+
+    g_test_add_func ("/export/html-to-ansi/plain",        test_plain);
+    g_test_add_func ("/export/html-to-ansi/entities",     test_entities);
+    g_test_add_func ("/export/html-to-ansi/attributes",   test_attributes);
+    g_test_add_func ("/export/html-to-ansi/colors",       test_colors);
+    g_test_add_func ("/export/html-to-ansi/nesting",      test_nesting);
+    g_test_add_func ("/export/html-to-ansi/unknown-tags", test_unknown_tags);
+    g_test_add_func ("/export/format-for-file",           test_format_for_file);
+
+    if (!g_getenv ("DISPLAY") && !g_getenv ("WAYLAND_DISPLAY"))
+    {
+        g_test_add_func ("/export/no-display", test_no_display);
+        return g_test_run ();
+    }
+
+    gtk_init ();
+
+    g_test_add_func ("/export/chunks",       test_export_chunks);
+    g_test_add_func ("/export/cancel",       test_export_cancel);
+    g_test_add_func ("/export/dropped-rows", test_export_dropped_rows);
+
+    return g_test_run ();
+}
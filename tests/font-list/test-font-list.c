@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-font-list.h"
+
+#include <pango/pangocairo.h>
+
+static void
+on_families (GHashTable *families,
+             gpointer    user_data G_GNUC_UNUSED)
+{
+    GHashTable **result = g_object_get_data (user_data, "result");
+
+    *result = families;
+}
+
+static GHashTable *
+get_monospace (gboolean expect_cached)
+{
+    g_autoptr (GObject) owner = g_object_new (G_TYPE_OBJECT, NULL);
+    GHashTable *families = NULL;
+
+    g_object_set_data (owner, "result", &families);
+    germinal_font_list_get_monospace (owner, on_families);
+
+    if (expect_cached)
+        g_assert_nonnull (families);
+
+    while (!families)
+        g_main_context_iteration (NULL, TRUE);
+
+    return families;
+}
+
+static void
+test_monospace_only (void)
+{
+    GHashTable *families = get_monospace (FALSE);
+    PangoFontMap *font_map = pango_cairo_font_map_get_default ();
+    PangoFontFamily **list = NULL;
+    gint n_families = 0;
+
+    pango_font_map_list_families (font_map, &list, &n_families);
+
+    for (gint i = 0; i < n_families; ++i)
+        g_assert_cmpint (g_hash_table_contains (families, pango_font_family_get_name (list[i])), ==, pango_font_family_is_monospace (list[i]));
+
+    g_free (list);
+}
+
+static void
+test_cached (void)
+{
+    GHashTable *families = get_monospace (FALSE);
+    guint n_families = g_hash_table_size (families);
+
+    /* No thread involved the second time */
+    g_assert_true (get_monospace (TRUE) == families);
+
+    /* Listed again after fontconfig changes */
+    germinal_font_list_invalidate ();
+    g_assert_cmpuint (g_hash_table_size (get_monospace (FALSE)), ==, n_families);
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/font-list/monospace-only", test_monospace_only);
+    g_test_add_func ("/font-list/cached",         test_cached);
+
+    return g_test_run ();
+}
@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-font-warmup.h"
+
+static void
+wait_for_warmup (void)
+{
+    while (germinal_font_warmup_get_n_pending ())
+        g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+warmup (GtkWidget   *widget,
+        const gchar *name)
+{
+    PangoFontDescription *font = pango_font_description_from_string (name);
+
+    germinal_font_warmup (widget, font);
+    pango_font_description_free (font);
+}
+
+static void
+test_once_per_font (void)
+{
+    GtkWidget *label = g_object_ref_sink (gtk_label_new (NULL));
+
+    warmup (label, "Monospace 11");
+    g_assert_cmpuint (germinal_font_warmup_get_n_pending (), ==, 1);
+
+    /* Already queued */
+    warmup (label, "Monospace 11");
+    g_assert_cmpuint (germinal_font_warmup_get_n_pending (), ==, 1);
+
+    /* Another zoom level is another font */
+    warmup (label, "Monospace 13");
+    g_assert_cmpuint (germinal_font_warmup_get_n_pending (), ==, 2);
+
+    wait_for_warmup ();
+
+    /* Only shaped, without a renderer to draw the glyphs with */
+    warmup (label, "Monospace 11");
+    g_assert_cmpuint (germinal_font_warmup_get_n_pending (), ==, 1);
+
+    wait_for_warmup ();
+    g_object_unref (label);
+}
+
+static void
+test_renderer (void)
+{
+    GtkWidget *window = gtk_window_new ();
+    GtkWidget *label = gtk_label_new ("germinal");
+
+    gtk_window_set_child (GTK_WINDOW (window), label);
+    gtk_window_present (GTK_WINDOW (window));
+
+    while (!gtk_widget_get_mapped (label))
+        g_main_context_iteration (NULL, TRUE);
+
+    /* Drawn through the window's renderer */
+    warmup (label, "Monospace 17");
+    wait_for_warmup ();
+
+    /* Already warmed up */
+    warmup (label, "Monospace 17");
+    g_assert_cmpuint (germinal_font_warmup_get_n_pending (), ==, 0);
+
+    gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static void
+test_realize (void)
+{
+    GtkWidget *window = gtk_window_new ();
+    GtkWidget *label = gtk_label_new ("germinal");
+
+    gtk_window_set_child (GTK_WINDOW (window), label);
+
+    /* Before the window is shown, only shaped */
+    warmup (label, "Monospace 23");
+    wait_for_warmup ();
+
+    gtk_window_present (GTK_WINDOW (window));
+
+    while (!gtk_widget_get_mapped (label))
+        g_main_context_iteration (NULL, TRUE);
+
+    /* Warmed up again once realized, for real this time */
+    wait_for_warmup ();
+    warmup (label, "Monospace 23");
+    g_assert_cmpuint (germinal_font_warmup_get_n_pending (), ==, 0);
+
+    gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static void
+test_widget_gone (void)
+{
+    GtkWidget *label = g_object_ref_sink (gtk_label_new (NULL));
+
+    warmup (label, "Monospace 19");
+    g_object_unref (label);
+
+    /* Still resolves the font, without anything to render with */
+    wait_for_warmup ();
+}
+
+static void
+test_no_display (void)
+{
+    g_test_skip ("no display available");
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+    g_test_init (&argc, &argv, NULL);
+
+    if (!g_getenv ("DISPLAY") && !g_getenv ("WAYLAND_DISPLAY"))
+    {
+        g_test_add_func ("/font-warmup/no-display", test_no_display);
+        return g_test_run ();
+    }
+
+    gtk_init ();
+
+    g_test_add_func ("/font-warmup/once-per-font", test_once_per_font);
+    g_test_add_func ("/font-warmup/renderer",      test_renderer);
+    g_test_add_func ("/font-warmup/widget-gone",   test_widget_gone);
+    g_test_add_func ("/font-warmup/realize",       test_realize);
+
+    return g_test_run ();
+}
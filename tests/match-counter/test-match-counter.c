@@ -0,0 +1,177 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-match-counter.h"
+
+static void
+on_changed (GerminalMatchCounter *counter,
+            gpointer              user_data)
+{
+    if (!germinal_match_counter_is_scanning (counter))
+        g_main_loop_quit (user_data);
+}
+
+static void
+scan (GerminalMatchCounter *counter,
+      gint64                first_row,
+      const gchar * const  *rows)
+{
+    g_autoptr (GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+    GPtrArray *copy = g_ptr_array_new_with_free_func (g_free);
+    gulong handler = g_signal_connect (counter, "changed", G_CALLBACK (on_changed), loop);
+
+    for (guint i = 0; rows[i]; ++i)
+        g_ptr_array_add (copy, g_strdup (rows[i]));
+
+    germinal_match_counter_scan (counter, first_row, copy);
+    g_assert_true (germinal_match_counter_is_scanning (counter));
+    g_main_loop_run (loop);
+    g_signal_handler_disconnect (counter, handler);
+}
+
+static void
+assert_row (GerminalMatchCounter *counter,
+            guint                 index,
+            gint64                row,
+            guint                 matches)
+{
+    const GArray *rows = germinal_match_counter_get_rows (counter);
+
+    g_assert_cmpuint (index, <, rows->len);
+    g_assert_cmpint (g_array_index (rows, GerminalMatchRow, index).row, ==, row);
+    g_assert_cmpuint (g_array_index (rows, GerminalMatchRow, index).matches, ==, matches);
+}
+
+static void
+test_count (void)
+{
+    g_autoptr (GerminalMatchCounter) counter = germinal_match_counter_new ();
+    const gchar *rows[] = { "error: one", "nothing here", "Error, ERROR and error", "", NULL };
+
+    g_assert_true (germinal_match_counter_set_pattern (counter, "error", FALSE, NULL));
+    scan (counter, 10, rows);
+
+    g_assert_cmpuint (germinal_match_counter_get_n_matches (counter), ==, 4);
+    g_assert_cmpuint (germinal_match_counter_get_rows (counter)->len, ==, 2);
+    assert_row (counter, 0, 10, 1);
+    assert_row (counter, 1, 12, 3);
+    g_assert_cmpuint (germinal_match_counter_count_before (counter, 10), ==, 0);
+    g_assert_cmpuint (germinal_match_counter_count_before (counter, 12), ==, 1);
+    g_assert_cmpuint (germinal_match_counter_count_before (counter, 100), ==, 4);
+}
+
+static void
+test_literal (void)
+{
+    g_autoptr (GerminalMatchCounter) counter = germinal_match_counter_new ();
+    const gchar *rows[] = { "a.b axb", NULL };
+
+    g_assert_true (germinal_match_counter_set_pattern (counter, "a.b", FALSE, NULL));
+    scan (counter, 0, rows);
+    g_assert_cmpuint (germinal_match_counter_get_n_matches (counter), ==, 1);
+
+    g_assert_true (germinal_match_counter_set_pattern (counter, "a.b", TRUE, NULL));
+    g_assert_cmpuint (germinal_match_counter_get_n_matches (counter), ==, 0);
+    scan (counter, 0, rows);
+    g_assert_cmpuint (germinal_match_counter_get_n_matches (counter), ==, 2);
+}
+
+static void
+test_incremental (void)
+{
+    g_autoptr (GerminalMatchCounter) counter = germinal_match_counter_new ();
+    const gchar *scrollback[] = { "make: ok", "warning: a", "warning: b", "$ make", NULL };
+    const gchar *screen[] = { "warning: b warning: c", "$ ", NULL };
+
+    g_assert_true (germinal_match_counter_set_pattern (counter, "warning", FALSE, NULL));
+    scan (counter, 0, scrollback);
+    g_assert_cmpuint (germinal_match_counter_get_n_matches (counter), ==, 2);
+
+    /* Output rewrote the last rows, what came before stays */
+    scan (counter, 2, screen);
+    g_assert_cmpuint (germinal_match_counter_get_n_matches (counter), ==, 3);
+    g_assert_cmpuint (germinal_match_counter_get_rows (counter)->len, ==, 2);
+    assert_row (counter, 0, 1, 1);
+    assert_row (counter, 1, 2, 2);
+
+    /* The scrollback forgot about its first rows */
+    germinal_match_counter_trim (counter, 2);
+    g_assert_cmpuint (germinal_match_counter_get_n_matches (counter), ==, 2);
+    assert_row (counter, 0, 2, 2);
+}
+
+static void
+test_invalid (void)
+{
+    g_autoptr (GerminalMatchCounter) counter = germinal_match_counter_new ();
+    g_autoptr (GError) error = NULL;
+    const gchar *rows[] = { "(unbalanced", NULL };
+
+    g_assert_false (germinal_match_counter_set_pattern (counter, "(unbalanced", TRUE, &error));
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT);
+
+    /* Without a pattern, there is nothing to scan for */
+    GPtrArray *copy = g_ptr_array_new_with_free_func (g_free);
+    g_ptr_array_add (copy, g_strdup (rows[0]));
+    germinal_match_counter_scan (counter, 0, copy);
+    g_assert_false (germinal_match_counter_is_scanning (counter));
+    g_assert_cmpuint (germinal_match_counter_get_n_matches (counter), ==, 0);
+
+    /* Plain text is never invalid */
+    g_assert_true (germinal_match_counter_set_pattern (counter, "(unbalanced", FALSE, NULL));
+    scan (counter, 0, rows);
+    g_assert_cmpuint (germinal_match_counter_get_n_matches (counter), ==, 1);
+}
+
+static void
+on_stale_changed (GerminalMatchCounter *counter G_GNUC_UNUSED,
+                  gpointer              user_data)
+{
+    ++*(guint *) user_data;
+}
+
+static gboolean
+quit_loop (gpointer user_data)
+{
+    g_main_loop_quit (user_data);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+test_stale (void)
+{
+    g_autoptr (GerminalMatchCounter) counter = germinal_match_counter_new ();
+    g_autoptr (GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+    GPtrArray *rows = g_ptr_array_new_with_free_func (g_free);
+    guint changes = 0;
+
+    g_assert_true (germinal_match_counter_set_pattern (counter, "old", FALSE, NULL));
+    g_ptr_array_add (rows, g_strdup ("old old old"));
+    germinal_match_counter_scan (counter, 0, rows);
+
+    /* The search changed before the scan was done, its results don't count */
+    g_signal_connect (counter, "changed", G_CALLBACK (on_stale_changed), &changes);
+    g_assert_true (germinal_match_counter_set_pattern (counter, "new", FALSE, NULL));
+    g_assert_cmpuint (changes, ==, 1);
+
+    g_timeout_add (100, quit_loop, loop);
+    g_main_loop_run (loop);
+
+    g_assert_cmpuint (changes, ==, 1);
+    g_assert_cmpuint (germinal_match_counter_get_n_matches (counter), ==, 0);
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/match-counter/count",       test_count);
+    g_test_add_func ("/match-counter/literal",     test_literal);
+    g_test_add_func ("/match-counter/incremental", test_incremental);
+    g_test_add_func ("/match-counter/invalid",     test_invalid);
+    g_test_add_func ("/match-counter/stale",       test_stale);
+
+    return g_test_run ();
+}
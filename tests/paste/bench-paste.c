@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*
+ * How fast the pacing gets a paste through a pty to a raw mode reader, a
+ * chunk at a time as the pty can take more. A slow reader stands for an ssh
+ * session on a thin link. Chunks are written straight to the pty here, where
+ * germinal hands them to vte which queues and writes them itself: vte's own
+ * cost isn't part of what's measured.
+ */
+
+#define _GNU_SOURCE
+#include "germinal-paste.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define PASTE_SIZE    (32 * 1024 * 1024)
+#define SLOW_SIZE     (2 * 1024 * 1024)
+#define SLOW_READ     1024
+#define SLOW_PAUSE_US 100
+
+typedef struct
+{
+    gint       master;
+    gint       slave;
+    gsize      expected;
+    gsize      received;
+    gboolean   slow;
+    GMainLoop *loop;
+    gdouble    throughput;
+} Bench;
+
+static gpointer
+drain (gpointer data)
+{
+    Bench *bench = data;
+    gchar buffer[65536];
+
+    while (bench->received < bench->expected)
+    {
+        gssize n = read (bench->slave, buffer, bench->slow ? SLOW_READ : sizeof (buffer));
+
+        if (n <= 0)
+            break;
+        bench->received += n;
+        if (bench->slow)
+            g_usleep (SLOW_PAUSE_US);
+    }
+
+    return NULL;
+}
+
+static void
+open_pty (Bench *bench)
+{
+    struct termios attributes;
+
+    bench->master = posix_openpt (O_RDWR | O_NOCTTY);
+    g_assert_cmpint (bench->master, >=, 0);
+    g_assert_cmpint (grantpt (bench->master), ==, 0);
+    g_assert_cmpint (unlockpt (bench->master), ==, 0);
+
+    bench->slave = open (ptsname (bench->master), O_RDWR | O_NOCTTY);
+    g_assert_cmpint (bench->slave, >=, 0);
+
+    tcgetattr (bench->slave, &attributes);
+    cfmakeraw (&attributes);
+    tcsetattr (bench->slave, TCSANOW, &attributes);
+}
+
+static void
+write_chunk (const gchar *chunk,
+             gsize        length,
+             gpointer     user_data)
+{
+    Bench *bench = user_data;
+
+    while (length)
+    {
+        gssize n = write (bench->master, chunk, length);
+
+        g_assert_cmpint (n, >, 0);
+        chunk += n;
+        length -= n;
+    }
+}
+
+static void
+on_pasted (GObject      *source G_GNUC_UNUSED,
+           GAsyncResult *result,
+           gpointer      user_data)
+{
+    Bench *bench = user_data;
+    g_autoptr (GError) error = NULL;
+
+    g_assert_true (germinal_paste_finish (result, &bench->throughput, &error));
+    g_main_loop_quit (bench->loop);
+}
+
+static void
+bench_paste (const gchar *name,
+             gsize        size,
+             gboolean     slow)
+{
+    g_autoptr (GString) text = g_string_sized_new (size);
+    Bench bench = { .expected = size, .slow = slow };
+
+    while (text->len < size)
+        g_string_append_printf (text, "INSERT INTO t VALUES (%u, 'some row of a big sql dump');\n", text->len);
+    g_string_truncate (text, size);
+
+    open_pty (&bench);
+    bench.loop = g_main_loop_new (NULL, FALSE);
+
+    GThread *reader = g_thread_new ("drain", drain, &bench);
+    g_autoptr (GBytes) bytes = g_bytes_new_static (text->str, text->len);
+
+    germinal_paste_async (bench.master, bytes, write_chunk, &bench, NULL, NULL, NULL, on_pasted, &bench);
+    g_main_loop_run (bench.loop);
+
+    g_thread_join (reader);
+    g_assert_cmpuint (bench.received, ==, size);
+
+    g_autofree gchar *rate = g_format_size ((guint64) bench.throughput);
+
+    g_print ("%-12s %12s/s\n", name, rate);
+
+    close (bench.master);
+    close (bench.slave);
+    g_main_loop_unref (bench.loop);
+}
+
+gint
+main (void)
+{
+    bench_paste ("fast reader", PASTE_SIZE, FALSE);
+    bench_paste ("slow reader", SLOW_SIZE,  TRUE);
+
+    return 0;
+}
@@ -0,0 +1,242 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define _GNU_SOURCE
+#include "germinal-paste.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+static void
+test_chunk_end (void)
+{
+    const gchar *text = "abc\ndef\nghijkl";
+
+    /* Small enough */
+    g_assert_cmpuint (germinal_paste_chunk_end (text, strlen (text), 0, 64), ==, strlen (text));
+    /* After the last newline that fits */
+    g_assert_cmpuint (germinal_paste_chunk_end (text, strlen (text), 0, 10), ==, 8);
+    g_assert_cmpuint (germinal_paste_chunk_end (text, strlen (text), 4, 6), ==, 8);
+    /* No newline, cut anywhere */
+    g_assert_cmpuint (germinal_paste_chunk_end (text, strlen (text), 8, 4), ==, 12);
+}
+
+static void
+test_chunk_end_utf8 (void)
+{
+    /* é is two bytes, € three */
+    const gchar *text = "aaé€bb";
+
+    g_assert_cmpuint (germinal_paste_chunk_end (text, strlen (text), 0, 3), ==, 2);
+    g_assert_cmpuint (germinal_paste_chunk_end (text, strlen (text), 2, 3), ==, 4);
+    g_assert_cmpuint (germinal_paste_chunk_end (text, strlen (text), 4, 4), ==, 8);
+}
+
+static void
+test_chunk_end_crlf (void)
+{
+    const gchar *text = "abc\r\ndef";
+
+    g_assert_cmpuint (germinal_paste_chunk_end (text, strlen (text), 0, 4), ==, 3);
+    g_assert_cmpuint (germinal_paste_chunk_end (text, strlen (text), 0, 5), ==, 5);
+}
+
+static void
+test_sanitize (void)
+{
+    /* Line ends, controls (an early end of a bracketed paste too), a C1 control, and é */
+    const gchar *text = "a\nb\r\nc\td\033[201~e\x7f\xc2\x9b" "f\xc3\xa9";
+    gsize length = 0;
+    g_autofree gchar *sanitized = germinal_paste_sanitize (text, strlen (text), &length);
+
+    g_assert_cmpuint (length, ==, strlen (sanitized));
+    g_assert_cmpstr (sanitized, ==, "a\rb\rc\td[201~ef\xc3\xa9");
+}
+
+/* --- Through a pty ---------------------------------------------------- */
+
+typedef struct
+{
+    gint          master;
+    gint          slave;
+    gsize         expected;
+    gsize         received;
+    GThread      *reader;
+    GMainLoop    *loop;
+    gsize         last_progress;
+    guint         n_progress;
+    gboolean      done;
+    gboolean      cancel;
+    GError       *error;
+    GCancellable *cancellable;
+} Fixture;
+
+static gpointer
+drain (gpointer data)
+{
+    Fixture *fixture = data;
+    gchar buffer[4096];
+
+    while (fixture->received < fixture->expected)
+    {
+        gssize n = read (fixture->slave, buffer, sizeof (buffer));
+
+        if (n <= 0)
+            break;
+        fixture->received += n;
+    }
+
+    return NULL;
+}
+
+static void
+fixture_setup (Fixture       *fixture,
+               gconstpointer  data G_GNUC_UNUSED)
+{
+    struct termios attributes;
+
+    fixture->master = posix_openpt (O_RDWR | O_NOCTTY);
+    g_assert_cmpint (fixture->master, >=, 0);
+    g_assert_cmpint (grantpt (fixture->master), ==, 0);
+    g_assert_cmpint (unlockpt (fixture->master), ==, 0);
+
+    fixture->slave = open (ptsname (fixture->master), O_RDWR | O_NOCTTY);
+    g_assert_cmpint (fixture->slave, >=, 0);
+
+    /* Like an editor or readline, which read whatever comes */
+    tcgetattr (fixture->slave, &attributes);
+    cfmakeraw (&attributes);
+    tcsetattr (fixture->slave, TCSANOW, &attributes);
+
+    fixture->loop = g_main_loop_new (NULL, FALSE);
+    fixture->cancellable = g_cancellable_new ();
+}
+
+static void
+fixture_teardown (Fixture       *fixture,
+                  gconstpointer  data G_GNUC_UNUSED)
+{
+    close (fixture->master);
+    if (fixture->reader)
+        g_thread_join (fixture->reader);
+    close (fixture->slave);
+    g_clear_error (&fixture->error);
+    g_clear_object (&fixture->cancellable);
+    g_main_loop_unref (fixture->loop);
+}
+
+static void
+write_chunk (const gchar *chunk,
+             gsize        length,
+             gpointer     user_data)
+{
+    Fixture *fixture = user_data;
+
+    while (length)
+    {
+        gssize n = write (fixture->master, chunk, length);
+
+        g_assert_cmpint (n, >, 0);
+        chunk += n;
+        length -= n;
+    }
+}
+
+static void
+on_progress (gsize    bytes_done,
+             gsize    n_bytes,
+             gpointer user_data)
+{
+    Fixture *fixture = user_data;
+
+    g_assert_cmpuint (bytes_done, >, fixture->last_progress);
+    g_assert_cmpuint (bytes_done, <=, n_bytes);
+    g_assert_cmpuint (bytes_done - fixture->last_progress, <=, GERMINAL_PASTE_CHUNK_SIZE);
+    fixture->last_progress = bytes_done;
+    ++fixture->n_progress;
+
+    if (fixture->cancel)
+        g_cancellable_cancel (fixture->cancellable);
+}
+
+static void
+on_pasted (GObject      *source G_GNUC_UNUSED,
+           GAsyncResult *result,
+           gpointer      user_data)
+{
+    Fixture *fixture = user_data;
+    gdouble throughput = 0;
+
+    fixture->done = germinal_paste_finish (result, &throughput, &fixture->error);
+    if (fixture->done)
+        g_assert_cmpfloat (throughput, >, 0);
+    g_main_loop_quit (fixture->loop);
+}
+
+static GBytes *
+make_text (gsize size)
+{
+    GString *text = g_string_sized_new (size);
+
+    while (text->len < size)
+        g_string_append_printf (text, "INSERT INTO t VALUES (%u, 'row');\n", text->len);
+
+    return g_string_free_to_bytes (text);
+}
+
+static void
+test_paste (Fixture       *fixture,
+            gconstpointer  data G_GNUC_UNUSED)
+{
+    g_autoptr (GBytes) text = make_text (1024 * 1024);
+
+    fixture->expected = g_bytes_get_size (text);
+    fixture->reader = g_thread_new ("drain", drain, fixture);
+
+    germinal_paste_async (fixture->master, text, write_chunk, fixture, fixture->cancellable,
+                          on_progress, fixture, on_pasted, fixture);
+    g_main_loop_run (fixture->loop);
+
+    g_assert_no_error (fixture->error);
+    g_assert_true (fixture->done);
+    g_assert_cmpuint (fixture->last_progress, ==, g_bytes_get_size (text));
+    g_assert_cmpuint (fixture->n_progress, >, 1);
+
+    g_thread_join (g_steal_pointer (&fixture->reader));
+    g_assert_cmpuint (fixture->received, ==, g_bytes_get_size (text));
+}
+
+static void
+test_cancel (Fixture       *fixture,
+             gconstpointer  data G_GNUC_UNUSED)
+{
+    g_autoptr (GBytes) text = make_text (1024 * 1024);
+
+    /* Nobody reads, the first chunk fits in the pty anyway */
+    fixture->cancel = TRUE;
+
+    germinal_paste_async (fixture->master, text, write_chunk, fixture, fixture->cancellable,
+                          on_progress, fixture, on_pasted, fixture);
+    g_main_loop_run (fixture->loop);
+
+    g_assert_error (fixture->error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+    g_assert_cmpuint (fixture->n_progress, ==, 1);
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/paste/chunk-end",      test_chunk_end);
+    g_test_add_func ("/paste/chunk-end/utf8", test_chunk_end_utf8);
+    g_test_add_func ("/paste/chunk-end/crlf", test_chunk_end_crlf);
+    g_test_add_func ("/paste/sanitize",       test_sanitize);
+    g_test_add ("/paste/pty",    Fixture, NULL, fixture_setup, test_paste,  fixture_teardown);
+    g_test_add ("/paste/cancel", Fixture, NULL, fixture_setup, test_cancel, fixture_teardown);
+
+    return g_test_run ();
+}
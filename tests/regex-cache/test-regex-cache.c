@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-regex-cache.h"
+#include "germinal-util.h"
+
+#define PCRE2_CODE_UNIT_WIDTH 0
+#include <pcre2.h>
+
+#define URL_FLAGS (PCRE2_CASELESS | PCRE2_NOTEMPTY | PCRE2_MULTILINE)
+
+static void
+test_match_shared (void)
+{
+    g_autoptr (GError) error = NULL;
+    g_autoptr (VteRegex) first = germinal_regex_cache_get_match (URL_REGEXP, URL_FLAGS, &error);
+    g_assert_no_error (error);
+    g_autoptr (VteRegex) second = germinal_regex_cache_get_match (URL_REGEXP, URL_FLAGS, &error);
+    g_assert_no_error (error);
+
+    g_assert_true (first == second);
+}
+
+static void
+test_keyed_by_flags (void)
+{
+    g_autoptr (VteRegex) caseless = germinal_regex_cache_get_search ("foo", PCRE2_CASELESS, NULL);
+    g_autoptr (VteRegex) exact = germinal_regex_cache_get_search ("foo", 0, NULL);
+    g_autoptr (VteRegex) match = germinal_regex_cache_get_match ("foo", PCRE2_CASELESS, NULL);
+
+    g_assert_nonnull (caseless);
+    g_assert_true (caseless != exact);
+    g_assert_true (caseless != match);
+}
+
+static void
+test_invalid (void)
+{
+    g_autoptr (GError) error = NULL;
+    g_autoptr (VteRegex) regex = germinal_regex_cache_get_search ("foo(", 0, &error);
+
+    g_assert_null (regex);
+    g_assert_nonnull (error);
+}
+
+static void
+test_search_eviction (void)
+{
+    g_autoptr (VteRegex) first = germinal_regex_cache_get_search ("first", 0, NULL);
+    /* Kept alive, so that its address can't be reused */
+    g_autoptr (VteRegex) pattern0 = germinal_regex_cache_get_search ("pattern0", 0, NULL);
+
+    /* Still the most recent search after this */
+    for (guint i = 0; i < 100; ++i)
+    {
+        g_autofree gchar *pattern = g_strdup_printf ("pattern%u", i);
+        g_autoptr (VteRegex) regex = germinal_regex_cache_get_search (pattern, 0, NULL);
+        g_autoptr (VteRegex) again = germinal_regex_cache_get_search ("first", 0, NULL);
+
+        g_assert_true (again == first);
+    }
+
+    /* Recent enough to still be there */
+    g_autoptr (VteRegex) pattern99 = germinal_regex_cache_get_search ("pattern99", 0, NULL);
+    g_autoptr (VteRegex) pattern99_again = germinal_regex_cache_get_search ("pattern99", 0, NULL);
+    g_assert_true (pattern99 == pattern99_again);
+
+    /* pattern0 was evicted long ago, and compiled again */
+    g_autoptr (VteRegex) recompiled = germinal_regex_cache_get_search ("pattern0", 0, NULL);
+    g_assert_nonnull (recompiled);
+    g_assert_true (recompiled != pattern0);
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/regex-cache/match-shared",    test_match_shared);
+    g_test_add_func ("/regex-cache/keyed-by-flags",  test_keyed_by_flags);
+    g_test_add_func ("/regex-cache/invalid",         test_invalid);
+    g_test_add_func ("/regex-cache/search-eviction", test_search_eviction);
+
+    return g_test_run ();
+}
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*
+ * How long the url matcher and a typical search take over a large
+ * scrollback, one pcre2_match per line like vte does, with and without JIT.
+ */
+
+#include "germinal-util.h"
+
+#include <glib.h>
+#include <string.h>
+
+#define PCRE2_CODE_UNIT_WIDTH 8
+#include <pcre2.h>
+
+#define N_LINES 200000
+
+static GPtrArray *
+make_scrollback (void)
+{
+    GPtrArray *lines = g_ptr_array_new_with_free_func (g_free);
+
+    for (guint i = 0; i < N_LINES; ++i)
+    {
+        if (i % 50 == 0)
+            g_ptr_array_add (lines, g_strdup_printf ("[%06u] fetching https://example.com/build/%u/log?attempt=2 (redirected)", i, i));
+        else if (i % 997 == 0)
+            g_ptr_array_add (lines, g_strdup_printf ("[%06u] error: connection timeout after 30s", i));
+        else
+            g_ptr_array_add (lines, g_strdup_printf ("[%06u] compiling src/module_%u.c -> build/module_%u.o  [ok]", i, i % 128, i % 128));
+    }
+
+    return lines;
+}
+
+static pcre2_code *
+compile (const gchar *pattern,
+         guint32      flags,
+         gboolean     jit)
+{
+    gint errcode;
+    PCRE2_SIZE erroffset;
+    pcre2_code *code = pcre2_compile ((PCRE2_SPTR) pattern, PCRE2_ZERO_TERMINATED, flags | PCRE2_UTF, &errcode, &erroffset, NULL);
+
+    g_assert_nonnull (code);
+
+    if (jit && pcre2_jit_compile (code, PCRE2_JIT_COMPLETE))
+        g_printerr ("JIT isn't available\n");
+
+    return code;
+}
+
+static void
+bench (const gchar *name,
+       const gchar *pattern,
+       guint32      flags,
+       GPtrArray   *lines)
+{
+    for (guint jit = 0; jit <= 1; ++jit)
+    {
+        pcre2_code *code = compile (pattern, flags, jit);
+        pcre2_match_data *match_data = pcre2_match_data_create_from_pattern (code, NULL);
+        guint matches = 0;
+        gint64 start = g_get_monotonic_time ();
+
+        for (guint i = 0; i < lines->len; ++i)
+        {
+            const gchar *line = lines->pdata[i];
+
+            if (pcre2_match (code, (PCRE2_SPTR) line, strlen (line), 0, 0, match_data, NULL) >= 0)
+                ++matches;
+        }
+
+        g_print ("%-6s %-6s %8.2f ms (%u matches in %u lines)\n",
+                 name, jit ? "JIT" : "no JIT", (g_get_monotonic_time () - start) / 1000.0, matches, lines->len);
+
+        pcre2_match_data_free (match_data);
+        pcre2_code_free (code);
+    }
+}
+
+gint
+main (void)
+{
+    g_autoptr (GPtrArray) lines = make_scrollback ();
+
+    bench ("url",    URL_REGEXP,         PCRE2_CASELESS | PCRE2_NOTEMPTY | PCRE2_MULTILINE, lines);
+    bench ("search", "error: .*timeout", PCRE2_CASELESS | PCRE2_MULTILINE,                  lines);
+
+    return 0;
+}
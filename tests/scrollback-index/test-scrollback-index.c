@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-scrollback-index.h"
+
+static void
+update (GerminalScrollbackIndex *index,
+        guint                    document,
+        gint64                   first_row,
+        const gchar * const     *rows)
+{
+    g_autoptr (GPtrArray) array = g_ptr_array_new ();
+
+    for (guint i = 0; rows[i]; ++i)
+        g_ptr_array_add (array, (gpointer) rows[i]);
+
+    germinal_scrollback_index_update (index, document, first_row, array);
+}
+
+static void
+assert_hit (GArray *hits,
+            guint   index,
+            guint   document,
+            gint64  row)
+{
+    g_assert_cmpuint (index, <, hits->len);
+    g_assert_cmpuint (g_array_index (hits, GerminalIndexHit, index).document, ==, document);
+    g_assert_cmpint (g_array_index (hits, GerminalIndexHit, index).row, ==, row);
+}
+
+static void
+test_search (void)
+{
+    g_autoptr (GerminalScrollbackIndex) index = germinal_scrollback_index_new (G_MAXSIZE);
+    guint first = germinal_scrollback_index_add_document (index, GUINT_TO_POINTER (1));
+    guint second = germinal_scrollback_index_add_document (index, GUINT_TO_POINTER (2));
+    const gchar *first_rows[] = { "GET /users request-id=4f2a", "200 OK", NULL };
+    const gchar *second_rows[] = { "POST /login", "500 Request-ID=4F2A failed", "ok", NULL };
+
+    update (index, first, 0, first_rows);
+    update (index, second, 10, second_rows);
+
+    g_assert_cmpuint (germinal_scrollback_index_get_n_rows (index), ==, 5);
+    g_assert_true (germinal_scrollback_index_get_owner (index, second) == GUINT_TO_POINTER (2));
+
+    /* Case folded, newest first */
+    g_autoptr (GArray) hits = germinal_scrollback_index_search (index, "request-id=4f2a", 10);
+    g_assert_cmpuint (hits->len, ==, 2);
+    assert_hit (hits, 0, second, 11);
+    assert_hit (hits, 1, first, 0);
+    g_assert_cmpstr (g_array_index (hits, GerminalIndexHit, 1).text, ==, "GET /users request-id=4f2a");
+
+    /* Every trigram is there, not in that order */
+    g_clear_pointer (&hits, g_array_unref);
+    hits = germinal_scrollback_index_search (index, "4f2a request", 10);
+    g_assert_cmpuint (hits->len, ==, 0);
+
+    /* Shorter than a trigram */
+    g_clear_pointer (&hits, g_array_unref);
+    hits = germinal_scrollback_index_search (index, "ok", 10);
+    g_assert_cmpuint (hits->len, ==, 2);
+    assert_hit (hits, 0, second, 12);
+    assert_hit (hits, 1, first, 1);
+
+    g_clear_pointer (&hits, g_array_unref);
+    hits = germinal_scrollback_index_search (index, "request", 1);
+    g_assert_cmpuint (hits->len, ==, 1);
+}
+
+static void
+test_update (void)
+{
+    g_autoptr (GerminalScrollbackIndex) index = germinal_scrollback_index_new (G_MAXSIZE);
+    guint document = germinal_scrollback_index_add_document (index, NULL);
+    const gchar *screen[] = { "$ make", "building", "$ ", NULL };
+    const gchar *output[] = { "$ make", "building", "done", "$ ", NULL };
+
+    update (index, document, 0, screen);
+    update (index, document, 0, output);
+    g_assert_cmpuint (germinal_scrollback_index_get_n_rows (index), ==, 4);
+
+    g_autoptr (GArray) hits = germinal_scrollback_index_search (index, "done", 10);
+    assert_hit (hits, 0, document, 2);
+
+    /* The scrollback forgot about its first rows */
+    germinal_scrollback_index_trim (index, document, 2);
+    g_assert_cmpuint (germinal_scrollback_index_get_n_rows (index), ==, 2);
+    g_clear_pointer (&hits, g_array_unref);
+    hits = germinal_scrollback_index_search (index, "make", 10);
+    g_assert_cmpuint (hits->len, ==, 0);
+
+    germinal_scrollback_index_remove_document (index, document);
+    g_assert_cmpuint (germinal_scrollback_index_get_n_rows (index), ==, 0);
+    g_assert_null (germinal_scrollback_index_get_owner (index, document));
+}
+
+static void
+test_budget (void)
+{
+    g_autoptr (GerminalScrollbackIndex) index = germinal_scrollback_index_new (256 * 1024);
+    guint document = germinal_scrollback_index_add_document (index, NULL);
+    g_autoptr (GPtrArray) rows = g_ptr_array_new_with_free_func (g_free);
+    const guint n_rows = 20000;
+
+    for (guint i = 0; i < n_rows; ++i)
+        g_ptr_array_add (rows, g_strdup_printf ("row %u of the scrollback, request-id=%08x", i, i * 2654435761u));
+
+    for (guint i = 0; i < n_rows; i += 100)
+    {
+        g_autoptr (GPtrArray) chunk = g_ptr_array_new ();
+
+        for (guint j = i; j < i + 100; ++j)
+            g_ptr_array_add (chunk, rows->pdata[j]);
+
+        germinal_scrollback_index_update (index, document, i, chunk);
+        g_assert_cmpuint (germinal_scrollback_index_get_size (index), <=, 256 * 1024);
+    }
+
+    /* The oldest rows went first */
+    guint kept = germinal_scrollback_index_get_n_rows (index);
+    g_assert_cmpuint (kept, >, 0);
+    g_assert_cmpuint (kept, <, n_rows);
+
+    g_autoptr (GArray) hits = germinal_scrollback_index_search (index, rows->pdata[n_rows - 1], 10);
+    assert_hit (hits, 0, document, n_rows - 1);
+    g_clear_pointer (&hits, g_array_unref);
+    hits = germinal_scrollback_index_search (index, rows->pdata[0], 10);
+    g_assert_cmpuint (hits->len, ==, 0);
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/scrollback-index/search", test_search);
+    g_test_add_func ("/scrollback-index/update", test_update);
+    g_test_add_func ("/scrollback-index/budget", test_budget);
+
+    return g_test_run ();
+}
@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*
+ * Keystroke to highlight latency while typing a query over a full
+ * scrollback, the way vte searches (one pcre2_match per row): escaping the
+ * query and starting over from the top at each keystroke, or going on from
+ * the current match as it gets refined.
+ *
+ * The query is full of regex metacharacters on purpose. Compiled as is, it
+ * isn't the same search at all (and "read(" doesn't even compile), so there
+ * is nothing to compare the literal search with in regex mode.
+ */
+
+#include <glib.h>
+#include <string.h>
+
+#define PCRE2_CODE_UNIT_WIDTH 8
+#include <pcre2.h>
+
+#define N_LINES 65536
+#define QUERY   "error: read(fd, buf+8) timed out."
+
+static GPtrArray *
+make_scrollback (void)
+{
+    GPtrArray *lines = g_ptr_array_new_with_free_func (g_free);
+
+    for (guint i = 0; i < N_LINES; ++i)
+    {
+        /* The only full match is close to the end */
+        if (i == N_LINES - 100)
+            g_ptr_array_add (lines, g_strdup_printf ("[%06u] error: read(fd, buf+8) timed out.", i));
+        else if (i % 64 == 0)
+            g_ptr_array_add (lines, g_strdup_printf ("[%06u] retrying connection to build-%u (attempt %u)", i, i % 7, i % 3));
+        else
+            g_ptr_array_add (lines, g_strdup_printf ("[%06u] compiling src/module_%u.c -> build/module_%u.o  [ok]", i, i % 128, i % 128));
+    }
+
+    return lines;
+}
+
+/* Returns the first matching row from start, wrapping around like vte */
+static guint
+find_next (pcre2_code *code,
+           GPtrArray  *lines,
+           guint       start)
+{
+    pcre2_match_data *match_data = pcre2_match_data_create_from_pattern (code, NULL);
+    guint found = G_MAXUINT;
+
+    for (guint n = 0; n < lines->len && found == G_MAXUINT; ++n)
+    {
+        guint row = (start + n) % lines->len;
+        const gchar *line = lines->pdata[row];
+
+        if (pcre2_match (code, (PCRE2_SPTR) line, strlen (line), 0, 0, match_data, NULL) >= 0)
+            found = row;
+    }
+
+    pcre2_match_data_free (match_data);
+
+    return found;
+}
+
+static pcre2_code *
+compile (const gchar *pattern)
+{
+    gint errcode;
+    PCRE2_SIZE erroffset;
+    pcre2_code *code = pcre2_compile ((PCRE2_SPTR) pattern, PCRE2_ZERO_TERMINATED,
+                                      PCRE2_UTF | PCRE2_CASELESS | PCRE2_MULTILINE, &errcode, &erroffset, NULL);
+
+    g_assert_nonnull (code);
+    pcre2_jit_compile (code, PCRE2_JIT_COMPLETE);
+
+    return code;
+}
+
+static void
+bench (const gchar *name,
+       gboolean     refine,
+       GPtrArray   *lines)
+{
+    gint64 total = 0, worst = 0;
+    guint row = 0;
+
+    for (gsize len = 1; len <= strlen (QUERY); ++len)
+    {
+        g_autofree gchar *prefix = g_strndup (QUERY, len);
+        g_autofree gchar *pattern = g_regex_escape_string (prefix, -1);
+        gint64 start = g_get_monotonic_time ();
+        pcre2_code *code = compile (pattern);
+
+        row = find_next (code, lines, refine ? row : 0);
+        pcre2_code_free (code);
+
+        gint64 elapsed = g_get_monotonic_time () - start;
+
+        total += elapsed;
+        worst = MAX (worst, elapsed);
+    }
+
+    g_assert_cmpuint (row, ==, N_LINES - 100);
+    g_print ("%-28s %8.3f ms mean %8.3f ms worst per keystroke\n",
+             name, total / 1000.0 / strlen (QUERY), worst / 1000.0);
+}
+
+gint
+main (void)
+{
+    g_autoptr (GPtrArray) lines = make_scrollback ();
+
+    bench ("literal, from the top",     FALSE, lines);
+    bench ("literal, refining",         TRUE,  lines);
+
+    /* Typing faster than the debounce delay only searches for the whole query */
+    g_autofree gchar *pattern = g_regex_escape_string (QUERY, -1);
+    gint64 start = g_get_monotonic_time ();
+    pcre2_code *code = compile (pattern);
+
+    g_assert_cmpuint (find_next (code, lines, 0), ==, N_LINES - 100);
+    pcre2_code_free (code);
+    g_print ("%-28s %8.3f ms once, after the delay\n", "literal, debounced", (g_get_monotonic_time () - start) / 1000.0);
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*
+ * What a cold start pays to get the values it needs: reading them from a
+ * fresh keyfile backed GSettings and parsing them, or loading the snapshot
+ * of the previous run and reading the rest from a GSettings answered from
+ * it, the keyfile being left for later.
+ */
+
+#include "germinal-settings.h"
+#include "germinal-settings-backend.h"
+#include "germinal-settings-snapshot.h"
+
+#include <glib/gstdio.h>
+
+#define N_RUNS 200
+
+static GSettings *
+create_settings (const gchar *config)
+{
+    g_autoptr (GSettingsBackend) backend = g_keyfile_settings_backend_new (config, "/org/gnome/Germinal/", "Germinal");
+
+    return g_settings_new_with_backend ("org.gnome.Germinal", backend);
+}
+
+/* What windows read besides the values terminals need */
+static void
+read_startup_keys (GSettings *settings)
+{
+    g_autofree gchar *command = g_settings_get_string (settings, STARTUP_COMMAND_KEY);
+    g_autofree gchar *multiplexer = g_settings_get_string (settings, MULTIPLEXER_KEY);
+    g_autofree gchar *term = g_settings_get_string (settings, TERM_KEY);
+
+    g_settings_get_boolean (settings, DECORATED_KEY);
+    g_settings_get_int (settings, SPARE_WINDOWS_KEY);
+}
+
+static void
+parse_settings (const gchar            *config,
+                GerminalSettingsValues *values)
+{
+    g_autoptr (GSettings) settings = create_settings (config);
+    g_autofree gchar *font = g_settings_get_string (settings, FONT_KEY);
+    g_autofree gchar *forecolor = g_settings_get_string (settings, FORECOLOR_KEY);
+    g_autofree gchar *backcolor = g_settings_get_string (settings, BACKCOLOR_KEY);
+    g_autoptr (GVariant) palette = g_settings_get_value (settings, PALETTE_KEY);
+    PangoFontDescription *desc = pango_font_description_from_string (font);
+
+    values->font = pango_font_description_to_string (desc);
+    gdk_rgba_parse (&values->forecolor, forecolor);
+    gdk_rgba_parse (&values->backcolor, backcolor);
+    values->palette = germinal_settings_get_palette (settings, &values->palette_size);
+    values->scrollback = g_settings_get_int (settings, SCROLLBACK_KEY);
+    values->user_values = g_variant_ref_sink (g_variant_new_parsed ("{'font': <%s>, 'palette': <%@as>, 'scrollback-lines': <%i>}",
+                                                                    font,
+                                                                    palette,
+                                                                    values->scrollback));
+    read_startup_keys (settings);
+
+    pango_font_description_free (desc);
+}
+
+gint
+main (void)
+{
+    g_autofree gchar *dir = g_dir_make_tmp ("germinal-bench-XXXXXX", NULL);
+    g_autofree gchar *config = g_build_filename (dir, "germinal.conf", NULL);
+    g_autofree gchar *path = g_build_filename (dir, "settings.snapshot", NULL);
+    g_autoptr (GString) palette = g_string_new ("[Germinal]\npalette=[");
+    g_auto (GerminalSettingsValues) values = { 0 };
+
+    g_setenv ("GSETTINGS_BACKEND", "memory", TRUE);
+
+    for (guint i = 0; i < 24; ++i)
+        g_string_append_printf (palette, "%s'#%02x%02x%02x'", i ? ", " : "", i * 10, 255 - i * 10, i * 5);
+    g_string_append (palette, "]\nfont='Source Code Pro Semi-Bold 11'\nscrollback-lines=10000\n");
+    g_assert_true (g_file_set_contents (config, palette->str, -1, NULL));
+
+    gint64 start = g_get_monotonic_time ();
+    for (guint i = 0; i < N_RUNS; ++i)
+    {
+        germinal_settings_values_clear (&values);
+        parse_settings (config, &values);
+    }
+    g_print ("%-8s %8.3f ms per start\n", "parse", (g_get_monotonic_time () - start) / 1000.0 / N_RUNS);
+
+    g_assert_true (germinal_settings_snapshot_save (path, config, &values, NULL));
+
+    start = g_get_monotonic_time ();
+    for (guint i = 0; i < N_RUNS; ++i)
+    {
+        g_autoptr (GSettingsBackend) backend = NULL;
+        g_autoptr (GSettings) settings = NULL;
+
+        germinal_settings_values_clear (&values);
+        g_assert_true (germinal_settings_snapshot_load (path, config, &values));
+        backend = germinal_settings_backend_new (config, values.user_values);
+        settings = g_settings_new_with_backend ("org.gnome.Germinal", backend);
+        read_startup_keys (settings);
+    }
+    g_print ("%-8s %8.3f ms per start\n", "snapshot", (g_get_monotonic_time () - start) / 1000.0 / N_RUNS);
+
+    g_unlink (path);
+    g_unlink (config);
+    g_rmdir (dir);
+
+    return 0;
+}
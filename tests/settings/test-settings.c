@@ -3,8 +3,12 @@
 
 #define G_SETTINGS_ENABLE_BACKEND 1
 #include "germinal-settings.h"
+#include "germinal-settings-backend.h"
+#include "germinal-settings-snapshot.h"
+#include <glib/gstdio.h>
 
-#include <gio/gsettingsbackend.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 
 static GSettings *
 make_settings (void)
@@ -141,10 +145,264 @@ test_palette_color_parsing (void)
     g_assert_cmpfloat_with_epsilon (palette[2].blue,  1.0, 1e-3);
 }
 
+static void
+test_shared (void)
+{
+    g_autoptr (GSettings) first = germinal_settings_new ();
+    g_autoptr (GSettings) second = germinal_settings_new ();
+
+    g_assert_true (first == second);
+}
+
+static void
+test_cached_font (void)
+{
+    g_autoptr (GSettings) settings = germinal_settings_new ();
+
+    g_settings_set_string (settings, FONT_KEY, "Monospace 12");
+    const PangoFontDescription *font = germinal_settings_get_font ();
+    g_assert_cmpint (pango_font_description_get_size (font), ==, 12 * PANGO_SCALE);
+    /* Parsed once, then borrowed */
+    g_assert_true (germinal_settings_get_font () == font);
+
+    g_settings_set_string (settings, FONT_KEY, "Monospace 14");
+    g_assert_cmpint (pango_font_description_get_size (germinal_settings_get_font ()), ==, 14 * PANGO_SCALE);
+}
+
+static void
+test_cached_colors (void)
+{
+    g_autoptr (GSettings) settings = germinal_settings_new ();
+
+    g_settings_set_string (settings, FORECOLOR_KEY, "#ff0000");
+    g_assert_cmpfloat_with_epsilon (germinal_settings_get_forecolor ()->red, 1.0, 1e-3);
+
+    g_settings_set_string (settings, FORECOLOR_KEY, "#000000");
+    g_assert_cmpfloat_with_epsilon (germinal_settings_get_forecolor ()->red, 0.0, 1e-3);
+
+    set_palette (settings, 8);
+    gsize size = 0;
+    const GdkRGBA *palette = germinal_settings_get_cached_palette (&size);
+    g_assert_cmpuint (size, ==, 8);
+    g_assert_true (germinal_settings_get_cached_palette (&size) == palette);
+
+    set_palette (settings, 24);
+    germinal_settings_get_cached_palette (&size);
+    g_assert_cmpuint (size, ==, 24);
+}
+
+static void
+count_change_events (GSettings *settings G_GNUC_UNUSED,
+                     gpointer   keys      G_GNUC_UNUSED,
+                     gint       n_keys    G_GNUC_UNUSED,
+                     guint     *count)
+{
+    ++*count;
+}
+
+static void
+test_delayed_writes (void)
+{
+    g_autoptr (GSettings) settings = germinal_settings_new ();
+    /* Not shared, sees what actually reaches the backend */
+    g_autoptr (GSettings) backend = g_settings_new ("org.gnome.Germinal");
+    gint initial = g_settings_get_int (backend, SCROLLBACK_KEY);
+    guint writes = 0;
+
+    g_signal_connect (backend, "change-event", G_CALLBACK (count_change_events), &writes);
+
+    /* Spinning the scrollback in the preferences */
+    for (gint i = 1; i <= 10; ++i)
+        g_settings_set_int (settings, SCROLLBACK_KEY, initial + i);
+
+    /* Already what terminals get */
+    g_assert_cmpint (germinal_settings_get_scrollback (), ==, initial + 10);
+    while (g_main_context_iteration (NULL, FALSE));
+    g_assert_cmpint (g_settings_get_int (backend, SCROLLBACK_KEY), ==, initial);
+    g_assert_cmpuint (writes, ==, 0);
+
+    germinal_settings_flush ();
+    while (g_main_context_iteration (NULL, FALSE));
+    g_assert_cmpint (g_settings_get_int (backend, SCROLLBACK_KEY), ==, initial + 10);
+    g_assert_cmpuint (writes, ==, 1);
+}
+
+static void
+test_changes_for_key (void)
+{
+    /* A theme switch is a single reconfiguration */
+    g_assert_cmpint (germinal_settings_changes_for_key (BACKCOLOR_KEY), ==, GERMINAL_SETTINGS_CHANGE_COLORS);
+    g_assert_cmpint (germinal_settings_changes_for_key (FORECOLOR_KEY), ==, GERMINAL_SETTINGS_CHANGE_COLORS);
+    g_assert_cmpint (germinal_settings_changes_for_key (PALETTE_KEY),   ==, GERMINAL_SETTINGS_CHANGE_COLORS);
+
+    g_assert_cmpint (germinal_settings_changes_for_key (FONT_KEY),       ==, GERMINAL_SETTINGS_CHANGE_FONT);
+    g_assert_cmpint (germinal_settings_changes_for_key (SCROLLBACK_KEY), ==, GERMINAL_SETTINGS_CHANGE_SCROLLBACK);
+
+    /* Not something terminals care about */
+    g_assert_cmpint (germinal_settings_changes_for_key (DROP_DOWN_KEY), ==, GERMINAL_SETTINGS_CHANGE_NONE);
+    g_assert_cmpint (germinal_settings_changes_for_key (NULL),          ==, GERMINAL_SETTINGS_CHANGE_NONE);
+}
+
+static void
+make_snapshot_files (gchar **path,
+                     gchar **source)
+{
+    *path = g_build_filename (g_get_user_cache_dir (), "germinal", "settings.snapshot", NULL);
+    *source = g_build_filename (g_get_user_config_dir (), "germinal.conf", NULL);
+
+    g_assert_true (g_file_set_contents (*source, "[Germinal]\n", -1, NULL));
+}
+
+static void
+test_snapshot_roundtrip (void)
+{
+    g_autofree gchar *path = NULL;
+    g_autofree gchar *source = NULL;
+    GdkRGBA palette[2] = { { 1.0, 0.0, 0.0, 1.0 }, { 0.0, 0.5, 1.0, 1.0 } };
+    GerminalSettingsValues values = {
+        .font = "Monospace 11",
+        .forecolor = { 0.0, 1.0, 0.0, 1.0 },
+        .backcolor = { 0.0, 0.0, 0.0, 0.8 },
+        .palette = palette,
+        .palette_size = G_N_ELEMENTS (palette),
+        .scrollback = 4096,
+    };
+    g_auto (GerminalSettingsValues) loaded = { 0 };
+    g_autoptr (GVariant) user_values = g_variant_ref_sink (g_variant_new_parsed ("{'term': <'xterm-256color'>}"));
+    g_autoptr (GError) error = NULL;
+
+    values.user_values = user_values;
+    make_snapshot_files (&path, &source);
+    g_assert_true (germinal_settings_snapshot_save (path, source, &values, &error));
+    g_assert_no_error (error);
+
+    g_assert_true (germinal_settings_snapshot_load (path, source, &loaded));
+    g_assert_cmpstr (loaded.font, ==, "Monospace 11");
+    g_assert_true (gdk_rgba_equal (&loaded.forecolor, &values.forecolor));
+    g_assert_true (gdk_rgba_equal (&loaded.backcolor, &values.backcolor));
+    g_assert_cmpuint (loaded.palette_size, ==, 2);
+    g_assert_true (gdk_rgba_equal (&loaded.palette[1], &palette[1]));
+    g_assert_cmpint (loaded.scrollback, ==, 4096);
+    g_assert_true (g_variant_equal (loaded.user_values, user_values));
+}
+
+static void
+test_snapshot_stale (void)
+{
+    g_autofree gchar *path = NULL;
+    g_autofree gchar *source = NULL;
+    GerminalSettingsValues values = { .font = "Monospace 11", .scrollback = 1000 };
+    g_auto (GerminalSettingsValues) loaded = { 0 };
+
+    make_snapshot_files (&path, &source);
+    g_assert_true (germinal_settings_snapshot_save (path, source, &values, NULL));
+
+    /* Same mtime granularity, but a different size */
+    g_assert_true (g_file_set_contents (source, "[Germinal]\nscrollback-lines=10\n", -1, NULL));
+    g_assert_false (germinal_settings_snapshot_load (path, source, &loaded));
+
+    /* Garbage is rejected, not trusted */
+    g_assert_true (g_file_set_contents (path, "not a snapshot", -1, NULL));
+    g_assert_false (germinal_settings_snapshot_load (path, source, &loaded));
+
+    g_assert_null (loaded.font);
+}
+
+static void
+test_snapshot_same_second (void)
+{
+    g_autofree gchar *path = NULL;
+    g_autofree gchar *source = NULL;
+    GerminalSettingsValues values = { .font = "Monospace 11", .scrollback = 1000 };
+    g_auto (GerminalSettingsValues) loaded = { 0 };
+    GStatBuf buf;
+
+    make_snapshot_files (&path, &source);
+    g_assert_true (germinal_settings_snapshot_save (path, source, &values, NULL));
+
+    /* Rewritten with the same size within the same second */
+    g_assert_cmpint (g_stat (source, &buf), ==, 0);
+    g_assert_true (g_file_set_contents (source, "[Gzrminal]\n", -1, NULL));
+
+    struct timespec times[2] = { buf.st_atim, buf.st_mtim };
+    times[1].tv_nsec = (times[1].tv_nsec + 1) % 1000000000;
+    g_assert_cmpint (utimensat (AT_FDCWD, source, times, 0), ==, 0);
+
+    g_assert_false (germinal_settings_snapshot_load (path, source, &loaded));
+    g_assert_null (loaded.font);
+}
+
+static void
+count_changes (GSettings   *settings G_GNUC_UNUSED,
+               const gchar *key      G_GNUC_UNUSED,
+               guint       *count)
+{
+    ++*count;
+}
+
+static void
+test_backend_lazy (void)
+{
+    g_autofree gchar *keyfile = g_build_filename (g_get_user_config_dir (), "germinal.conf", NULL);
+    g_autoptr (GVariant) user_values = g_variant_ref_sink (g_variant_new_parsed ("{'font': <'Monospace 13'>}"));
+    g_autoptr (GSettingsBackend) backend = NULL;
+    g_autoptr (GSettings) settings = NULL;
+    g_autofree gchar *font = NULL;
+    guint changes = 0;
+
+    /* Edited since the snapshot was taken */
+    g_assert_true (g_file_set_contents (keyfile, "[Germinal]\nfont='Monospace 9'\n", -1, NULL));
+    backend = germinal_settings_backend_new (keyfile, user_values);
+    settings = g_settings_new_with_backend ("org.gnome.Germinal", backend);
+    g_signal_connect (settings, "changed::" FONT_KEY, G_CALLBACK (count_changes), &changes);
+
+    /* Answered from the snapshot, without parsing the keyfile */
+    font = g_settings_get_string (settings, FONT_KEY);
+    g_assert_cmpstr (font, ==, "Monospace 13");
+    g_assert_null (g_settings_get_user_value (settings, TERM_KEY));
+    g_assert_false (germinal_settings_backend_is_loaded (GERMINAL_SETTINGS_BACKEND (backend)));
+
+    /* Once idle */
+    while (g_main_context_iteration (NULL, FALSE));
+    g_assert_true (germinal_settings_backend_is_loaded (GERMINAL_SETTINGS_BACKEND (backend)));
+    g_assert_cmpuint (changes, ==, 1);
+    g_clear_pointer (&font, g_free);
+    font = g_settings_get_string (settings, FONT_KEY);
+    g_assert_cmpstr (font, ==, "Monospace 9");
+}
+
+static void
+test_backend_write (void)
+{
+    g_autofree gchar *keyfile = g_build_filename (g_get_user_config_dir (), "germinal.conf", NULL);
+    g_autoptr (GVariant) user_values = g_variant_ref_sink (g_variant_new_parsed ("@a{sv} {}"));
+    g_autoptr (GSettingsBackend) backend = NULL;
+    g_autoptr (GSettings) settings = NULL;
+    g_autoptr (GKeyFile) contents = g_key_file_new ();
+    guint changes = 0;
+
+    g_assert_true (g_file_set_contents (keyfile, "[Germinal]\n", -1, NULL));
+    backend = germinal_settings_backend_new (keyfile, user_values);
+    settings = g_settings_new_with_backend ("org.gnome.Germinal", backend);
+    g_signal_connect (settings, "changed::" SCROLLBACK_KEY, G_CALLBACK (count_changes), &changes);
+
+    /* Writing needs the keyfile right away, and is only notified once */
+    g_assert_true (g_settings_set_int (settings, SCROLLBACK_KEY, 42));
+    g_assert_true (germinal_settings_backend_is_loaded (GERMINAL_SETTINGS_BACKEND (backend)));
+    while (g_main_context_iteration (NULL, FALSE));
+    g_assert_cmpuint (changes, ==, 1);
+    g_assert_cmpint (g_settings_get_int (settings, SCROLLBACK_KEY), ==, 42);
+
+    g_assert_true (g_key_file_load_from_file (contents, keyfile, G_KEY_FILE_NONE, NULL));
+    g_assert_cmpint (g_key_file_get_integer (contents, "Germinal", SCROLLBACK_KEY, NULL), ==, 42);
+}
+
 gint
 main (gint argc, gchar *argv[])
 {
-    g_test_init (&argc, &argv, NULL);
+    /* The shared settings use the default backend */
+    g_setenv ("GSETTINGS_BACKEND", "memory", TRUE);
+    g_test_init (&argc, &argv, G_TEST_OPTION_ISOLATE_DIRS, NULL);
 
     g_test_add_func ("/palette/valid/empty",   test_palette_valid_empty);
     g_test_add_func ("/palette/valid/8",       test_palette_valid_8);
@@ -154,6 +412,16 @@ main (gint argc, gchar *argv[])
     g_test_add_func ("/palette/valid/255",     test_palette_valid_255);
     g_test_add_func ("/palette/invalid/resets",  test_palette_invalid_resets);
     g_test_add_func ("/palette/color-parsing", test_palette_color_parsing);
+    g_test_add_func ("/shared/same",           test_shared);
+    g_test_add_func ("/shared/font",           test_cached_font);
+    g_test_add_func ("/shared/colors",         test_cached_colors);
+    g_test_add_func ("/shared/delayed-writes", test_delayed_writes);
+    g_test_add_func ("/changes/for-key",       test_changes_for_key);
+    g_test_add_func ("/snapshot/roundtrip",    test_snapshot_roundtrip);
+    g_test_add_func ("/snapshot/stale",        test_snapshot_stale);
+    g_test_add_func ("/snapshot/same-second",  test_snapshot_same_second);
+    g_test_add_func ("/backend/lazy",          test_backend_lazy);
+    g_test_add_func ("/backend/write",         test_backend_write);
 
     return g_test_run ();
 }
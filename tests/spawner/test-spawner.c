@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-spawner.h"
+
+#include <string.h>
+
+static void
+test_roundtrip (void)
+{
+    const gchar *fields[] = { "42", "/home/user", "sh", "-c", "printf 'a\tb\\n' | cat", "", "é\n", NULL };
+    g_autofree gchar *line = germinal_spawner_encode (fields);
+
+    /* One line, one tab between each field */
+    guint n_tabs = 0;
+
+    g_assert_null (strchr (line, '\n'));
+    for (const gchar *c = line; *c; ++c)
+        n_tabs += *c == '\t';
+    g_assert_cmpuint (n_tabs, ==, g_strv_length ((GStrv) fields) - 1);
+
+    g_auto (GStrv) decoded = germinal_spawner_decode (line);
+    g_assert_true (g_strv_equal ((const gchar * const *) decoded, fields));
+}
+
+static void
+test_empty (void)
+{
+    const gchar *fields[] = { NULL };
+    g_autofree gchar *line = germinal_spawner_encode (fields);
+
+    g_assert_cmpstr (line, ==, "");
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/protocol/roundtrip", test_roundtrip);
+    g_test_add_func ("/protocol/empty",     test_empty);
+
+    return g_test_run ();
+}
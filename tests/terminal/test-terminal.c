@@ -0,0 +1,341 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define _GNU_SOURCE
+#include "germinal-terminal.h"
+#include "germinal-scrollback-index.h"
+#include "germinal-settings.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+static GtkWidget *
+show_terminal (GtkWidget **window)
+{
+    GtkWidget *terminal = germinal_terminal_new ();
+
+    *window = gtk_window_new ();
+    gtk_window_set_child (GTK_WINDOW (*window), terminal);
+    gtk_window_present (GTK_WINDOW (*window));
+
+    while (!gtk_widget_get_mapped (terminal))
+        g_main_context_iteration (NULL, TRUE);
+
+    return terminal;
+}
+
+static gboolean
+on_timeout (gpointer user_data)
+{
+    *(gboolean *) user_data = TRUE;
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Let a few frames go by, reconfiguring if anything is pending */
+static void
+run_frames (void)
+{
+    gboolean done = FALSE;
+
+    g_timeout_add (100, on_timeout, &done);
+
+    while (!done)
+        g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+test_reconfigure_once (void)
+{
+    g_autoptr (GSettings) settings = germinal_settings_new ();
+    GtkWidget *window;
+    GerminalTerminal *terminal = GERMINAL_TERMINAL (show_terminal (&window));
+
+    run_frames ();
+    g_assert_cmpuint (germinal_terminal_get_reconfigurations (terminal), ==, 0);
+
+    /* A theme switch, all within the same frame */
+    g_settings_set_string (settings, FORECOLOR_KEY, "#00ff00");
+    g_settings_set_string (settings, BACKCOLOR_KEY, "#101010");
+    g_settings_set_string (settings, FONT_KEY, "Monospace 13");
+    g_settings_set_int (settings, SCROLLBACK_KEY, 2000);
+
+    run_frames ();
+    g_assert_cmpuint (germinal_terminal_get_reconfigurations (terminal), ==, 1);
+    g_assert_cmpint (vte_terminal_get_scrollback_lines (VTE_TERMINAL (terminal)), ==, 2000);
+
+    gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static void
+test_reconfigurations_count (void)
+{
+    g_autoptr (GSettings) settings = germinal_settings_new ();
+    GtkWidget *window;
+    GerminalTerminal *terminal = GERMINAL_TERMINAL (show_terminal (&window));
+
+    g_settings_set_int (settings, SCROLLBACK_KEY, 3000);
+    run_frames ();
+    g_assert_cmpuint (germinal_terminal_get_reconfigurations (terminal), ==, 1);
+
+    g_settings_set_int (settings, SCROLLBACK_KEY, 4000);
+    run_frames ();
+    g_assert_cmpuint (germinal_terminal_get_reconfigurations (terminal), ==, 2);
+
+    /* Nothing for the terminal to apply */
+    g_settings_set_string (settings, TERM_KEY, "xterm");
+    run_frames ();
+    g_assert_cmpuint (germinal_terminal_get_reconfigurations (terminal), ==, 2);
+
+    gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static gchar *
+search (GerminalTerminal *terminal,
+        const gchar      *text)
+{
+    germinal_terminal_search (terminal, text, FALSE);
+    run_frames ();
+
+    return vte_terminal_get_text_selected (VTE_TERMINAL (terminal), VTE_FORMAT_TEXT);
+}
+
+static void
+test_search_refine (void)
+{
+    GtkWidget *window;
+    GerminalTerminal *terminal = GERMINAL_TERMINAL (show_terminal (&window));
+
+    vte_terminal_feed (VTE_TERMINAL (terminal), "first row\r\nALPHABET on the current row\r\nnothing\r\nalphabet further down\r\n", -1);
+    run_frames ();
+
+    g_autofree gchar *match = search (terminal, "alpha");
+    g_assert_cmpstr (match, ==, "ALPHA");
+
+    /* Still the same row, not the next one down */
+    g_autofree gchar *refined = search (terminal, "alphab");
+    g_assert_cmpstr (refined, ==, "ALPHAB");
+
+    /* Refined past the current row */
+    g_autofree gchar *further = search (terminal, "alphabet f");
+    g_assert_cmpstr (further, ==, "alphabet f");
+
+    gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static void
+test_search_wrapped (void)
+{
+    GtkWidget *window;
+    GerminalTerminal *terminal = GERMINAL_TERMINAL (show_terminal (&window));
+    glong columns = vte_terminal_get_column_count (VTE_TERMINAL (terminal));
+    g_autofree gchar *padding = g_strnfill (columns - 2, 'x');
+    g_autofree gchar *text = g_strconcat (padding, "needle\r\nneedle\r\n", NULL);
+    guint current, total;
+
+    /* The first one is split by a soft wrap */
+    vte_terminal_feed (VTE_TERMINAL (terminal), text, -1);
+    run_frames ();
+
+    germinal_terminal_search (terminal, "needle", FALSE);
+    while (!germinal_terminal_get_search_matches (terminal, &current, &total))
+        g_main_context_iteration (NULL, TRUE);
+
+    g_assert_cmpuint (total, ==, 2);
+
+    gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static void
+test_index_wrapped (void)
+{
+    GerminalScrollbackIndex *index = germinal_scrollback_index_get_default ();
+    GtkWidget *window;
+    GerminalTerminal *terminal = GERMINAL_TERMINAL (show_terminal (&window));
+    glong columns = vte_terminal_get_column_count (VTE_TERMINAL (terminal));
+    g_autofree gchar *padding = g_strnfill (columns - 3, 'y');
+    g_autofree gchar *text = g_strconcat (padding, "haystack\r\nhaystack\r\n", NULL);
+
+    vte_terminal_feed (VTE_TERMINAL (terminal), text, -1);
+    run_frames ();
+
+    /* Nothing searched across terminals yet, nothing indexed */
+    g_assert_cmpuint (germinal_scrollback_index_get_n_rows (index), ==, 0);
+
+    germinal_scrollback_index_start (index);
+    run_frames ();
+
+    /* Found on the first row of the line, even if split by a soft wrap, newest first */
+    g_autoptr (GArray) hits = germinal_scrollback_index_search (index, "haystack", 10);
+    g_assert_cmpuint (hits->len, ==, 2);
+    g_assert_cmpint (g_array_index (hits, GerminalIndexHit, 0).row, ==, 2);
+    g_assert_cmpint (g_array_index (hits, GerminalIndexHit, 1).row, ==, 0);
+
+    gtk_window_destroy (GTK_WINDOW (window));
+}
+
+typedef struct
+{
+    gint     slave;
+    gsize    expected;
+    GString *received;
+    gint     done;
+} Reader;
+
+static gpointer
+drain (gpointer data)
+{
+    Reader *reader = data;
+    gchar buffer[4096];
+
+    while (reader->received->len < reader->expected)
+    {
+        gssize n = read (reader->slave, buffer, sizeof (buffer));
+
+        if (n <= 0)
+            break;
+        g_string_append_len (reader->received, buffer, n);
+    }
+
+    g_atomic_int_set (&reader->done, TRUE);
+    g_main_context_wakeup (NULL);
+
+    return NULL;
+}
+
+static void
+test_paste_queued (void)
+{
+    GtkWidget *window;
+    GerminalTerminal *terminal = GERMINAL_TERMINAL (show_terminal (&window));
+    GdkClipboard *clipboard = gtk_widget_get_clipboard (GTK_WIDGET (terminal));
+    g_autoptr (GError) error = NULL;
+    g_autoptr (VtePty) pty = vte_pty_new_sync (VTE_PTY_DEFAULT, NULL, &error);
+    g_autofree gchar *big = g_strnfill (1024 * 1024, 'a');
+    struct termios attributes;
+
+    g_assert_no_error (error);
+    vte_terminal_set_pty (VTE_TERMINAL (terminal), pty);
+
+    Reader reader = {
+        .slave = open (ptsname (vte_pty_get_fd (pty)), O_RDWR | O_NOCTTY),
+        .expected = strlen (big) + strlen ("zzz"),
+        .received = g_string_new (NULL),
+    };
+
+    g_assert_cmpint (reader.slave, >=, 0);
+    tcgetattr (reader.slave, &attributes);
+    cfmakeraw (&attributes);
+    tcsetattr (reader.slave, TCSANOW, &attributes);
+
+    /* Nothing reads yet, so the big one stays stuck halfway */
+    gdk_clipboard_set_text (clipboard, big);
+    germinal_terminal_paste (terminal);
+    while (!germinal_terminal_get_paste_progress (terminal, NULL, NULL))
+        g_main_context_iteration (NULL, TRUE);
+
+    gdk_clipboard_set_text (clipboard, "zzz");
+    germinal_terminal_paste (terminal);
+    run_frames ();
+
+    GThread *thread = g_thread_new ("drain", drain, &reader);
+
+    while (!g_atomic_int_get (&reader.done))
+        g_main_context_iteration (NULL, TRUE);
+    g_thread_join (thread);
+
+    /* The small one waited for the big one to be through */
+    g_assert_cmpuint (reader.received->len, ==, reader.expected);
+    g_assert_cmpuint (strchr (reader.received->str, 'z') - reader.received->str, ==, strlen (big));
+
+    close (reader.slave);
+    g_string_free (reader.received, TRUE);
+    gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static void
+test_paste_bracketed (void)
+{
+    GtkWidget *window;
+    GerminalTerminal *terminal = GERMINAL_TERMINAL (show_terminal (&window));
+    GdkClipboard *clipboard = gtk_widget_get_clipboard (GTK_WIDGET (terminal));
+    g_autoptr (GError) error = NULL;
+    g_autoptr (VtePty) pty = vte_pty_new_sync (VTE_PTY_DEFAULT, NULL, &error);
+    g_autoptr (GString) lines = g_string_new (NULL);
+    g_autoptr (GString) expected = g_string_new ("\033[200~\033[201~\033[200~");
+    struct termios attributes;
+
+    g_assert_no_error (error);
+    vte_terminal_set_pty (VTE_TERMINAL (terminal), pty);
+    /* As if the application asked for it */
+    vte_terminal_feed (VTE_TERMINAL (terminal), "\033[?2004h", -1);
+
+    while (lines->len < 256 * 1024)
+        g_string_append_printf (lines, "echo line %u\n", lines->len);
+    for (gsize i = 0; i < lines->len; ++i)
+        g_string_append_c (expected, lines->str[i] == '\n' ? '\r' : lines->str[i]);
+    g_string_append (expected, "\033[201~");
+
+    Reader reader = {
+        .slave = open (ptsname (vte_pty_get_fd (pty)), O_RDWR | O_NOCTTY),
+        .expected = expected->len,
+        .received = g_string_new (NULL),
+    };
+
+    g_assert_cmpint (reader.slave, >=, 0);
+    tcgetattr (reader.slave, &attributes);
+    cfmakeraw (&attributes);
+    tcsetattr (reader.slave, TCSANOW, &attributes);
+
+    GThread *thread = g_thread_new ("drain", drain, &reader);
+
+    gdk_clipboard_set_text (clipboard, lines->str);
+    germinal_terminal_paste (terminal);
+
+    while (!g_atomic_int_get (&reader.done))
+        g_main_context_iteration (NULL, TRUE);
+    g_thread_join (thread);
+
+    /* After the empty one telling the mode, one paste for all of the chunks */
+    g_assert_cmpuint (reader.received->len, ==, expected->len);
+    g_assert_true (!memcmp (reader.received->str, expected->str, expected->len));
+
+    close (reader.slave);
+    g_string_free (reader.received, TRUE);
+    gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static void
+test_no_display (void)
+{
+    g_test_skip ("no display available");
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+    /* The shared settings use the default backend */
+    g_setenv ("GSETTINGS_BACKEND", "memory", TRUE);
+    g_test_init (&argc, &argv, G_TEST_OPTION_ISOLATE_DIRS, NULL);
+
+    if (!g_getenv ("DISPLAY") && !g_getenv ("WAYLAND_DISPLAY"))
+    {
+        g_test_add_func ("/terminal/no-display", test_no_display);
+        return g_test_run ();
+    }
+
+    gtk_init ();
+
+    g_test_add_func ("/terminal/reconfigure-once",        test_reconfigure_once);
+    g_test_add_func ("/terminal/reconfigurations-count", test_reconfigurations_count);
+    g_test_add_func ("/terminal/search-refine",          test_search_refine);
+    g_test_add_func ("/terminal/search-wrapped",         test_search_wrapped);
+    g_test_add_func ("/terminal/index-wrapped",          test_index_wrapped);
+    g_test_add_func ("/terminal/paste-queued",           test_paste_queued);
+    g_test_add_func ("/terminal/paste-bracketed",        test_paste_bracketed);
+
+    return g_test_run ();
+}
@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-theme.h"
+
+static GFile *
+write_scheme (const gchar *basename,
+              const gchar *contents)
+{
+    g_autofree gchar *path = g_build_filename (g_get_user_data_dir (), basename, NULL);
+
+    g_assert_true (g_file_set_contents (path, contents, -1, NULL));
+
+    return g_file_new_for_path (path);
+}
+
+static void
+assert_rgb (const GdkRGBA *rgba,
+            gdouble        red,
+            gdouble        green,
+            gdouble        blue)
+{
+    g_assert_cmpfloat_with_epsilon (rgba->red,   red,   1e-3);
+    g_assert_cmpfloat_with_epsilon (rgba->green, green, 1e-3);
+    g_assert_cmpfloat_with_epsilon (rgba->blue,  blue,  1e-3);
+}
+
+static void
+test_xresources (void)
+{
+    g_autoptr (GString) scheme = g_string_new ("! A comment\n#define red #ff0000\n*.foreground: #ffffff\nURxvt*background: rgb:00/00/80\n");
+
+    for (guint i = 0; i < GERMINAL_THEME_N_COLORS; ++i)
+        g_string_append_printf (scheme, "*color%u: %s\n", i, i == 1 ? "red" : "#000000");
+
+    g_autoptr (GFile) file = write_scheme ("Dark.Xresources", scheme->str);
+    g_autoptr (GError) error = NULL;
+    g_autoptr (GerminalTheme) theme = germinal_theme_load (file, NULL, &error);
+
+    g_assert_no_error (error);
+    g_assert_cmpstr (germinal_theme_get_name (theme), ==, "Dark");
+    assert_rgb (germinal_theme_get_foreground (theme), 1.0, 1.0, 1.0);
+    assert_rgb (germinal_theme_get_background (theme), 0.0, 0.0, 128.0 / 255.0);
+    assert_rgb (&germinal_theme_get_palette (theme)[1], 1.0, 0.0, 0.0);
+}
+
+static void
+test_base16 (void)
+{
+    g_autoptr (GString) scheme = g_string_new ("# A comment\nscheme: \"Ocean\"\nauthor: \"Someone\"\n");
+
+    for (guint i = 0; i < 16; ++i)
+        g_string_append_printf (scheme, "base%02X: \"%02x0000\" # base%02X\n", i, i * 16, i);
+
+    g_autoptr (GFile) file = write_scheme ("ocean.yaml", scheme->str);
+    g_autoptr (GError) error = NULL;
+    g_autoptr (GerminalTheme) theme = germinal_theme_load (file, NULL, &error);
+
+    g_assert_no_error (error);
+    g_assert_cmpstr (germinal_theme_get_name (theme), ==, "Ocean");
+    /* base05 on base00, red is base08 */
+    assert_rgb (germinal_theme_get_foreground (theme), 0x50 / 255.0, 0.0, 0.0);
+    assert_rgb (germinal_theme_get_background (theme), 0.0, 0.0, 0.0);
+    assert_rgb (&germinal_theme_get_palette (theme)[1], 0x80 / 255.0, 0.0, 0.0);
+    assert_rgb (&germinal_theme_get_palette (theme)[15], 0x70 / 255.0, 0.0, 0.0);
+}
+
+static void
+test_iterm (void)
+{
+    g_autoptr (GString) scheme = g_string_new ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<plist version=\"1.0\">\n<dict>\n");
+
+    for (guint i = 0; i < GERMINAL_THEME_N_COLORS; ++i)
+        g_string_append_printf (scheme,
+                                "<key>Ansi %u Color</key>\n<dict>\n"
+                                "<key>Blue Component</key><real>%g</real>\n"
+                                "<key>Color Space</key><string>sRGB</string>\n"
+                                "<key>Green Component</key><real>0</real>\n"
+                                "<key>Red Component</key><real>0</real>\n"
+                                "</dict>\n", i, i / 15.0);
+    /* Must not override the regular ones */
+    g_string_append (scheme, "<key>Ansi 1 Color (Light)</key>\n<dict><key>Red Component</key><real>1</real></dict>\n");
+    g_string_append (scheme, "<key>Foreground Color</key>\n<dict><key>Green Component</key><real>1</real></dict>\n");
+    g_string_append (scheme, "</dict>\n</plist>\n");
+
+    g_autoptr (GFile) file = write_scheme ("Solar.itermcolors", scheme->str);
+    g_autoptr (GError) error = NULL;
+    g_autoptr (GerminalTheme) theme = germinal_theme_load (file, NULL, &error);
+
+    g_assert_no_error (error);
+    g_assert_cmpstr (germinal_theme_get_name (theme), ==, "Solar");
+    assert_rgb (germinal_theme_get_foreground (theme), 0.0, 1.0, 0.0);
+    /* No background, the first palette color then */
+    assert_rgb (germinal_theme_get_background (theme), 0.0, 0.0, 0.0);
+    assert_rgb (&germinal_theme_get_palette (theme)[1], 0.0, 0.0, 1.0 / 15.0);
+    assert_rgb (&germinal_theme_get_palette (theme)[15], 0.0, 0.0, 1.0);
+}
+
+static void
+test_incomplete (void)
+{
+    g_autoptr (GFile) file = write_scheme ("partial.Xresources", "*.color0: #000000\n*.color1: #ff0000\n");
+    g_autoptr (GError) error = NULL;
+    g_autoptr (GerminalTheme) theme = germinal_theme_load (file, NULL, &error);
+
+    g_assert_null (theme);
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+}
+
+static void
+test_library (void)
+{
+    g_autoptr (GString) scheme = g_string_new (NULL);
+
+    for (guint i = 0; i < GERMINAL_THEME_N_COLORS; ++i)
+        g_string_append_printf (scheme, "*.color%u: #%02x%02x%02x\n", i, i, i * 2, i * 3);
+
+    g_autoptr (GFile) file = write_scheme ("library.Xresources", scheme->str);
+    g_autoptr (GListStore) themes = g_list_store_new (GERMINAL_TYPE_THEME);
+    g_autoptr (GerminalTheme) theme = germinal_theme_load (file, NULL, NULL);
+    g_autofree gchar *path = g_build_filename (g_get_user_data_dir (), "germinal", "themes", NULL);
+    g_autoptr (GError) error = NULL;
+
+    g_list_store_append (themes, theme);
+    g_assert_true (germinal_theme_library_save (path, G_LIST_MODEL (themes), &error));
+    g_assert_no_error (error);
+
+    g_autoptr (GPtrArray) library = germinal_theme_library_load (path);
+    g_assert_cmpuint (library->len, ==, 1);
+
+    GerminalTheme *loaded = library->pdata[0];
+    g_autoptr (GFileInfo) info = g_file_query_info (file, GERMINAL_THEME_FILE_ATTRIBUTES, G_FILE_QUERY_INFO_NONE, NULL, NULL);
+
+    g_assert_cmpstr (germinal_theme_get_name (loaded), ==, "library");
+    g_assert_cmpstr (germinal_theme_get_source (loaded), ==, germinal_theme_get_source (theme));
+    g_assert_true (gdk_rgba_equal (&germinal_theme_get_palette (loaded)[15], &germinal_theme_get_palette (theme)[15]));
+    g_assert_true (germinal_theme_is_up_to_date (loaded, info));
+
+    /* Rewritten within the same second, with the same size */
+    g_autoptr (GFileInfo) rewritten = g_file_info_dup (info);
+    guint32 nsec = g_file_info_get_attribute_uint32 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED_NSEC);
+
+    g_file_info_set_attribute_uint32 (rewritten, G_FILE_ATTRIBUTE_TIME_MODIFIED_NSEC, (nsec + 1) % 1000000000);
+    g_assert_false (germinal_theme_is_up_to_date (loaded, rewritten));
+
+    /* A damaged library is ignored, not trusted */
+    g_assert_true (g_file_set_contents (path, "garbage", -1, NULL));
+    g_clear_pointer (&library, g_ptr_array_unref);
+    library = germinal_theme_library_load (path);
+    g_assert_cmpuint (library->len, ==, 0);
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+    g_test_init (&argc, &argv, G_TEST_OPTION_ISOLATE_DIRS, NULL);
+
+    g_test_add_func ("/theme/xresources", test_xresources);
+    g_test_add_func ("/theme/base16",     test_base16);
+    g_test_add_func ("/theme/iterm",      test_iterm);
+    g_test_add_func ("/theme/incomplete", test_incomplete);
+    g_test_add_func ("/theme/library",    test_library);
+
+    return g_test_run ();
+}
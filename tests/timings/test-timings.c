@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-timings.h"
+
+#include <string.h>
+
+static void
+test_format (void)
+{
+    gint64 marks[GERMINAL_TIMING_N_PHASES] = {
+        [GERMINAL_TIMING_PROCESS_START]   = 1000000,
+        [GERMINAL_TIMING_SETTINGS_LOADED] = 1012500,
+        [GERMINAL_TIMING_FIRST_FRAME]     = 1250000,
+    };
+    g_autofree gchar *timeline = germinal_timings_format (marks);
+
+    g_assert_nonnull (strstr (timeline, "settings loaded"));
+    g_assert_nonnull (strstr (timeline, "12.50\n"));
+    g_assert_nonnull (strstr (timeline, "250.00\n"));
+    /* Phases that weren't reached */
+    g_assert_nonnull (strstr (timeline, "window mapped"));
+    g_assert_nonnull (strstr (timeline, "-\n"));
+}
+
+static void
+test_no_start (void)
+{
+    gint64 marks[GERMINAL_TIMING_N_PHASES] = {
+        [GERMINAL_TIMING_FIRST_FRAME] = 1250000,
+    };
+    g_autofree gchar *timeline = germinal_timings_format (marks);
+
+    g_assert_null (strstr (timeline, "."));
+}
+
+static void
+test_first_mark_wins (void)
+{
+    g_assert_false (germinal_timings_has (GERMINAL_TIMING_PTY_OPENED));
+
+    germinal_timings_mark (GERMINAL_TIMING_PTY_OPENED);
+    g_assert_true (germinal_timings_has (GERMINAL_TIMING_PTY_OPENED));
+    g_assert_false (germinal_timings_has (GERMINAL_TIMING_FIRST_FRAME));
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/timings/format",          test_format);
+    g_test_add_func ("/timings/no-start",        test_no_start);
+    g_test_add_func ("/timings/first-mark-wins", test_first_mark_wins);
+
+    return g_test_run ();
+}
@@ -0,0 +1,260 @@
+// SPDX-FileCopyrightText: 2026 Marc-Antoine Perennou <Marc-Antoine@Perennou.com>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "germinal-tmux.h"
+
+#include <string.h>
+
+static void
+assert_pane (GArray *panes,
+             guint   index,
+             guint   id,
+             guint   width,
+             guint   height,
+             guint   x,
+             guint   y)
+{
+    g_assert_cmpuint (index, <, panes->len);
+
+    GerminalTmuxPane *pane = &g_array_index (panes, GerminalTmuxPane, index);
+
+    g_assert_cmpuint (pane->id,     ==, id);
+    g_assert_cmpuint (pane->width,  ==, width);
+    g_assert_cmpuint (pane->height, ==, height);
+    g_assert_cmpuint (pane->x,      ==, x);
+    g_assert_cmpuint (pane->y,      ==, y);
+}
+
+static void
+test_layout_single (void)
+{
+    g_autoptr (GArray) panes = germinal_tmux_parse_layout ("b25d,80x24,0,0,0");
+
+    g_assert_nonnull (panes);
+    g_assert_cmpuint (panes->len, ==, 1);
+    assert_pane (panes, 0, 0, 80, 24, 0, 0);
+}
+
+static void
+test_layout_nested (void)
+{
+    g_autoptr (GArray) panes = germinal_tmux_parse_layout ("5c3d,159x48,0,0{79x48,0,0,1,79x48,80,0[79x24,80,0,2,79x23,80,25,3]}");
+
+    g_assert_nonnull (panes);
+    g_assert_cmpuint (panes->len, ==, 3);
+    assert_pane (panes, 0, 1, 79, 48, 0,  0);
+    assert_pane (panes, 1, 2, 79, 24, 80, 0);
+    assert_pane (panes, 2, 3, 79, 23, 80, 25);
+}
+
+static void
+test_layout_invalid (void)
+{
+    const gchar *layouts[] = {
+        "",
+        "b25d",
+        "b25d,80x24,0,0",
+        "b25d,80x24,0,0{79x48,0,0,1",
+        "b25d,80x24,0,0,0trailing",
+        "b25d,80xfoo,0,0,0",
+        NULL,
+    };
+
+    for (guint i = 0; layouts[i]; ++i)
+    {
+        g_autoptr (GArray) panes = germinal_tmux_parse_layout (layouts[i]);
+        g_assert_null (panes);
+    }
+}
+
+static void
+test_unescape (void)
+{
+    g_autoptr (GBytes) bytes = germinal_tmux_unescape ("a\\033[0m\\015\\012\\134z\\0");
+    gsize size = 0;
+    const gchar *data = g_bytes_get_data (bytes, &size);
+
+    g_assert_cmpmem (data, size, "a\033[0m\r\n\\z\\0", 11);
+}
+
+static void
+test_control_argv (void)
+{
+    const gchar *tmux[] = { "/usr/bin/tmux", "-u2", "new", "-As0", NULL };
+    const gchar *already[] = { "tmux", "-CC", "attach", NULL };
+    const gchar *shell[] = { "/bin/zsh", NULL };
+    const gchar *empty[] = { NULL };
+
+    g_auto (GStrv) argv = germinal_tmux_control_argv (tmux);
+    const gchar *expected[] = { "/usr/bin/tmux", "-C", "-u2", "new", "-As0", NULL };
+    g_assert_true (g_strv_equal ((const gchar * const *) argv, expected));
+
+    g_auto (GStrv) argv2 = germinal_tmux_control_argv (already);
+    const gchar *expected2[] = { "tmux", "-C", "attach", NULL };
+    g_assert_true (g_strv_equal ((const gchar * const *) argv2, expected2));
+
+    g_assert_null (germinal_tmux_control_argv (shell));
+    g_assert_null (germinal_tmux_control_argv (empty));
+}
+
+static void
+test_session_argv (void)
+{
+    const gchar *command[] = { "tmux", "-u2", "new", "-As0", NULL };
+    g_autofree gchar *session = NULL;
+    g_auto (GStrv) globals = NULL;
+
+    g_auto (GStrv) first = germinal_tmux_session_argv (command, GERMINAL_TMUX_SESSIONS_GROUPED, 0, &session, &globals);
+    g_assert_null (first);
+    g_assert_cmpstr (session, ==, "0");
+    g_clear_pointer (&session, g_free);
+    g_clear_pointer (&globals, g_strfreev);
+
+    g_auto (GStrv) shared = germinal_tmux_session_argv (command, GERMINAL_TMUX_SESSIONS_SHARED, 2, &session, &globals);
+    g_assert_null (shared);
+    g_assert_cmpstr (session, ==, "0");
+    g_clear_pointer (&session, g_free);
+    g_clear_pointer (&globals, g_strfreev);
+
+    g_auto (GStrv) grouped = germinal_tmux_session_argv (command, GERMINAL_TMUX_SESSIONS_GROUPED, 1, &session, &globals);
+    const gchar *expected_grouped[] = { "tmux", "-u2", "new-session", "-t", "0", "-s", "0-1", ";",
+                                        "set-option", "destroy-unattached", "on", NULL };
+    g_assert_true (g_strv_equal ((const gchar * const *) grouped, expected_grouped));
+    g_assert_cmpstr (session, ==, "0-1");
+    g_clear_pointer (&session, g_free);
+    g_clear_pointer (&globals, g_strfreev);
+
+    g_auto (GStrv) per_window = germinal_tmux_session_argv (command, GERMINAL_TMUX_SESSIONS_PER_WINDOW, 3, &session, &globals);
+    const gchar *expected_per_window[] = { "tmux", "-u2", "new-session", "-A", "-s", "0-3", NULL };
+    g_assert_true (g_strv_equal ((const gchar * const *) per_window, expected_per_window));
+    g_assert_cmpstr (session, ==, "0-3");
+}
+
+static void
+test_session_argv_names (void)
+{
+    const gchar *split[] = { "/usr/bin/tmux", "-L", "germinal", "new-session", "-A", "-s", "main", NULL };
+    const gchar *attach[] = { "tmux", "-CC", "-Sa socket", "attach", "-t", "work", NULL };
+    const gchar *unnamed[] = { "tmux", "new", NULL };
+    const gchar *shell[] = { "/bin/zsh", NULL };
+    g_autofree gchar *session = NULL;
+    g_auto (GStrv) globals = NULL;
+
+    g_auto (GStrv) argv = germinal_tmux_session_argv (split, GERMINAL_TMUX_SESSIONS_PER_WINDOW, 1, &session, &globals);
+    const gchar *expected[] = { "/usr/bin/tmux", "-L", "germinal", "new-session", "-A", "-s", "main-1", NULL };
+    g_assert_true (g_strv_equal ((const gchar * const *) argv, expected));
+    g_assert_cmpstr (session, ==, "main-1");
+
+    /* The control client talks to the same server */
+    g_auto (GStrv) control = germinal_tmux_attach_argv ((const gchar * const *) globals, session);
+    const gchar *expected_control[] = { "/usr/bin/tmux", "-L", "germinal", "-C", "attach-session",
+                                        "-f", "ignore-size,no-output", "-t", "main-1", NULL };
+    g_assert_true (g_strv_equal ((const gchar * const *) control, expected_control));
+    g_clear_pointer (&session, g_free);
+    g_clear_pointer (&globals, g_strfreev);
+
+    g_auto (GStrv) argv2 = germinal_tmux_session_argv (attach, GERMINAL_TMUX_SESSIONS_SHARED, 1, &session, &globals);
+    const gchar *expected_globals[] = { "tmux", "-Sa socket", NULL };
+    g_assert_null (argv2);
+    g_assert_cmpstr (session, ==, "work");
+    g_assert_true (g_strv_equal ((const gchar * const *) globals, expected_globals));
+
+    /* So does the one-shot fallback */
+    g_autofree gchar *cmdline = germinal_tmux_command_line ((const gchar * const *) globals, "next-window");
+    g_auto (GStrv) fallback = NULL;
+    const gchar *expected_fallback[] = { "tmux", "-Sa socket", "next-window", NULL };
+    g_assert_true (g_shell_parse_argv (cmdline, NULL, &fallback, NULL));
+    g_assert_true (g_strv_equal ((const gchar * const *) fallback, expected_fallback));
+    g_clear_pointer (&session, g_free);
+    g_clear_pointer (&globals, g_strfreev);
+
+    g_assert_null (germinal_tmux_session_argv (unnamed, GERMINAL_TMUX_SESSIONS_GROUPED, 1, &session, &globals));
+    g_assert_null (session);
+    g_clear_pointer (&globals, g_strfreev);
+    g_assert_null (germinal_tmux_session_argv (shell, GERMINAL_TMUX_SESSIONS_GROUPED, 1, &session, &globals));
+    g_assert_null (session);
+    g_assert_null (globals);
+}
+
+/* Stands for tmux: every command list but those with "fail" in them succeeds */
+static const gchar *fake_tmux =
+    "while read -r line; do\n"
+    "  echo \"%received $line\"\n"
+    "  case \"$line\" in\n"
+    "    *fail*) echo '%begin 1 1 1'; echo '%end 1 1 1'; echo '%begin 1 2 1'; echo '%error 1 2 1' ;;\n"
+    "    *) echo '%begin 1 1 1'; echo '%end 1 1 1' ;;\n"
+    "  esac\n"
+    "done\n";
+
+static void
+on_notification (GerminalTmux *tmux G_GNUC_UNUSED,
+                 const gchar  *line,
+                 gpointer      user_data)
+{
+    GPtrArray *received = user_data;
+
+    if (g_str_has_prefix (line, "%received "))
+        g_ptr_array_add (received, g_strdup (line + strlen ("%received ")));
+}
+
+static gboolean
+on_timeout (gpointer user_data)
+{
+    *(gboolean *) user_data = TRUE;
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+wait_for_command (GPtrArray   *received,
+                  const gchar *command)
+{
+    gboolean timed_out = FALSE;
+    guint timeout_id = g_timeout_add_seconds (5, on_timeout, &timed_out);
+
+    while (!timed_out && !g_ptr_array_find_with_equal_func (received, command, g_str_equal, NULL))
+        g_main_context_iteration (NULL, TRUE);
+
+    g_assert_false (timed_out);
+    g_source_remove (timeout_id);
+}
+
+static void
+test_batch_error (void)
+{
+    const gchar *argv[] = { "/bin/sh", "-c", fake_tmux, NULL };
+    g_autoptr (GPtrArray) received = g_ptr_array_new_with_free_func (g_free);
+    g_autoptr (GError) error = NULL;
+    g_autoptr (GerminalTmux) tmux = germinal_tmux_new_for_argv (argv, &error);
+
+    g_assert_no_error (error);
+    g_signal_connect (tmux, "notification", G_CALLBACK (on_notification), received);
+
+    /* The last three wait for the first, then go together */
+    g_assert_true (germinal_tmux_send (tmux, "first"));
+    g_assert_true (germinal_tmux_send (tmux, "select-pane -t %1"));
+    g_assert_true (germinal_tmux_send (tmux, "fail"));
+    g_assert_true (germinal_tmux_send (tmux, "select-pane -t %2"));
+    wait_for_command (received, "select-pane -t %1 ; fail ; select-pane -t %2");
+
+    /* No block comes for the one after the failed command, this must not wait for it */
+    g_assert_true (germinal_tmux_send (tmux, "after"));
+    wait_for_command (received, "after");
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/layout/single",  test_layout_single);
+    g_test_add_func ("/layout/nested",  test_layout_nested);
+    g_test_add_func ("/layout/invalid", test_layout_invalid);
+    g_test_add_func ("/unescape",       test_unescape);
+    g_test_add_func ("/control-argv",   test_control_argv);
+    g_test_add_func ("/session-argv",   test_session_argv);
+    g_test_add_func ("/session-argv/names", test_session_argv_names);
+    g_test_add_func ("/batch-error",    test_batch_error);
+
+    return g_test_run ();
+}